@@ -20,6 +20,7 @@
 #include <ignition/msgs/serialized.pb.h>
 #include <ignition/msgs/serialized_map.pb.h>
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <optional>
@@ -110,6 +111,27 @@ namespace ignition
       public: Entity Clone(Entity _entity, Entity _parent,
                   const std::string &_name, bool _allowRename);
 
+      /// \brief Clone an entity and its children many times, such as to
+      /// spawn many copies of a model. This is faster than calling Clone
+      /// repeatedly: the subtree of _entity is only walked once, and views
+      /// are only updated once per cloned entity.
+      ///
+      /// The same rules as Clone apply, except that descendants of each
+      /// clone keep the names of the entities they were cloned from, since
+      /// they're scoped by their cloned parents. Joints therefore keep
+      /// referring to the cloned links.
+      /// \param[in] _entity The entity to clone.
+      /// \param[in] _parent The parent of the cloned entities. Set this to
+      /// kNullEntity if they should not have a parent.
+      /// \param[in] _names One name per clone. Empty names are replaced with
+      /// auto-generated unique names. A clone is skipped if its name is
+      /// already used by another child of _parent.
+      /// \return The cloned entities, in the order of _names. Skipped clones
+      /// are kNullEntity, as are all of them if _entity doesn't exist.
+      /// \sa Clone
+      public: std::vector<Entity> CloneMany(Entity _entity, Entity _parent,
+                  const std::vector<std::string> &_names);
+
       /// \brief Get the number of entities on the server.
       /// \return Entity count.
       public: size_t EntityCount() const;
@@ -353,6 +375,10 @@ namespace ignition
       ///
       /// \details Component type must have inequality operator.
       ///
+      /// If any of the component types has a value index, only the entities
+      /// in the index with a matching value are checked.
+      /// \sa EnableValueIndex
+      ///
       /// \param[in] _desiredComponents All the components which must match.
       /// \return Entity or kNullEntity if no entity has the exact components.
       public: template<typename ...ComponentTypeTs>
@@ -368,6 +394,10 @@ namespace ignition
       ///
       /// \details Component type must have inequality operator.
       ///
+      /// If any of the component types has a value index, only the entities
+      /// in the index with a matching value are checked.
+      /// \sa EnableValueIndex
+      ///
       /// \param[in] _desiredComponents All the components which must match.
       /// \return All matching entities, or an empty vector if no child entity
       /// has the exact components.
@@ -385,6 +415,9 @@ namespace ignition
       ///
       /// \details Component type must have inequality operator.
       ///
+      /// Only the children of _parent are checked, so the cost depends on
+      /// the number of children rather than the number of entities.
+      ///
       /// \param[in] _parent Entity which should be an immediate parent of the
       /// returned entity.
       /// \param[in] _desiredComponents All the components which must match.
@@ -394,10 +427,78 @@ namespace ignition
               std::vector<Entity> ChildrenByComponents(Entity _parent,
                    const ComponentTypeTs &..._desiredComponents) const;
 
+      /// \brief Keep a hashed index of the values of a component type, so
+      /// that EntityByComponents and EntitiesByComponents calls that include
+      /// that component type only check the entities with a matching value,
+      /// instead of every entity that has the component.
+      ///
+      /// The index is updated when components are created, removed or set
+      /// through SetComponentData, when entities are removed, and when SetState
+      /// or SetChanged are called. Entities found through the index are
+      /// always checked against their current value, but an entity whose
+      /// component was modified in place, without calling SetChanged, won't
+      /// be found by its new value. So only enable the index for types whose
+      /// data is always written through the ECM.
+      ///
+      /// The index is enabled by default for components::ParentEntity, which
+      /// must be set through the ECM to keep the entity graph up to date.
+      /// Calling this for a type that is already indexed has no effect.
+      /// \tparam ComponentTypeT Component type, whose data type must be
+      /// supported by std::hash.
+      public: template<typename ComponentTypeT>
+              void EnableValueIndex();
+
+      /// \brief Get whether a component type has a value index.
+      /// \param[in] _typeId Component type ID.
+      /// \return True if the component type's values are indexed.
+      /// \sa EnableValueIndex
+      public: bool HasValueIndex(const ComponentTypeId _typeId) const;
+
       /// why is this required?
       private: template <typename T>
                struct identity;  // NOLINT
 
+      /// \brief Get whether an entity has components with the same value as
+      /// all the given components.
+      /// \param[in] _entity Entity to check.
+      /// \param[in] _desiredComponents All the components which must match.
+      /// \return True if all components match.
+      private: template<typename ...ComponentTypeTs>
+               bool EntityMatchesComponents(const Entity _entity,
+                   const ComponentTypeTs &..._desiredComponents) const;
+
+      /// \brief Get the entities that may match the given components according
+      /// to the value indexes, using the index with fewest candidates.
+      /// \param[in] _desiredComponents Components to look up.
+      /// \return Candidate entities, which still need to be checked, or
+      /// nullptr if none of the component types is indexed.
+      private: template<typename ...ComponentTypeTs>
+               const std::vector<Entity> *IndexedCandidates(
+                   const ComponentTypeTs &..._desiredComponents) const;
+
+      /// \brief Get the entities whose component, of the same type as the
+      /// given one, has the same value hash.
+      /// \param[in] _desired Component to look up.
+      /// \return Candidate entities, or nullptr if the type isn't indexed.
+      private: const std::vector<Entity> *ValueIndexCandidates(
+                   const components::BaseComponent &_desired) const;
+
+      /// \brief Implementation of EnableValueIndex.
+      /// \param[in] _typeId Component type ID.
+      /// \param[in] _hash Function that hashes the value of a component of
+      /// type _typeId.
+      private: void EnableValueIndexImplementation(
+                   const ComponentTypeId _typeId,
+                   std::function<std::size_t(
+                       const components::BaseComponent &)> _hash);
+
+      /// \brief Update the value index entry of an entity's component, if
+      /// its type is indexed.
+      /// \param[in] _entity Entity.
+      /// \param[in] _typeId Component type ID.
+      private: void UpdateValueIndex(const Entity _entity,
+                   const ComponentTypeId _typeId);
+
       /// \brief Helper function for cloning an entity and its children (this
       /// includes cloning components attached to these entities). This method
       /// should never be called directly - it is called internally from the
@@ -669,10 +770,94 @@ namespace ignition
       /// \param[in] _offset Offset value.
       public: void SetEntityCreateOffset(uint64_t _offset);
 
+      /// \brief Reserve a block of entity ids, which won't be given to
+      /// entities created with CreateEntity. The block can be populated in
+      /// another ECM, using SetEntityCreateOffset, and then merged into this
+      /// one with Merge.
+      /// \param[in] _count Number of ids to reserve. With 0, nothing is
+      /// reserved, and the id the next block would start at is returned.
+      /// \return First id of the block.
+      public: Entity ReserveEntities(std::size_t _count);
+
+      /// \brief Move all the entities and components of another ECM into
+      /// this one, as newly created entities. This is faster than creating
+      /// them one component at a time, since views are only updated once per
+      /// entity. Parent relationships between the moved entities are kept.
+      ///
+      /// The other ECM is expected to have been populated from scratch, with
+      /// ids reserved with ReserveEntities. Removal requests and change
+      /// tracking of the other ECM aren't carried over. It's left empty.
+      /// \param[in] _other ECM to move entities from.
+      /// \return False if any entity id is already used, in which case
+      /// nothing is moved.
+      public: bool Merge(EntityComponentManager &_other);
+
+      /// \brief Start a batch of component additions and removals. Until
+      /// the matching CommitComponentBatch, components are still added to
+      /// and removed from entities right away, but views are only updated
+      /// once per touched entity when the batch is committed, instead of
+      /// once per component. Queries that go through a view, such as Each,
+      /// update the views first, so they see the latest components.
+      ///
+      /// Batches can be nested; views are updated when the outermost batch
+      /// is committed.
+      /// \sa CommitComponentBatch
+      public: void BeginComponentBatch();
+
+      /// \brief Finish a batch started with BeginComponentBatch.
+      /// \sa BeginComponentBatch
+      public: void CommitComponentBatch();
+
       /// \brief Return true if there are components marked for removal.
       /// \return True if there are components marked for removal.
       public: bool HasRemovedComponents() const;
 
+      /// \brief Get a counter that is incremented every time the structure of
+      /// the ECM changes, that is, when a component is added to or removed
+      /// from an entity, an entity is removed, or an entity is reparented.
+      /// Modifying the data of existing components doesn't change it.
+      ///
+      /// Pointers returned by Component() remain valid until their entity is
+      /// removed. Systems that cache such pointers can compare this counter
+      /// against the value they stored when building their cache to find out
+      /// whether it needs to be refreshed.
+      /// \return The current structure version.
+      public: uint64_t StructureVersion() const;
+
+      /// \brief Get an entity's scoped name from the ECM's scoped name
+      /// registry. If the name isn't registered yet, _compute is called to
+      /// create it.
+      ///
+      /// A registered name is dropped when the entity or one of its
+      /// ancestors is removed, reparented, gets or loses a component, or has
+      /// its components::Name or components::ParentEntity set, so registered
+      /// names are up to date as long as names modified in place are followed
+      /// by a call to SetChanged. This is used by scopedName, which should be
+      /// preferred.
+      /// \param[in] _entity Entity.
+      /// \param[in] _format Key identifying the format of the name, such as
+      /// its delimiter.
+      /// \param[in] _compute Function that creates the scoped name.
+      /// \return The scoped name.
+      public: std::string ScopedName(const Entity _entity,
+                  const std::string &_format,
+                  const std::function<std::string()> &_compute) const;
+
+      /// \brief Get the entities matching a scoped name query from the
+      /// ECM's scoped name registry. If the query isn't registered yet,
+      /// _compute is called to resolve it. All queries are dropped whenever
+      /// any entity is removed or reparented, or a components::Name or
+      /// components::ParentEntity is created, set or removed. This is used by
+      /// entitiesFromScopedName, which should be preferred.
+      /// \param[in] _query Key identifying the query, including the scoped
+      /// name.
+      /// \param[in] _compute Function that resolves the query.
+      /// \return The matching entities.
+      public: std::unordered_set<Entity> EntitiesFromScopedName(
+                  const std::string &_query,
+                  const std::function<std::unordered_set<Entity>()> &_compute)
+                  const;
+
       /// \brief Clear the list of newly added entities so that a call to
       /// EachAdded after this will have no entities to iterate. This function
       /// is protected to facilitate testing.
@@ -750,6 +935,12 @@ namespace ignition
       private: std::pair<detail::BaseView *, std::mutex *> FindView(
                    const std::vector<ComponentTypeId> &_types) const;
 
+      /// \brief Update the views for the entities touched by the open
+      /// component batch. The caller must hold the views mutex. Each view's
+      /// own mutex is locked while it's updated.
+      /// \sa BeginComponentBatch
+      private: void UpdateBatchViews() const;
+
       /// \brief Add a new view to the set of stored views.
       /// \param[in] _types The set of component type ids that act as the key
       /// for the view.
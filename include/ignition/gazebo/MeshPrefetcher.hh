@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_MESHPREFETCHER_HH_
+#define IGNITION_GAZEBO_MESHPREFETCHER_HH_
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include <ignition/common/Mesh.hh>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/Export.hh>
+
+namespace ignition
+{
+  namespace gazebo
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+    // Forward declarations.
+    class IGNITION_GAZEBO_HIDDEN MeshPrefetcherPrivate;
+
+    /// \brief Resolves and decodes mesh files on background threads ahead of
+    /// the systems that use them.
+    ///
+    /// Meshes are queued with Prefetch as soon as the entities referencing
+    /// them are created. Worker threads resolve the file, which may fetch it
+    /// from Fuel or the local cache, and decode it. Physics and rendering
+    /// then call Load instead of common::MeshManager::Load. A decoded mesh is
+    /// added to the common::MeshManager on the calling thread, so it's
+    /// shared with every other user of the mesh manager. If the mesh is still
+    /// queued, it's decoded right away on the calling thread, and if it's
+    /// being decoded, Load waits for it instead of decoding it again.
+    ///
+    /// Prefetching only helps when there's time between queuing a mesh and
+    /// loading it, such as at startup, while the rest of the world and the
+    /// plugins are loaded. An entity spawned while simulation is running is
+    /// usually loaded by physics on the same step it's created, so its mesh
+    /// is still decoded on the simulation thread, and that step stalls as
+    /// it did without the prefetcher.
+    ///
+    /// Only COLLADA, OBJ and STL files are prefetched, other files are left
+    /// to the mesh manager. Meshes are named after the string passed to
+    /// Prefetch, the same way common::MeshManager names them.
+    ///
+    /// Decoded meshes which aren't loaded before they expire are deleted,
+    /// so meshes of entities which were removed before physics or rendering
+    /// needed them aren't kept forever. Loading an expired mesh falls back to
+    /// the mesh manager.
+    ///
+    /// A server-wide prefetcher is available through Instance(). Its threads
+    /// are started the first time a mesh is queued. Workers resolve files
+    /// through the find file callbacks registered by the server, so the
+    /// server calls Cancel when it's destroyed.
+    class IGNITION_GAZEBO_VISIBLE MeshPrefetcher
+    {
+      /// \brief Constructor
+      /// \param[in] _threadCount Number of worker threads, at least 1.
+      /// \param[in] _expiry How long a decoded mesh is kept if it isn't
+      /// loaded.
+      public: explicit MeshPrefetcher(std::size_t _threadCount = 2,
+                  const std::chrono::steady_clock::duration &_expiry =
+                      std::chrono::minutes(1));
+
+      /// \brief Destructor. Stops the worker threads and deletes the meshes
+      /// which were decoded but never loaded.
+      public: ~MeshPrefetcher();
+
+      /// \brief Get the server-wide prefetcher.
+      /// \return The prefetcher.
+      public: static MeshPrefetcher &Instance();
+
+      /// \brief Queue a mesh to be decoded in the background.
+      /// \param[in] _name Mesh file name or URI, as it would be passed to
+      /// common::MeshManager::Load, typically the result of asFullPath.
+      /// \return True if the mesh was queued. False if the file type isn't
+      /// supported, or the mesh is already queued or loaded.
+      public: bool Prefetch(const std::string &_name);
+
+      /// \brief Get a mesh, using the prefetched one if there is one.
+      /// \param[in] _name Mesh file name or URI.
+      /// \return The mesh, owned by common::MeshManager, or null if it
+      /// couldn't be loaded.
+      public: const common::Mesh *Load(const std::string &_name);
+
+      /// \brief Block until all the queued meshes have been decoded.
+      public: void Flush();
+
+      /// \brief Drop the meshes which are still queued and block until the
+      /// ones being decoded are done. Loading a dropped mesh falls back to
+      /// the mesh manager. Meshes can be queued again afterwards.
+      public: void Cancel();
+
+      /// \brief Get the number of meshes which were decoded in the
+      /// background but haven't been loaded yet.
+      /// \return Mesh count.
+      public: std::size_t ReadyCount() const;
+
+      /// \brief Get the number of worker threads.
+      /// \return Thread count.
+      public: std::size_t ThreadCount() const;
+
+      /// \brief Private data pointer.
+      private: std::unique_ptr<MeshPrefetcherPrivate> dataPtr;
+    };
+    }
+  }
+}
+#endif
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_PUBLISHEXECUTOR_HH_
+#define IGNITION_GAZEBO_PUBLISHEXECUTOR_HH_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/Export.hh>
+
+namespace ignition
+{
+  namespace gazebo
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+    // Forward declarations.
+    class IGNITION_GAZEBO_HIDDEN PublishExecutorPrivate;
+
+    /// \brief Statistics of a PublishExecutor.
+    struct PublishExecutorStats
+    {
+      /// \brief Number of tasks currently waiting in the queue.
+      std::size_t queueDepth{0};
+
+      /// \brief Largest queue depth seen so far.
+      std::size_t maxQueueDepth{0};
+
+      /// \brief Number of tasks accepted by Post, including coalesced ones.
+      uint64_t posted{0};
+
+      /// \brief Number of tasks that have been run.
+      uint64_t executed{0};
+
+      /// \brief Number of tasks that replaced a queued task with the same
+      /// key instead of being queued.
+      uint64_t coalesced{0};
+
+      /// \brief Number of tasks rejected because the queue was full.
+      uint64_t dropped{0};
+    };
+
+    /// \brief Runs tasks, typically message publications, on a fixed number
+    /// of background threads. Systems that need to publish from outside the
+    /// simulation thread can post tasks here instead of starting their own
+    /// threads, so that the number of threads doesn't grow with the number of
+    /// plugin instances.
+    ///
+    /// The queue is bounded. When it's full, new tasks are dropped and
+    /// counted in the statistics. Tasks posted with a non-zero key replace
+    /// any task with the same key that hasn't started running yet, so a
+    /// publisher that posts faster than the executor can run has at most one
+    /// task queued.
+    ///
+    /// A shared executor is available through Instance(). It's created the
+    /// first time it's requested, with a thread count based on the number
+    /// of hardware threads, and destroyed once nobody holds it anymore.
+    class IGNITION_GAZEBO_VISIBLE PublishExecutor
+    {
+      /// \brief Constructor
+      /// \param[in] _threadCount Number of worker threads, at least 1.
+      /// \param[in] _maxQueueSize Maximum number of queued tasks.
+      public: explicit PublishExecutor(std::size_t _threadCount = 2,
+                  std::size_t _maxQueueSize = 1024);
+
+      /// \brief Destructor. Runs the tasks that are already queued, then
+      /// stops the worker threads.
+      public: ~PublishExecutor();
+
+      /// \brief Get the shared executor, creating it if needed. Callers
+      /// should hold on to it for as long as they post tasks, and must not
+      /// release it from one of its own tasks.
+      /// \return The executor.
+      public: static std::shared_ptr<PublishExecutor> Instance();
+
+      /// \brief Get a key which hasn't been returned before, to be used for
+      /// coalescing the tasks of one publisher.
+      /// \return A non-zero key.
+      public: static uint64_t NewKey();
+
+      /// \brief Queue a task.
+      /// \param[in] _task Task to run on a worker thread.
+      /// \param[in] _key If non-zero, a queued task posted with the same key
+      /// is replaced by this one.
+      /// \return False if the task was dropped because the queue was full.
+      public: bool Post(std::function<void()> _task, uint64_t _key = 0);
+
+      /// \brief Remove the queued tasks posted with a key, and wait for any
+      /// running task with that key to finish. Owners of tasks must call this
+      /// before destroying the data those tasks use. When called from a task
+      /// with the same key, it doesn't wait for that task itself.
+      /// \param[in] _key Key passed to Post.
+      public: void Cancel(uint64_t _key);
+
+      /// \brief Block until all queued tasks have been run. Must not be
+      /// called from a task, which would wait for itself.
+      public: void Flush();
+
+      /// \brief Get the number of worker threads.
+      /// \return Thread count.
+      public: std::size_t ThreadCount() const;
+
+      /// \brief Get the executor statistics.
+      /// \return Current statistics.
+      public: PublishExecutorStats Stats() const;
+
+      /// \brief Private data pointer.
+      private: std::unique_ptr<PublishExecutorPrivate> dataPtr;
+    };
+    }
+  }
+}
+#endif
@@ -179,6 +179,20 @@ namespace ignition
       private: Entity CreateEntities(const sdf::Model *_model,
                                      bool _staticParent);
 
+      /// \brief Create the entities of a world's top level models on
+      /// multiple threads, each populating its own ECM with reserved ids,
+      /// and merge them into the ECM. Model plugins are loaded once all the
+      /// models exist, in the order they'd be loaded if the models were
+      /// created one at a time.
+      /// \param[in] _world SDF world object.
+      /// \param[in] _worldEntity World entity.
+      /// \return False if the models weren't created, because there are too
+      /// few of them, their ids are taken, or a model didn't fit in its
+      /// block of ids. Nothing is added to the ECM and no ids are reserved
+      /// in that case.
+      private: bool CreateModelsInParallel(const sdf::World *_world,
+                                           Entity _worldEntity);
+
       /// \brief Pointer to private data.
       private: std::unique_ptr<SdfEntityCreatorPrivate> dataPtr;
     };
@@ -339,6 +339,19 @@ namespace ignition
       /// ~/.ignition/fuel.
       public: void SetResourceCache(const std::string &_path);
 
+      /// \brief Path to the startup report, which lists how long each phase
+      /// of the server startup took.
+      /// \return Path to the report. Empty if no report is written.
+      public: const std::string &StartupReportPath() const;
+
+      /// \brief Set the path to write a startup report to. The report lists
+      /// how long loading the SDF, fetching resources, loading each plugin,
+      /// creating entities and the first simulation step took, as JSON in
+      /// the trace event format. It's written once the server is constructed,
+      /// and again after the first step of each world.
+      /// \param[in] _path Path to the report. An empty string disables it.
+      public: void SetStartupReportPath(const std::string &_path);
+
       /// \brief Physics engine plugin library to load.
       /// \return File containing physics engine library.
       public: const std::string &PhysicsEngine() const;
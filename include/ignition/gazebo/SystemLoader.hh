@@ -20,6 +20,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include <sdf/Element.hh>
 
@@ -66,6 +67,17 @@ namespace ignition
                   const std::string &_name,
                   const sdf::ElementPtr &_sdf);
 
+      /// \brief Find and load the libraries of many plugins ahead of time,
+      /// so that LoadPlugin only has to instantiate them. Distinct libraries
+      /// are searched for in parallel, then loaded in the given order.
+      /// Libraries that were already searched for are skipped.
+      ///
+      /// Library paths are cached, whether they're found through this or
+      /// LoadPlugin, until a plugin path is added or the plugin path
+      /// environment variable changes.
+      /// \param[in] _filenames Shared library filenames, may have duplicates.
+      public: void PreloadPlugins(const std::vector<std::string> &_filenames);
+
       /// \brief Makes a printable string with info about systems
       /// \returns A pretty string
       public: std::string PrettyStr() const;
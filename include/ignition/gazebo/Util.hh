@@ -175,6 +175,17 @@ namespace ignition
         const Entity &_entity,
         const EntityComponentManager &_ecm);
 
+    /// \brief Check whether an entity is sleeping, see components::Sleeping.
+    /// Entities that just fell asleep on the current update aren't
+    /// considered to be sleeping yet, so systems that skip sleeping entities
+    /// still get to see their final pose.
+    /// \param[in] _entity Input entity
+    /// \param[in] _ecm Constant reference to ECM.
+    /// \return True if the entity was already sleeping before the current
+    /// update.
+    bool IGNITION_GAZEBO_VISIBLE isSleeping(const Entity &_entity,
+        const EntityComponentManager &_ecm);
+
     /// \brief Helper function to generate a valid transport topic, given
     /// a list of topics ordered by preference. The generated topic will be,
     /// in this order:
@@ -0,0 +1,293 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_COMPONENTS_CONTACTSENSORBUFFER_HH_
+#define IGNITION_GAZEBO_COMPONENTS_CONTACTSENSORBUFFER_HH_
+
+#include <ignition/msgs/contact.pb.h>
+#include <ignition/msgs/contacts.pb.h>
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <ignition/math/Vector3.hh>
+#include <ignition/msgs/Utility.hh>
+
+#include <ignition/gazebo/components/Component.hh>
+#include <ignition/gazebo/components/Factory.hh>
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/Entity.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+  /// \brief Native storage for all the contacts of one collision entity
+  /// during a single simulation step.
+  ///
+  /// Contact points are kept in flat arrays, and each collision pair refers
+  /// to a contiguous range of those arrays. This avoids building a protobuf
+  /// message per collision every step; use AddToMsg when a message is
+  /// actually needed, for example to publish it.
+  ///
+  /// The `normals`, `depths` and `forces` arrays are either empty, when the
+  /// physics engine doesn't provide that data, or have the same size as
+  /// `positions`.
+  struct ContactBuffer
+  {
+    /// \brief Contacts between the owning collision and one other collision.
+    struct Pair
+    {
+      /// \brief Collision entity that owns the buffer.
+      Entity collision1{kNullEntity};
+
+      /// \brief Collision entity in contact with collision1.
+      Entity collision2{kNullEntity};
+
+      /// \brief Scoped name of collision1, empty if names aren't populated.
+      std::string collision1Name;
+
+      /// \brief Scoped name of collision2, empty if names aren't populated.
+      std::string collision2Name;
+
+      /// \brief Index of the pair's first point in the point arrays.
+      std::size_t offset{0};
+
+      /// \brief Number of contact points between the two collisions.
+      std::size_t count{0};
+    };
+
+    /// \brief Collision pairs, each referring to a range of points.
+    std::vector<Pair> pairs;
+
+    /// \brief Contact positions in the world frame.
+    std::vector<math::Vector3d> positions;
+
+    /// \brief Contact normals in the world frame.
+    std::vector<math::Vector3d> normals;
+
+    /// \brief Penetration depths.
+    std::vector<double> depths;
+
+    /// \brief Contact forces applied on collision1, in the world frame.
+    std::vector<math::Vector3d> forces;
+
+    /// \brief Remove all contacts while keeping the allocated memory, so the
+    /// buffer can be refilled on the next step without reallocating.
+    public: void Clear()
+    {
+      this->pairs.clear();
+      this->positions.clear();
+      this->normals.clear();
+      this->depths.clear();
+      this->forces.clear();
+    }
+
+    /// \brief Whether there are no contacts in the buffer.
+    /// \return True if empty.
+    public: bool Empty() const
+    {
+      return this->pairs.empty();
+    }
+
+    /// \brief Whether normals, depths and forces are available.
+    /// \return True if the extra contact data is populated.
+    public: bool HasExtraData() const
+    {
+      return !this->positions.empty() &&
+          this->normals.size() == this->positions.size();
+    }
+
+    /// \brief Compare contact points against another buffer.
+    /// \param[in] _other Buffer to compare to.
+    /// \param[in] _tol Tolerance used for the point positions.
+    /// \return True if both buffers hold the same collision pairs and
+    /// positions.
+    public: bool Equal(const ContactBuffer &_other, double _tol = 1e-6) const
+    {
+      if (this->pairs.size() != _other.pairs.size() ||
+          this->positions.size() != _other.positions.size())
+      {
+        return false;
+      }
+
+      for (std::size_t i = 0; i < this->pairs.size(); ++i)
+      {
+        if (this->pairs[i].collision1 != _other.pairs[i].collision1 ||
+            this->pairs[i].collision2 != _other.pairs[i].collision2 ||
+            this->pairs[i].count != _other.pairs[i].count)
+        {
+          return false;
+        }
+      }
+
+      for (std::size_t i = 0; i < this->positions.size(); ++i)
+      {
+        if (!this->positions[i].Equal(_other.positions[i], _tol))
+          return false;
+      }
+      return true;
+    }
+
+    public: bool operator==(const ContactBuffer &_other) const
+    {
+      return this->Equal(_other);
+    }
+
+    public: bool operator!=(const ContactBuffer &_other) const
+    {
+      return !(*this == _other);
+    }
+
+    /// \brief Add the contacts in this buffer to a contacts message, one
+    /// msgs::Contact per collision pair. Time stamps are left untouched.
+    /// \param[in,out] _msg Message to add contacts to.
+    public: void AddToMsg(msgs::Contacts &_msg) const
+    {
+      const bool extra = this->HasExtraData();
+      for (const auto &pair : this->pairs)
+      {
+        auto *contactMsg = _msg.add_contact();
+        contactMsg->mutable_collision1()->set_id(pair.collision1);
+        contactMsg->mutable_collision2()->set_id(pair.collision2);
+        if (!pair.collision1Name.empty())
+          contactMsg->mutable_collision1()->set_name(pair.collision1Name);
+        if (!pair.collision2Name.empty())
+          contactMsg->mutable_collision2()->set_name(pair.collision2Name);
+
+        for (std::size_t i = pair.offset; i < pair.offset + pair.count; ++i)
+        {
+          msgs::Set(contactMsg->add_position(), this->positions[i]);
+          if (!extra)
+            continue;
+
+          msgs::Set(contactMsg->add_normal(), this->normals[i]);
+          contactMsg->add_depth(this->depths[i]);
+
+          auto *wrench = contactMsg->add_wrench();
+          wrench->set_body_1_name(pair.collision1Name);
+          wrench->set_body_1_id(pair.collision1);
+          wrench->set_body_2_name(pair.collision2Name);
+          wrench->set_body_2_id(pair.collision2);
+          msgs::Set(wrench->mutable_body_1_wrench()->mutable_force(),
+              this->forces[i]);
+          msgs::Set(wrench->mutable_body_2_wrench()->mutable_force(),
+              -this->forces[i]);
+        }
+      }
+    }
+
+    /// \brief Fill this buffer from a contacts message.
+    /// \param[in] _msg Message to read.
+    public: void FromMsg(const msgs::Contacts &_msg)
+    {
+      this->Clear();
+      for (const auto &contactMsg : _msg.contact())
+      {
+        Pair pair;
+        pair.collision1 = contactMsg.collision1().id();
+        pair.collision2 = contactMsg.collision2().id();
+        pair.collision1Name = contactMsg.collision1().name();
+        pair.collision2Name = contactMsg.collision2().name();
+        pair.offset = this->positions.size();
+        pair.count = static_cast<std::size_t>(contactMsg.position_size());
+
+        const int size = contactMsg.position_size();
+        const bool extra = contactMsg.normal_size() == size &&
+            contactMsg.depth_size() == size &&
+            contactMsg.wrench_size() == size;
+
+        for (int i = 0; i < contactMsg.position_size(); ++i)
+        {
+          this->positions.push_back(msgs::Convert(contactMsg.position(i)));
+          if (!extra)
+            continue;
+
+          this->normals.push_back(msgs::Convert(contactMsg.normal(i)));
+          this->depths.push_back(contactMsg.depth(i));
+          this->forces.push_back(msgs::Convert(
+              contactMsg.wrench(i).body_1_wrench().force()));
+        }
+        this->pairs.push_back(std::move(pair));
+      }
+
+      // Keep the extra arrays consistent if only some pairs had extra data
+      if (this->normals.size() != this->positions.size())
+      {
+        this->normals.clear();
+        this->depths.clear();
+        this->forces.clear();
+      }
+    }
+  };
+
+namespace serializers
+{
+  /// \brief Serializer for ContactBuffer, which goes through msgs::Contacts
+  /// so that logs and state messages keep the same format as
+  /// components::ContactSensorData.
+  class ContactBufferSerializer
+  {
+    /// \brief Serialization
+    /// \param[in] _out Output stream.
+    /// \param[in] _data Buffer to stream.
+    /// \return The stream.
+    public: static std::ostream &Serialize(std::ostream &_out,
+                                           const ContactBuffer &_data)
+    {
+      msgs::Contacts msg;
+      _data.AddToMsg(msg);
+      msg.SerializeToOstream(&_out);
+      return _out;
+    }
+
+    /// \brief Deserialization
+    /// \param[in] _in Input stream.
+    /// \param[out] _data Buffer to populate.
+    /// \return The stream.
+    public: static std::istream &Deserialize(std::istream &_in,
+                                             ContactBuffer &_data)
+    {
+      msgs::Contacts msg;
+      msg.ParseFromIstream(&_in);
+      _data.FromMsg(msg);
+      return _in;
+    }
+  };
+}
+
+namespace components
+{
+  /// \brief A component type that contains the contacts of a collision in a
+  /// compact native format. The physics system fills it for every collision
+  /// that has it. It's cheaper to update than ContactSensorData, and can be
+  /// converted to msgs::Contacts on demand with ContactBuffer::AddToMsg.
+  using ContactSensorBuffer = Component<ContactBuffer,
+      class ContactSensorBufferTag, serializers::ContactBufferSerializer>;
+  IGN_GAZEBO_REGISTER_COMPONENT("ign_gazebo_components.ContactSensorBuffer",
+                                ContactSensorBuffer)
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GAZEBO_COMPONENTS_SLEEPING_HH_
+#define IGNITION_GAZEBO_COMPONENTS_SLEEPING_HH_
+
+#include <ignition/gazebo/components/Factory.hh>
+#include <ignition/gazebo/components/Component.hh>
+#include <ignition/gazebo/config.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace components
+{
+  /// \brief A component that indicates whether a model, or a link, is
+  /// sleeping. The physics system manages this component on models and their
+  /// links when sleeping is enabled: a model falls asleep after all of its
+  /// links have been resting for a while, and wakes up as soon as any of them
+  /// moves. Poses of sleeping entities aren't updated, so other systems may
+  /// skip them, see gazebo::isSleeping.
+  ///
+  /// The component is created the first time an entity falls asleep, and is
+  /// then marked as a one-time change whenever its value flips, so entities
+  /// that woke up can be found through ComponentState.
+  using Sleeping = Component<bool, class SleepingTag>;
+  IGN_GAZEBO_REGISTER_COMPONENT("ign_gazebo_components.Sleeping", Sleeping)
+}
+}
+}
+}
+
+#endif
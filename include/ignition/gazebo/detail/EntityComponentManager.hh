@@ -17,7 +17,9 @@
 #ifndef IGNITION_GAZEBO_DETAIL_ENTITYCOMPONENTMANAGER_HH_
 #define IGNITION_GAZEBO_DETAIL_ENTITYCOMPONENTMANAGER_HH_
 
+#include <algorithm>
 #include <cstring>
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -100,6 +102,7 @@ ComponentTypeT *EntityComponentManager::CreateComponent(const Entity _entity,
       return comp;
     }
     *comp = _data;
+    this->UpdateValueIndex(_entity, ComponentTypeT::typeId);
   }
   return comp;
 }
@@ -183,7 +186,11 @@ bool EntityComponentManager::SetComponentData(const Entity _entity,
     return true;
   }
 
-  return comp->SetData(_data, CompareData<typename ComponentTypeT::Type>);
+  const bool changed =
+      comp->SetData(_data, CompareData<typename ComponentTypeT::Type>);
+  if (changed)
+    this->UpdateValueIndex(_entity, ComponentTypeT::typeId);
+  return changed;
 }
 
 //////////////////////////////////////////////////
@@ -204,76 +211,124 @@ ComponentTypeT *EntityComponentManager::First()
   return nullptr;
 }
 
+//////////////////////////////////////////////////
+template<typename ComponentTypeT>
+void EntityComponentManager::EnableValueIndex()
+{
+  this->EnableValueIndexImplementation(ComponentTypeT::typeId,
+      [](const components::BaseComponent &_comp) -> std::size_t
+      {
+        return std::hash<typename ComponentTypeT::Type>()(
+            static_cast<const ComponentTypeT &>(_comp).Data());
+      });
+}
+
 //////////////////////////////////////////////////
 template<typename ...ComponentTypeTs>
-Entity EntityComponentManager::EntityByComponents(
+bool EntityComponentManager::EntityMatchesComponents(const Entity _entity,
     const ComponentTypeTs &..._desiredComponents) const
 {
-  // Get all entities which have components of the desired types
-  const auto &view = this->FindView<ComponentTypeTs...>();
+  bool matches{true};
 
-  // Iterate over entities
-  Entity result{kNullEntity};
-  for (const Entity entity : view->Entities())
+  // Iterate over desired components, comparing each of them to the
+  // equivalent component in the entity.
+  ForEach([&](const auto &_desiredComponent)
   {
-    bool different{false};
+    auto entityComponent = this->Component<
+        std::remove_cv_t<std::remove_reference_t<
+            decltype(_desiredComponent)>>>(_entity);
 
-    // Iterate over desired components, comparing each of them to the
-    // equivalent component in the entity.
-    ForEach([&](const auto &_desiredComponent)
+    if (nullptr == entityComponent || *entityComponent != _desiredComponent)
     {
-      auto entityComponent = this->Component<
-          std::remove_cv_t<std::remove_reference_t<
-              decltype(_desiredComponent)>>>(entity);
+      matches = false;
+    }
+  }, _desiredComponents...);
 
-      if (*entityComponent != _desiredComponent)
-      {
-        different = true;
-      }
-    }, _desiredComponents...);
+  return matches;
+}
 
-    if (!different)
+//////////////////////////////////////////////////
+template<typename ...ComponentTypeTs>
+const std::vector<Entity> *EntityComponentManager::IndexedCandidates(
+    const ComponentTypeTs &..._desiredComponents) const
+{
+  const std::vector<Entity> *result{nullptr};
+  ForEach([&](const auto &_desiredComponent)
+  {
+    auto candidates = this->ValueIndexCandidates(_desiredComponent);
+    if (nullptr != candidates &&
+        (nullptr == result || candidates->size() < result->size()))
     {
-      result = entity;
-      break;
+      result = candidates;
     }
-  }
+  }, _desiredComponents...);
 
   return result;
 }
 
 //////////////////////////////////////////////////
 template<typename ...ComponentTypeTs>
-std::vector<Entity> EntityComponentManager::EntitiesByComponents(
+Entity EntityComponentManager::EntityByComponents(
     const ComponentTypeTs &..._desiredComponents) const
 {
+  // Use a value index if there's one, returning the lowest matching entity,
+  // which is the first one a view would return.
+  auto candidates = this->IndexedCandidates(_desiredComponents...);
+  if (nullptr != candidates)
+  {
+    Entity result{kNullEntity};
+    for (const Entity entity : *candidates)
+    {
+      if ((kNullEntity == result || entity < result) &&
+          this->EntityMatchesComponents(entity, _desiredComponents...))
+      {
+        result = entity;
+      }
+    }
+    return result;
+  }
+
   // Get all entities which have components of the desired types
   const auto &view = this->FindView<ComponentTypeTs...>();
 
   // Iterate over entities
-  std::vector<Entity> result;
   for (const Entity entity : view->Entities())
   {
-    bool different{false};
+    if (this->EntityMatchesComponents(entity, _desiredComponents...))
+      return entity;
+  }
 
-    // Iterate over desired components, comparing each of them to the
-    // equivalent component in the entity.
-    ForEach([&](const auto &_desiredComponent)
-    {
-      auto entityComponent = this->Component<
-          std::remove_cv_t<std::remove_reference_t<
-              decltype(_desiredComponent)>>>(entity);
+  return kNullEntity;
+}
 
-      if (*entityComponent != _desiredComponent)
-      {
-        different = true;
-      }
-    }, _desiredComponents...);
+//////////////////////////////////////////////////
+template<typename ...ComponentTypeTs>
+std::vector<Entity> EntityComponentManager::EntitiesByComponents(
+    const ComponentTypeTs &..._desiredComponents) const
+{
+  std::vector<Entity> result;
 
-    if (!different)
+  // Use a value index if there's one, keeping the same order as a view.
+  auto candidates = this->IndexedCandidates(_desiredComponents...);
+  if (nullptr != candidates)
+  {
+    for (const Entity entity : *candidates)
     {
-      result.push_back(entity);
+      if (this->EntityMatchesComponents(entity, _desiredComponents...))
+        result.push_back(entity);
     }
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  // Get all entities which have components of the desired types
+  const auto &view = this->FindView<ComponentTypeTs...>();
+
+  // Iterate over entities
+  for (const Entity entity : view->Entities())
+  {
+    if (this->EntityMatchesComponents(entity, _desiredComponents...))
+      result.push_back(entity);
   }
 
   return result;
@@ -284,40 +339,13 @@ template<typename ...ComponentTypeTs>
 std::vector<Entity> EntityComponentManager::ChildrenByComponents(Entity _parent,
      const ComponentTypeTs &..._desiredComponents) const
 {
-  // Get all entities which have components of the desired types
-  const auto &view = this->FindView<ComponentTypeTs...>();
-
-  // Get all entities which are immediate children of the given parent
-  auto children = this->Entities().AdjacentsFrom(_parent);
-
-  // Iterate over entities
+  // Iterate over the immediate children of the given parent, which are
+  // ordered by entity ID.
   std::vector<Entity> result;
-  for (const Entity entity : view->Entities())
+  for (const auto &child : this->Entities().AdjacentsFrom(_parent))
   {
-    if (children.find(entity) == children.end())
-    {
-      continue;
-    }
-
-    // Iterate over desired components, comparing each of them to the
-    // equivalent component in the entity.
-    bool different{false};
-    ForEach([&](const auto &_desiredComponent)
-    {
-      auto entityComponent = this->Component<
-          std::remove_cv_t<std::remove_reference_t<
-              decltype(_desiredComponent)>>>(entity);
-
-      if (*entityComponent != _desiredComponent)
-      {
-        different = true;
-      }
-    }, _desiredComponents...);
-
-    if (!different)
-    {
-      result.push_back(entity);
-    }
+    if (this->EntityMatchesComponents(child.first, _desiredComponents...))
+      result.push_back(child.first);
   }
 
   return result;
@@ -17,8 +17,12 @@
 
 #include "ignition/gazebo/EntityComponentManager.hh"
 
+#include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <sstream>
 #include <string>
@@ -276,12 +280,161 @@ class ignition::gazebo::EntityComponentManagerPrivate
 
   /// \brief Set of entities that are prevented from removal.
   public: std::unordered_set<Entity> pinnedEntities;
+
+  /// \brief Incremented whenever components are added or removed, entities
+  /// are removed or reparented.
+  /// \sa EntityComponentManager::StructureVersion
+  public: uint64_t structureVersion{0};
+
+  /// \brief Depth of nested component batches, zero if there's no open
+  /// batch.
+  /// \sa EntityComponentManager::BeginComponentBatch
+  public: unsigned int batchDepth{0};
+
+  /// \brief Entities which had components added or removed since the views
+  /// were last updated in the open batch. May contain duplicates. Flushed
+  /// while holding viewsMutex.
+  public: mutable std::vector<Entity> batchEntities;
+
+  /// \brief Hashed index of the values of one component type.
+  /// \sa EntityComponentManager::EnableValueIndex
+  public: struct ValueIndex
+  {
+    /// \brief Add an entity to the index, replacing its previous entry.
+    /// \param[in] _entity Entity.
+    /// \param[in] _hash Hash of the entity's component value.
+    public: void Insert(const Entity _entity, const std::size_t _hash);
+
+    /// \brief Remove an entity from the index.
+    /// \param[in] _entity Entity.
+    public: void Erase(const Entity _entity);
+
+    /// \brief Function that hashes the value of a component of this type.
+    public: std::function<std::size_t(const components::BaseComponent &)>
+            hash;
+
+    /// \brief Entities grouped by the hash of their component's value.
+    public: std::unordered_map<std::size_t, std::vector<Entity>> entities;
+
+    /// \brief Hash currently stored for each entity.
+    public: std::unordered_map<Entity, std::size_t> hashes;
+  };
+
+  /// \brief Value indexes, keyed by component type.
+  public: std::unordered_map<ComponentTypeId, ValueIndex> valueIndexes;
+
+  /// \brief Incremented whenever a Name or ParentEntity component is set,
+  /// created or removed, or an entity is removed or reparented.
+  public: uint64_t namesVersion{0};
+
+  /// \brief Scoped names and scoped name queries.
+  /// \sa EntityComponentManager::ScopedName
+  public: struct ScopedNameRegistry
+  {
+    /// \brief Clear the queries if the names version changed.
+    /// \param[in] _namesVersion Current names version.
+    public: void Refresh(uint64_t _namesVersion);
+
+    /// \brief Forget the names which depend on an entity.
+    /// \param[in] _entity Entity whose name, parent or type changed, or
+    /// which was removed.
+    public: void Invalidate(const Entity _entity);
+
+    /// \brief Scoped names, keyed by entity and then by format.
+    public: std::unordered_map<Entity,
+                std::unordered_map<std::string, std::string>> names;
+
+    /// \brief Entities whose registered names go through each entity, that
+    /// is, the entity itself and its descendants.
+    public: std::unordered_map<Entity, std::unordered_set<Entity>>
+                dependents;
+
+    /// \brief Entities matching each query. Queries may match any entity, so
+    /// they're all cleared when any name changes.
+    public: std::unordered_map<std::string, std::unordered_set<Entity>>
+                queries;
+
+    /// \brief Names version when the queries were resolved.
+    public: uint64_t namesVersion{0};
+
+    /// \brief Protects the registry, which is filled from const functions
+    /// that systems may call concurrently.
+    public: std::mutex mutex;
+  };
+
+  /// \brief Scoped name registry.
+  public: mutable ScopedNameRegistry scopedNames;
 };
 
+//////////////////////////////////////////////////
+void EntityComponentManagerPrivate::ScopedNameRegistry::Refresh(
+    uint64_t _namesVersion)
+{
+  if (this->namesVersion == _namesVersion)
+    return;
+
+  this->queries.clear();
+  this->namesVersion = _namesVersion;
+}
+
+//////////////////////////////////////////////////
+void EntityComponentManagerPrivate::ScopedNameRegistry::Invalidate(
+    const Entity _entity)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  auto it = this->dependents.find(_entity);
+  if (it == this->dependents.end())
+    return;
+
+  // Dependents may still be listed under other ancestors, which at worst
+  // causes their names to be computed again later
+  for (auto dependent : it->second)
+    this->names.erase(dependent);
+  this->dependents.erase(it);
+}
+
+//////////////////////////////////////////////////
+void EntityComponentManagerPrivate::ValueIndex::Insert(const Entity _entity,
+    const std::size_t _hash)
+{
+  auto hashIt = this->hashes.find(_entity);
+  if (hashIt != this->hashes.end())
+  {
+    if (hashIt->second == _hash)
+      return;
+    this->Erase(_entity);
+  }
+
+  this->hashes[_entity] = _hash;
+  this->entities[_hash].push_back(_entity);
+}
+
+//////////////////////////////////////////////////
+void EntityComponentManagerPrivate::ValueIndex::Erase(const Entity _entity)
+{
+  auto hashIt = this->hashes.find(_entity);
+  if (hashIt == this->hashes.end())
+    return;
+
+  auto bucketIt = this->entities.find(hashIt->second);
+  if (bucketIt != this->entities.end())
+  {
+    auto &bucket = bucketIt->second;
+    bucket.erase(std::remove(bucket.begin(), bucket.end(), _entity),
+        bucket.end());
+    if (bucket.empty())
+      this->entities.erase(bucketIt);
+  }
+  this->hashes.erase(hashIt);
+}
+
 //////////////////////////////////////////////////
 EntityComponentManager::EntityComponentManager()
   : dataPtr(new EntityComponentManagerPrivate)
 {
+  // Parents are only meant to change through the ECM, which keeps the entity
+  // graph in sync, so their index can't miss in-place modifications
+  this->EnableValueIndex<components::ParentEntity>();
 }
 
 //////////////////////////////////////////////////
@@ -354,6 +507,7 @@ Entity EntityComponentManager::Clone(Entity _entity, Entity _parent,
   this->dataPtr->originalToClonedLink.clear();
   this->dataPtr->clonedToOriginalJointLinks.clear();
 
+  this->BeginComponentBatch();
   auto clonedEntity = this->CloneImpl(_entity, _parent, _name, _allowRename);
 
   if (kNullEntity != clonedEntity)
@@ -401,10 +555,148 @@ Entity EntityComponentManager::Clone(Entity _entity, Entity _parent,
       }
     }
   }
+  this->CommitComponentBatch();
 
   return clonedEntity;
 }
 
+/////////////////////////////////////////////////
+std::vector<Entity> EntityComponentManager::CloneMany(Entity _entity,
+    Entity _parent, const std::vector<std::string> &_names)
+{
+  IGN_PROFILE("EntityComponentManager::CloneMany");
+
+  std::vector<Entity> result(_names.size(), kNullEntity);
+  if (!this->HasEntity(_entity))
+  {
+    ignerr << "Requested to clone entity [" << _entity
+      << "], but this entity does not exist." << std::endl;
+    return result;
+  }
+
+  // An entity of the subtree being cloned
+  struct Node
+  {
+    Entity original;
+    std::size_t parent;
+    std::vector<ComponentTypeId> types;
+    std::size_t canonicalLink{SIZE_MAX};
+  };
+
+  // Walk the subtree once, parents before children
+  std::vector<Node> nodes;
+  std::unordered_map<Entity, std::size_t> nodeIndex;
+  nodes.push_back({_entity, SIZE_MAX, {}});
+  for (std::size_t i = 0; i < nodes.size(); ++i)
+  {
+    const Entity original = nodes[i].original;
+    nodeIndex[original] = i;
+    for (const auto &type : this->ComponentTypes(original))
+    {
+      // The root's name and all parents are set for each clone
+      if (type == components::ParentEntity::typeId ||
+          (i == 0 && type == components::Name::typeId))
+      {
+        continue;
+      }
+      nodes[i].types.push_back(type);
+    }
+
+    for (const auto &child :
+        this->EntitiesByComponents(components::ParentEntity(original)))
+    {
+      nodes.push_back({child, i, {}});
+    }
+  }
+
+  // Cloned models get the clone of their canonical link
+  for (auto &node : nodes)
+  {
+    auto linkComp =
+        this->Component<components::ModelCanonicalLink>(node.original);
+    if (nullptr == linkComp)
+      continue;
+
+    auto linkIt = nodeIndex.find(linkComp->Data());
+    if (linkIt == nodeIndex.end())
+    {
+      ignerr << "Error: attempted to clone model [" << node.original
+        << "], but its canonical link [" << linkComp->Data()
+        << "] is not being cloned." << std::endl;
+      continue;
+    }
+    node.canonicalLink = linkIt->second;
+  }
+
+  std::string baseName;
+  if (auto nameComp = this->Component<components::Name>(_entity))
+    baseName = nameComp->Data();
+  else
+    baseName = "cloned_entity";
+
+  // Generated names keep counting up across clones
+  uint64_t suffix = 1;
+
+  this->BeginComponentBatch();
+  std::vector<Entity> clones(nodes.size(), kNullEntity);
+  for (std::size_t c = 0; c < _names.size(); ++c)
+  {
+    std::string name = _names[c];
+    if (name.empty())
+    {
+      do
+      {
+        name = baseName + "_" + std::to_string(suffix++);
+      }
+      while (kNullEntity != this->EntityByComponents(components::Name(name)));
+    }
+    else if (kNullEntity != this->EntityByComponents(components::Name(name),
+        components::ParentEntity(_parent)))
+    {
+      ignerr << "Requested to clone entity [" << _entity
+        << "] with a name of [" << name << "], but another entity already "
+        << "has this name." << std::endl;
+      continue;
+    }
+
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+    {
+      const auto &node = nodes[i];
+      Entity clone = this->CreateEntity();
+      clones[i] = clone;
+
+      Entity parent = i == 0 ? _parent : clones[node.parent];
+      if (parent != kNullEntity)
+      {
+        this->SetParentEntity(clone, parent);
+        this->CreateComponent(clone, components::ParentEntity(parent));
+      }
+
+      if (i == 0)
+        this->CreateComponent(clone, components::Name(name));
+
+      for (const auto &type : node.types)
+      {
+        this->CreateComponentImplementation(clone, type,
+            this->ComponentImplementation(node.original, type));
+      }
+    }
+
+    for (std::size_t i = 0; i < nodes.size(); ++i)
+    {
+      if (nodes[i].canonicalLink == SIZE_MAX)
+        continue;
+      this->SetComponentData<components::ModelCanonicalLink>(clones[i],
+          clones[nodes[i].canonicalLink]);
+    }
+
+    result[c] = clones[0];
+  }
+  this->CommitComponentBatch();
+
+  return result;
+}
+
 /////////////////////////////////////////////////
 Entity EntityComponentManager::CloneImpl(Entity _entity, Entity _parent,
     const std::string &_name, bool _allowRename)
@@ -490,10 +782,10 @@ Entity EntityComponentManager::CloneImpl(Entity _entity, Entity _parent,
         (type == components::ParentEntity::typeId))
       continue;
 
-    auto originalComp = this->ComponentImplementation(_entity, type);
-    auto clonedComp = originalComp->Clone();
-
-    this->CreateComponentImplementation(clonedEntity, type, clonedComp.get());
+    // The factory copies the original component, so there's no need to clone
+    // it first
+    const auto *originalComp = this->ComponentImplementation(_entity, type);
+    this->CreateComponentImplementation(clonedEntity, type, originalComp);
   }
 
   // keep track of canonical link information (for clones of models, the cloned
@@ -612,6 +904,69 @@ bool EntityComponentManager::HasRemovedComponents() const
   return !this->dataPtr->removedComponents.empty();
 }
 
+/////////////////////////////////////////////////
+uint64_t EntityComponentManager::StructureVersion() const
+{
+  return this->dataPtr->structureVersion;
+}
+
+/////////////////////////////////////////////////
+std::string EntityComponentManager::ScopedName(const Entity _entity,
+    const std::string &_format,
+    const std::function<std::string()> &_compute) const
+{
+  auto &registry = this->dataPtr->scopedNames;
+  {
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto entityIt = registry.names.find(_entity);
+    if (entityIt != registry.names.end())
+    {
+      auto nameIt = entityIt->second.find(_format);
+      if (nameIt != entityIt->second.end())
+        return nameIt->second;
+    }
+  }
+
+  // Compute without holding the lock, the ECM can't change meanwhile
+  auto name = _compute();
+
+  // The name depends on the entity and all its ancestors
+  std::vector<Entity> ancestors;
+  for (auto entity = _entity; kNullEntity != entity;)
+  {
+    ancestors.push_back(entity);
+    auto parentComp = this->Component<components::ParentEntity>(entity);
+    entity = nullptr == parentComp ? kNullEntity : parentComp->Data();
+  }
+
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.names[_entity].emplace(_format, name);
+  for (auto ancestor : ancestors)
+    registry.dependents[ancestor].insert(_entity);
+  return name;
+}
+
+/////////////////////////////////////////////////
+std::unordered_set<Entity> EntityComponentManager::EntitiesFromScopedName(
+    const std::string &_query,
+    const std::function<std::unordered_set<Entity>()> &_compute) const
+{
+  auto &registry = this->dataPtr->scopedNames;
+  {
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.Refresh(this->dataPtr->namesVersion);
+    auto queryIt = registry.queries.find(_query);
+    if (queryIt != registry.queries.end())
+      return queryIt->second;
+  }
+
+  auto entities = _compute();
+
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.queries.emplace(_query, entities);
+  return entities;
+}
+
 /////////////////////////////////////////////////
 void EntityComponentManager::ClearRemovedComponents()
 {
@@ -751,8 +1106,22 @@ void EntityComponentManager::ProcessRemoveEntityRequests()
     this->dataPtr->componentTypeIndex.clear();
     this->dataPtr->componentTypeIndexDirty = true;
 
+    for (auto &index : this->dataPtr->valueIndexes)
+    {
+      index.second.entities.clear();
+      index.second.hashes.clear();
+    }
+
     // All views are now invalid.
     this->dataPtr->views.clear();
+    ++this->dataPtr->structureVersion;
+
+    {
+      std::lock_guard<std::mutex> namesLock(this->dataPtr->scopedNames.mutex);
+      this->dataPtr->scopedNames.names.clear();
+      this->dataPtr->scopedNames.dependents.clear();
+    }
+    ++this->dataPtr->namesVersion;
   }
   else
   {
@@ -772,11 +1141,18 @@ void EntityComponentManager::ProcessRemoveEntityRequests()
       this->dataPtr->componentTypeIndex.erase(entity);
       this->dataPtr->componentTypeIndexDirty = true;
 
+      for (auto &index : this->dataPtr->valueIndexes)
+        index.second.Erase(entity);
+
+      this->dataPtr->scopedNames.Invalidate(entity);
+      ++this->dataPtr->namesVersion;
+
       // Remove the entity from views.
       for (auto &view : this->dataPtr->views)
       {
         view.second.first->RemoveEntity(entity);
       }
+      ++this->dataPtr->structureVersion;
     }
     // Clear the set of entities to remove.
     this->dataPtr->toRemoveEntities.clear();
@@ -817,8 +1193,28 @@ bool EntityComponentManager::RemoveComponent(
     this->dataPtr->componentsMarkedAsRemoved[_entity].insert(_typeId);
 
     // update views to reflect the component removal
-    for (auto &viewPair : this->dataPtr->views)
-      viewPair.second.first->NotifyComponentRemoval(_entity, _typeId);
+    if (this->dataPtr->batchDepth > 0)
+    {
+      this->dataPtr->batchEntities.push_back(_entity);
+    }
+    else
+    {
+      for (auto &viewPair : this->dataPtr->views)
+        viewPair.second.first->NotifyComponentRemoval(_entity, _typeId);
+    }
+    ++this->dataPtr->structureVersion;
+
+    auto indexIt = this->dataPtr->valueIndexes.find(_typeId);
+    if (indexIt != this->dataPtr->valueIndexes.end())
+      indexIt->second.Erase(_entity);
+
+    // The entity's type or name may have changed
+    this->dataPtr->scopedNames.Invalidate(_entity);
+    if (_typeId == components::Name::typeId ||
+        _typeId == components::ParentEntity::typeId)
+    {
+      ++this->dataPtr->namesVersion;
+    }
   }
 
   this->dataPtr->AddModifiedComponent(_entity);
@@ -969,6 +1365,10 @@ Entity EntityComponentManager::ParentEntity(const Entity _entity) const
 bool EntityComponentManager::SetParentEntity(const Entity _child,
     const Entity _parent)
 {
+  ++this->dataPtr->structureVersion;
+  this->dataPtr->scopedNames.Invalidate(_child);
+  ++this->dataPtr->namesVersion;
+
   // Remove current parent(s)
   auto parents = this->Entities().AdjacentsTo(_child);
   for (const auto &parent : parents)
@@ -1050,13 +1450,24 @@ bool EntityComponentManager::CreateComponentImplementation(
     entityCompIter->second.push_back(std::move(newComp));
     this->dataPtr->componentTypeIndex[_entity][_componentTypeId] = vectorIdx;
     this->dataPtr->componentTypeIndexDirty = true;
+    ++this->dataPtr->structureVersion;
+
+    // The entity's type may have changed
+    this->dataPtr->scopedNames.Invalidate(_entity);
 
     updateData = false;
-    for (auto &viewPair : this->dataPtr->views)
+    if (this->dataPtr->batchDepth > 0)
     {
-      auto &view = viewPair.second.first;
-      if (this->EntityMatches(_entity, view->ComponentTypes()))
-        view->MarkEntityToAdd(_entity, this->IsNewEntity(_entity));
+      this->dataPtr->batchEntities.push_back(_entity);
+    }
+    else
+    {
+      for (auto &viewPair : this->dataPtr->views)
+      {
+        auto &view = viewPair.second.first;
+        if (this->EntityMatches(_entity, view->ComponentTypes()))
+          view->MarkEntityToAdd(_entity, this->IsNewEntity(_entity));
+      }
     }
   }
   else
@@ -1082,17 +1493,31 @@ bool EntityComponentManager::CreateComponentImplementation(
     else if (this->dataPtr->ComponentMarkedAsRemoved(_entity, _componentTypeId))
     {
       this->dataPtr->componentsMarkedAsRemoved[_entity].erase(_componentTypeId);
+      ++this->dataPtr->structureVersion;
+      this->dataPtr->scopedNames.Invalidate(_entity);
 
-      for (auto &viewPair : this->dataPtr->views)
+      if (this->dataPtr->batchDepth > 0)
       {
-        viewPair.second.first->NotifyComponentAddition(_entity,
-            this->IsNewEntity(_entity), _componentTypeId);
+        this->dataPtr->batchEntities.push_back(_entity);
+      }
+      else
+      {
+        for (auto &viewPair : this->dataPtr->views)
+        {
+          viewPair.second.first->NotifyComponentAddition(_entity,
+              this->IsNewEntity(_entity), _componentTypeId);
+        }
       }
     }
   }
 
   this->dataPtr->createdCompTypes.insert(_componentTypeId);
 
+  // If the data still needs to be set, the caller updates the index after
+  // setting it
+  if (!updateData)
+    this->UpdateValueIndex(_entity, _componentTypeId);
+
   // If the component is a components::ParentEntity, then make sure to
   // update the entities graph.
   if (_componentTypeId == components::ParentEntity::typeId)
@@ -1205,6 +1630,12 @@ std::pair<detail::BaseView *, std::mutex *> EntityComponentManager::FindView(
     const std::vector<ComponentTypeId> &_types) const
 {
   std::lock_guard<std::mutex> lockViews(this->dataPtr->viewsMutex);
+
+  // Views must be up to date before they're used. Const queries may run
+  // concurrently, so the batch is only flushed while holding viewsMutex.
+  if (!this->dataPtr->batchEntities.empty())
+    this->UpdateBatchViews();
+
   std::pair<detail::BaseView *, std::mutex *> viewMutexPair(nullptr, nullptr);
   auto iter = this->dataPtr->views.find(_types);
   if (iter != this->dataPtr->views.end())
@@ -1667,6 +2098,8 @@ void EntityComponentManager::SetState(
     const ignition::msgs::SerializedState &_stateMsg)
 {
   IGN_PROFILE("EntityComponentManager::SetState Non-map");
+  this->BeginComponentBatch();
+
   // Create / remove / update entities
   for (int e = 0; e < _stateMsg.entities_size(); ++e)
   {
@@ -1745,10 +2178,13 @@ void EntityComponentManager::SetState(
       else
       {
         comp->Deserialize(istr);
+        this->UpdateValueIndex(entity, type);
         this->dataPtr->AddModifiedComponent(entity);
       }
     }
   }
+
+  this->CommitComponentBatch();
 }
 
 //////////////////////////////////////////////////
@@ -1756,6 +2192,8 @@ void EntityComponentManager::SetState(
     const ignition::msgs::SerializedStateMap &_stateMsg)
 {
   IGN_PROFILE("EntityComponentManager::SetState Map");
+  this->BeginComponentBatch();
+
   // Create / remove / update entities
   for (const auto &iter : _stateMsg.entities())
   {
@@ -1840,6 +2278,8 @@ void EntityComponentManager::SetState(
       }
     }
   }
+
+  this->CommitComponentBatch();
 }
 
 //////////////////////////////////////////////////
@@ -1890,6 +2330,9 @@ void EntityComponentManager::SetChanged(
       this->dataPtr->ComponentMarkedAsRemoved(_entity, _type))
     return;
 
+  // The data may have been modified in place
+  this->UpdateValueIndex(_entity, _type);
+
   if (_c == ComponentState::PeriodicChange)
   {
     this->dataPtr->periodicChangedComponents[_type].insert(_entity);
@@ -1952,6 +2395,157 @@ void EntityComponentManager::SetEntityCreateOffset(uint64_t _offset)
   this->dataPtr->entityCount = _offset;
 }
 
+/////////////////////////////////////////////////
+Entity EntityComponentManager::ReserveEntities(std::size_t _count)
+{
+  Entity first = this->dataPtr->entityCount + 1;
+  this->dataPtr->entityCount += _count;
+  return first;
+}
+
+/////////////////////////////////////////////////
+bool EntityComponentManager::Merge(EntityComponentManager &_other)
+{
+  IGN_PROFILE("EntityComponentManager::Merge");
+
+  auto &other = *_other.dataPtr;
+  std::vector<Entity> merged;
+  merged.reserve(other.entities.Vertices().size());
+  for (const auto &vertex : other.entities.Vertices())
+  {
+    if (this->HasEntity(vertex.first))
+    {
+      ignerr << "Failed to merge entities, entity [" << vertex.first
+             << "] already exists." << std::endl;
+      return false;
+    }
+    merged.push_back(vertex.first);
+  }
+  std::sort(merged.begin(), merged.end());
+
+  // Move the component storage over, without copying components
+  for (auto entity : merged)
+  {
+    this->dataPtr->CreateEntityImplementation(entity);
+    this->dataPtr->entityCount = std::max(this->dataPtr->entityCount,
+        entity);
+
+    auto &storage = this->dataPtr->componentStorage[entity];
+    storage = std::move(other.componentStorage[entity]);
+    auto &typeIndex = this->dataPtr->componentTypeIndex[entity];
+    typeIndex = std::move(other.componentTypeIndex[entity]);
+
+    for (const auto &[typeId, index] : typeIndex)
+    {
+      this->dataPtr->createdCompTypes.insert(typeId);
+      this->dataPtr->oneTimeChangedComponents[typeId].insert(entity);
+      this->UpdateValueIndex(entity, typeId);
+    }
+  }
+
+  for (auto entity : merged)
+  {
+    for (const auto &parent : other.entities.AdjacentsTo(entity))
+      this->dataPtr->entities.AddEdge({parent.first, entity}, true);
+  }
+
+  if (!merged.empty())
+  {
+    this->dataPtr->componentTypeIndexDirty = true;
+    ++this->dataPtr->structureVersion;
+  }
+
+  // Each view is updated once per entity, instead of once per component
+  for (auto &viewPair : this->dataPtr->views)
+  {
+    auto &view = viewPair.second.first;
+    for (auto entity : merged)
+    {
+      if (this->EntityMatches(entity, view->ComponentTypes()))
+        view->MarkEntityToAdd(entity, true);
+    }
+  }
+
+  // Leave the other ECM as if newly constructed
+  _other.dataPtr = std::make_unique<EntityComponentManagerPrivate>();
+  _other.EnableValueIndex<components::ParentEntity>();
+  return true;
+}
+
+/////////////////////////////////////////////////
+void EntityComponentManager::BeginComponentBatch()
+{
+  ++this->dataPtr->batchDepth;
+}
+
+/////////////////////////////////////////////////
+void EntityComponentManager::CommitComponentBatch()
+{
+  if (this->dataPtr->batchDepth == 0)
+  {
+    ignerr << "Trying to commit a component batch, but no batch was started."
+           << std::endl;
+    return;
+  }
+
+  if (--this->dataPtr->batchDepth > 0)
+    return;
+
+  std::lock_guard<std::mutex> lockViews(this->dataPtr->viewsMutex);
+  this->UpdateBatchViews();
+}
+
+/////////////////////////////////////////////////
+void EntityComponentManager::UpdateBatchViews() const
+{
+  IGN_PROFILE("EntityComponentManager::UpdateBatchViews");
+
+  auto &entities = this->dataPtr->batchEntities;
+  if (entities.empty())
+    return;
+
+  std::sort(entities.begin(), entities.end());
+  entities.erase(std::unique(entities.begin(), entities.end()),
+      entities.end());
+
+  // The end result of all the additions and removals is applied at once,
+  // so each view is updated once per entity
+  for (auto &viewPair : this->dataPtr->views)
+  {
+    auto &view = viewPair.second.first;
+    std::lock_guard<std::mutex> lockView(*viewPair.second.second);
+    const auto &types = view->ComponentTypes();
+    for (auto entity : entities)
+    {
+      if (!this->HasEntity(entity))
+        continue;
+
+      // Removals first, so an entity missing components doesn't go back to
+      // the view while its missing types are being updated
+      bool matches{true};
+      for (auto type : types)
+      {
+        if (!this->EntityHasComponentType(entity, type))
+        {
+          view->NotifyComponentRemoval(entity, type);
+          matches = false;
+        }
+      }
+
+      bool isNew = this->IsNewEntity(entity);
+      for (auto type : types)
+      {
+        if (this->EntityHasComponentType(entity, type))
+          view->NotifyComponentAddition(entity, isNew, type);
+      }
+
+      if (matches)
+        view->MarkEntityToAdd(entity, isNew);
+    }
+  }
+  entities.clear();
+}
+
 /////////////////////////////////////////////////
 void EntityComponentManager::LockAddingEntitiesToViews(bool _lock)
 {
@@ -2072,3 +2666,74 @@ void EntityComponentManager::UnpinAllEntities()
 {
   this->dataPtr->pinnedEntities.clear();
 }
+
+/////////////////////////////////////////////////
+bool EntityComponentManager::HasValueIndex(const ComponentTypeId _typeId) const
+{
+  return this->dataPtr->valueIndexes.find(_typeId) !=
+      this->dataPtr->valueIndexes.end();
+}
+
+/////////////////////////////////////////////////
+void EntityComponentManager::EnableValueIndexImplementation(
+    const ComponentTypeId _typeId,
+    std::function<std::size_t(const components::BaseComponent &)> _hash)
+{
+  if (this->HasValueIndex(_typeId))
+    return;
+
+  auto &index = this->dataPtr->valueIndexes[_typeId];
+  index.hash = std::move(_hash);
+
+  // Index existing components
+  for (const auto &entityIt : this->dataPtr->componentTypeIndex)
+  {
+    auto comp = this->ComponentImplementation(entityIt.first, _typeId);
+    if (nullptr != comp)
+      index.Insert(entityIt.first, index.hash(*comp));
+  }
+}
+
+/////////////////////////////////////////////////
+void EntityComponentManager::UpdateValueIndex(const Entity _entity,
+    const ComponentTypeId _typeId)
+{
+  // Renaming or reparenting invalidates the scoped names of the entity and
+  // its descendants, and all queries. Names may not be indexed, so any
+  // update to them counts.
+  if (_typeId == components::Name::typeId ||
+      _typeId == components::ParentEntity::typeId)
+  {
+    this->dataPtr->scopedNames.Invalidate(_entity);
+    ++this->dataPtr->namesVersion;
+  }
+
+  auto indexIt = this->dataPtr->valueIndexes.find(_typeId);
+  if (indexIt == this->dataPtr->valueIndexes.end())
+    return;
+
+  auto comp = this->ComponentImplementation(_entity, _typeId);
+  if (nullptr == comp)
+  {
+    indexIt->second.Erase(_entity);
+    return;
+  }
+  indexIt->second.Insert(_entity, indexIt->second.hash(*comp));
+}
+
+/////////////////////////////////////////////////
+const std::vector<Entity> *EntityComponentManager::ValueIndexCandidates(
+    const components::BaseComponent &_desired) const
+{
+  auto indexIt = this->dataPtr->valueIndexes.find(_desired.TypeId());
+  if (indexIt == this->dataPtr->valueIndexes.end())
+    return nullptr;
+
+  static const std::vector<Entity> kNoEntities;
+  auto bucketIt = indexIt->second.entities.find(
+      indexIt->second.hash(_desired));
+  if (bucketIt == indexIt->second.entities.end())
+    return &kNoEntities;
+
+  return &bucketIt->second;
+}
@@ -3161,6 +3161,333 @@ TEST_P(EntityComponentManagerFixture,
   EXPECT_EQ(1, foundEntities);
 }
 
+/////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, StructureVersion)
+{
+  auto version = manager.StructureVersion();
+
+  // Creating an entity without components doesn't change the structure
+  Entity e1 = manager.CreateEntity();
+  EXPECT_EQ(version, manager.StructureVersion());
+
+  // Adding a component does
+  manager.CreateComponent<IntComponent>(e1, IntComponent(1));
+  EXPECT_LT(version, manager.StructureVersion());
+  version = manager.StructureVersion();
+
+  // Setting data of an existing component doesn't
+  auto *comp = manager.Component<IntComponent>(e1);
+  ASSERT_NE(nullptr, comp);
+  comp->Data() = 2;
+  manager.CreateComponent<IntComponent>(e1, IntComponent(3));
+  EXPECT_EQ(version, manager.StructureVersion());
+  EXPECT_EQ(comp, manager.Component<IntComponent>(e1));
+
+  // Removing and re-adding a component does
+  EXPECT_TRUE(manager.RemoveComponent<IntComponent>(e1));
+  EXPECT_LT(version, manager.StructureVersion());
+  version = manager.StructureVersion();
+
+  manager.CreateComponent<IntComponent>(e1, IntComponent(4));
+  EXPECT_LT(version, manager.StructureVersion());
+  version = manager.StructureVersion();
+
+  // Reparenting does
+  Entity e2 = manager.CreateEntity();
+  EXPECT_TRUE(manager.SetParentEntity(e2, e1));
+  EXPECT_LT(version, manager.StructureVersion());
+  version = manager.StructureVersion();
+
+  // Requesting removal doesn't, until the entity is actually removed
+  manager.RequestRemoveEntity(e2);
+  EXPECT_EQ(version, manager.StructureVersion());
+  manager.ProcessEntityRemovals();
+  EXPECT_LT(version, manager.StructureVersion());
+}
+
+/////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, ValueIndex)
+{
+  EXPECT_FALSE(manager.HasValueIndex(components::Name::typeId));
+  EXPECT_TRUE(manager.HasValueIndex(components::ParentEntity::typeId));
+  EXPECT_FALSE(manager.HasValueIndex(StringComponent::typeId));
+
+  // Names aren't indexed by default, so in-place modifications are found
+  Entity named = manager.CreateEntity();
+  manager.CreateComponent(named, components::Name("g"));
+  manager.Component<components::Name>(named)->Data() = "h";
+  EXPECT_EQ(named, manager.EntityByComponents(components::Name("h")));
+
+  manager.EnableValueIndex<components::Name>();
+  EXPECT_TRUE(manager.HasValueIndex(components::Name::typeId));
+
+  Entity parent = manager.CreateEntity();
+  Entity e1 = manager.CreateEntity();
+  Entity e2 = manager.CreateEntity();
+  Entity e3 = manager.CreateEntity();
+  manager.CreateComponent(e1, components::Name("a"));
+  manager.CreateComponent(e2, components::Name("b"));
+  manager.CreateComponent(e3, components::Name("a"));
+  manager.CreateComponent(e2, IntComponent(1));
+  manager.CreateComponent(e3, IntComponent(1));
+  manager.CreateComponent(e2, components::ParentEntity(parent));
+  manager.CreateComponent(e3, components::ParentEntity(parent));
+
+  EXPECT_EQ(e1, manager.EntityByComponents(components::Name("a")));
+  EXPECT_EQ(e3, manager.EntityByComponents(components::Name("a"),
+      IntComponent(1)));
+  EXPECT_EQ(kNullEntity, manager.EntityByComponents(components::Name("c")));
+  EXPECT_EQ(std::vector<Entity>({e1, e3}),
+      manager.EntitiesByComponents(components::Name("a")));
+  EXPECT_EQ(std::vector<Entity>({e2, e3}),
+      manager.EntitiesByComponents(components::ParentEntity(parent)));
+  EXPECT_EQ(std::vector<Entity>({e3}),
+      manager.ChildrenByComponents(parent, components::Name("a")));
+
+  // Setting data moves the entity in the index
+  EXPECT_TRUE(manager.SetComponentData<components::Name>(e1, "c"));
+  EXPECT_EQ(e3, manager.EntityByComponents(components::Name("a")));
+  EXPECT_EQ(e1, manager.EntityByComponents(components::Name("c")));
+
+  // Re-creating a component updates its data
+  manager.CreateComponent(e1, components::Name("d"));
+  EXPECT_EQ(kNullEntity, manager.EntityByComponents(components::Name("c")));
+  EXPECT_EQ(e1, manager.EntityByComponents(components::Name("d")));
+
+  // In-place modifications are picked up by SetChanged
+  manager.Component<components::Name>(e2)->Data() = "e";
+  manager.SetChanged(e2, components::Name::typeId,
+      ComponentState::OneTimeChange);
+  EXPECT_EQ(e2, manager.EntityByComponents(components::Name("e")));
+  EXPECT_EQ(kNullEntity, manager.EntityByComponents(components::Name("b")));
+
+  // Without SetChanged, the entity isn't found by its new value, but it's
+  // not returned for its old value either
+  manager.Component<components::Name>(e2)->Data() = "f";
+  EXPECT_EQ(kNullEntity, manager.EntityByComponents(components::Name("e")));
+  EXPECT_TRUE(manager.EntitiesByComponents(components::Name("e")).empty());
+  manager.SetChanged(e2, components::Name::typeId,
+      ComponentState::OneTimeChange);
+  EXPECT_EQ(e2, manager.EntityByComponents(components::Name("f")));
+
+  // Removed components and entities aren't found
+  EXPECT_TRUE(manager.RemoveComponent<components::Name>(e1));
+  EXPECT_EQ(kNullEntity, manager.EntityByComponents(components::Name("d")));
+
+  manager.RequestRemoveEntity(e3);
+  manager.ProcessEntityRemovals();
+  EXPECT_EQ(kNullEntity, manager.EntityByComponents(components::Name("a")));
+  EXPECT_EQ(std::vector<Entity>({e2}),
+      manager.EntitiesByComponents(components::ParentEntity(parent)));
+
+  // Indexes can be enabled for other types after components exist
+  manager.CreateComponent(e1, StringComponent("x"));
+  manager.CreateComponent(e2, StringComponent("y"));
+  manager.EnableValueIndex<StringComponent>();
+  EXPECT_TRUE(manager.HasValueIndex(StringComponent::typeId));
+  EXPECT_EQ(e2, manager.EntityByComponents(StringComponent("y")));
+  EXPECT_EQ(e2, manager.EntityByComponents(StringComponent("y"),
+      IntComponent(1)));
+  EXPECT_EQ(kNullEntity, manager.EntityByComponents(StringComponent("x"),
+      IntComponent(1)));
+}
+
+/////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, ReserveAndMerge)
+{
+  auto e1 = manager.CreateEntity();
+  manager.CreateComponent(e1, IntComponent(1));
+
+  // A view that the merged entities should be added to
+  int viewCount{0};
+  manager.Each<IntComponent>([&](const Entity &, const IntComponent *)
+      {
+        ++viewCount;
+        return true;
+      });
+  EXPECT_EQ(1, viewCount);
+
+  auto first = manager.ReserveEntities(3);
+  EXPECT_EQ(e1 + 1, first);
+  EXPECT_EQ(first + 3, manager.CreateEntity());
+
+  // Populate the reserved ids in another ECM
+  EntityComponentManager other;
+  other.SetEntityCreateOffset(first - 1);
+  auto parent = other.CreateEntity();
+  auto child = other.CreateEntity();
+  EXPECT_EQ(first, parent);
+  other.CreateComponent(parent, IntComponent(2));
+  other.CreateComponent(parent, components::Name("parent"));
+  other.CreateComponent(child, IntComponent(3));
+  other.CreateComponent(child, components::ParentEntity(parent));
+  other.SetParentEntity(child, parent);
+
+  auto version = manager.StructureVersion();
+  EXPECT_TRUE(manager.Merge(other));
+  EXPECT_GT(manager.StructureVersion(), version);
+  EXPECT_EQ(0u, other.EntityCount());
+
+  EXPECT_TRUE(manager.HasEntity(parent));
+  EXPECT_TRUE(manager.HasEntity(child));
+  EXPECT_EQ(parent, manager.ParentEntity(child));
+  EXPECT_EQ(3, manager.Component<IntComponent>(child)->Data());
+  EXPECT_TRUE(manager.HasNewEntities());
+  EXPECT_EQ(parent, manager.EntityByComponents(components::Name("parent")));
+  EXPECT_EQ(std::vector<Entity>({child}),
+      manager.EntitiesByComponents(components::ParentEntity(parent)));
+
+  viewCount = 0;
+  manager.Each<IntComponent>([&](const Entity &, const IntComponent *)
+      {
+        ++viewCount;
+        return true;
+      });
+  EXPECT_EQ(3, viewCount);
+
+  // Ids in use can't be merged
+  other.SetEntityCreateOffset(first - 1);
+  other.CreateEntity();
+  EXPECT_FALSE(manager.Merge(other));
+  EXPECT_EQ(1u, other.EntityCount());
+}
+
+/////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, ComponentBatch)
+{
+  auto e1 = manager.CreateEntity();
+  manager.CreateComponent(e1, IntComponent(1));
+  manager.CreateComponent(e1, DoubleComponent(1.0));
+  auto e2 = manager.CreateEntity();
+  manager.CreateComponent(e2, IntComponent(2));
+
+  auto viewEntities = [&]()
+  {
+    std::vector<Entity> entities;
+    manager.Each<IntComponent, DoubleComponent>(
+        [&](const Entity &_entity, const IntComponent *,
+            const DoubleComponent *)
+        {
+          entities.push_back(_entity);
+          return true;
+        });
+    return entities;
+  };
+  EXPECT_EQ(std::vector<Entity>({e1}), viewEntities());
+
+  auto version = manager.StructureVersion();
+
+  manager.BeginComponentBatch();
+  manager.BeginComponentBatch();
+
+  // Leaves the view, then comes back
+  EXPECT_TRUE(manager.RemoveComponent<DoubleComponent>(e1));
+  manager.CreateComponent(e1, DoubleComponent(1.5));
+
+  // Joins the view
+  manager.CreateComponent(e2, DoubleComponent(2.0));
+
+  // Joins the view, then leaves it
+  auto e3 = manager.CreateEntity();
+  manager.CreateComponent(e3, IntComponent(3));
+  manager.CreateComponent(e3, DoubleComponent(3.0));
+  EXPECT_TRUE(manager.RemoveComponent<IntComponent>(e3));
+
+  manager.CommitComponentBatch();
+
+  // Components are in place before the batch is committed
+  EXPECT_TRUE(manager.EntityHasComponentType(e2, DoubleComponent::typeId));
+  EXPECT_DOUBLE_EQ(1.5, manager.Component<DoubleComponent>(e1)->Data());
+  EXPECT_GT(manager.StructureVersion(), version);
+
+  manager.CommitComponentBatch();
+
+  EXPECT_EQ(std::vector<Entity>({e1, e2}), viewEntities());
+
+  // Views used during a batch are brought up to date
+  manager.BeginComponentBatch();
+  EXPECT_TRUE(manager.RemoveComponent<DoubleComponent>(e2));
+  EXPECT_EQ(std::vector<Entity>({e1}), viewEntities());
+  manager.CreateComponent(e3, IntComponent(4));
+  EXPECT_EQ(std::vector<Entity>({e1, e3}), viewEntities());
+  manager.CommitComponentBatch();
+  EXPECT_EQ(std::vector<Entity>({e1, e3}), viewEntities());
+
+  // Committing without a batch does nothing
+  manager.CommitComponentBatch();
+  EXPECT_EQ(std::vector<Entity>({e1, e3}), viewEntities());
+}
+
+/////////////////////////////////////////////////
+TEST_P(EntityComponentManagerFixture, CloneMany)
+{
+  auto world = manager.CreateEntity();
+  auto model = manager.CreateEntity();
+  manager.CreateComponent(model, components::Name("robot"));
+  manager.CreateComponent(model, components::ParentEntity(world));
+  auto link = manager.CreateEntity();
+  manager.CreateComponent(link, components::Name("base"));
+  manager.CreateComponent(link, components::ParentEntity(model));
+  manager.CreateComponent(link, components::Link());
+  manager.CreateComponent(link, components::CanonicalLink());
+  manager.CreateComponent(link, IntComponent(5));
+  manager.CreateComponent(model, components::ModelCanonicalLink(link));
+  auto joint = manager.CreateEntity();
+  manager.CreateComponent(joint, components::Name("joint"));
+  manager.CreateComponent(joint, components::ParentEntity(model));
+  manager.CreateComponent(joint, components::Joint());
+  manager.CreateComponent(joint, components::ParentLinkName("base"));
+  EXPECT_EQ(4u, manager.EntityCount());
+
+  auto clones = manager.CloneMany(model, world, {"a", "", "", "robot"});
+  ASSERT_EQ(4u, clones.size());
+  EXPECT_EQ(kNullEntity, clones[3]);
+  EXPECT_EQ(13u, manager.EntityCount());
+
+  EXPECT_EQ("a", manager.Component<components::Name>(clones[0])->Data());
+  EXPECT_EQ("robot_1",
+      manager.Component<components::Name>(clones[1])->Data());
+  EXPECT_EQ("robot_2",
+      manager.Component<components::Name>(clones[2])->Data());
+
+  for (std::size_t i = 0; i < 3; ++i)
+  {
+    auto clone = clones[i];
+    EXPECT_EQ(world, manager.ParentEntity(clone));
+    EXPECT_EQ(world,
+        manager.Component<components::ParentEntity>(clone)->Data());
+
+    // Descendants keep their names, so joints still refer to their links
+    auto clonedLink = manager.EntityByComponents(components::Name("base"),
+        components::ParentEntity(clone));
+    ASSERT_NE(kNullEntity, clonedLink);
+    EXPECT_NE(link, clonedLink);
+    EXPECT_EQ(clone, manager.ParentEntity(clonedLink));
+    EXPECT_EQ(5, manager.Component<IntComponent>(clonedLink)->Data());
+    EXPECT_EQ(clonedLink,
+        manager.Component<components::ModelCanonicalLink>(clone)->Data());
+
+    auto clonedJoint = manager.EntityByComponents(components::Name("joint"),
+        components::ParentEntity(clone));
+    ASSERT_NE(kNullEntity, clonedJoint);
+    EXPECT_EQ("base",
+        manager.Component<components::ParentLinkName>(clonedJoint)->Data());
+  }
+
+  // Clones don't share data
+  manager.Component<IntComponent>(manager.EntityByComponents(
+      components::Name("base"), components::ParentEntity(clones[0])))->Data()
+      = 6;
+  EXPECT_EQ(5, manager.Component<IntComponent>(link)->Data());
+
+  // Clones show up in views
+  EXPECT_EQ(4u, manager.EntitiesByComponents(components::Joint()).size());
+
+  EXPECT_EQ(std::vector<Entity>({kNullEntity}),
+      manager.CloneMany(kNullEntity, world, {""}));
+  EXPECT_EQ(13u, manager.EntityCount());
+}
+
 // Run multiple times. We want to make sure that static globals don't cause
 // problems.
 INSTANTIATE_TEST_SUITE_P(EntityComponentManagerRepeat,
@@ -0,0 +1,431 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ignition/gazebo/MeshPrefetcher.hh"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <ignition/common/ColladaLoader.hh>
+#include <ignition/common/MeshManager.hh>
+#include <ignition/common/OBJLoader.hh>
+#include <ignition/common/Profiler.hh>
+#include <ignition/common/STLLoader.hh>
+#include <ignition/common/Util.hh>
+
+using namespace ignition;
+using namespace gazebo;
+
+class ignition::gazebo::MeshPrefetcherPrivate
+{
+  /// \brief State of a prefetched mesh.
+  public: enum class State
+  {
+    /// \brief Waiting for a worker.
+    QUEUED,
+
+    /// \brief Being decoded by a worker or by Load.
+    DECODING,
+
+    /// \brief Decoded, waiting to be loaded.
+    READY,
+
+    /// \brief Couldn't be decoded.
+    FAILED
+  };
+
+  /// \brief A prefetched mesh.
+  public: struct Entry
+  {
+    /// \brief State.
+    State state{State::QUEUED};
+
+    /// \brief Decoded mesh, owned by the entry until it's loaded.
+    common::Mesh *mesh{nullptr};
+
+    /// \brief Time the entry became READY or FAILED.
+    std::chrono::steady_clock::time_point doneTime;
+  };
+
+  /// \brief Get the lowercase extension of a mesh name.
+  /// \param[in] _name Mesh file name or URI.
+  /// \return Extension, or empty if the file type isn't supported.
+  public: static std::string Extension(const std::string &_name);
+
+  /// \brief Resolve and decode a mesh file.
+  /// \param[in] _name Mesh file name or URI.
+  /// \return New mesh, or null on failure.
+  public: static common::Mesh *Decode(const std::string &_name);
+
+  /// \brief Decode a mesh on the calling thread and update its entry.
+  /// \param[in] _name Mesh name, whose entry is in the DECODING state.
+  /// \param[in] _lock Lock on mutex, released while decoding.
+  public: void DecodeEntry(const std::string &_name,
+              std::unique_lock<std::mutex> &_lock);
+
+  /// \brief Delete the decoded meshes which weren't loaded in time, and
+  /// forget the ones which failed. Must be called with mutex locked.
+  /// \return Time the next entry expires, or the maximum time point if
+  /// none will.
+  public: std::chrono::steady_clock::time_point EvictExpired();
+
+  /// \brief Worker thread loop.
+  public: void Run();
+
+  /// \brief Number of worker threads.
+  public: std::size_t threadCount{1};
+
+  /// \brief How long decoded meshes are kept if they're never loaded.
+  public: std::chrono::steady_clock::duration expiry{std::chrono::minutes(1)};
+
+  /// \brief Worker threads, started when the first mesh is queued.
+  public: std::vector<std::thread> threads;
+
+  /// \brief Protects all members below.
+  public: mutable std::mutex mutex;
+
+  /// \brief Signaled when meshes are queued or the prefetcher stops.
+  public: std::condition_variable queued;
+
+  /// \brief Signaled when a mesh has been decoded.
+  public: std::condition_variable decoded;
+
+  /// \brief Names of the meshes waiting for a worker, oldest first.
+  public: std::deque<std::string> queue;
+
+  /// \brief Prefetched meshes which haven't been loaded yet, by name.
+  public: std::unordered_map<std::string, Entry> entries;
+
+  /// \brief True when the workers should exit.
+  public: bool stop{false};
+};
+
+//////////////////////////////////////////////////
+std::string MeshPrefetcherPrivate::Extension(const std::string &_name)
+{
+  auto dot = _name.rfind('.');
+  if (dot == std::string::npos)
+    return "";
+
+  std::string extension = _name.substr(dot + 1);
+  std::transform(extension.begin(), extension.end(), extension.begin(),
+      [](unsigned char _c) {return std::tolower(_c);});
+
+  if (extension != "dae" && extension != "obj" && extension != "stl")
+    return "";
+  return extension;
+}
+
+//////////////////////////////////////////////////
+common::Mesh *MeshPrefetcherPrivate::Decode(const std::string &_name)
+{
+  IGN_PROFILE("MeshPrefetcher::Decode");
+
+  // This may fetch the file, if it's a Fuel URI
+  auto path = common::findFile(_name);
+  if (path.empty())
+    return nullptr;
+
+  // Loaders keep state while loading, so each call uses its own
+  auto extension = Extension(_name);
+  common::Mesh *mesh{nullptr};
+  if (extension == "dae")
+  {
+    common::ColladaLoader loader;
+    mesh = loader.Load(path);
+  }
+  else if (extension == "obj")
+  {
+    common::OBJLoader loader;
+    mesh = loader.Load(path);
+  }
+  else if (extension == "stl")
+  {
+    common::STLLoader loader;
+    mesh = loader.Load(path);
+  }
+
+  if (nullptr != mesh)
+    mesh->SetName(_name);
+  return mesh;
+}
+
+//////////////////////////////////////////////////
+void MeshPrefetcherPrivate::DecodeEntry(const std::string &_name,
+    std::unique_lock<std::mutex> &_lock)
+{
+  _lock.unlock();
+  auto *mesh = Decode(_name);
+  _lock.lock();
+
+  // Entries in the DECODING state are only erased by Load after waiting
+  auto &entry = this->entries[_name];
+  entry.mesh = mesh;
+  entry.state = nullptr == mesh ? State::FAILED : State::READY;
+  entry.doneTime = std::chrono::steady_clock::now();
+  this->decoded.notify_all();
+}
+
+//////////////////////////////////////////////////
+std::chrono::steady_clock::time_point MeshPrefetcherPrivate::EvictExpired()
+{
+  auto now = std::chrono::steady_clock::now();
+  auto next = std::chrono::steady_clock::time_point::max();
+  for (auto it = this->entries.begin(); it != this->entries.end();)
+  {
+    const auto &entry = it->second;
+    if (entry.state != State::READY && entry.state != State::FAILED)
+    {
+      ++it;
+      continue;
+    }
+
+    // The entity which referenced it may have been removed before physics
+    // or rendering got to it. Loading it later falls back to the mesh
+    // manager.
+    auto expiryTime = entry.doneTime + this->expiry;
+    if (expiryTime <= now)
+    {
+      delete entry.mesh;
+      it = this->entries.erase(it);
+      continue;
+    }
+
+    next = std::min(next, expiryTime);
+    ++it;
+  }
+  return next;
+}
+
+//////////////////////////////////////////////////
+void MeshPrefetcherPrivate::Run()
+{
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (true)
+  {
+    // Also wake up when the next decoded mesh expires
+    auto next = this->EvictExpired();
+    auto ready = [this]
+        {
+          return this->stop || !this->queue.empty();
+        };
+    if (next == std::chrono::steady_clock::time_point::max())
+      this->queued.wait(lock, ready);
+    else if (!this->queued.wait_until(lock, next, ready))
+      continue;
+
+    if (this->stop)
+      return;
+
+    auto name = std::move(this->queue.front());
+    this->queue.pop_front();
+
+    // Load may have taken it already
+    auto it = this->entries.find(name);
+    if (it == this->entries.end() || it->second.state != State::QUEUED)
+      continue;
+
+    it->second.state = State::DECODING;
+    this->DecodeEntry(name, lock);
+  }
+}
+
+//////////////////////////////////////////////////
+MeshPrefetcher::MeshPrefetcher(std::size_t _threadCount,
+    const std::chrono::steady_clock::duration &_expiry)
+  : dataPtr(std::make_unique<MeshPrefetcherPrivate>())
+{
+  this->dataPtr->threadCount = std::max<std::size_t>(_threadCount, 1u);
+  this->dataPtr->expiry = _expiry;
+}
+
+//////////////////////////////////////////////////
+MeshPrefetcher::~MeshPrefetcher()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stop = true;
+  }
+  this->dataPtr->queued.notify_all();
+  for (auto &thread : this->dataPtr->threads)
+  {
+    if (thread.joinable())
+      thread.join();
+  }
+
+  for (auto &[name, entry] : this->dataPtr->entries)
+    delete entry.mesh;
+}
+
+//////////////////////////////////////////////////
+MeshPrefetcher &MeshPrefetcher::Instance()
+{
+  static MeshPrefetcher instance(std::min<std::size_t>(4u,
+      std::max(2u, std::thread::hardware_concurrency() / 2)));
+  return instance;
+}
+
+//////////////////////////////////////////////////
+bool MeshPrefetcher::Prefetch(const std::string &_name)
+{
+  if (MeshPrefetcherPrivate::Extension(_name).empty())
+    return false;
+
+  if (common::MeshManager::Instance()->HasMesh(_name))
+    return false;
+
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (this->dataPtr->stop ||
+      !this->dataPtr->entries.emplace(_name,
+          MeshPrefetcherPrivate::Entry()).second)
+  {
+    return false;
+  }
+  this->dataPtr->queue.push_back(_name);
+
+  if (this->dataPtr->threads.empty())
+  {
+    for (std::size_t i = 0; i < this->dataPtr->threadCount; ++i)
+    {
+      this->dataPtr->threads.emplace_back(&MeshPrefetcherPrivate::Run,
+          this->dataPtr.get());
+    }
+  }
+  this->dataPtr->queued.notify_one();
+  return true;
+}
+
+//////////////////////////////////////////////////
+const common::Mesh *MeshPrefetcher::Load(const std::string &_name)
+{
+  IGN_PROFILE("MeshPrefetcher::Load");
+
+  using State = MeshPrefetcherPrivate::State;
+  auto &meshManager = *common::MeshManager::Instance();
+
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  auto it = this->dataPtr->entries.find(_name);
+  if (it == this->dataPtr->entries.end())
+  {
+    lock.unlock();
+    return meshManager.Load(_name);
+  }
+
+  // Don't wait for a worker to get to it
+  if (it->second.state == State::QUEUED)
+  {
+    it->second.state = State::DECODING;
+    this->dataPtr->DecodeEntry(_name, lock);
+  }
+
+  this->dataPtr->decoded.wait(lock, [&]
+      {
+        it = this->dataPtr->entries.find(_name);
+        return it == this->dataPtr->entries.end() ||
+            it->second.state != State::DECODING;
+      });
+
+  // If another thread loaded it while waiting, the mesh manager has it
+  common::Mesh *mesh{nullptr};
+  if (it != this->dataPtr->entries.end())
+  {
+    mesh = it->second.mesh;
+    this->dataPtr->entries.erase(it);
+  }
+
+  if (nullptr == mesh)
+  {
+    // If decoding failed, let the mesh manager try again, so it reports
+    // the error
+    lock.unlock();
+    return meshManager.Load(_name);
+  }
+
+  if (meshManager.HasMesh(_name))
+    delete mesh;
+  else
+    meshManager.AddMesh(mesh);
+  return meshManager.MeshByName(_name);
+}
+
+//////////////////////////////////////////////////
+void MeshPrefetcher::Flush()
+{
+  using State = MeshPrefetcherPrivate::State;
+
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->decoded.wait(lock, [this]
+      {
+        for (const auto &[name, entry] : this->dataPtr->entries)
+        {
+          if (entry.state == State::QUEUED || entry.state == State::DECODING)
+            return false;
+        }
+        return true;
+      });
+}
+
+//////////////////////////////////////////////////
+void MeshPrefetcher::Cancel()
+{
+  using State = MeshPrefetcherPrivate::State;
+
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->queue.clear();
+  for (auto it = this->dataPtr->entries.begin();
+      it != this->dataPtr->entries.end();)
+  {
+    if (it->second.state == State::QUEUED)
+      it = this->dataPtr->entries.erase(it);
+    else
+      ++it;
+  }
+
+  this->dataPtr->decoded.wait(lock, [this]
+      {
+        for (const auto &[name, entry] : this->dataPtr->entries)
+        {
+          if (entry.state == State::DECODING)
+            return false;
+        }
+        return true;
+      });
+}
+
+//////////////////////////////////////////////////
+std::size_t MeshPrefetcher::ReadyCount() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return std::count_if(this->dataPtr->entries.begin(),
+      this->dataPtr->entries.end(), [](const auto &_pair)
+      {
+        return _pair.second.state == MeshPrefetcherPrivate::State::READY;
+      });
+}
+
+//////////////////////////////////////////////////
+std::size_t MeshPrefetcher::ThreadCount() const
+{
+  return this->dataPtr->threadCount;
+}
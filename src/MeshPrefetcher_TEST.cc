@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/MeshManager.hh>
+
+#include "ignition/gazebo/MeshPrefetcher.hh"
+#include "ignition/gazebo/test_config.hh"  // NOLINT(build/include)
+
+using namespace ignition;
+using namespace gazebo;
+using namespace std::chrono_literals;
+
+/////////////////////////////////////////////////
+TEST(MeshPrefetcherTest, PrefetchAndLoad)
+{
+  MeshPrefetcher prefetcher(2);
+  EXPECT_EQ(2u, prefetcher.ThreadCount());
+
+  auto duck = common::joinPaths(std::string(PROJECT_SOURCE_PATH),
+      "test", "media", "duck.dae");
+  auto box = common::joinPaths(std::string(PROJECT_SOURCE_PATH),
+      "test", "worlds", "models", "scheme_resource_uri", "meshes", "box.dae");
+
+  auto &meshManager = *common::MeshManager::Instance();
+  EXPECT_FALSE(meshManager.HasMesh(duck));
+  EXPECT_FALSE(meshManager.HasMesh(box));
+
+  EXPECT_TRUE(prefetcher.Prefetch(duck));
+  EXPECT_TRUE(prefetcher.Prefetch(box));
+
+  // Already queued
+  EXPECT_FALSE(prefetcher.Prefetch(duck));
+
+  // Unsupported file types are left to the mesh manager
+  EXPECT_FALSE(prefetcher.Prefetch("model.txt"));
+  EXPECT_FALSE(prefetcher.Prefetch(""));
+
+  // Decoded meshes aren't added to the mesh manager until they're loaded
+  prefetcher.Flush();
+  EXPECT_EQ(2u, prefetcher.ReadyCount());
+  EXPECT_FALSE(meshManager.HasMesh(duck));
+
+  auto *mesh = prefetcher.Load(duck);
+  ASSERT_NE(nullptr, mesh);
+  EXPECT_EQ(duck, mesh->Name());
+  EXPECT_LT(0u, mesh->SubMeshCount());
+  EXPECT_EQ(1u, prefetcher.ReadyCount());
+  EXPECT_TRUE(meshManager.HasMesh(duck));
+  EXPECT_EQ(mesh, meshManager.MeshByName(duck));
+
+  // Loading it again returns the same mesh, and it isn't queued again
+  EXPECT_EQ(mesh, prefetcher.Load(duck));
+  EXPECT_FALSE(prefetcher.Prefetch(duck));
+
+  auto *boxMesh = prefetcher.Load(box);
+  ASSERT_NE(nullptr, boxMesh);
+  EXPECT_EQ(0u, prefetcher.ReadyCount());
+  EXPECT_EQ(boxMesh, meshManager.MeshByName(box));
+}
+
+/////////////////////////////////////////////////
+TEST(MeshPrefetcherTest, ConcurrentLoad)
+{
+  MeshPrefetcher prefetcher(1);
+
+  auto floor = common::joinPaths(std::string(PROJECT_SOURCE_PATH),
+      "test", "worlds", "models", "building_L1", "meshes", "floor_1.obj");
+  EXPECT_TRUE(prefetcher.Prefetch(floor));
+
+  // Physics and rendering may need the same mesh at the same time, while
+  // it's still being decoded. They must get the same mesh.
+  std::vector<const common::Mesh *> meshes(4, nullptr);
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < meshes.size(); ++i)
+  {
+    threads.emplace_back([&, i]
+        {
+          meshes[i] = prefetcher.Load(floor);
+        });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  ASSERT_NE(nullptr, meshes[0]);
+  for (const auto *mesh : meshes)
+    EXPECT_EQ(meshes[0], mesh);
+  EXPECT_EQ(0u, prefetcher.ReadyCount());
+}
+
+/////////////////////////////////////////////////
+TEST(MeshPrefetcherTest, Missing)
+{
+  MeshPrefetcher prefetcher(1);
+
+  auto missing = common::joinPaths(std::string(PROJECT_BINARY_PATH),
+      "missing_mesh.stl");
+  EXPECT_TRUE(prefetcher.Prefetch(missing));
+  prefetcher.Flush();
+  EXPECT_EQ(0u, prefetcher.ReadyCount());
+
+  EXPECT_EQ(nullptr, prefetcher.Load(missing));
+  EXPECT_FALSE(common::MeshManager::Instance()->HasMesh(missing));
+
+  // A failed mesh can be queued again
+  EXPECT_TRUE(prefetcher.Prefetch(missing));
+}
+
+/////////////////////////////////////////////////
+TEST(MeshPrefetcherTest, Expiry)
+{
+  MeshPrefetcher prefetcher(1, 100ms);
+
+  auto wall = common::joinPaths(std::string(PROJECT_SOURCE_PATH),
+      "test", "worlds", "models", "building_L1", "meshes", "wall_1.obj");
+  EXPECT_TRUE(prefetcher.Prefetch(wall));
+  prefetcher.Flush();
+  EXPECT_EQ(1u, prefetcher.ReadyCount());
+
+  // Meshes which are never loaded are deleted once they expire
+  for (int sleep = 0; sleep < 50 && prefetcher.ReadyCount() > 0; ++sleep)
+    std::this_thread::sleep_for(20ms);
+  EXPECT_EQ(0u, prefetcher.ReadyCount());
+  EXPECT_FALSE(common::MeshManager::Instance()->HasMesh(wall));
+
+  // Loading it afterwards falls back to the mesh manager
+  auto *mesh = prefetcher.Load(wall);
+  ASSERT_NE(nullptr, mesh);
+  EXPECT_EQ(mesh, common::MeshManager::Instance()->MeshByName(wall));
+}
+
+/////////////////////////////////////////////////
+TEST(MeshPrefetcherTest, Cancel)
+{
+  MeshPrefetcher prefetcher(1);
+
+  std::vector<std::string> names;
+  for (int i = 0; i < 20; ++i)
+  {
+    names.push_back(common::joinPaths(std::string(PROJECT_BINARY_PATH),
+        "cancelled_mesh_" + std::to_string(i) + ".stl"));
+    EXPECT_TRUE(prefetcher.Prefetch(names.back()));
+  }
+
+  // Queued meshes are dropped and the one being decoded is waited for, so
+  // nothing is left for the workers
+  prefetcher.Cancel();
+  prefetcher.Flush();
+  EXPECT_EQ(0u, prefetcher.ReadyCount());
+
+  // Dropped meshes fall back to the mesh manager
+  for (const auto &name : names)
+    EXPECT_EQ(nullptr, prefetcher.Load(name));
+
+  // The prefetcher can still be used
+  EXPECT_TRUE(prefetcher.Prefetch(names[0]));
+  prefetcher.Flush();
+}
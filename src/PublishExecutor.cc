@@ -0,0 +1,302 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ignition/gazebo/PublishExecutor.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief Executor whose task is running on this thread, if any.
+static thread_local const PublishExecutorPrivate *tlsExecutor{nullptr};
+
+/// \brief Key of the task running on this thread.
+static thread_local uint64_t tlsKey{0};
+
+class ignition::gazebo::PublishExecutorPrivate
+{
+  /// \brief A queued task.
+  public: struct Task
+  {
+    /// \brief Function to run.
+    std::function<void()> fn;
+
+    /// \brief Coalescing key, or 0.
+    uint64_t key{0};
+  };
+
+  /// \brief Worker thread loop.
+  public: void Run();
+
+  /// \brief Maximum number of queued tasks.
+  public: std::size_t maxQueueSize{0};
+
+  /// \brief Worker threads.
+  public: std::vector<std::thread> threads;
+
+  /// \brief Protects all members below.
+  public: mutable std::mutex mutex;
+
+  /// \brief Signaled when tasks are queued or the executor stops.
+  public: std::condition_variable taskAvailable;
+
+  /// \brief Signaled when a task finishes.
+  public: std::condition_variable taskDone;
+
+  /// \brief Queued tasks, oldest first.
+  public: std::list<Task> queue;
+
+  /// \brief Queued tasks by key, for coalescing.
+  public: std::unordered_map<uint64_t, std::list<Task>::iterator> queuedKeys;
+
+  /// \brief Keys of the tasks that are currently running.
+  public: std::unordered_multiset<uint64_t> runningKeys;
+
+  /// \brief Number of tasks currently running.
+  public: std::size_t running{0};
+
+  /// \brief Statistics.
+  public: PublishExecutorStats stats;
+
+  /// \brief True when the workers should exit once the queue is empty.
+  public: bool stop{false};
+};
+
+//////////////////////////////////////////////////
+PublishExecutor::PublishExecutor(std::size_t _threadCount,
+    std::size_t _maxQueueSize)
+  : dataPtr(std::make_unique<PublishExecutorPrivate>())
+{
+  this->dataPtr->maxQueueSize = std::max<std::size_t>(_maxQueueSize, 1u);
+  _threadCount = std::max<std::size_t>(_threadCount, 1u);
+  for (std::size_t i = 0; i < _threadCount; ++i)
+  {
+    this->dataPtr->threads.emplace_back(&PublishExecutorPrivate::Run,
+        this->dataPtr.get());
+  }
+}
+
+//////////////////////////////////////////////////
+PublishExecutor::~PublishExecutor()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->stop = true;
+  }
+  this->dataPtr->taskAvailable.notify_all();
+  for (auto &thread : this->dataPtr->threads)
+  {
+    if (thread.joinable())
+      thread.join();
+  }
+
+  const auto &stats = this->dataPtr->stats;
+  igndbg << "Publish executor stopping. Executed [" << stats.executed
+         << "], coalesced [" << stats.coalesced << "], dropped ["
+         << stats.dropped << "], max queue depth [" << stats.maxQueueDepth
+         << "]" << std::endl;
+}
+
+//////////////////////////////////////////////////
+std::shared_ptr<PublishExecutor> PublishExecutor::Instance()
+{
+  // Only a weak pointer is kept, so the executor is destroyed along with its
+  // last user rather than during static destruction, when the plugins which
+  // posted tasks may have been unloaded already
+  static std::mutex mutex;
+  static std::weak_ptr<PublishExecutor> weakInstance;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto instance = weakInstance.lock();
+  if (nullptr == instance)
+  {
+    // Publishing is mostly serialization and socket writes, so a fraction
+    // of the hardware threads is enough
+    auto threadCount = std::clamp(std::thread::hardware_concurrency() / 4,
+        1u, 8u);
+    instance = std::make_shared<PublishExecutor>(threadCount);
+    weakInstance = instance;
+  }
+  return instance;
+}
+
+//////////////////////////////////////////////////
+uint64_t PublishExecutor::NewKey()
+{
+  static std::atomic<uint64_t> lastKey{0};
+  return ++lastKey;
+}
+
+//////////////////////////////////////////////////
+bool PublishExecutor::Post(std::function<void()> _task, uint64_t _key)
+{
+  if (!_task)
+    return false;
+
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    auto &stats = this->dataPtr->stats;
+
+    if (_key != 0)
+    {
+      auto it = this->dataPtr->queuedKeys.find(_key);
+      if (it != this->dataPtr->queuedKeys.end())
+      {
+        it->second->fn = std::move(_task);
+        ++stats.posted;
+        ++stats.coalesced;
+        return true;
+      }
+    }
+
+    if (this->dataPtr->queue.size() >= this->dataPtr->maxQueueSize)
+    {
+      if (stats.dropped == 0)
+      {
+        ignwarn << "Publish executor queue is full ["
+                << this->dataPtr->maxQueueSize << " tasks]. Tasks will be "
+                << "dropped until the queue drains." << std::endl;
+      }
+      ++stats.dropped;
+      return false;
+    }
+
+    this->dataPtr->queue.push_back({std::move(_task), _key});
+    if (_key != 0)
+    {
+      this->dataPtr->queuedKeys[_key] = std::prev(this->dataPtr->queue.end());
+    }
+
+    ++stats.posted;
+    stats.queueDepth = this->dataPtr->queue.size();
+    stats.maxQueueDepth = std::max(stats.maxQueueDepth, stats.queueDepth);
+  }
+  this->dataPtr->taskAvailable.notify_one();
+  return true;
+}
+
+//////////////////////////////////////////////////
+void PublishExecutor::Cancel(uint64_t _key)
+{
+  if (_key == 0)
+    return;
+
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  auto it = this->dataPtr->queuedKeys.find(_key);
+  if (it != this->dataPtr->queuedKeys.end())
+  {
+    this->dataPtr->queue.erase(it->second);
+    this->dataPtr->queuedKeys.erase(it);
+    this->dataPtr->stats.queueDepth = this->dataPtr->queue.size();
+  }
+
+  // A task cancelling its own key can't wait for itself
+  const std::size_t self =
+      (tlsExecutor == this->dataPtr.get() && tlsKey == _key) ? 1u : 0u;
+  this->dataPtr->taskDone.wait(lock, [&]
+      {
+        return this->dataPtr->runningKeys.count(_key) <= self;
+      });
+}
+
+//////////////////////////////////////////////////
+void PublishExecutor::Flush()
+{
+  std::unique_lock<std::mutex> lock(this->dataPtr->mutex);
+  this->dataPtr->taskDone.wait(lock, [&]
+      {
+        return this->dataPtr->queue.empty() && this->dataPtr->running == 0;
+      });
+}
+
+//////////////////////////////////////////////////
+std::size_t PublishExecutor::ThreadCount() const
+{
+  return this->dataPtr->threads.size();
+}
+
+//////////////////////////////////////////////////
+PublishExecutorStats PublishExecutor::Stats() const
+{
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  return this->dataPtr->stats;
+}
+
+//////////////////////////////////////////////////
+void PublishExecutorPrivate::Run()
+{
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (true)
+  {
+    this->taskAvailable.wait(lock, [this]
+        {
+          return this->stop || !this->queue.empty();
+        });
+
+    if (this->queue.empty())
+    {
+      // Stopping and nothing left to run
+      return;
+    }
+
+    Task task = std::move(this->queue.front());
+    this->queue.pop_front();
+    if (task.key != 0)
+    {
+      this->queuedKeys.erase(task.key);
+      this->runningKeys.insert(task.key);
+    }
+    this->stats.queueDepth = this->queue.size();
+    ++this->running;
+
+    lock.unlock();
+    tlsExecutor = this;
+    tlsKey = task.key;
+    try
+    {
+      task.fn();
+    }
+    catch (const std::exception &_e)
+    {
+      ignerr << "Exception thrown by publish executor task: " << _e.what()
+             << std::endl;
+    }
+    tlsExecutor = nullptr;
+    tlsKey = 0;
+    lock.lock();
+
+    --this->running;
+    if (task.key != 0)
+      this->runningKeys.erase(this->runningKeys.find(task.key));
+    ++this->stats.executed;
+    this->taskDone.notify_all();
+  }
+}
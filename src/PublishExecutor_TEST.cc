@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "ignition/gazebo/PublishExecutor.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief Blocks the executor's threads until released.
+class Gate
+{
+  /// \brief Wait until Open is called.
+  public: void Wait()
+  {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->cv.wait(lock, [this]{return this->open;});
+  }
+
+  /// \brief Release all waiting threads.
+  public: void Open()
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      this->open = true;
+    }
+    this->cv.notify_all();
+  }
+
+  /// \brief Mutex.
+  private: std::mutex mutex;
+
+  /// \brief Condition variable.
+  private: std::condition_variable cv;
+
+  /// \brief Whether the gate is open.
+  private: bool open{false};
+};
+
+//////////////////////////////////////////////////
+TEST(PublishExecutorTest, Run)
+{
+  PublishExecutor executor(3);
+  EXPECT_EQ(3u, executor.ThreadCount());
+
+  std::atomic<int> count{0};
+  for (int i = 0; i < 100; ++i)
+  {
+    EXPECT_TRUE(executor.Post([&count]{++count;}));
+  }
+  EXPECT_FALSE(executor.Post(nullptr));
+
+  executor.Flush();
+  EXPECT_EQ(100, count);
+
+  auto stats = executor.Stats();
+  EXPECT_EQ(100u, stats.posted);
+  EXPECT_EQ(100u, stats.executed);
+  EXPECT_EQ(0u, stats.queueDepth);
+  EXPECT_EQ(0u, stats.dropped);
+  EXPECT_EQ(0u, stats.coalesced);
+}
+
+//////////////////////////////////////////////////
+TEST(PublishExecutorTest, CoalesceAndDrop)
+{
+  PublishExecutor executor(1, 3);
+  Gate gate;
+
+  // Keep the only thread busy
+  std::atomic<bool> started{false};
+  EXPECT_TRUE(executor.Post([&]{started = true; gate.Wait();}));
+  while (!started)
+    std::this_thread::yield();
+
+  // Tasks with the same key replace each other
+  const auto key = PublishExecutor::NewKey();
+  EXPECT_NE(0u, key);
+  EXPECT_NE(key, PublishExecutor::NewKey());
+  std::atomic<int> value{0};
+  for (int i = 1; i <= 10; ++i)
+  {
+    EXPECT_TRUE(executor.Post([&value, i]{value = i;}, key));
+  }
+
+  // The queue holds 3 tasks
+  EXPECT_TRUE(executor.Post([]{}));
+  EXPECT_TRUE(executor.Post([]{}));
+  EXPECT_FALSE(executor.Post([]{}));
+
+  auto stats = executor.Stats();
+  EXPECT_EQ(3u, stats.queueDepth);
+  EXPECT_EQ(3u, stats.maxQueueDepth);
+  EXPECT_EQ(9u, stats.coalesced);
+  EXPECT_EQ(1u, stats.dropped);
+
+  gate.Open();
+  executor.Flush();
+  EXPECT_EQ(10, value);
+  EXPECT_EQ(4u, executor.Stats().executed);
+}
+
+//////////////////////////////////////////////////
+TEST(PublishExecutorTest, Cancel)
+{
+  PublishExecutor executor(1);
+  Gate gate;
+
+  std::atomic<bool> started{false};
+  EXPECT_TRUE(executor.Post([&]{started = true; gate.Wait();}));
+  while (!started)
+    std::this_thread::yield();
+
+  const auto key = PublishExecutor::NewKey();
+  std::atomic<bool> ran{false};
+  EXPECT_TRUE(executor.Post([&ran]{ran = true;}, key));
+  executor.Cancel(key);
+  EXPECT_EQ(0u, executor.Stats().queueDepth);
+
+  gate.Open();
+  executor.Flush();
+  EXPECT_FALSE(ran);
+}
+
+//////////////////////////////////////////////////
+TEST(PublishExecutorTest, CancelFromTask)
+{
+  PublishExecutor executor(2);
+
+  // A task cancelling its own key doesn't wait for itself
+  const auto key = PublishExecutor::NewKey();
+  std::atomic<bool> done{false};
+  EXPECT_TRUE(executor.Post([&]
+      {
+        executor.Cancel(key);
+        done = true;
+      }, key));
+  executor.Flush();
+  EXPECT_TRUE(done);
+}
+
+//////////////////////////////////////////////////
+TEST(PublishExecutorTest, Instance)
+{
+  auto instance = PublishExecutor::Instance();
+  ASSERT_NE(nullptr, instance);
+  EXPECT_LE(1u, instance->ThreadCount());
+  EXPECT_EQ(instance, PublishExecutor::Instance());
+
+  // The instance is destroyed with its last user, and a new one is created
+  // on demand
+  std::weak_ptr<PublishExecutor> weakInstance = instance;
+  instance.reset();
+  EXPECT_TRUE(weakInstance.expired());
+  EXPECT_NE(nullptr, PublishExecutor::Instance());
+}
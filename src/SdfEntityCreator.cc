@@ -15,12 +15,21 @@
  *
 */
 
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <thread>
+#include <vector>
+
 #include <ignition/common/Console.hh>
 #include <ignition/common/Profiler.hh>
+#include <sdf/Mesh.hh>
 #include <sdf/Types.hh>
 
 #include "ignition/gazebo/Events.hh"
+#include "ignition/gazebo/MeshPrefetcher.hh"
 #include "ignition/gazebo/SdfEntityCreator.hh"
+#include "ignition/gazebo/Util.hh"
 
 #include "ignition/gazebo/components/Actor.hh"
 #include "ignition/gazebo/components/AirPressureSensor.hh"
@@ -103,6 +112,31 @@ class ignition::gazebo::SdfEntityCreatorPrivate
 using namespace ignition;
 using namespace gazebo;
 
+/// \brief Minimum number of top level models for each thread creating them
+/// in parallel. Small worlds are faster to create on a single thread.
+static const uint64_t kMinModelsPerThread{64};
+
+/////////////////////////////////////////////////
+/// \brief Count the entities that will be created for a model.
+/// \param[in] _model SDF model.
+/// \return Number of entities, including the model's.
+static std::size_t countEntities(const sdf::Model *_model)
+{
+  std::size_t count{1};
+  for (uint64_t i = 0; i < _model->LinkCount(); ++i)
+  {
+    auto link = _model->LinkByIndex(i);
+    count += 1 + link->VisualCount() + link->CollisionCount() +
+        link->LightCount() + link->SensorCount() +
+        link->ParticleEmitterCount();
+  }
+  for (uint64_t i = 0; i < _model->JointCount(); ++i)
+    count += 1 + _model->JointByIndex(i)->SensorCount();
+  for (uint64_t i = 0; i < _model->ModelCount(); ++i)
+    count += countEntities(_model->ModelByIndex(i));
+  return count;
+}
+
 /////////////////////////////////////////////////
 /// \brief Resolve the pose of an SDF DOM object with respect to its relative_to
 /// frame. If that fails, return the raw pose
@@ -219,6 +253,9 @@ Entity SdfEntityCreator::CreateEntities(const sdf::World *_world)
 {
   IGN_PROFILE("SdfEntityCreator::CreateEntities(sdf::World)");
 
+  // Update views once per entity, instead of once per component
+  this->dataPtr->ecm->BeginComponentBatch();
+
   // World entity
   Entity worldEntity = this->dataPtr->ecm->CreateEntity();
 
@@ -249,13 +286,16 @@ Entity SdfEntityCreator::CreateEntities(const sdf::World *_world)
   }
 
   // Models
-  for (uint64_t modelIndex = 0; modelIndex < _world->ModelCount();
-      ++modelIndex)
+  if (!this->CreateModelsInParallel(_world, worldEntity))
   {
-    auto model = _world->ModelByIndex(modelIndex);
-    auto modelEntity = this->CreateEntities(model);
+    for (uint64_t modelIndex = 0; modelIndex < _world->ModelCount();
+        ++modelIndex)
+    {
+      auto model = _world->ModelByIndex(modelIndex);
+      auto modelEntity = this->CreateEntities(model);
 
-    this->SetParent(modelEntity, worldEntity);
+      this->SetParent(modelEntity, worldEntity);
+    }
   }
 
   // Actors
@@ -321,6 +361,8 @@ Entity SdfEntityCreator::CreateEntities(const sdf::World *_world)
   this->dataPtr->ecm->CreateComponent(worldEntity,
       components::MagneticField(_world->MagneticField()));
 
+  this->dataPtr->ecm->CommitComponentBatch();
+
   this->dataPtr->eventManager->Emit<events::LoadPlugins>(worldEntity,
       _world->Element());
 
@@ -331,12 +373,125 @@ Entity SdfEntityCreator::CreateEntities(const sdf::World *_world)
   return worldEntity;
 }
 
+//////////////////////////////////////////////////
+bool SdfEntityCreator::CreateModelsInParallel(const sdf::World *_world,
+    Entity _worldEntity)
+{
+  auto modelCount = _world->ModelCount();
+  auto threadCount = std::min<std::size_t>(
+      std::thread::hardware_concurrency(),
+      modelCount / kMinModelsPerThread);
+  if (threadCount < 2)
+    return false;
+
+  IGN_PROFILE("SdfEntityCreator::CreateModelsInParallel");
+
+  // Lay out a block of ids for each model, so the ids match the ones they'd
+  // get if they were created one at a time. The ids are only reserved once
+  // all the models have been created, so the ECM is left untouched if they
+  // have to be created one at a time instead.
+  const Entity first = this->dataPtr->ecm->ReserveEntities(0);
+  std::vector<Entity> firstEntities(modelCount);
+  std::vector<std::size_t> entityCounts(modelCount);
+  std::size_t totalCount{0};
+  for (uint64_t i = 0; i < modelCount; ++i)
+  {
+    entityCounts[i] = countEntities(_world->ModelByIndex(i));
+    firstEntities[i] = first + totalCount;
+    totalCount += entityCounts[i];
+  }
+
+  // Ids may have been taken out of order, for example with
+  // SetEntityCreateOffset
+  for (Entity entity = first; entity < first + totalCount; ++entity)
+  {
+    if (this->dataPtr->ecm->HasEntity(entity))
+      return false;
+  }
+
+  /// \brief Result of creating a model, with the plugins it should load.
+  struct CreatedModel
+  {
+    Entity entity{kNullEntity};
+    std::map<Entity, sdf::ElementPtr> newModels;
+    std::map<Entity, sdf::ElementPtr> newSensors;
+    std::map<Entity, sdf::ElementPtr> newVisuals;
+  };
+  std::vector<CreatedModel> created(modelCount);
+
+  // Each thread creates models in increasing order into its own ECM
+  std::vector<EntityComponentManager> ecms(threadCount);
+  std::atomic<uint64_t> nextModel{0};
+  std::atomic<bool> ok{true};
+  auto worker = [&](std::size_t _thread)
+  {
+    IGN_PROFILE_THREAD_NAME("SdfEntityCreator");
+    EventManager eventManager;
+    SdfEntityCreator creator(ecms[_thread], eventManager);
+    for (auto i = nextModel++; i < modelCount && ok; i = nextModel++)
+    {
+      auto entityCount = ecms[_thread].EntityCount();
+      ecms[_thread].SetEntityCreateOffset(firstEntities[i] - 1);
+
+      auto &model = created[i];
+      model.entity = creator.CreateEntities(_world->ModelByIndex(i), false);
+      model.newModels.swap(creator.dataPtr->newModels);
+      model.newSensors.swap(creator.dataPtr->newSensors);
+      model.newVisuals.swap(creator.dataPtr->newVisuals);
+
+      // Spilling out of the block would collide with the next model
+      if (ecms[_thread].EntityCount() - entityCount > entityCounts[i])
+      {
+        ignwarn << "Model [" << _world->ModelByIndex(i)->Name()
+                << "] created more entities than expected." << std::endl;
+        ok = false;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (std::size_t t = 1; t < threadCount; ++t)
+    threads.emplace_back(worker, t);
+  worker(0);
+  for (auto &thread : threads)
+    thread.join();
+
+  if (!ok)
+  {
+    ignwarn << "Creating models one at a time instead." << std::endl;
+    return false;
+  }
+
+  // None of the ids are in use, so every merge succeeds
+  this->dataPtr->ecm->ReserveEntities(totalCount);
+  for (auto &ecm : ecms)
+    this->dataPtr->ecm->Merge(ecm);
+
+  // Parent the models and load plugins in the same order as if they were
+  // created one at a time
+  for (auto &model : created)
+  {
+    this->SetParent(model.entity, _worldEntity);
+
+    for (const auto &[entity, element] : model.newModels)
+      this->dataPtr->eventManager->Emit<events::LoadPlugins>(entity, element);
+    for (const auto &[entity, element] : model.newSensors)
+      this->dataPtr->eventManager->Emit<events::LoadPlugins>(entity, element);
+    for (const auto &[entity, element] : model.newVisuals)
+      this->dataPtr->eventManager->Emit<events::LoadPlugins>(entity, element);
+  }
+
+  return true;
+}
+
 //////////////////////////////////////////////////
 Entity SdfEntityCreator::CreateEntities(const sdf::Model *_model)
 {
   IGN_PROFILE("SdfEntityCreator::CreateEntities(sdf::Model)");
 
+  this->dataPtr->ecm->BeginComponentBatch();
   auto ent = this->CreateEntities(_model, false);
+  this->dataPtr->ecm->CommitComponentBatch();
 
   // Load all model plugins afterwards, so we get scoped name for nested models.
   for (const auto &[entity, element] : this->dataPtr->newModels)
@@ -806,6 +961,15 @@ Entity SdfEntityCreator::CreateEntities(const sdf::Collision *_collision)
   {
     this->dataPtr->ecm->CreateComponent(collisionEntity,
         components::Geometry(*_collision->Geom()));
+
+    // Start decoding the mesh now, physics will need it on its next update
+    auto meshSdf = _collision->Geom()->MeshShape();
+    if (_collision->Geom()->Type() == sdf::GeometryType::MESH &&
+        nullptr != meshSdf)
+    {
+      MeshPrefetcher::Instance().Prefetch(
+          asFullPath(meshSdf->Uri(), meshSdf->FilePath()));
+    }
   }
 
   this->dataPtr->ecm->CreateComponent(collisionEntity,
@@ -1271,3 +1271,76 @@ TEST_F(SdfEntityCreatorTest, EachRemovedRecursiveRemoved)
   EXPECT_EQ(0u, removedCount<components::Collision>(ecm));
   EXPECT_EQ(0u, removedCount<components::Visual>(ecm));
 }
+
+/////////////////////////////////////////////////
+TEST_F(SdfEntityCreatorTest, CreateManyModels)
+{
+  // Enough models to be created in parallel if there are multiple cores
+  const int modelCount{400};
+  std::string sdf = "<?xml version=\"1.0\" ?><sdf version=\"1.6\">"
+      "<world name=\"default\">";
+  for (int i = 0; i < modelCount; ++i)
+  {
+    sdf += "<model name=\"model_" + std::to_string(i) + "\">"
+        "<pose>" + std::to_string(i) + " 0 0 0 0 0</pose>"
+        "<link name=\"link\">"
+        "<collision name=\"collision\"><geometry><box>"
+        "<size>1 1 1</size></box></geometry></collision>"
+        "<visual name=\"visual\"><geometry><box>"
+        "<size>1 1 1</size></box></geometry></visual>"
+        "</link>"
+        "<model name=\"nested\"><link name=\"nested_link\"/></model>"
+        "</model>";
+  }
+  sdf += "</world></sdf>";
+
+  sdf::Root root;
+  ASSERT_TRUE(root.LoadSdfString(sdf).empty());
+
+  // A view created before the entities should get all of them
+  int viewCount{0};
+  this->ecm.Each<components::Model>(
+      [&](const Entity &, const components::Model *) -> bool
+      {
+        ++viewCount;
+        return true;
+      });
+  EXPECT_EQ(0, viewCount);
+
+  SdfEntityCreator creator(this->ecm, evm);
+  auto world = creator.CreateEntities(root.WorldByIndex(0));
+
+  // 1 x world + 400 x (model + link + collision + visual + nested model +
+  // nested link)
+  EXPECT_EQ(1u + modelCount * 6u, this->ecm.EntityCount());
+
+  this->ecm.Each<components::Model>(
+      [&](const Entity &, const components::Model *) -> bool
+      {
+        ++viewCount;
+        return true;
+      });
+  EXPECT_EQ(modelCount * 2, viewCount);
+
+  // Entities have the same ids as if they were created one at a time
+  for (int i = 0; i < modelCount; ++i)
+  {
+    auto name = "model_" + std::to_string(i);
+    Entity model = this->ecm.EntityByComponents(components::Name(name),
+        components::Model());
+    EXPECT_EQ(world + 1 + i * 6u, model) << name;
+    EXPECT_EQ(world, this->ecm.ParentEntity(model));
+    EXPECT_EQ(math::Pose3d(i, 0, 0, 0, 0, 0),
+        this->ecm.Component<components::Pose>(model)->Data());
+
+    auto canonical = this->ecm.Component<components::ModelCanonicalLink>(
+        model);
+    ASSERT_NE(nullptr, canonical) << name;
+    EXPECT_EQ(model, this->ecm.ParentEntity(canonical->Data()));
+    EXPECT_EQ("link",
+        this->ecm.Component<components::Name>(canonical->Data())->Data());
+
+    // The model itself and its 5 descendants
+    EXPECT_EQ(6u, this->ecm.Descendants(model).size());
+  }
+}
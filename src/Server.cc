@@ -29,6 +29,7 @@
 
 #include "ServerPrivate.hh"
 #include "SimulationRunner.hh"
+#include "StartupTimeline.hh"
 
 using namespace ignition;
 using namespace gazebo;
@@ -57,6 +58,10 @@ Server::Server(const ServerConfig &_config)
 {
   this->dataPtr->config = _config;
 
+  if (!_config.StartupReportPath().empty())
+    this->dataPtr->startupTimeline = std::make_shared<StartupTimeline>();
+  auto timeline = this->dataPtr->startupTimeline.get();
+
   // Configure the fuel client
   fuel_tools::ClientConfig config;
   if (!_config.ResourceCache().empty())
@@ -73,6 +78,7 @@ Server::Server(const ServerConfig &_config)
 
   sdf::Errors errors;
 
+  auto loadStart = StartupTimeline::Clock::now();
   switch (_config.Source())
   {
     // Load a world if specified. Check SDF string first, then SDF file
@@ -101,8 +107,12 @@ Server::Server(const ServerConfig &_config)
 
     case ServerConfig::SourceType::kSdfFile:
     {
-      std::string filePath = resolveSdfWorldFile(_config.SdfFile(),
-          _config.ResourceCache());
+      std::string filePath;
+      {
+        StartupTimeline::Scope scope(timeline, "sdf", "Resolve world file");
+        filePath = resolveSdfWorldFile(_config.SdfFile(),
+            _config.ResourceCache());
+      }
 
       if (filePath.empty())
       {
@@ -133,6 +143,12 @@ Server::Server(const ServerConfig &_config)
     }
   }
 
+  if (nullptr != timeline)
+  {
+    timeline->Add("server", "Load SDF", loadStart,
+        StartupTimeline::Clock::now());
+  }
+
   if (!errors.empty())
   {
     for (auto &err : errors)
@@ -146,7 +162,10 @@ Server::Server(const ServerConfig &_config)
     this->dataPtr->AddRecordPlugin(_config);
   }
 
-  this->dataPtr->CreateEntities();
+  {
+    StartupTimeline::Scope scope(timeline, "server", "Create worlds");
+    this->dataPtr->CreateEntities();
+  }
 
   // Set the desired update period, this will override the desired RTF given in
   // the world file which was parsed by CreateEntities.
@@ -156,7 +175,14 @@ Server::Server(const ServerConfig &_config)
   }
 
   // Establish publishers and subscribers.
-  this->dataPtr->SetupTransport();
+  {
+    StartupTimeline::Scope scope(timeline, "server", "Setup transport");
+    this->dataPtr->SetupTransport();
+  }
+
+  // Each world writes the report again after its first step
+  if (nullptr != timeline)
+    timeline->Write(_config.StartupReportPath());
 }
 
 /////////////////////////////////////////////////
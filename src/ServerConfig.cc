@@ -229,6 +229,7 @@ class ignition::gazebo::ServerConfigPrivate
             logRecordResources(_cfg->logRecordResources),
             logRecordCompressPath(_cfg->logRecordCompressPath),
             resourceCache(_cfg->resourceCache),
+            startupReportPath(_cfg->startupReportPath),
             physicsEngine(_cfg->physicsEngine),
             renderEngineServer(_cfg->renderEngineServer),
             renderEngineGui(_cfg->renderEngineGui),
@@ -270,6 +271,9 @@ class ignition::gazebo::ServerConfigPrivate
   /// from fuel.ignitionrobotics.org, should be stored.
   public: std::string resourceCache = "";
 
+  /// \brief Path to write the startup report to, empty to skip it.
+  public: std::string startupReportPath = "";
+
   /// \brief File containing physics engine plugin. If empty, DART will be used.
   public: std::string physicsEngine = "";
 
@@ -515,6 +519,18 @@ void ServerConfig::SetResourceCache(const std::string &_path)
   this->dataPtr->resourceCache = _path;
 }
 
+/////////////////////////////////////////////////
+const std::string &ServerConfig::StartupReportPath() const
+{
+  return this->dataPtr->startupReportPath;
+}
+
+/////////////////////////////////////////////////
+void ServerConfig::SetStartupReportPath(const std::string &_path)
+{
+  this->dataPtr->startupReportPath = _path;
+}
+
 /////////////////////////////////////////////////
 const std::string &ServerConfig::PhysicsEngine() const
 {
@@ -26,8 +26,10 @@
 
 #include <ignition/fuel_tools/Interface.hh>
 
+#include "ignition/gazebo/MeshPrefetcher.hh"
 #include "ignition/gazebo/Util.hh"
 #include "SimulationRunner.hh"
+#include "StartupTimeline.hh"
 
 using namespace ignition;
 using namespace gazebo;
@@ -102,6 +104,9 @@ ServerPrivate::~ServerPrivate()
   {
     this->stopThread->join();
   }
+
+  // Prefetcher workers may be resolving files through FetchResourceUri
+  MeshPrefetcher::Instance().Cancel();
 }
 
 //////////////////////////////////////////////////
@@ -308,7 +313,11 @@ void ServerPrivate::CreateEntities()
       this->worldNames.push_back(world->Name());
     }
     auto runner = std::make_unique<SimulationRunner>(
-        world, this->systemLoader, this->config);
+        world, this->systemLoader, this->config, this->startupTimeline);
+
+    // Meshes may have been fetched in the background while the runner was
+    // created
+    std::lock_guard<std::mutex> lock(this->fetchMutex);
     runner->SetFuelUriMap(this->fuelUriMap);
     this->simRunners.push_back(std::move(runner));
   }
@@ -488,6 +497,9 @@ bool ServerPrivate::ResourcePathsService(
 //////////////////////////////////////////////////
 std::string ServerPrivate::FetchResource(const std::string &_uri)
 {
+  std::lock_guard<std::mutex> lock(this->fetchMutex);
+  StartupTimeline::Scope scope(this->startupTimeline.get(), "fuel", _uri);
+
   auto path =
       fuel_tools::fetchResourceWithClient(_uri, *this->fuelClient.get());
 
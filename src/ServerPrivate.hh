@@ -56,6 +56,7 @@ namespace ignition
     // Inline bracket to help doxygen filtering.
     inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
     class SimulationRunner;
+    class StartupTimeline;
 
     // Private data for Server
     class IGNITION_GAZEBO_HIDDEN ServerPrivate
@@ -164,6 +165,16 @@ namespace ignition
       /// Server. It is used in the SDFormat world generator when saving worlds
       public: std::unordered_map<std::string, std::string> fuelUriMap;
 
+      /// \brief Protects fuelClient and fuelUriMap while fetching, since
+      /// resources such as meshes may be fetched from background threads.
+      /// \sa MeshPrefetcher
+      public: std::mutex fetchMutex;
+
+      /// \brief Startup timeline, null unless a startup report was
+      /// requested.
+      /// \sa ServerConfig::SetStartupReportPath
+      public: std::shared_ptr<StartupTimeline> startupTimeline;
+
       /// \brief List of names for all worlds loaded in this server.
       private: std::vector<std::string> worldNames;
 
@@ -17,7 +17,11 @@
 
 #include <gtest/gtest.h>
 #include <csignal>
+#include <fstream>
+#include <iterator>
+#include <string>
 #include <vector>
+#include <ignition/common/Filesystem.hh>
 #include <ignition/common/StringUtils.hh>
 #include <ignition/common/Util.hh>
 #include <ignition/math/Rand.hh>
@@ -70,6 +74,7 @@ TEST_P(ServerFixture, IGN_UTILS_TEST_DISABLED_ON_WIN32(DefaultServerConfig))
   EXPECT_EQ(0u, serverConfig.Seed());
   EXPECT_EQ(123ms, serverConfig.UpdatePeriod().value_or(123ms));
   EXPECT_TRUE(serverConfig.ResourceCache().empty());
+  EXPECT_TRUE(serverConfig.StartupReportPath().empty());
   EXPECT_TRUE(serverConfig.PhysicsEngine().empty());
   EXPECT_TRUE(serverConfig.Plugins().empty());
   EXPECT_TRUE(serverConfig.LogRecordTopics().empty());
@@ -295,6 +300,38 @@ TEST_P(ServerFixture, IGN_UTILS_TEST_DISABLED_ON_WIN32(SdfServerConfig))
   EXPECT_FALSE(server.HasEntity("bad", 1));
 }
 
+/////////////////////////////////////////////////
+TEST_P(ServerFixture, IGN_UTILS_TEST_DISABLED_ON_WIN32(StartupReport))
+{
+  auto reportPath = common::joinPaths(std::string(PROJECT_BINARY_PATH),
+      "test_startup_report.json");
+  common::removeFile(reportPath);
+
+  ServerConfig serverConfig;
+  serverConfig.SetSdfFile(std::string(PROJECT_SOURCE_PATH) +
+      "/test/worlds/shapes.sdf");
+  serverConfig.SetStartupReportPath(reportPath);
+
+  auto readReport = [&]()
+  {
+    std::ifstream file(reportPath);
+    return std::string(std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>());
+  };
+
+  gazebo::Server server(serverConfig);
+  auto report = readReport();
+  EXPECT_NE(std::string::npos, report.find("\"Load SDF\""));
+  EXPECT_NE(std::string::npos, report.find("\"Create entities [default]\""));
+  EXPECT_NE(std::string::npos, report.find("\"cat\": \"plugin\""));
+  EXPECT_EQ(std::string::npos, report.find("First step"));
+
+  EXPECT_TRUE(server.RunOnce(true));
+  report = readReport();
+  EXPECT_NE(std::string::npos, report.find("\"First step [default]\""));
+  EXPECT_NE(std::string::npos, report.find("\"totalsMs\""));
+}
+
 /////////////////////////////////////////////////
 TEST_P(ServerFixture, IGN_UTILS_TEST_DISABLED_ON_WIN32(SdfRootServerConfig))
 {
@@ -18,6 +18,8 @@
 #include "SimulationRunner.hh"
 
 #include <algorithm>
+#include <string>
+#include <vector>
 
 #include <sdf/Root.hh>
 
@@ -43,14 +45,39 @@ using namespace gazebo;
 
 using StringSet = std::unordered_set<std::string>;
 
+/// \brief Collect the library file names of all the system plugins in an
+/// element and its descendants. GUI plugins inside `<gui>` are skipped.
+/// \param[in] _elem Element.
+/// \param[out] _filenames File names, in document order.
+static void collectPluginFilenames(const sdf::ElementPtr &_elem,
+    std::vector<std::string> &_filenames)
+{
+  for (auto child = _elem->GetFirstElement(); child;
+      child = child->GetNextElement())
+  {
+    if (child->GetName() == "plugin")
+    {
+      auto filename = child->Get<std::string>("filename");
+      if (filename != "__default__")
+        _filenames.push_back(filename);
+    }
+    else if (child->GetName() != "gui")
+    {
+      collectPluginFilenames(child, _filenames);
+    }
+  }
+}
 
 //////////////////////////////////////////////////
 SimulationRunner::SimulationRunner(const sdf::World *_world,
                                    const SystemLoaderPtr &_systemLoader,
-                                   const ServerConfig &_config)
+                                   const ServerConfig &_config,
+                                   std::shared_ptr<StartupTimeline>
+                                       _startupTimeline)
     // \todo(nkoenig) Either copy the world, or add copy constructor to the
     // World and other elements.
-    : sdfWorld(_world), serverConfig(_config)
+    : sdfWorld(_world), serverConfig(_config),
+      startupTimeline(std::move(_startupTimeline))
 {
   if (nullptr == _world)
   {
@@ -61,6 +88,10 @@ SimulationRunner::SimulationRunner(const sdf::World *_world,
   // Keep world name
   this->worldName = _world->Name();
 
+  // The startup report is done once every world took its first step
+  if (this->startupTimeline)
+    this->startupTimeline->AddWorld();
+
   // Get the physics profile
   // TODO(luca): remove duplicated logic in SdfEntityCreator and LevelManager
   auto physics = _world->PhysicsByIndex(0);
@@ -166,8 +197,26 @@ SimulationRunner::SimulationRunner(const sdf::World *_world,
     }
   }
 
+  // Find and load all the plugin libraries at once, so loading each plugin
+  // while entities are created only has to instantiate it
+  {
+    StartupTimeline::Scope scope(this->startupTimeline.get(), "plugin",
+        "Preload plugin libraries");
+    std::vector<std::string> filenames;
+    if (_world->Element())
+      collectPluginFilenames(_world->Element(), filenames);
+    for (const auto &plugin : this->serverConfig.Plugins())
+      filenames.push_back(plugin.Filename());
+    if (_systemLoader)
+      _systemLoader->PreloadPlugins(filenames);
+  }
+
   // Load the active levels
-  this->levelMgr->UpdateLevelsState();
+  {
+    StartupTimeline::Scope scope(this->startupTimeline.get(), "entities",
+        "Create entities [" + this->worldName + "]");
+    this->levelMgr->UpdateLevelsState();
+  }
 
   // Load any additional plugins from the Server Configuration
   this->LoadServerPlugins(this->serverConfig.Plugins());
@@ -532,20 +581,28 @@ void SimulationRunner::UpdateSystems()
   // WorkerPool.cc). We could turn on parallel updates in the future, and/or
   // turn it on if there are sufficient systems. More testing is required.
 
+  // The first step is part of the startup, since systems such as physics
+  // create their own entities then
+  auto timeline = this->startupReported ? nullptr :
+      this->startupTimeline.get();
+
   {
     IGN_PROFILE("PreUpdate");
+    StartupTimeline::Scope scope(timeline, "step", "PreUpdate");
     for (auto& system : this->systemMgr->SystemsPreUpdate())
       system->PreUpdate(this->currentInfo, this->entityCompMgr);
   }
 
   {
     IGN_PROFILE("Update");
+    StartupTimeline::Scope scope(timeline, "step", "Update");
     for (auto& system : this->systemMgr->SystemsUpdate())
       system->Update(this->currentInfo, this->entityCompMgr);
   }
 
   {
     IGN_PROFILE("PostUpdate");
+    StartupTimeline::Scope scope(timeline, "step", "PostUpdate");
     this->entityCompMgr.LockAddingEntitiesToViews(true);
     // If no systems implementing PostUpdate have been added, then
     // the barriers will be uninitialized, so guard against that condition.
@@ -784,6 +841,7 @@ bool SimulationRunner::Run(const uint64_t _iterations)
 void SimulationRunner::Step(const UpdateInfo &_info)
 {
   IGN_PROFILE("SimulationRunner::Step");
+  auto stepStart = std::chrono::steady_clock::now();
   this->currentInfo = _info;
 
   // Process new ECM state information, typically sent from the GUI after
@@ -852,6 +910,15 @@ void SimulationRunner::Step(const UpdateInfo &_info)
   // Each network manager takes care of marking its components as unchanged
   if (!this->networkMgr)
     this->entityCompMgr.SetAllComponentsUnchanged();
+
+  if (this->startupTimeline && !this->startupReported)
+  {
+    this->startupTimeline->Add("server",
+        "First step [" + this->worldName + "]",
+        stepStart, std::chrono::steady_clock::now());
+    this->startupTimeline->WorldDone(this->serverConfig.StartupReportPath());
+    this->startupReported = true;
+  }
 }
 
 //////////////////////////////////////////////////
@@ -860,6 +927,8 @@ void SimulationRunner::LoadPlugin(const Entity _entity,
                                   const std::string &_name,
                                   const sdf::ElementPtr &_sdf)
 {
+  StartupTimeline::Scope scope(this->startupReported ? nullptr :
+      this->startupTimeline.get(), "plugin", _name + " [" + _fname + "]");
   this->systemMgr->LoadPlugin(_entity, _fname, _name, _sdf);
 }
 
@@ -53,6 +53,7 @@
 
 #include "network/NetworkManager.hh"
 #include "LevelManager.hh"
+#include "StartupTimeline.hh"
 #include "SystemManager.hh"
 #include "Barrier.hh"
 #include "WorldControl.hh"
@@ -74,9 +75,12 @@ namespace ignition
       /// \param[in] _world Pointer to the SDF world.
       /// \param[in] _systemLoader Reference to system manager.
       /// \param[in] _useLevels Whether to use levles or not. False by default.
+      /// \param[in] _startupTimeline Timeline to add startup phases to, such
+      /// as entity creation, plugin loading and the first step. May be null.
       public: explicit SimulationRunner(const sdf::World *_world,
-                                const SystemLoaderPtr &_systemLoader,
-                                const ServerConfig &_config = ServerConfig());
+                const SystemLoaderPtr &_systemLoader,
+                const ServerConfig &_config = ServerConfig(),
+                std::shared_ptr<StartupTimeline> _startupTimeline = nullptr);
 
       /// \brief Destructor.
       public: virtual ~SimulationRunner();
@@ -518,6 +522,13 @@ namespace ignition
       /// \brief Map from file paths to Fuel URIs.
       private: std::unordered_map<std::string, std::string> fuelUriMap;
 
+      /// \brief Startup timeline, null if no startup report was requested.
+      private: std::shared_ptr<StartupTimeline> startupTimeline;
+
+      /// \brief True once the first step has been added to the startup
+      /// timeline.
+      private: bool startupReported{false};
+
       /// \brief True if Server::RunOnce triggered a blocking paused step
       private: bool blockingPausedStepPending{false};
 
@@ -0,0 +1,221 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "StartupTimeline.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+#include <ignition/common/Console.hh>
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief Quote and escape a string for JSON.
+/// \param[in] _str String.
+/// \return Quoted string.
+static std::string quoted(const std::string &_str)
+{
+  std::string result{"\""};
+  for (char c : _str)
+  {
+    if (c == '"' || c == '\\')
+    {
+      result += '\\';
+      result += c;
+    }
+    else if (static_cast<unsigned char>(c) < 0x20)
+    {
+      char buf[8];
+      std::snprintf(buf, sizeof(buf), "\\u%04x",
+          static_cast<unsigned int>(c));
+      result += buf;
+    }
+    else
+    {
+      result += c;
+    }
+  }
+  result += '"';
+  return result;
+}
+
+/// \brief Microseconds in a duration.
+/// \param[in] _duration Duration.
+/// \return Microseconds.
+static int64_t micros(const StartupTimeline::Clock::duration &_duration)
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      _duration).count();
+}
+
+//////////////////////////////////////////////////
+StartupTimeline::Scope::Scope(StartupTimeline *_timeline,
+    const std::string &_category, const std::string &_name)
+  : timeline(_timeline)
+{
+  if (nullptr == this->timeline)
+    return;
+
+  if (!this->timeline->Recording())
+  {
+    this->timeline = nullptr;
+    return;
+  }
+
+  this->category = _category;
+  this->name = _name;
+  this->start = Clock::now();
+}
+
+//////////////////////////////////////////////////
+StartupTimeline::Scope::~Scope()
+{
+  if (nullptr != this->timeline)
+  {
+    this->timeline->Add(this->category, this->name, this->start,
+        Clock::now());
+  }
+}
+
+//////////////////////////////////////////////////
+StartupTimeline::StartupTimeline()
+  : origin(Clock::now())
+{
+}
+
+//////////////////////////////////////////////////
+void StartupTimeline::Add(const std::string &_category,
+    const std::string &_name, const Clock::time_point &_start,
+    const Clock::time_point &_end)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  if (!this->recording)
+    return;
+
+  this->events.push_back({_category, _name, _start, _end - _start,
+      std::this_thread::get_id()});
+}
+
+//////////////////////////////////////////////////
+void StartupTimeline::AddWorld()
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  ++this->pendingWorlds;
+}
+
+//////////////////////////////////////////////////
+bool StartupTimeline::WorldDone(const std::string &_path)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->pendingWorlds > 0 && --this->pendingWorlds == 0)
+      this->recording = false;
+  }
+  return this->Write(_path);
+}
+
+//////////////////////////////////////////////////
+bool StartupTimeline::Recording() const
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->recording;
+}
+
+//////////////////////////////////////////////////
+std::vector<StartupTimeline::Event> StartupTimeline::Events() const
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->events;
+}
+
+//////////////////////////////////////////////////
+std::string StartupTimeline::Json() const
+{
+  auto events = this->Events();
+
+  // Threads are numbered in the order they show up
+  std::unordered_map<std::thread::id, int> threads;
+  std::map<std::string, Clock::duration> totals;
+  Clock::time_point end{this->origin};
+
+  std::ostringstream out;
+  out << "{\n  \"traceEvents\": [";
+  for (std::size_t i = 0; i < events.size(); ++i)
+  {
+    const auto &event = events[i];
+    auto tid = threads.emplace(event.thread,
+        static_cast<int>(threads.size()) + 1).first->second;
+    totals[event.category] += event.duration;
+    end = std::max(end, event.start + event.duration);
+
+    out << (i == 0 ? "\n" : ",\n")
+        << "    {\"name\": " << quoted(event.name)
+        << ", \"cat\": " << quoted(event.category)
+        << ", \"ph\": \"X\""
+        << ", \"ts\": " << micros(event.start - this->origin)
+        << ", \"dur\": " << micros(event.duration)
+        << ", \"pid\": 1, \"tid\": " << tid << "}";
+  }
+  out << "\n  ],\n  \"displayTimeUnit\": \"ms\",\n";
+
+  // Totals are in milliseconds. Phases of different categories may overlap,
+  // so totals don't add up to the duration. Phases of the same category
+  // aren't nested, so they're not counted twice.
+  out << "  \"totalsMs\": {";
+  bool first{true};
+  for (const auto &[category, duration] : totals)
+  {
+    out << (first ? "\n" : ",\n") << "    " << quoted(category) << ": "
+        << micros(duration) / 1000.0;
+    first = false;
+  }
+  out << "\n  },\n  \"durationMs\": " << micros(end - this->origin) / 1000.0
+      << "\n}\n";
+  return out.str();
+}
+
+//////////////////////////////////////////////////
+bool StartupTimeline::Write(const std::string &_path) const
+{
+  // Each world writes the report from its own thread
+  std::lock_guard<std::mutex> lock(this->writeMutex);
+
+  std::ofstream file(_path, std::ios::out | std::ios::trunc);
+  if (!file.is_open())
+  {
+    ignerr << "Failed to open startup report [" << _path << "] for writing."
+           << std::endl;
+    return false;
+  }
+
+  file << this->Json();
+  if (!file.good())
+  {
+    ignerr << "Failed to write startup report [" << _path << "]."
+           << std::endl;
+    return false;
+  }
+
+  igndbg << "Wrote startup report to [" << _path << "]." << std::endl;
+  return true;
+}
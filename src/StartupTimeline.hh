@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef IGNITION_GAZEBO_STARTUPTIMELINE_HH_
+#define IGNITION_GAZEBO_STARTUPTIMELINE_HH_
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/Export.hh>
+
+namespace ignition
+{
+  namespace gazebo
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+
+    /// \class StartupTimeline StartupTimeline.hh
+    /// \brief Records how long each phase of the server startup takes, such
+    /// as loading the SDF, fetching resources, loading each plugin and
+    /// creating entities, and writes them as a JSON report.
+    ///
+    /// The report uses the trace event format, so it can be opened in
+    /// chrome://tracing or Perfetto, and it also lists the total time spent
+    /// in each category. Events can be added from any thread.
+    ///
+    /// Phases of the same category shouldn't be nested, or the nested time
+    /// is counted twice in the category's total. A phase enclosing others,
+    /// such as the whole first step, goes in a category of its own.
+    ///
+    /// Each world registers with AddWorld and calls WorldDone after its first
+    /// step. Once all of them are done, the startup is over and new phases
+    /// are ignored.
+    class IGNITION_GAZEBO_VISIBLE StartupTimeline
+    {
+      /// \brief Clock used for all times.
+      public: using Clock = std::chrono::steady_clock;
+
+      /// \brief A timed phase.
+      public: struct Event
+      {
+        /// \brief Category, such as "sdf" or "plugin".
+        std::string category;
+
+        /// \brief Name of the phase.
+        std::string name;
+
+        /// \brief Start time.
+        Clock::time_point start;
+
+        /// \brief How long the phase took.
+        Clock::duration duration;
+
+        /// \brief Thread the phase ran on.
+        std::thread::id thread;
+      };
+
+      /// \brief Times a phase from construction to destruction, adding it to
+      /// a timeline. Does nothing if the timeline is null or no longer
+      /// recording.
+      public: class IGNITION_GAZEBO_VISIBLE Scope
+      {
+        /// \brief Constructor. Starts timing.
+        /// \param[in] _timeline Timeline to add the phase to, may be null.
+        /// \param[in] _category Category of the phase.
+        /// \param[in] _name Name of the phase.
+        public: Scope(StartupTimeline *_timeline, const std::string &_category,
+                    const std::string &_name);
+
+        /// \brief Destructor. Adds the phase to the timeline.
+        public: ~Scope();
+
+        /// \brief Timeline, may be null.
+        private: StartupTimeline *timeline;
+
+        /// \brief Category of the phase.
+        private: std::string category;
+
+        /// \brief Name of the phase.
+        private: std::string name;
+
+        /// \brief Start time.
+        private: Clock::time_point start;
+      };
+
+      /// \brief Constructor. The timeline starts now.
+      public: StartupTimeline();
+
+      /// \brief Add a phase. Does nothing once every world is done.
+      /// \param[in] _category Category of the phase.
+      /// \param[in] _name Name of the phase.
+      /// \param[in] _start Start time.
+      /// \param[in] _end End time.
+      public: void Add(const std::string &_category, const std::string &_name,
+                  const Clock::time_point &_start,
+                  const Clock::time_point &_end);
+
+      /// \brief Get all the phases added so far, in the order they were
+      /// added.
+      /// \return Phases.
+      public: std::vector<Event> Events() const;
+
+      /// \brief Get the report.
+      /// \return JSON report.
+      public: std::string Json() const;
+
+      /// \brief Write the report to a file, replacing it if it exists.
+      /// Writes are serialized, so several worlds sharing a timeline can
+      /// each write it when they're done starting.
+      /// \param[in] _path Path to the file.
+      /// \return True if the file was written.
+      public: bool Write(const std::string &_path) const;
+
+      /// \brief Register a world which will call WorldDone when it's done
+      /// starting.
+      public: void AddWorld();
+
+      /// \brief Mark a registered world as done starting and write the
+      /// report. When it's the last world, recording stops.
+      /// \param[in] _path Path to the report file.
+      /// \return True if the file was written.
+      public: bool WorldDone(const std::string &_path);
+
+      /// \brief Whether phases are still being recorded.
+      /// \return False once every registered world is done.
+      public: bool Recording() const;
+
+      /// \brief Time the timeline started.
+      private: Clock::time_point origin;
+
+      /// \brief Protects events, pendingWorlds and recording.
+      private: mutable std::mutex mutex;
+
+      /// \brief Worlds which haven't called WorldDone yet.
+      private: unsigned int pendingWorlds{0};
+
+      /// \brief False once every registered world is done.
+      private: bool recording{true};
+
+      /// \brief Phases added so far.
+      private: std::vector<Event> events;
+
+      /// \brief Serializes writes to the report file.
+      private: mutable std::mutex writeMutex;
+    };
+    }
+  }
+}
+#endif
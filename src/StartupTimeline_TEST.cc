@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ignition/common/Filesystem.hh>
+
+#include "ignition/gazebo/test_config.hh"
+
+#include "StartupTimeline.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace std::chrono_literals;
+
+/////////////////////////////////////////////////
+TEST(StartupTimeline, Events)
+{
+  StartupTimeline timeline;
+  EXPECT_TRUE(timeline.Events().empty());
+
+  auto start = StartupTimeline::Clock::now();
+  timeline.Add("sdf", "Load SDF", start, start + 3ms);
+  {
+    StartupTimeline::Scope scope(&timeline, "plugin", "physics");
+    std::this_thread::sleep_for(1ms);
+  }
+  std::thread([&]
+      {
+        StartupTimeline::Scope scope(&timeline, "plugin", "sensors");
+      }).join();
+
+  // Null timelines are ignored
+  {
+    StartupTimeline::Scope scope(nullptr, "plugin", "ignored");
+  }
+
+  auto events = timeline.Events();
+  ASSERT_EQ(3u, events.size());
+  EXPECT_EQ("sdf", events[0].category);
+  EXPECT_EQ("Load SDF", events[0].name);
+  EXPECT_EQ(start, events[0].start);
+  EXPECT_EQ(std::chrono::duration_cast<StartupTimeline::Clock::duration>(3ms),
+      events[0].duration);
+  EXPECT_EQ("physics", events[1].name);
+  EXPECT_GE(events[1].duration, 1ms);
+  EXPECT_EQ(events[0].thread, events[1].thread);
+  EXPECT_NE(events[1].thread, events[2].thread);
+}
+
+/////////////////////////////////////////////////
+TEST(StartupTimeline, Json)
+{
+  StartupTimeline timeline;
+  auto start = StartupTimeline::Clock::now();
+  timeline.Add("plugin", "a \"quoted\" \\ name", start, start + 2ms);
+  timeline.Add("plugin", "b", start, start + 3ms);
+  std::thread([&]
+      {
+        timeline.Add("fuel", "https://fuel/model", start, start + 1ms);
+      }).join();
+
+  auto json = timeline.Json();
+  EXPECT_NE(std::string::npos, json.find("\"traceEvents\""));
+  EXPECT_NE(std::string::npos,
+      json.find("\"name\": \"a \\\"quoted\\\" \\\\ name\""));
+  EXPECT_NE(std::string::npos, json.find("\"dur\": 2000, \"pid\": 1, "
+      "\"tid\": 1}"));
+  EXPECT_NE(std::string::npos, json.find("\"dur\": 1000, \"pid\": 1, "
+      "\"tid\": 2}"));
+  EXPECT_NE(std::string::npos, json.find("\"plugin\": 5"));
+  EXPECT_NE(std::string::npos, json.find("\"fuel\": 1"));
+
+  auto path = common::joinPaths(std::string(PROJECT_BINARY_PATH),
+      "test_startup_timeline.json");
+  common::removeFile(path);
+  EXPECT_TRUE(timeline.Write(path));
+
+  std::ifstream file(path);
+  std::string written((std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>());
+  EXPECT_EQ(json, written);
+
+  EXPECT_FALSE(timeline.Write(common::joinPaths(std::string(
+      PROJECT_BINARY_PATH), "nonexistent", "report.json")));
+}
+
+/////////////////////////////////////////////////
+TEST(StartupTimeline, ConcurrentWrite)
+{
+  StartupTimeline timeline;
+  auto start = StartupTimeline::Clock::now();
+  for (int i = 0; i < 100; ++i)
+  {
+    timeline.Add("plugin", "plugin_" + std::to_string(i), start,
+        start + 1ms);
+  }
+
+  // Worlds write the same report from their own threads
+  auto path = common::joinPaths(std::string(PROJECT_BINARY_PATH),
+      "test_startup_timeline_concurrent.json");
+  common::removeFile(path);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i)
+  {
+    threads.emplace_back([&]
+        {
+          EXPECT_TRUE(timeline.Write(path));
+        });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  std::ifstream file(path);
+  std::string written((std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>());
+  EXPECT_EQ(timeline.Json(), written);
+}
+
+/////////////////////////////////////////////////
+TEST(StartupTimeline, WorldDone)
+{
+  StartupTimeline timeline;
+  timeline.AddWorld();
+  timeline.AddWorld();
+
+  auto path = common::joinPaths(std::string(PROJECT_BINARY_PATH),
+      "test_startup_timeline_done.json");
+  common::removeFile(path);
+
+  auto start = StartupTimeline::Clock::now();
+  timeline.Add("plugin", "first", start, start + 1ms);
+  EXPECT_TRUE(timeline.WorldDone(path));
+  EXPECT_TRUE(timeline.Recording());
+
+  // Phases are recorded until the last world is done
+  timeline.Add("plugin", "second", start, start + 1ms);
+  EXPECT_TRUE(timeline.WorldDone(path));
+  EXPECT_FALSE(timeline.Recording());
+
+  timeline.Add("fuel", "late", start, start + 1ms);
+  {
+    StartupTimeline::Scope scope(&timeline, "fuel", "late scope");
+  }
+  auto events = timeline.Events();
+  ASSERT_EQ(2u, events.size());
+  EXPECT_EQ("second", events[1].name);
+
+  std::ifstream file(path);
+  std::string written((std::istreambuf_iterator<char>(file)),
+      std::istreambuf_iterator<char>());
+  EXPECT_EQ(timeline.Json(), written);
+}
@@ -15,9 +15,15 @@
  *
 */
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include <ignition/gazebo/SystemLoader.hh>
 
@@ -25,6 +31,7 @@
 
 #include <ignition/common/Console.hh>
 #include <ignition/common/Filesystem.hh>
+#include <ignition/common/Profiler.hh>
 #include <ignition/common/StringUtils.hh>
 #include <ignition/common/SystemPaths.hh>
 #include <ignition/common/Util.hh>
@@ -46,18 +53,9 @@ class ignition::gazebo::SystemLoaderPrivate
               const sdf::ElementPtr &/*_sdf*/,
               ignition::plugin::PluginPtr &_plugin)
   {
-    ignition::common::SystemPaths systemPaths;
-    systemPaths.SetPluginPathEnv(pluginPathEnv);
-
-    for (const auto &path : this->systemPluginPaths)
-      systemPaths.AddPluginPaths(path);
-
-    std::string homePath;
-    ignition::common::env(IGN_HOMEDIR, homePath);
-    systemPaths.AddPluginPaths(homePath + "/.ignition/gazebo/plugins");
-    systemPaths.AddPluginPaths(IGN_GAZEBO_PLUGIN_INSTALL_DIR);
+    std::lock_guard<std::mutex> lock(this->mutex);
 
-    auto pathToLib = systemPaths.FindSharedLibrary(_filename);
+    auto pathToLib = this->FindLibrary(_filename);
     if (pathToLib.empty())
     {
       // We assume ignition::gazebo corresponds to the levels feature
@@ -69,23 +67,8 @@ class ignition::gazebo::SystemLoaderPrivate
       return false;
     }
 
-    auto pluginNames = this->loader.LoadLib(pathToLib);
-    if (pluginNames.empty())
-    {
-      ignerr << "Failed to load system plugin [" << _filename <<
-                "] : couldn't load library on path [" << pathToLib <<
-                "]." << std::endl;
+    if (!this->LoadLibraryOnce(_filename, pathToLib))
       return false;
-    }
-
-    auto pluginName = *pluginNames.begin();
-    if (pluginName.empty())
-    {
-      ignerr << "Failed to load system plugin [" << _filename <<
-                "] : couldn't load library on path [" << pathToLib <<
-                "]." << std::endl;
-      return false;
-    }
 
     _plugin = this->loader.Instantiate(_name);
     if (!_plugin)
@@ -109,9 +92,90 @@ class ignition::gazebo::SystemLoaderPrivate
     return true;
   }
 
+  /// \brief Search the plugin paths for a library, without using the cache.
+  /// \param[in] _filename Library file name.
+  /// \param[in] _paths Paths added with AddSystemPluginPath.
+  /// \return Path to the library, empty if not found.
+  public: std::string SearchLibrary(const std::string &_filename,
+              const std::vector<std::string> &_paths) const
+  {
+    ignition::common::SystemPaths systemPaths;
+    systemPaths.SetPluginPathEnv(this->pluginPathEnv);
+
+    for (const auto &path : _paths)
+      systemPaths.AddPluginPaths(path);
+
+    std::string homePath;
+    ignition::common::env(IGN_HOMEDIR, homePath);
+    systemPaths.AddPluginPaths(homePath + "/.ignition/gazebo/plugins");
+    systemPaths.AddPluginPaths(IGN_GAZEBO_PLUGIN_INSTALL_DIR);
+
+    return systemPaths.FindSharedLibrary(_filename);
+  }
+
+  /// \brief Find a library, searching the plugin paths only the first time.
+  /// The mutex must be locked.
+  /// \param[in] _filename Library file name.
+  /// \return Path to the library, empty if not found.
+  public: std::string FindLibrary(const std::string &_filename)
+  {
+    this->CheckPathEnv();
+
+    auto it = this->libraryPaths.find(_filename);
+    if (it != this->libraryPaths.end())
+      return it->second;
+
+    auto path = this->SearchLibrary(_filename, std::vector<std::string>(
+        this->systemPluginPaths.begin(), this->systemPluginPaths.end()));
+    this->libraryPaths[_filename] = path;
+    return path;
+  }
+
+  /// \brief Forget the library paths found so far if the plugin path
+  /// environment variable changed since they were found. The mutex must be
+  /// locked.
+  public: void CheckPathEnv()
+  {
+    std::string env;
+    ignition::common::env(this->pluginPathEnv, env);
+    if (env != this->cachedPathEnv)
+    {
+      this->libraryPaths.clear();
+      this->cachedPathEnv = env;
+    }
+  }
+
+  /// \brief Load a library, unless it's already loaded. The mutex must be
+  /// locked.
+  /// \param[in] _filename Library file name, for error messages.
+  /// \param[in] _path Path to the library.
+  /// \return True if the library is loaded.
+  public: bool LoadLibraryOnce(const std::string &_filename,
+              const std::string &_path)
+  {
+    if (this->loadedLibraries.find(_path) != this->loadedLibraries.end())
+      return true;
+
+    auto pluginNames = this->loader.LoadLib(_path);
+    if (pluginNames.empty() || pluginNames.begin()->empty())
+    {
+      ignerr << "Failed to load system plugin [" << _filename <<
+                "] : couldn't load library on path [" << _path <<
+                "]." << std::endl;
+      return false;
+    }
+
+    this->loadedLibraries.insert(_path);
+    return true;
+  }
+
   // Default plugin search path environment variable
   public: std::string pluginPathEnv{"IGN_GAZEBO_SYSTEM_PLUGIN_PATH"};
 
+  /// \brief Protects all the members below. The plugin loader isn't thread
+  /// safe, and a loader may be shared by several simulation runners.
+  public: std::mutex mutex;
+
   /// \brief Plugin loader instace
   public: ignition::plugin::Loader loader;
 
@@ -120,6 +184,17 @@ class ignition::gazebo::SystemLoaderPrivate
 
   /// \brief System plugins that have instances loaded via the manager.
   public: std::unordered_set<SystemPluginPtr> systemPluginsAdded;
+
+  /// \brief Library file names to the paths they were found at, or empty
+  /// strings if they weren't found.
+  public: std::unordered_map<std::string, std::string> libraryPaths;
+
+  /// \brief Value of the plugin path environment variable when
+  /// libraryPaths was filled.
+  public: std::string cachedPathEnv;
+
+  /// \brief Paths of the libraries loaded so far.
+  public: std::unordered_set<std::string> loadedLibraries;
 };
 
 //////////////////////////////////////////////////
@@ -134,7 +209,75 @@ SystemLoader::~SystemLoader() = default;
 //////////////////////////////////////////////////
 void SystemLoader::AddSystemPluginPath(const std::string &_path)
 {
-  this->dataPtr->systemPluginPaths.insert(_path);
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  if (this->dataPtr->systemPluginPaths.insert(_path).second)
+  {
+    // The new path may have libraries that weren't found, or that should be
+    // found there instead
+    this->dataPtr->libraryPaths.clear();
+  }
+}
+
+//////////////////////////////////////////////////
+void SystemLoader::PreloadPlugins(const std::vector<std::string> &_filenames)
+{
+  IGN_PROFILE("SystemLoader::PreloadPlugins");
+
+  std::vector<std::string> filenames;
+  std::vector<std::string> paths;
+  {
+    std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+    this->dataPtr->CheckPathEnv();
+
+    std::unordered_set<std::string> seen;
+    for (const auto &filename : _filenames)
+    {
+      if (!filename.empty() &&
+          this->dataPtr->libraryPaths.find(filename) ==
+          this->dataPtr->libraryPaths.end() &&
+          seen.insert(filename).second)
+      {
+        filenames.push_back(filename);
+      }
+    }
+    paths.assign(this->dataPtr->systemPluginPaths.begin(),
+        this->dataPtr->systemPluginPaths.end());
+  }
+
+  if (filenames.empty())
+    return;
+
+  // Searching the file system is the slow part, and it's independent for
+  // each library
+  std::vector<std::string> found(filenames.size());
+  std::atomic<std::size_t> next{0};
+  auto search = [&]
+  {
+    for (auto i = next++; i < filenames.size(); i = next++)
+      found[i] = this->dataPtr->SearchLibrary(filenames[i], paths);
+  };
+
+  auto threadCount = std::min<std::size_t>(filenames.size(),
+      std::max(1u, std::thread::hardware_concurrency()));
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < threadCount; ++i)
+    threads.emplace_back(search);
+  search();
+  for (auto &thread : threads)
+    thread.join();
+
+  // The plugin loader isn't thread safe, and the dynamic linker serializes
+  // loading anyway, so libraries are loaded one at a time, in order
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
+  for (std::size_t i = 0; i < filenames.size(); ++i)
+  {
+    this->dataPtr->libraryPaths.emplace(filenames[i], found[i]);
+    if (!found[i].empty())
+      this->dataPtr->LoadLibraryOnce(filenames[i], found[i]);
+  }
+
+  igndbg << "Preloaded [" << filenames.size() << "] system plugin libraries "
+         << "with [" << threadCount << "] threads." << std::endl;
 }
 
 //////////////////////////////////////////////////
@@ -180,6 +323,7 @@ std::optional<SystemPluginPtr> SystemLoader::LoadPlugin(
 //////////////////////////////////////////////////
 std::string SystemLoader::PrettyStr() const
 {
+  std::lock_guard<std::mutex> lock(this->dataPtr->mutex);
   return this->dataPtr->loader.PrettyStr();
 }
 
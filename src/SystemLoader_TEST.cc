@@ -65,3 +65,40 @@ TEST(SystemLoader, EmptyNames)
   auto system = sm.LoadPlugin("", "", element);
   ASSERT_FALSE(system.has_value());
 }
+
+/////////////////////////////////////////////////
+TEST(SystemLoader, PreloadPlugins)
+{
+  gazebo::SystemLoader sm;
+  auto testBuildPath = ignition::common::joinPaths(
+      std::string(PROJECT_BINARY_PATH), "lib");
+  sm.AddSystemPluginPath(testBuildPath);
+
+  std::string physics = std::string("libignition-gazebo") +
+      IGNITION_GAZEBO_MAJOR_VERSION_STR + "-physics-system.so";
+  std::string sceneBroadcaster = std::string("libignition-gazebo") +
+      IGNITION_GAZEBO_MAJOR_VERSION_STR + "-scene-broadcaster-system.so";
+
+  // Duplicates and missing libraries are fine
+  sm.PreloadPlugins({physics, sceneBroadcaster, physics, "libmissing.so",
+      ""});
+  EXPECT_NE(std::string::npos, sm.PrettyStr().find("SceneBroadcaster"));
+
+  // Each load creates a new instance from the preloaded library
+  sdf::ElementPtr element;
+  auto first = sm.LoadPlugin(physics, "ignition::gazebo::systems::Physics",
+      element);
+  auto second = sm.LoadPlugin(physics, "ignition::gazebo::systems::Physics",
+      element);
+  ASSERT_TRUE(first.has_value());
+  ASSERT_TRUE(second.has_value());
+  EXPECT_NE(first.value(), second.value());
+
+  EXPECT_FALSE(sm.LoadPlugin("libmissing.so", "missing", element)
+      .has_value());
+
+  // Preloading again doesn't load the libraries again
+  auto loaded = sm.PrettyStr();
+  sm.PreloadPlugins({physics, sceneBroadcaster});
+  EXPECT_EQ(loaded, sm.PrettyStr());
+}
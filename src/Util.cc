@@ -50,6 +50,7 @@
 #include "ignition/gazebo/components/ParticleEmitter.hh"
 #include "ignition/gazebo/components/Pose.hh"
 #include "ignition/gazebo/components/Sensor.hh"
+#include "ignition/gazebo/components/Sleeping.hh"
 #include "ignition/gazebo/components/SphericalCoordinates.hh"
 #include "ignition/gazebo/components/Visual.hh"
 #include "ignition/gazebo/components/World.hh"
@@ -62,6 +63,18 @@ namespace gazebo
 {
 // Inline bracket to help doxygen filtering.
 inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+/// \brief Implementation of scopedName which doesn't use the ECM's
+/// registry.
+static std::string computeScopedName(const Entity &_entity,
+    const EntityComponentManager &_ecm, const std::string &_delim,
+    bool _includePrefix);
+
+/// \brief Implementation of entitiesFromScopedName which doesn't use the
+/// ECM's registry.
+static std::unordered_set<Entity> computeEntitiesFromScopedName(
+    const std::string &_scopedName, const EntityComponentManager &_ecm,
+    Entity _relativeTo, const std::string &_delim);
+
 //////////////////////////////////////////////////
 math::Pose3d worldPose(const Entity &_entity,
     const EntityComponentManager &_ecm)
@@ -95,6 +108,20 @@ math::Pose3d worldPose(const Entity &_entity,
 std::string scopedName(const Entity &_entity,
     const EntityComponentManager &_ecm, const std::string &_delim,
     bool _includePrefix)
+{
+  // Names are registered in the ECM, so the parent chain is only walked the
+  // first time a name is requested after the entity or its ancestors change
+  auto format = _delim + (_includePrefix ? "+" : "-");
+  return _ecm.ScopedName(_entity, format, [&]
+      {
+        return computeScopedName(_entity, _ecm, _delim, _includePrefix);
+      });
+}
+
+//////////////////////////////////////////////////
+static std::string computeScopedName(const Entity &_entity,
+    const EntityComponentManager &_ecm, const std::string &_delim,
+    bool _includePrefix)
 {
   std::string result;
 
@@ -152,6 +179,20 @@ std::unordered_set<Entity> entitiesFromScopedName(
     return {};
   }
 
+  auto query = std::to_string(_relativeTo) + "|" + _delim + "|" +
+      _scopedName;
+  return _ecm.EntitiesFromScopedName(query, [&]
+      {
+        return computeEntitiesFromScopedName(_scopedName, _ecm, _relativeTo,
+            _delim);
+      });
+}
+
+//////////////////////////////////////////////////
+static std::unordered_set<Entity> computeEntitiesFromScopedName(
+    const std::string &_scopedName, const EntityComponentManager &_ecm,
+    Entity _relativeTo, const std::string &_delim)
+{
   // Split names
   std::vector<std::string> names;
   size_t pos1 = 0;
@@ -521,6 +562,17 @@ ignition::gazebo::Entity topLevelModel(const Entity &_entity,
   return modelEntity;
 }
 
+//////////////////////////////////////////////////
+bool isSleeping(const Entity &_entity, const EntityComponentManager &_ecm)
+{
+  auto sleepingComp = _ecm.Component<components::Sleeping>(_entity);
+  if (!sleepingComp || !sleepingComp->Data())
+    return false;
+
+  return _ecm.ComponentState(_entity, components::Sleeping::typeId) ==
+      ComponentState::NoChange;
+}
+
 //////////////////////////////////////////////////
 std::string topicFromScopedName(const Entity &_entity,
     const EntityComponentManager &_ecm, bool _excludeWorld)
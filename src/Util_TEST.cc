@@ -32,7 +32,9 @@
 #include "ignition/gazebo/components/Name.hh"
 #include "ignition/gazebo/components/ParentEntity.hh"
 #include "ignition/gazebo/components/ParticleEmitter.hh"
+#include "ignition/gazebo/components/Pose.hh"
 #include "ignition/gazebo/components/Sensor.hh"
+#include "ignition/gazebo/components/Sleeping.hh"
 #include "ignition/gazebo/components/Visual.hh"
 #include "ignition/gazebo/components/World.hh"
 #include "ignition/gazebo/EntityComponentManager.hh"
@@ -314,6 +316,120 @@ TEST_F(UtilTest, EntitiesFromScopedName)
   checkEntities("plum=pear", pear8, {pear10}, "=");
 }
 
+/////////////////////////////////////////////////
+TEST_F(UtilTest, ScopedNameRegistry)
+{
+  EntityComponentManager ecm;
+
+  auto worldEntity = ecm.CreateEntity();
+  ecm.CreateComponent(worldEntity, components::World());
+  ecm.CreateComponent(worldEntity, components::Name("world_name"));
+
+  auto modelEntity = ecm.CreateEntity();
+  ecm.CreateComponent(modelEntity, components::Model());
+  ecm.CreateComponent(modelEntity, components::Name("model_name"));
+  ecm.CreateComponent(modelEntity, components::ParentEntity(worldEntity));
+
+  auto linkEntity = ecm.CreateEntity();
+  ecm.CreateComponent(linkEntity, components::Link());
+  ecm.CreateComponent(linkEntity, components::Name("link_name"));
+  ecm.CreateComponent(linkEntity, components::ParentEntity(modelEntity));
+
+  // Repeated calls return the registered values
+  for (int i = 0; i < 2; ++i)
+  {
+    EXPECT_EQ("world_name::model_name::link_name",
+        scopedName(linkEntity, ecm, "::", false));
+    EXPECT_EQ("world/world_name/model/model_name/link/link_name",
+        scopedName(linkEntity, ecm));
+    EXPECT_EQ(std::unordered_set<Entity>{linkEntity},
+        entitiesFromScopedName("model_name::link_name", ecm));
+  }
+
+  // Renaming updates names and queries
+  ecm.SetComponentData<components::Name>(modelEntity, "new_model");
+  EXPECT_EQ("world_name::new_model::link_name",
+      scopedName(linkEntity, ecm, "::", false));
+  EXPECT_EQ("world/world_name/model/new_model/link/link_name",
+      scopedName(linkEntity, ecm));
+  EXPECT_TRUE(entitiesFromScopedName("model_name::link_name", ecm).empty());
+  EXPECT_EQ(std::unordered_set<Entity>{linkEntity},
+      entitiesFromScopedName("new_model::link_name", ecm));
+
+  // Setting the same name keeps the registry
+  ecm.SetComponentData<components::Name>(modelEntity, "new_model");
+  EXPECT_EQ("world_name::new_model::link_name",
+      scopedName(linkEntity, ecm, "::", false));
+
+  // Reparenting
+  auto otherModel = ecm.CreateEntity();
+  ecm.CreateComponent(otherModel, components::Model());
+  ecm.CreateComponent(otherModel, components::Name("other_model"));
+  ecm.CreateComponent(otherModel, components::ParentEntity(worldEntity));
+  ecm.SetParentEntity(linkEntity, otherModel);
+  ecm.SetComponentData<components::ParentEntity>(linkEntity, otherModel);
+  EXPECT_EQ("world_name::other_model::link_name",
+      scopedName(linkEntity, ecm, "::", false));
+  EXPECT_EQ(std::unordered_set<Entity>{linkEntity},
+      entitiesFromScopedName("other_model::link_name", ecm));
+  EXPECT_TRUE(entitiesFromScopedName("new_model::link_name", ecm).empty());
+
+  // Names modified in place are updated once SetChanged is called
+  ecm.Component<components::Name>(otherModel)->Data() = "renamed_model";
+  ecm.SetChanged(otherModel, components::Name::typeId,
+      ComponentState::OneTimeChange);
+  EXPECT_EQ("world_name::renamed_model::link_name",
+      scopedName(linkEntity, ecm, "::", false));
+
+  // Only the names which depend on a changed entity are computed again
+  int linkComputed{0};
+  int modelComputed{0};
+  auto linkName = [&]
+  {
+    return ecm.ScopedName(linkEntity, "test", [&]
+        {
+          ++linkComputed;
+          return std::string("link");
+        });
+  };
+  auto modelName = [&]
+  {
+    return ecm.ScopedName(otherModel, "test", [&]
+        {
+          ++modelComputed;
+          return std::string("model");
+        });
+  };
+  EXPECT_EQ("link", linkName());
+  EXPECT_EQ("model", modelName());
+  EXPECT_EQ(1, linkComputed);
+  EXPECT_EQ(1, modelComputed);
+
+  // New entities and components on other entities don't affect them
+  auto unrelated = ecm.CreateEntity();
+  ecm.CreateComponent(unrelated, components::Name("unrelated"));
+  ecm.CreateComponent(unrelated, components::ParentEntity(worldEntity));
+  ecm.CreateComponent(modelEntity, components::Pose());
+  linkName();
+  modelName();
+  EXPECT_EQ(1, linkComputed);
+  EXPECT_EQ(1, modelComputed);
+
+  // A component on the link only affects the link
+  ecm.CreateComponent(linkEntity, components::Pose());
+  linkName();
+  modelName();
+  EXPECT_EQ(2, linkComputed);
+  EXPECT_EQ(1, modelComputed);
+
+  // Renaming the world affects its descendants
+  ecm.SetComponentData<components::Name>(worldEntity, "new_world");
+  linkName();
+  modelName();
+  EXPECT_EQ(3, linkComputed);
+  EXPECT_EQ(2, modelComputed);
+}
+
 /////////////////////////////////////////////////
 TEST_F(UtilTest, EntityTypeId)
 {
@@ -580,6 +696,41 @@ TEST_F(UtilTest, TopLevelModel)
   EXPECT_EQ(kNullEntity, topLevelModel(worldEntity, ecm));
 }
 
+/////////////////////////////////////////////////
+TEST_F(UtilTest, IsSleeping)
+{
+  EntityComponentManager ecm;
+
+  auto modelEntity = ecm.CreateEntity();
+  ecm.CreateComponent(modelEntity, components::Model());
+
+  // No component
+  EXPECT_FALSE(isSleeping(modelEntity, ecm));
+
+  // Awake
+  ecm.CreateComponent(modelEntity, components::Sleeping(false));
+  ecm.SetChanged(modelEntity, components::Sleeping::typeId,
+      ComponentState::NoChange);
+  EXPECT_FALSE(isSleeping(modelEntity, ecm));
+
+  // Just fell asleep
+  ecm.Component<components::Sleeping>(modelEntity)->Data() = true;
+  ecm.SetChanged(modelEntity, components::Sleeping::typeId,
+      ComponentState::OneTimeChange);
+  EXPECT_FALSE(isSleeping(modelEntity, ecm));
+
+  // Sleeping since a previous update
+  ecm.SetChanged(modelEntity, components::Sleeping::typeId,
+      ComponentState::NoChange);
+  EXPECT_TRUE(isSleeping(modelEntity, ecm));
+
+  // Woke up
+  ecm.Component<components::Sleeping>(modelEntity)->Data() = false;
+  ecm.SetChanged(modelEntity, components::Sleeping::typeId,
+      ComponentState::OneTimeChange);
+  EXPECT_FALSE(isSleeping(modelEntity, ecm));
+}
+
 /////////////////////////////////////////////////
 TEST_F(UtilTest, ValidTopic)
 {
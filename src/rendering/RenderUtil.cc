@@ -29,6 +29,7 @@
 #include <sdf/Joint.hh>
 #include <sdf/Light.hh>
 #include <sdf/Link.hh>
+#include <sdf/Mesh.hh>
 #include <sdf/Model.hh>
 #include <sdf/parser.hh>
 #include <sdf/Scene.hh>
@@ -78,6 +79,7 @@
 #include "ignition/gazebo/components/Scene.hh"
 #include "ignition/gazebo/components/SegmentationCamera.hh"
 #include "ignition/gazebo/components/SemanticLabel.hh"
+#include "ignition/gazebo/components/Sleeping.hh"
 #include "ignition/gazebo/components/SourceFilePath.hh"
 #include "ignition/gazebo/components/Temperature.hh"
 #include "ignition/gazebo/components/TemperatureRange.hh"
@@ -88,6 +90,7 @@
 #include "ignition/gazebo/components/VisualCmd.hh"
 #include "ignition/gazebo/components/World.hh"
 #include "ignition/gazebo/EntityComponentManager.hh"
+#include "ignition/gazebo/MeshPrefetcher.hh"
 
 #include "ignition/gazebo/rendering/Events.hh"
 #include "ignition/gazebo/rendering/RenderUtil.hh"
@@ -2147,12 +2150,17 @@ void RenderUtilPrivate::UpdateRenderingEntities(
     const EntityComponentManager &_ecm)
 {
   IGN_PROFILE("RenderUtilPrivate::UpdateRenderingEntities");
+  // Poses of sleeping models and links don't change, so they can be skipped.
+  // Nothing sleeps unless physics has sleeping enabled.
+  const bool checkSleeping =
+      _ecm.HasComponentType(components::Sleeping::typeId);
   _ecm.Each<components::Model, components::Pose>(
       [&](const Entity &_entity,
         const components::Model *,
         const components::Pose *_pose)->bool
       {
-        this->entityPoses[_entity] = _pose->Data();
+        if (!checkSleeping || !isSleeping(_entity, _ecm))
+          this->entityPoses[_entity] = _pose->Data();
         return true;
       });
 
@@ -2161,7 +2169,8 @@ void RenderUtilPrivate::UpdateRenderingEntities(
         const components::Link *,
         const components::Pose *_pose)->bool
       {
-        this->entityPoses[_entity] = _pose->Data();
+        if (!checkSleeping || !isSleeping(_entity, _ecm))
+          this->entityPoses[_entity] = _pose->Data();
         return true;
       });
 
@@ -3647,6 +3656,14 @@ void RenderUtilPrivate::CreateVisual(
     const components::VisibilityFlags *_visibilityFlags,
     const components::ParentEntity *_parent)
 {
+  // Start decoding the mesh now, the rendering thread will need it soon
+  auto meshSdf = _geom->Data().MeshShape();
+  if (_geom->Data().Type() == sdf::GeometryType::MESH && nullptr != meshSdf)
+  {
+    MeshPrefetcher::Instance().Prefetch(
+        asFullPath(meshSdf->Uri(), meshSdf->FilePath()));
+  }
+
   sdf::Visual visual;
   visual.SetName(_name->Data());
   visual.SetRawPose(_pose->Data());
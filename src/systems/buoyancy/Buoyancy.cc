@@ -19,6 +19,7 @@
 #include <map>
 #include <mutex>
 #include <string>
+#include <tuple>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -39,6 +40,7 @@
 
 #include "ignition/gazebo/components/CenterOfVolume.hh"
 #include "ignition/gazebo/components/Collision.hh"
+#include "ignition/gazebo/components/ExternalWorldWrenchCmd.hh"
 #include "ignition/gazebo/components/Gravity.hh"
 #include "ignition/gazebo/components/Inertial.hh"
 #include "ignition/gazebo/components/Link.hh"
@@ -136,6 +138,84 @@ class ignition::gazebo::systems::BuoyancyPrivate
   /// \brief Scoped names of entities that buoyancy should apply to. If empty,
   /// all links will receive buoyancy.
   public: std::unordered_set<std::string> enabled;
+
+  /// \brief Rebuild the buoyant link arrays if the structure of the ECM
+  /// changed since they were last built. Creates world pose components on
+  /// buoyant links so their poses don't need to be computed every step.
+  /// \param[in] _ecm Mutable reference to the ECM.
+  public: void UpdateBuoyantLinks(EntityComponentManager &_ecm);
+
+  /// \brief Compute buoyancy wrenches for all links with a uniform fluid.
+  /// \param[in] _gravity Gravity acceleration in the world frame.
+  public: void ComputeUniformBuoyancy(const math::Vector3d &_gravity);
+
+  /// \brief Compute buoyancy wrenches for all links with graded fluid layers.
+  /// \param[in] _gravity Gravity acceleration in the world frame.
+  public: void ComputeGradedBuoyancy(const math::Vector3d &_gravity);
+
+  /// \brief Add the computed wrenches to the links.
+  /// \param[in] _ecm Mutable reference to the ECM.
+  public: void ApplyWrenches(EntityComponentManager &_ecm);
+
+  /// \brief Collision shape used by graded buoyancy.
+  public: struct GradedShape
+  {
+    /// \brief Geometry type, either box or sphere.
+    sdf::GeometryType type{sdf::GeometryType::EMPTY};
+
+    /// \brief Box shape, if type is box.
+    math::Boxd box;
+
+    /// \brief Sphere shape, if type is sphere.
+    math::Sphered sphere;
+
+    /// \brief Pose of the collision relative to its link.
+    const components::Pose *pose{nullptr};
+  };
+
+  /// \brief Links that have a volume and center of volume, stored as parallel
+  /// arrays so that all of their wrenches can be computed in a single pass
+  /// without component lookups.
+  public: struct BuoyantLinks
+  {
+    /// \brief Link entities.
+    std::vector<Entity> entities;
+
+    /// \brief Volume components.
+    std::vector<const components::Volume *> volumes;
+
+    /// \brief Center of volume components.
+    std::vector<const components::CenterOfVolume *> centersOfVolume;
+
+    /// \brief World pose components.
+    std::vector<const components::WorldPose *> poses;
+
+    /// \brief Wrench components, null until created.
+    std::vector<components::ExternalWorldWrenchCmd *> wrenches;
+
+    /// \brief Graded buoyancy only: the shapes of link i are in the range
+    /// [shapeOffsets[i], shapeOffsets[i + 1]) of shapes.
+    std::vector<std::size_t> shapeOffsets;
+
+    /// \brief Graded buoyancy only: collision shapes of all links.
+    std::vector<GradedShape> shapes;
+
+    /// \brief Scratch: forces to apply, in the world frame.
+    std::vector<math::Vector3d> forces;
+
+    /// \brief Scratch: torques to apply, in the world frame.
+    std::vector<math::Vector3d> torques;
+  };
+
+  /// \brief Buoyant links.
+  public: BuoyantLinks links;
+
+  /// \brief ECM structure version the links were built for.
+  /// \sa EntityComponentManager::StructureVersion
+  public: uint64_t linksVersion{0};
+
+  /// \brief Whether the links have been built.
+  public: bool linksValid{false};
 };
 
 //////////////////////////////////////////////////
@@ -245,6 +325,183 @@ std::pair<math::Vector3d, math::Vector3d> BuoyancyPrivate::ResolveForces(
   return {force, torque};
 }
 
+//////////////////////////////////////////////////
+void BuoyancyPrivate::UpdateBuoyantLinks(EntityComponentManager &_ecm)
+{
+  if (this->linksValid && this->linksVersion == _ecm.StructureVersion())
+    return;
+
+  IGN_PROFILE("BuoyancyPrivate::UpdateBuoyantLinks");
+
+  std::vector<Entity> entities;
+  _ecm.Each<components::Link, components::Volume, components::CenterOfVolume>(
+      [&](const Entity &_entity, const components::Link *,
+          const components::Volume *, const components::CenterOfVolume *)
+      {
+        entities.push_back(_entity);
+        return true;
+      });
+
+  // Initialize world poses, which are then kept up to date by physics
+  for (const auto entity : entities)
+  {
+    if (!_ecm.Component<components::WorldPose>(entity))
+    {
+      _ecm.CreateComponent(entity,
+          components::WorldPose(worldPose(entity, _ecm)));
+    }
+  }
+
+  auto &l = this->links;
+  l.entities = std::move(entities);
+  l.volumes.clear();
+  l.centersOfVolume.clear();
+  l.poses.clear();
+  l.wrenches.clear();
+  l.shapeOffsets.clear();
+  l.shapes.clear();
+
+  for (const auto entity : l.entities)
+  {
+    l.volumes.push_back(_ecm.Component<components::Volume>(entity));
+    l.centersOfVolume.push_back(
+        _ecm.Component<components::CenterOfVolume>(entity));
+    l.poses.push_back(_ecm.Component<components::WorldPose>(entity));
+    l.wrenches.push_back(
+        _ecm.Component<components::ExternalWorldWrenchCmd>(entity));
+
+    if (this->buoyancyType != BuoyancyType::GRADED_BUOYANCY)
+      continue;
+
+    l.shapeOffsets.push_back(l.shapes.size());
+    for (const auto collision :
+        _ecm.ChildrenByComponents(entity, components::Collision()))
+    {
+      const components::CollisionElement *coll =
+        _ecm.Component<components::CollisionElement>(collision);
+
+      if (!coll)
+      {
+        ignerr << "Invalid collision pointer. This shouldn't happen\n";
+        continue;
+      }
+
+      GradedShape shape;
+      shape.type = coll->Data().Geom()->Type();
+      shape.pose = _ecm.Component<components::Pose>(collision);
+      switch (shape.type)
+      {
+        case sdf::GeometryType::BOX:
+          shape.box = coll->Data().Geom()->BoxShape()->Shape();
+          break;
+        case sdf::GeometryType::SPHERE:
+          shape.sphere = coll->Data().Geom()->SphereShape()->Shape();
+          break;
+        default:
+        {
+          static bool warned{false};
+          if (!warned)
+          {
+            ignwarn << "Only <box> and <sphere> collisions are supported "
+              << "by the graded buoyancy option." << std::endl;
+            warned = true;
+          }
+          continue;
+        }
+      }
+      if (shape.pose)
+        l.shapes.push_back(shape);
+    }
+  }
+  if (this->buoyancyType == BuoyancyType::GRADED_BUOYANCY)
+    l.shapeOffsets.push_back(l.shapes.size());
+
+  this->linksVersion = _ecm.StructureVersion();
+  this->linksValid = true;
+}
+
+//////////////////////////////////////////////////
+void BuoyancyPrivate::ComputeUniformBuoyancy(const math::Vector3d &_gravity)
+{
+  auto &l = this->links;
+  const auto count = l.entities.size();
+  l.forces.resize(count);
+  l.torques.resize(count);
+
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const auto &linkWorldPose = l.poses[i]->Data();
+
+    // By Archimedes' principle,
+    // buoyancy = -(mass*gravity)*fluid_density/object_density
+    // object_density = mass/volume, so the mass term cancels.
+    l.forces[i] = -this->UniformFluidDensity(linkWorldPose) *
+        l.volumes[i]->Data() * _gravity;
+
+    // Convert the center of volume to the world frame
+    const math::Vector3d offsetWorld = linkWorldPose.Rot().RotateVector(
+        l.centersOfVolume[i]->Data());
+
+    // Compute the torque that should be applied due to buoyancy and
+    // the center of volume.
+    l.torques[i] = offsetWorld.Cross(l.forces[i]);
+  }
+}
+
+//////////////////////////////////////////////////
+void BuoyancyPrivate::ComputeGradedBuoyancy(const math::Vector3d &_gravity)
+{
+  auto &l = this->links;
+  const auto count = l.entities.size();
+  l.forces.resize(count);
+  l.torques.resize(count);
+
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const auto &linkWorldPose = l.poses[i]->Data();
+
+    this->buoyancyForces.clear();
+    for (auto s = l.shapeOffsets[i]; s < l.shapeOffsets[i + 1]; ++s)
+    {
+      const auto &shape = l.shapes[s];
+      const auto pose = linkWorldPose * shape.pose->Data();
+      if (shape.type == sdf::GeometryType::BOX)
+        this->GradedFluidDensity<math::Boxd>(pose, shape.box, _gravity);
+      else
+        this->GradedFluidDensity<math::Sphered>(pose, shape.sphere, _gravity);
+    }
+
+    std::tie(l.forces[i], l.torques[i]) = this->ResolveForces(linkWorldPose);
+  }
+}
+
+//////////////////////////////////////////////////
+void BuoyancyPrivate::ApplyWrenches(EntityComponentManager &_ecm)
+{
+  auto &l = this->links;
+  for (std::size_t i = 0; i < l.entities.size(); ++i)
+  {
+    // Apply the wrench to the link. This wrench is applied in the
+    // Physics System.
+    auto *wrenchComp = l.wrenches[i];
+    if (!wrenchComp)
+    {
+      // The new component changes the ECM structure, so the links will be
+      // rebuilt with a pointer to it on the next update
+      components::ExternalWorldWrenchCmd wrench;
+      msgs::Set(wrench.Data().mutable_force(), l.forces[i]);
+      msgs::Set(wrench.Data().mutable_torque(), l.torques[i]);
+      _ecm.CreateComponent(l.entities[i], wrench);
+      continue;
+    }
+
+    msgs::Set(wrenchComp->Data().mutable_force(),
+              msgs::Convert(wrenchComp->Data().force()) + l.forces[i]);
+    msgs::Set(wrenchComp->Data().mutable_torque(),
+              msgs::Convert(wrenchComp->Data().torque()) + l.torques[i]);
+  }
+}
+
 //////////////////////////////////////////////////
 Buoyancy::Buoyancy()
   : dataPtr(std::make_unique<BuoyancyPrivate>())
@@ -456,96 +713,20 @@ void Buoyancy::PreUpdate(const ignition::gazebo::UpdateInfo &_info,
   if (_info.paused)
     return;
 
-  _ecm.Each<components::Link,
-            components::Volume,
-            components::CenterOfVolume>(
-      [&](const Entity &_entity,
-          const components::Link *,
-          const components::Volume *_volume,
-          const components::CenterOfVolume *_centerOfVolume) -> bool
-    {
-      // World pose of the link.
-      math::Pose3d linkWorldPose = worldPose(_entity, _ecm);
-
-      Link link(_entity);
-
-      math::Vector3d buoyancy;
-      // By Archimedes' principle,
-      // buoyancy = -(mass*gravity)*fluid_density/object_density
-      // object_density = mass/volume, so the mass term cancels.
-      if (this->dataPtr->buoyancyType
-        == BuoyancyPrivate::BuoyancyType::UNIFORM_BUOYANCY)
-      {
-        buoyancy =
-        -this->dataPtr->UniformFluidDensity(linkWorldPose) *
-        _volume->Data() * gravity->Data();
-
-        // Convert the center of volume to the world frame
-        math::Vector3d offsetWorld = linkWorldPose.Rot().RotateVector(
-            _centerOfVolume->Data());
-        // Compute the torque that should be applied due to buoyancy and
-        // the center of volume.
-        math::Vector3d torque = offsetWorld.Cross(buoyancy);
-
-        // Apply the wrench to the link. This wrench is applied in the
-        // Physics System.
-        link.AddWorldWrench(_ecm, buoyancy, torque);
-      }
-      else if (this->dataPtr->buoyancyType
-        == BuoyancyPrivate::BuoyancyType::GRADED_BUOYANCY)
-      {
-        std::vector<Entity> collisions = _ecm.ChildrenByComponents(
-          _entity, components::Collision());
-        this->dataPtr->buoyancyForces.clear();
-
-        for (auto e : collisions)
-        {
-          const components::CollisionElement *coll =
-            _ecm.Component<components::CollisionElement>(e);
-
-          auto pose = worldPose(e, _ecm);
+  this->dataPtr->UpdateBuoyantLinks(_ecm);
 
-          if (!coll)
-          {
-            ignerr << "Invalid collision pointer. This shouldn't happen\n";
-            continue;
-          }
-
-          switch (coll->Data().Geom()->Type())
-          {
-            case sdf::GeometryType::BOX:
-              this->dataPtr->GradedFluidDensity<math::Boxd>(
-                pose,
-                coll->Data().Geom()->BoxShape()->Shape(),
-                gravity->Data());
-              break;
-            case sdf::GeometryType::SPHERE:
-              this->dataPtr->GradedFluidDensity<math::Sphered>(
-                pose,
-                coll->Data().Geom()->SphereShape()->Shape(),
-                gravity->Data());
-              break;
-            default:
-            {
-              static bool warned{false};
-              if (!warned)
-              {
-                ignwarn << "Only <box> and <sphere> collisions are supported "
-                  << "by the graded buoyancy option." << std::endl;
-                warned = true;
-              }
-              break;
-            }
-          }
-        }
-        auto [force, torque] = this->dataPtr->ResolveForces(linkWorldPose);
-        // Apply the wrench to the link. This wrench is applied in the
-        // Physics System.
-        link.AddWorldWrench(_ecm, force, torque);
-      }
+  if (this->dataPtr->buoyancyType
+    == BuoyancyPrivate::BuoyancyType::UNIFORM_BUOYANCY)
+  {
+    this->dataPtr->ComputeUniformBuoyancy(gravity->Data());
+  }
+  else if (this->dataPtr->buoyancyType
+    == BuoyancyPrivate::BuoyancyType::GRADED_BUOYANCY)
+  {
+    this->dataPtr->ComputeGradedBuoyancy(gravity->Data());
+  }
 
-      return true;
-  });
+  this->dataPtr->ApplyWrenches(_ecm);
 }
 
 //////////////////////////////////////////////////
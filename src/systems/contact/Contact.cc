@@ -37,6 +37,7 @@
 #include "ignition/gazebo/Util.hh"
 #include "ignition/gazebo/components/Collision.hh"
 #include "ignition/gazebo/components/ContactSensor.hh"
+#include "ignition/gazebo/components/ContactSensorBuffer.hh"
 #include "ignition/gazebo/components/ContactSensorData.hh"
 #include "ignition/gazebo/components/Link.hh"
 #include "ignition/gazebo/components/Name.hh"
@@ -62,6 +63,12 @@ class ContactSensor
   public: void AddContacts(const std::chrono::steady_clock::duration &_stamp,
                            const msgs::Contacts &_contacts);
 
+  /// \brief Add contacts to the list to be published
+  /// \param[in] _stamp Time stamp of the sensor measurement
+  /// \param[in] _contacts Contacts to be added to the list
+  public: void AddContacts(const std::chrono::steady_clock::duration &_stamp,
+                           const ContactBuffer &_contacts);
+
   /// \brief Publish sensor data over ign transport
   public: void Publish();
 
@@ -100,6 +107,10 @@ class ignition::gazebo::systems::ContactPrivate
   /// \brief A map of Contact entity to its Contact sensor.
   public: std::unordered_map<Entity,
       std::unique_ptr<ContactSensor>> entitySensorMap;
+
+  /// \brief Whether to create ContactSensorBuffer components instead of
+  /// ContactSensorData.
+  public: bool useContactBuffer{false};
 };
 
 //////////////////////////////////////////////////
@@ -142,6 +153,23 @@ void ContactSensor::AddContacts(
   this->contactsMsg.mutable_header()->mutable_stamp()->CopyFrom(stamp);
 }
 
+//////////////////////////////////////////////////
+void ContactSensor::AddContacts(
+    const std::chrono::steady_clock::duration &_stamp,
+    const ContactBuffer &_contacts)
+{
+  auto stamp = convert<msgs::Time>(_stamp);
+  const int first = this->contactsMsg.contact_size();
+  _contacts.AddToMsg(this->contactsMsg);
+  for (int i = first; i < this->contactsMsg.contact_size(); ++i)
+  {
+    this->contactsMsg.mutable_contact(i)->mutable_header()->mutable_stamp()
+        ->CopyFrom(stamp);
+  }
+
+  this->contactsMsg.mutable_header()->mutable_stamp()->CopyFrom(stamp);
+}
+
 //////////////////////////////////////////////////
 void ContactSensor::Publish()
 {
@@ -195,8 +223,16 @@ void ContactPrivate::CreateSensors(EntityComponentManager &_ecm)
             collisionEntities.push_back(childEntities.front());
 
             // Create component to be filled by physics.
-            _ecm.CreateComponent(childEntities.front(),
-                                 components::ContactSensorData());
+            if (this->useContactBuffer)
+            {
+              _ecm.CreateComponent(childEntities.front(),
+                                   components::ContactSensorBuffer());
+            }
+            else
+            {
+              _ecm.CreateComponent(childEntities.front(),
+                                   components::ContactSensorData());
+            }
           }
         }
 
@@ -220,10 +256,22 @@ void ContactPrivate::UpdateSensors(const UpdateInfo &_info,
   {
     for (const Entity &entity : item.second->collisionEntities)
     {
-      auto contacts = _ecm.Component<components::ContactSensorData>(entity);
-
-      // We will assume that the ContactData component will have been created if
+      // We will assume that the contact component will have been created if
       // this entity is in the collisionEntities list
+      if (this->useContactBuffer)
+      {
+        auto contacts =
+            _ecm.Component<components::ContactSensorBuffer>(entity);
+
+        // Messages are only built for collisions that are in contact.
+        if (!contacts->Data().Empty())
+        {
+          item.second->AddContacts(_info.simTime, contacts->Data());
+        }
+        continue;
+      }
+
+      auto contacts = _ecm.Component<components::ContactSensorData>(entity);
       if (contacts->Data().contact_size() > 0)
       {
         item.second->AddContacts(_info.simTime, contacts->Data());
@@ -259,6 +307,17 @@ Contact::Contact() : System(), dataPtr(std::make_unique<ContactPrivate>())
 {
 }
 
+//////////////////////////////////////////////////
+void Contact::Configure(const Entity &,
+    const std::shared_ptr<const sdf::Element> &_sdf,
+    EntityComponentManager &, EventManager &)
+{
+  if (_sdf->HasElement("use_contact_buffer"))
+  {
+    this->dataPtr->useContactBuffer = _sdf->Get<bool>("use_contact_buffer");
+  }
+}
+
 //////////////////////////////////////////////////
 void Contact::PreUpdate(const UpdateInfo &, EntityComponentManager &_ecm)
 {
@@ -295,6 +354,7 @@ void Contact::PostUpdate(const UpdateInfo &_info,
 }
 
 IGNITION_ADD_PLUGIN(Contact, System,
+  Contact::ISystemConfigure,
   Contact::ISystemPreUpdate,
   Contact::ISystemPostUpdate
 )
@@ -36,8 +36,17 @@ namespace systems
   **/
   /// \brief Contact sensor system which manages all contact sensors in
   /// simulation
+  ///
+  /// ## System Parameters
+  ///
+  /// `<use_contact_buffer>`: If true, the collisions of contact sensors get
+  /// a components::ContactSensorBuffer, which is cheaper for physics to fill,
+  /// instead of a components::ContactSensorData. Systems reading
+  /// ContactSensorData won't see contacts from these sensors then.
+  /// Defaults to false.
   class Contact :
     public System,
+    public ISystemConfigure,
     public ISystemPreUpdate,
     public ISystemPostUpdate
   {
@@ -47,6 +56,12 @@ namespace systems
     /// \brief Destructor
     public: ~Contact() final = default;
 
+    /// Documentation inherited
+    public: void Configure(const Entity &_entity,
+                           const std::shared_ptr<const sdf::Element> &_sdf,
+                           EntityComponentManager &_ecm,
+                           EventManager &_eventMgr) final;
+
     /// Documentation inherited
     public: void PreUpdate(const UpdateInfo &_info,
                            EntityComponentManager &_ecm) final;
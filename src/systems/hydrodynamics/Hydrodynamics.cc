@@ -14,6 +14,7 @@
  * limitations under the License.
  *
  */
+#include <cmath>
 #include <string>
 
 #include <Eigen/Eigen>
@@ -21,8 +22,10 @@
 #include <ignition/plugin/Register.hh>
 
 #include "ignition/msgs/vector3d.pb.h"
+#include "ignition/msgs/Utility.hh"
 
 #include "ignition/gazebo/components/AngularVelocity.hh"
+#include "ignition/gazebo/components/ExternalWorldWrenchCmd.hh"
 #include "ignition/gazebo/components/LinearVelocity.hh"
 #include "ignition/gazebo/components/Pose.hh"
 #include "ignition/gazebo/components/World.hh"
@@ -39,6 +42,12 @@ using namespace ignition;
 using namespace gazebo;
 using namespace systems;
 
+/// \brief 6 DOF vector, fixed size so that it lives on the stack.
+using Vector6d = Eigen::Matrix<double, 6, 1>;
+
+/// \brief 6x6 matrix, fixed size so that it lives on the stack.
+using Matrix6d = Eigen::Matrix<double, 6, 6>;
+
 /// \brief Private Hydrodynamics data class.
 class ignition::gazebo::systems::HydrodynamicsPrivateData
 {
@@ -108,14 +117,38 @@ class ignition::gazebo::systems::HydrodynamicsPrivateData
 
   /// \brief Added mass of vehicle;
   /// See: https://en.wikipedia.org/wiki/Added_mass
-  public: Eigen::MatrixXd Ma;
+  public: Matrix6d Ma{Matrix6d::Zero()};
 
   /// \brief Previous state.
-  public: Eigen::VectorXd prevState;
+  public: Vector6d prevState{Vector6d::Zero()};
 
   /// \brief Link entity
   public: Entity linkEntity;
 
+  /// \brief Update the cached link components if the structure of the ECM
+  /// changed since they were last looked up.
+  /// \param[in] _ecm Immutable reference to the ECM.
+  public: void UpdateLinkComponents(const EntityComponentManager &_ecm);
+
+  /// \brief World pose of the link.
+  public: const components::WorldPose *worldPose{nullptr};
+
+  /// \brief World linear velocity of the link.
+  public: const components::WorldLinearVelocity *worldLinearVel{nullptr};
+
+  /// \brief World angular velocity of the link.
+  public: const components::WorldAngularVelocity *worldAngularVel{nullptr};
+
+  /// \brief Wrench applied to the link, null until created.
+  public: components::ExternalWorldWrenchCmd *wrench{nullptr};
+
+  /// \brief ECM structure version the cached components were looked up for.
+  /// \sa EntityComponentManager::StructureVersion
+  public: uint64_t componentsVersion{0};
+
+  /// \brief Whether the cached components have been looked up.
+  public: bool componentsValid{false};
+
   /// \brief Ocean current callback
   public: void UpdateCurrent(const msgs::Vector3d &_msg);
 
@@ -130,6 +163,28 @@ void HydrodynamicsPrivateData::UpdateCurrent(const msgs::Vector3d &_msg)
   this->currentVector = ignition::msgs::Convert(_msg);
 }
 
+/////////////////////////////////////////////////
+void HydrodynamicsPrivateData::UpdateLinkComponents(
+    const EntityComponentManager &_ecm)
+{
+  if (this->componentsValid &&
+      this->componentsVersion == _ecm.StructureVersion())
+  {
+    return;
+  }
+
+  this->worldPose = _ecm.Component<components::WorldPose>(this->linkEntity);
+  this->worldLinearVel =
+    _ecm.Component<components::WorldLinearVelocity>(this->linkEntity);
+  this->worldAngularVel =
+    _ecm.Component<components::WorldAngularVelocity>(this->linkEntity);
+  this->wrench =
+    _ecm.Component<components::ExternalWorldWrenchCmd>(this->linkEntity);
+
+  this->componentsVersion = _ecm.StructureVersion();
+  this->componentsValid = true;
+}
+
 /////////////////////////////////////////////////
 void AddAngularVelocityComponent(
   const ignition::gazebo::Entity &_entity,
@@ -268,7 +323,7 @@ void Hydrodynamics::Configure(
     this->dataPtr->currentVector = _sdf->Get<math::Vector3d>("default_current");
   }
 
-  this->dataPtr->prevState = Eigen::VectorXd::Zero(6);
+  this->dataPtr->prevState = Vector6d::Zero();
 
   AddWorldPose(this->dataPtr->linkEntity, _ecm);
   AddAngularVelocityComponent(this->dataPtr->linkEntity, _ecm);
@@ -276,7 +331,7 @@ void Hydrodynamics::Configure(
 
 
   // Added mass according to Fossen's equations (p 37)
-  this->dataPtr->Ma = Eigen::MatrixXd::Zero(6, 6);
+  this->dataPtr->Ma = Matrix6d::Zero();
 
   this->dataPtr->Ma(0, 0) = this->dataPtr->paramXdotU;
   this->dataPtr->Ma(1, 1) = this->dataPtr->paramYdotV;
@@ -301,16 +356,17 @@ void Hydrodynamics::PreUpdate(
   // `Cmat` corresponds to the Centripetal matrix
   // `Dmat` is the drag matrix
   // `Ma` is the added mass.
-  Eigen::VectorXd stateDot = Eigen::VectorXd(6);
-  Eigen::VectorXd state    = Eigen::VectorXd(6);
-  Eigen::MatrixXd Cmat     = Eigen::MatrixXd::Zero(6, 6);
-  Eigen::MatrixXd Dmat     = Eigen::MatrixXd::Zero(6, 6);
+  // All of these are fixed size, so no memory is allocated in the loop.
+  Vector6d stateDot;
+  Vector6d state;
+  Matrix6d Cmat = Matrix6d::Zero();
+  Matrix6d Dmat = Matrix6d::Zero();
 
   // Get vehicle state
-  ignition::gazebo::Link baseLink(this->dataPtr->linkEntity);
-  auto linearVelocity =
-    _ecm.Component<components::WorldLinearVelocity>(this->dataPtr->linkEntity);
-  auto rotationalVelocity = baseLink.WorldAngularVelocity(_ecm);
+  this->dataPtr->UpdateLinkComponents(_ecm);
+  auto linearVelocity = this->dataPtr->worldLinearVel;
+  auto rotationalVelocity = this->dataPtr->worldAngularVel;
+  auto worldPose = this->dataPtr->worldPose;
 
   if (!linearVelocity)
   {
@@ -318,6 +374,9 @@ void Hydrodynamics::PreUpdate(
     return;
   }
 
+  if (!rotationalVelocity || !worldPose)
+    return;
+
   // Get current vector
   math::Vector3d currentVector;
   {
@@ -325,12 +384,13 @@ void Hydrodynamics::PreUpdate(
     currentVector = this->dataPtr->currentVector;
   }
   // Transform state to local frame
-  auto pose = baseLink.WorldPose(_ecm);
+  const auto &pose = worldPose->Data();
   // Since we are transforming angular and linear velocity we only care about
   // rotation
-  auto localLinearVelocity = pose->Rot().Inverse() *
+  auto localLinearVelocity = pose.Rot().Inverse() *
     (linearVelocity->Data() - currentVector);
-  auto localRotationalVelocity = pose->Rot().Inverse() * *rotationalVelocity;
+  auto localRotationalVelocity =
+    pose.Rot().Inverse() * rotationalVelocity->Data();
 
   state(0) = localLinearVelocity.X();
   state(1) = localLinearVelocity.Y();
@@ -346,7 +406,7 @@ void Hydrodynamics::PreUpdate(
   this->dataPtr->prevState = state;
 
   // The added mass
-  const Eigen::VectorXd kAmassVec = this->dataPtr->Ma * stateDot;
+  const Vector6d kAmassVec = this->dataPtr->Ma * stateDot;
 
   // Coriolis and Centripetal forces for under water vehicles (Fossen P. 37)
   // Note: this is significantly different from VRX because we need to account
@@ -369,35 +429,48 @@ void Hydrodynamics::PreUpdate(
   Cmat(5, 1) =   this->dataPtr->paramXdotU * state(0);
   Cmat(5, 3) = - this->dataPtr->paramMdotQ * state(4);
   Cmat(5, 4) =   this->dataPtr->paramKdotP * state(3);
-  const Eigen::VectorXd kCmatVec = - Cmat * state;
+  const Vector6d kCmatVec = - Cmat * state;
 
   // Damping forces (Fossen P. 43)
   Dmat(1, 1)
-    = - this->dataPtr->paramYv - this->dataPtr->paramYvv * abs(state(1));
+    = - this->dataPtr->paramYv - this->dataPtr->paramYvv * std::abs(state(1));
   Dmat(0, 0)
-    = - this->dataPtr->paramXu - this->dataPtr->paramXuu * abs(state(0));
+    = - this->dataPtr->paramXu - this->dataPtr->paramXuu * std::abs(state(0));
   Dmat(2, 2)
-    = - this->dataPtr->paramZw - this->dataPtr->paramZww * abs(state(2));
+    = - this->dataPtr->paramZw - this->dataPtr->paramZww * std::abs(state(2));
   Dmat(3, 3)
-    = - this->dataPtr->paramKp - this->dataPtr->paramKpp * abs(state(3));
+    = - this->dataPtr->paramKp - this->dataPtr->paramKpp * std::abs(state(3));
   Dmat(4, 4)
-    = - this->dataPtr->paramMq - this->dataPtr->paramMqq * abs(state(4));
+    = - this->dataPtr->paramMq - this->dataPtr->paramMqq * std::abs(state(4));
   Dmat(5, 5)
-    = - this->dataPtr->paramNr - this->dataPtr->paramNrr * abs(state(5));
+    = - this->dataPtr->paramNr - this->dataPtr->paramNrr * std::abs(state(5));
 
-  const Eigen::VectorXd kDvec = Dmat * state;
+  const Vector6d kDvec = Dmat * state;
 
-  const Eigen::VectorXd kTotalWrench = kAmassVec + kDvec + kCmatVec;
+  const Vector6d kTotalWrench = kAmassVec + kDvec + kCmatVec;
 
   ignition::math::Vector3d
     totalForce(-kTotalWrench(0), -kTotalWrench(1), -kTotalWrench(2));
   ignition::math::Vector3d
     totalTorque(-kTotalWrench(3), -kTotalWrench(4), -kTotalWrench(5));
 
-  baseLink.AddWorldWrench(
-    _ecm,
-    pose->Rot()*(totalForce),
-    pose->Rot()*totalTorque);
+  // Add to the wrench component directly, avoiding the lookups done by
+  // Link::AddWorldWrench
+  if (!this->dataPtr->wrench)
+  {
+    ignition::gazebo::Link baseLink(this->dataPtr->linkEntity);
+    baseLink.AddWorldWrench(
+      _ecm,
+      pose.Rot()*(totalForce),
+      pose.Rot()*totalTorque);
+    return;
+  }
+
+  auto &wrenchMsg = this->dataPtr->wrench->Data();
+  msgs::Set(wrenchMsg.mutable_force(),
+    msgs::Convert(wrenchMsg.force()) + pose.Rot()*(totalForce));
+  msgs::Set(wrenchMsg.mutable_torque(),
+    msgs::Convert(wrenchMsg.torque()) + pose.Rot()*totalTorque);
 }
 
 IGNITION_ADD_PLUGIN(
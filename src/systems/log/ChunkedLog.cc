@@ -0,0 +1,407 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "ChunkedLog.hh"
+
+#include <zlib.h>
+
+#ifdef _WIN32
+  #include <io.h>
+#else
+  #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Profiler.hh>
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+
+/// \brief Magic string at the start of the file.
+static const char kFileMagic[] = "IGNCLOG1";
+
+/// \brief Magic string at the start of each chunk.
+static const char kChunkMagic[] = "CHNK";
+
+/// \brief Size of the file magic.
+static constexpr std::size_t kFileMagicSize{8};
+
+/// \brief Size of a chunk header: magic, compressed size, size, message
+/// count, checksum, start time and end time.
+static constexpr std::size_t kChunkHeaderSize{4 + 4 * 4 + 2 * 8};
+
+/// \brief Size of a message header: time and the sizes of the topic, type
+/// and data.
+static constexpr std::size_t kMessageHeaderSize{8 + 3 * 4};
+
+//////////////////////////////////////////////////
+/// \brief Append an integer in little-endian order.
+/// \param[in, out] _out String to append to.
+/// \param[in] _value Value.
+template<typename T>
+static void appendInt(std::string &_out, T _value)
+{
+  auto value = static_cast<uint64_t>(_value);
+  for (std::size_t i = 0; i < sizeof(T); ++i)
+    _out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+//////////////////////////////////////////////////
+/// \brief Read an integer stored in little-endian order.
+/// \param[in] _in Pointer to the first byte.
+/// \return Value.
+template<typename T>
+static T readInt(const char *_in)
+{
+  uint64_t value{0};
+  for (std::size_t i = 0; i < sizeof(T); ++i)
+  {
+    value |= static_cast<uint64_t>(static_cast<unsigned char>(_in[i]))
+        << (8 * i);
+  }
+  return static_cast<T>(value);
+}
+
+//////////////////////////////////////////////////
+ChunkedLogWriter::ChunkedLogWriter(std::size_t _maxMessages,
+    std::size_t _maxBytes)
+  : maxMessages(std::max<std::size_t>(_maxMessages, 1u)),
+    maxBytes(std::max<std::size_t>(_maxBytes, 1u))
+{
+}
+
+//////////////////////////////////////////////////
+ChunkedLogWriter::~ChunkedLogWriter()
+{
+  this->Close();
+}
+
+//////////////////////////////////////////////////
+bool ChunkedLogWriter::Open(const std::string &_path)
+{
+  this->Close();
+
+  this->file = std::fopen(_path.c_str(), "wb");
+  if (nullptr == this->file)
+  {
+    ignerr << "Failed to create chunked log [" << _path << "]." << std::endl;
+    return false;
+  }
+
+  if (std::fwrite(kFileMagic, 1, kFileMagicSize, this->file) !=
+      kFileMagicSize)
+  {
+    ignerr << "Failed to write to chunked log [" << _path << "]."
+           << std::endl;
+    std::fclose(this->file);
+    this->file = nullptr;
+    return false;
+  }
+
+  this->payload.clear();
+  this->messageCount = 0;
+  this->chunkCount = 0;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool ChunkedLogWriter::Write(const std::chrono::nanoseconds &_time,
+    const std::string &_topic, const std::string &_type,
+    const std::string &_data)
+{
+  if (nullptr == this->file)
+    return false;
+
+  if (this->messageCount == 0)
+    this->startTime = _time;
+  this->endTime = _time;
+
+  appendInt<int64_t>(this->payload, _time.count());
+  appendInt<uint32_t>(this->payload, _topic.size());
+  appendInt<uint32_t>(this->payload, _type.size());
+  appendInt<uint32_t>(this->payload, _data.size());
+  this->payload += _topic;
+  this->payload += _type;
+  this->payload += _data;
+  ++this->messageCount;
+
+  if (this->messageCount >= this->maxMessages ||
+      this->payload.size() >= this->maxBytes)
+  {
+    return this->Flush();
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool ChunkedLogWriter::Flush()
+{
+  if (nullptr == this->file || this->messageCount == 0)
+    return true;
+
+  IGN_PROFILE("ChunkedLogWriter::Flush");
+
+  // Fast compression, since this runs for the whole recording
+  uLongf compressedSize = compressBound(this->payload.size());
+  this->compressed.resize(compressedSize);
+  if (compress2(reinterpret_cast<Bytef *>(&this->compressed[0]),
+      &compressedSize, reinterpret_cast<const Bytef *>(this->payload.data()),
+      this->payload.size(), Z_BEST_SPEED) != Z_OK)
+  {
+    ignerr << "Failed to compress log chunk." << std::endl;
+    return false;
+  }
+  this->compressed.resize(compressedSize);
+
+  auto crc = crc32(0L, reinterpret_cast<const Bytef *>(
+      this->compressed.data()), this->compressed.size());
+
+  std::string header(kChunkMagic, 4);
+  appendInt<uint32_t>(header, this->compressed.size());
+  appendInt<uint32_t>(header, this->payload.size());
+  appendInt<uint32_t>(header, this->messageCount);
+  appendInt<uint32_t>(header, crc);
+  appendInt<int64_t>(header, this->startTime.count());
+  appendInt<int64_t>(header, this->endTime.count());
+
+  bool result =
+      std::fwrite(header.data(), 1, header.size(), this->file) ==
+          header.size() &&
+      std::fwrite(this->compressed.data(), 1, this->compressed.size(),
+          this->file) == this->compressed.size() &&
+      std::fflush(this->file) == 0;
+
+  // Make each chunk durable on its own
+#ifdef _WIN32
+  result = result && _commit(_fileno(this->file)) == 0;
+#else
+  result = result && fsync(fileno(this->file)) == 0;
+#endif
+
+  if (!result)
+    ignerr << "Failed to write log chunk." << std::endl;
+  else
+    ++this->chunkCount;
+
+  this->payload.clear();
+  this->messageCount = 0;
+  return result;
+}
+
+//////////////////////////////////////////////////
+void ChunkedLogWriter::Close()
+{
+  if (nullptr == this->file)
+    return;
+
+  this->Flush();
+  std::fclose(this->file);
+  this->file = nullptr;
+}
+
+//////////////////////////////////////////////////
+uint64_t ChunkedLogWriter::ChunkCount() const
+{
+  return this->chunkCount;
+}
+
+//////////////////////////////////////////////////
+bool ChunkedLogReader::Open(const std::string &_path)
+{
+  this->chunks.clear();
+  this->messages.clear();
+  this->cachedChunk = SIZE_MAX;
+
+  this->file = std::ifstream(_path, std::ios::binary);
+  if (!this->file)
+  {
+    ignerr << "Failed to open chunked log [" << _path << "]." << std::endl;
+    return false;
+  }
+
+  char magic[kFileMagicSize];
+  if (!this->file.read(magic, kFileMagicSize) ||
+      std::memcmp(magic, kFileMagic, kFileMagicSize) != 0)
+  {
+    ignerr << "File [" << _path << "] is not a chunked log." << std::endl;
+    return false;
+  }
+
+  this->file.seekg(0, std::ios::end);
+  const uint64_t fileSize = this->file.tellg();
+  uint64_t offset{kFileMagicSize};
+
+  // Only the headers are read, skipping over the payloads
+  char header[kChunkHeaderSize];
+  while (offset + kChunkHeaderSize <= fileSize)
+  {
+    this->file.seekg(offset);
+    if (!this->file.read(header, kChunkHeaderSize) ||
+        std::memcmp(header, kChunkMagic, 4) != 0)
+    {
+      ignwarn << "Invalid chunk at offset [" << offset << "] of ["
+              << _path << "]. Ignoring the rest of the log." << std::endl;
+      break;
+    }
+
+    Chunk chunk;
+    chunk.offset = offset + kChunkHeaderSize;
+    chunk.compressedSize = readInt<uint32_t>(header + 4);
+    chunk.size = readInt<uint32_t>(header + 8);
+    chunk.messageCount = readInt<uint32_t>(header + 12);
+    chunk.crc = readInt<uint32_t>(header + 16);
+    chunk.startTime = std::chrono::nanoseconds(readInt<int64_t>(header + 20));
+    chunk.endTime = std::chrono::nanoseconds(readInt<int64_t>(header + 28));
+
+    if (chunk.offset + chunk.compressedSize > fileSize)
+    {
+      ignwarn << "Truncated chunk at offset [" << offset << "] of ["
+              << _path << "], probably from an interrupted recording. "
+              << "Ignoring it." << std::endl;
+      break;
+    }
+
+    this->chunks.push_back(chunk);
+    offset = chunk.offset + chunk.compressedSize;
+  }
+
+  this->file.clear();
+  return true;
+}
+
+//////////////////////////////////////////////////
+std::chrono::nanoseconds ChunkedLogReader::StartTime() const
+{
+  if (this->chunks.empty())
+    return std::chrono::nanoseconds(0);
+  return this->chunks.front().startTime;
+}
+
+//////////////////////////////////////////////////
+std::chrono::nanoseconds ChunkedLogReader::EndTime() const
+{
+  if (this->chunks.empty())
+    return std::chrono::nanoseconds(0);
+  return this->chunks.back().endTime;
+}
+
+//////////////////////////////////////////////////
+std::size_t ChunkedLogReader::ChunkCount() const
+{
+  return this->chunks.size();
+}
+
+//////////////////////////////////////////////////
+bool ChunkedLogReader::Query(const std::chrono::nanoseconds &_start,
+    const std::chrono::nanoseconds &_end,
+    const std::function<bool(const ChunkedLogMessage &)> &_cb)
+{
+  // First chunk which may have messages at or after _start
+  auto it = std::lower_bound(this->chunks.begin(), this->chunks.end(),
+      _start, [](const Chunk &_chunk, const std::chrono::nanoseconds &_time)
+      {
+        return _chunk.endTime < _time;
+      });
+
+  for (; it != this->chunks.end() && it->startTime <= _end; ++it)
+  {
+    if (!this->LoadChunk(it - this->chunks.begin()))
+      return false;
+
+    for (const auto &msg : this->messages)
+    {
+      if (msg.time >= _start && msg.time <= _end && !_cb(msg))
+        return true;
+    }
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool ChunkedLogReader::LoadChunk(std::size_t _index)
+{
+  if (this->cachedChunk == _index)
+    return true;
+
+  IGN_PROFILE("ChunkedLogReader::LoadChunk");
+
+  const auto &chunk = this->chunks[_index];
+  std::string compressed(chunk.compressedSize, '\0');
+  this->file.seekg(chunk.offset);
+  if (!this->file.read(&compressed[0], chunk.compressedSize))
+  {
+    ignerr << "Failed to read log chunk [" << _index << "]." << std::endl;
+    this->file.clear();
+    return false;
+  }
+
+  auto crc = crc32(0L, reinterpret_cast<const Bytef *>(compressed.data()),
+      compressed.size());
+  if (crc != chunk.crc)
+  {
+    ignerr << "Log chunk [" << _index << "] is corrupted." << std::endl;
+    return false;
+  }
+
+  std::string payload(chunk.size, '\0');
+  uLongf size = chunk.size;
+  if (uncompress(reinterpret_cast<Bytef *>(&payload[0]), &size,
+      reinterpret_cast<const Bytef *>(compressed.data()),
+      compressed.size()) != Z_OK || size != chunk.size)
+  {
+    ignerr << "Failed to decompress log chunk [" << _index << "]."
+           << std::endl;
+    return false;
+  }
+
+  this->cachedChunk = SIZE_MAX;
+  this->messages.clear();
+  this->messages.reserve(chunk.messageCount);
+  std::size_t pos{0};
+  while (pos + kMessageHeaderSize <= payload.size())
+  {
+    const char *header = payload.data() + pos;
+    auto topicSize = readInt<uint32_t>(header + 8);
+    auto typeSize = readInt<uint32_t>(header + 12);
+    auto dataSize = readInt<uint32_t>(header + 16);
+    pos += kMessageHeaderSize;
+    if (pos + topicSize + typeSize + dataSize > payload.size())
+    {
+      ignerr << "Log chunk [" << _index << "] has a truncated message."
+             << std::endl;
+      return false;
+    }
+
+    ChunkedLogMessage msg;
+    msg.time = std::chrono::nanoseconds(readInt<int64_t>(header));
+    msg.topic = payload.substr(pos, topicSize);
+    pos += topicSize;
+    msg.type = payload.substr(pos, typeSize);
+    pos += typeSize;
+    msg.data = payload.substr(pos, dataSize);
+    pos += dataSize;
+    this->messages.push_back(std::move(msg));
+  }
+
+  this->cachedChunk = _index;
+  return true;
+}
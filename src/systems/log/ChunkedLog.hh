@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GAZEBO_SYSTEMS_CHUNKEDLOG_HH_
+#define IGNITION_GAZEBO_SYSTEMS_CHUNKEDLOG_HH_
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/log-system/Export.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems
+{
+  /// \brief File name of chunked state logs inside a log directory.
+  const std::string kChunkedLogFileName{"state.clog"};
+
+  /// \brief A message stored in a chunked log.
+  struct ChunkedLogMessage
+  {
+    /// \brief Time stamp.
+    std::chrono::nanoseconds time{0};
+
+    /// \brief Topic the message was recorded under.
+    std::string topic;
+
+    /// \brief Message type, such as ignition.msgs.SerializedStateMap.
+    std::string type;
+
+    /// \brief Serialized message.
+    std::string data;
+  };
+
+  /// \brief Writes an append-only chunked log.
+  ///
+  /// The file starts with a magic string, followed by chunks. Each chunk has
+  /// a fixed size header with the sizes, message count, time range and
+  /// checksum of its payload, followed by the zlib-compressed payload, which
+  /// holds the messages back to back. Messages are buffered until a chunk
+  /// is full, either by message count or by uncompressed size, and then the
+  /// chunk is compressed, appended and synced to disk. A crash loses at most
+  /// the chunk being filled, and readers skip a truncated last chunk.
+  class IGNITION_GAZEBO_LOG_SYSTEM_VISIBLE ChunkedLogWriter
+  {
+    /// \brief Constructor.
+    /// \param[in] _maxMessages Messages per chunk.
+    /// \param[in] _maxBytes Uncompressed bytes per chunk.
+    public: explicit ChunkedLogWriter(std::size_t _maxMessages = 1000,
+                std::size_t _maxBytes = 4u * 1024u * 1024u);
+
+    /// \brief Destructor. Writes the last chunk and closes the file.
+    public: ~ChunkedLogWriter();
+
+    /// \brief Create a log file, replacing any existing one.
+    /// \param[in] _path Path to the file.
+    /// \return True if the file was created.
+    public: bool Open(const std::string &_path);
+
+    /// \brief Add a message to the current chunk, writing the chunk if it's
+    /// full.
+    /// \param[in] _time Time stamp. Should not decrease between calls.
+    /// \param[in] _topic Topic.
+    /// \param[in] _type Message type.
+    /// \param[in] _data Serialized message.
+    /// \return False if a chunk couldn't be written.
+    public: bool Write(const std::chrono::nanoseconds &_time,
+                       const std::string &_topic, const std::string &_type,
+                       const std::string &_data);
+
+    /// \brief Write the current chunk, if it has any message.
+    /// \return False if the chunk couldn't be written.
+    public: bool Flush();
+
+    /// \brief Write the last chunk and close the file.
+    public: void Close();
+
+    /// \brief Number of chunks written.
+    /// \return Chunk count.
+    public: uint64_t ChunkCount() const;
+
+    /// \brief Maximum number of messages per chunk.
+    private: std::size_t maxMessages;
+
+    /// \brief Maximum uncompressed bytes per chunk.
+    private: std::size_t maxBytes;
+
+    /// \brief Open file, or null.
+    private: std::FILE *file{nullptr};
+
+    /// \brief Uncompressed payload of the current chunk.
+    private: std::string payload;
+
+    /// \brief Compressed payload, reused between chunks.
+    private: std::string compressed;
+
+    /// \brief Messages in the current chunk.
+    private: uint32_t messageCount{0};
+
+    /// \brief Time of the first message in the current chunk.
+    private: std::chrono::nanoseconds startTime{0};
+
+    /// \brief Time of the last message in the current chunk.
+    private: std::chrono::nanoseconds endTime{0};
+
+    /// \brief Number of chunks written.
+    private: uint64_t chunkCount{0};
+  };
+
+  /// \brief Reads a log written by ChunkedLogWriter.
+  ///
+  /// Opening the log only reads the chunk headers, which form an index by
+  /// time. Queries decompress the chunks overlapping the requested time
+  /// range. The last decompressed chunk is kept, since playback queries
+  /// consecutive short ranges.
+  class IGNITION_GAZEBO_LOG_SYSTEM_VISIBLE ChunkedLogReader
+  {
+    /// \brief Open a log file and index its chunks.
+    /// \param[in] _path Path to the file.
+    /// \return False if the file can't be opened or isn't a chunked log.
+    public: bool Open(const std::string &_path);
+
+    /// \brief Time of the first message.
+    /// \return Start time, or zero if the log is empty.
+    public: std::chrono::nanoseconds StartTime() const;
+
+    /// \brief Time of the last message.
+    /// \return End time, or zero if the log is empty.
+    public: std::chrono::nanoseconds EndTime() const;
+
+    /// \brief Number of valid chunks.
+    /// \return Chunk count.
+    public: std::size_t ChunkCount() const;
+
+    /// \brief Call a function for every message with a time stamp within
+    /// [_start, _end], in the order they were written.
+    /// \param[in] _start Start of the time range.
+    /// \param[in] _end End of the time range.
+    /// \param[in] _cb Function called for each message. Return false to
+    /// stop.
+    /// \return False if a chunk couldn't be read.
+    public: bool Query(const std::chrono::nanoseconds &_start,
+                       const std::chrono::nanoseconds &_end,
+                       const std::function<bool(const ChunkedLogMessage &)>
+                           &_cb);
+
+    /// \brief Index entry of a chunk.
+    private: struct Chunk
+    {
+      /// \brief Offset of the payload in the file.
+      uint64_t offset{0};
+
+      /// \brief Compressed payload size.
+      uint32_t compressedSize{0};
+
+      /// \brief Uncompressed payload size.
+      uint32_t size{0};
+
+      /// \brief Number of messages.
+      uint32_t messageCount{0};
+
+      /// \brief Checksum of the compressed payload.
+      uint32_t crc{0};
+
+      /// \brief Time of the first message.
+      std::chrono::nanoseconds startTime{0};
+
+      /// \brief Time of the last message.
+      std::chrono::nanoseconds endTime{0};
+    };
+
+    /// \brief Decompress a chunk into the cache.
+    /// \param[in] _index Index of the chunk.
+    /// \return False if the chunk couldn't be read.
+    private: bool LoadChunk(std::size_t _index);
+
+    /// \brief Open file.
+    private: std::ifstream file;
+
+    /// \brief Valid chunks, in file order.
+    private: std::vector<Chunk> chunks;
+
+    /// \brief Index of the chunk in messages, if any.
+    private: std::size_t cachedChunk{SIZE_MAX};
+
+    /// \brief Messages of the cached chunk.
+    private: std::vector<ChunkedLogMessage> messages;
+  };
+}
+}
+}
+}
+#endif
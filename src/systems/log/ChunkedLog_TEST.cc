@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Filesystem.hh>
+
+#include "ignition/gazebo/test_config.hh"
+#include "ChunkedLog.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+using namespace std::chrono_literals;
+
+/// \brief Write a log with one message per millisecond.
+/// \param[in] _path File path.
+/// \param[in] _count Number of messages.
+/// \param[in] _chunkMessages Messages per chunk.
+void writeLog(const std::string &_path, int _count, std::size_t _chunkMessages)
+{
+  ChunkedLogWriter writer(_chunkMessages);
+  ASSERT_TRUE(writer.Open(_path));
+  for (int i = 0; i < _count; ++i)
+  {
+    EXPECT_TRUE(writer.Write(std::chrono::milliseconds(i), "/state",
+        "ignition.msgs.SerializedStateMap", "data_" + std::to_string(i)));
+  }
+  writer.Close();
+}
+
+/////////////////////////////////////////////////
+TEST(ChunkedLogTest, WriteAndQuery)
+{
+  const auto path = common::joinPaths(PROJECT_BINARY_PATH,
+      "chunked_log_test.clog");
+  writeLog(path, 25, 10);
+
+  ChunkedLogReader reader;
+  ASSERT_TRUE(reader.Open(path));
+  EXPECT_EQ(3u, reader.ChunkCount());
+  EXPECT_EQ(0ms, reader.StartTime());
+  EXPECT_EQ(24ms, reader.EndTime());
+
+  // All messages, in order
+  std::vector<ChunkedLogMessage> msgs;
+  auto collect = [&](const ChunkedLogMessage &_msg)
+  {
+    msgs.push_back(_msg);
+    return true;
+  };
+  EXPECT_TRUE(reader.Query(reader.StartTime(), reader.EndTime(), collect));
+  ASSERT_EQ(25u, msgs.size());
+  for (int i = 0; i < 25; ++i)
+  {
+    EXPECT_EQ(std::chrono::milliseconds(i), msgs[i].time);
+    EXPECT_EQ("/state", msgs[i].topic);
+    EXPECT_EQ("ignition.msgs.SerializedStateMap", msgs[i].type);
+    EXPECT_EQ("data_" + std::to_string(i), msgs[i].data);
+  }
+
+  // Range across a chunk boundary, inclusive on both ends
+  msgs.clear();
+  EXPECT_TRUE(reader.Query(8ms, 12ms, collect));
+  ASSERT_EQ(5u, msgs.size());
+  EXPECT_EQ(8ms, msgs.front().time);
+  EXPECT_EQ(12ms, msgs.back().time);
+
+  // Stop early
+  int count{0};
+  EXPECT_TRUE(reader.Query(0ms, 24ms, [&](const ChunkedLogMessage &)
+      {
+        return ++count < 3;
+      }));
+  EXPECT_EQ(3, count);
+
+  // Nothing in range
+  msgs.clear();
+  EXPECT_TRUE(reader.Query(100ms, 200ms, collect));
+  EXPECT_TRUE(msgs.empty());
+
+  common::removeFile(path);
+}
+
+/////////////////////////////////////////////////
+TEST(ChunkedLogTest, TruncatedChunk)
+{
+  const auto path = common::joinPaths(PROJECT_BINARY_PATH,
+      "chunked_log_truncated_test.clog");
+  writeLog(path, 25, 10);
+
+  // Simulate a crash while writing the last chunk
+  std::string contents;
+  {
+    std::ifstream in(path, std::ios::binary);
+    contents.assign(std::istreambuf_iterator<char>(in),
+        std::istreambuf_iterator<char>());
+  }
+  ASSERT_GT(contents.size(), 10u);
+  {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(contents.data(), contents.size() - 10);
+  }
+
+  ChunkedLogReader reader;
+  ASSERT_TRUE(reader.Open(path));
+  EXPECT_EQ(2u, reader.ChunkCount());
+  EXPECT_EQ(19ms, reader.EndTime());
+
+  int count{0};
+  EXPECT_TRUE(reader.Query(reader.StartTime(), reader.EndTime(),
+      [&](const ChunkedLogMessage &)
+      {
+        ++count;
+        return true;
+      }));
+  EXPECT_EQ(20, count);
+
+  common::removeFile(path);
+}
+
+/////////////////////////////////////////////////
+TEST(ChunkedLogTest, Invalid)
+{
+  ChunkedLogReader reader;
+  EXPECT_FALSE(reader.Open("/this/file/does/not/exist"));
+
+  const auto path = common::joinPaths(PROJECT_BINARY_PATH,
+      "chunked_log_invalid_test.clog");
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << "not a chunked log";
+  }
+  EXPECT_FALSE(reader.Open(path));
+  EXPECT_EQ(0u, reader.ChunkCount());
+
+  common::removeFile(path);
+}
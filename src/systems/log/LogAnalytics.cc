@@ -0,0 +1,760 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "LogAnalytics.hh"
+
+#include <google/protobuf/io/coded_stream.h>
+#include <ignition/msgs/serialized.pb.h>
+#include <ignition/msgs/serialized_map.pb.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <iomanip>
+#include <iterator>
+#include <regex>
+#include <thread>
+#include <utility>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Filesystem.hh>
+#include <ignition/common/Profiler.hh>
+#include <ignition/common/Util.hh>
+#include <ignition/transport/log/Log.hh>
+#include <ignition/transport/log/QueryOptions.hh>
+
+#include "ignition/gazebo/components/Factory.hh"
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/ParentEntity.hh"
+
+#include "ChunkedLog.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+
+using google::protobuf::io::CodedInputStream;
+
+namespace
+{
+/// \brief Field numbers of the state messages, from their descriptors.
+struct FieldNumbers
+{
+  /// \brief SerializedStateMap.entities
+  int stateMapEntities;
+
+  /// \brief SerializedEntityMap.id
+  int entityMapId;
+
+  /// \brief SerializedEntityMap.components
+  int entityMapComponents;
+
+  /// \brief SerializedState.entities
+  int stateEntities;
+
+  /// \brief SerializedEntity.id
+  int entityId;
+
+  /// \brief SerializedEntity.components
+  int entityComponents;
+
+  /// \brief SerializedComponent.type
+  int componentType;
+
+  /// \brief SerializedComponent.component
+  int componentData;
+
+  /// \brief SerializedComponent.remove
+  int componentRemove;
+};
+
+/// \brief Get the field numbers of the state messages.
+/// \return Field numbers.
+const FieldNumbers &fields()
+{
+  static const FieldNumbers numbers = []
+  {
+    auto number = [](const google::protobuf::Descriptor *_desc,
+        const std::string &_name)
+    {
+      return _desc->FindFieldByName(_name)->number();
+    };
+    FieldNumbers n;
+    auto stateMap = msgs::SerializedStateMap::descriptor();
+    auto entityMap = msgs::SerializedEntityMap::descriptor();
+    auto state = msgs::SerializedState::descriptor();
+    auto entity = msgs::SerializedEntity::descriptor();
+    auto component = msgs::SerializedComponent::descriptor();
+    n.stateMapEntities = number(stateMap, "entities");
+    n.entityMapId = number(entityMap, "id");
+    n.entityMapComponents = number(entityMap, "components");
+    n.stateEntities = number(state, "entities");
+    n.entityId = number(entity, "id");
+    n.entityComponents = number(entity, "components");
+    n.componentType = number(component, "type");
+    n.componentData = number(component, "component");
+    n.componentRemove = number(component, "remove");
+    return n;
+  }();
+  return numbers;
+}
+
+/// \brief Wire types used by the state messages.
+enum WireType : uint32_t
+{
+  kVarint = 0,
+  kFixed64 = 1,
+  kLengthDelimited = 2,
+  kFixed32 = 5
+};
+
+/// \brief Skip a field.
+/// \param[in] _in Input stream, positioned after the tag.
+/// \param[in] _tag Tag of the field.
+/// \return False on malformed input.
+bool skipField(CodedInputStream &_in, uint32_t _tag)
+{
+  switch (_tag & 7u)
+  {
+    case kVarint:
+    {
+      uint64_t value;
+      return _in.ReadVarint64(&value);
+    }
+    case kFixed64:
+      return _in.Skip(8);
+    case kLengthDelimited:
+    {
+      uint32_t size;
+      return _in.ReadVarint32(&size) && _in.Skip(static_cast<int>(size));
+    }
+    case kFixed32:
+      return _in.Skip(4);
+    default:
+      return false;
+  }
+}
+
+/// \brief Read a varint field.
+/// \param[in] _in Input stream, positioned after the tag.
+/// \param[in] _tag Tag of the field.
+/// \param[out] _value Value.
+/// \return False if the field isn't a varint or input is malformed.
+bool readVarint(CodedInputStream &_in, uint32_t _tag, uint64_t &_value)
+{
+  return (_tag & 7u) == kVarint && _in.ReadVarint64(&_value);
+}
+
+/// \brief Scans state messages, calling a function for the wanted
+/// components only.
+class StateScanner
+{
+  /// \brief Called with the entity, type and data of each wanted component.
+  public: using Callback = std::function<void(Entity, ComponentTypeId,
+      std::string &)>;
+
+  /// \brief Constructor.
+  /// \param[in] _types Wanted component types.
+  /// \param[in] _entities Wanted entities, empty for all.
+  /// \param[in] _cb Callback.
+  public: StateScanner(const std::unordered_set<ComponentTypeId> &_types,
+      const std::unordered_set<Entity> &_entities, Callback _cb)
+    : types(_types), entities(_entities), cb(std::move(_cb))
+  {
+  }
+
+  /// \brief Scan a serialized message.
+  /// \param[in] _type Message type.
+  /// \param[in] _data Serialized message.
+  /// \return False on malformed input.
+  public: bool Scan(const std::string &_type, const std::string &_data)
+  {
+    bool isMap = _type == "ignition.msgs.SerializedStateMap";
+    if (!isMap && _type != "ignition.msgs.SerializedState")
+      return true;
+
+    CodedInputStream in(reinterpret_cast<const uint8_t *>(_data.data()),
+        static_cast<int>(_data.size()));
+
+    const auto &f = fields();
+    int entitiesField = isMap ? f.stateMapEntities : f.stateEntities;
+    while (uint32_t tag = in.ReadTag())
+    {
+      if (static_cast<int>(tag >> 3) != entitiesField ||
+          (tag & 7u) != kLengthDelimited)
+      {
+        if (!skipField(in, tag))
+          return false;
+        continue;
+      }
+
+      bool ok = isMap ?
+          this->Nested(in, [&] { return this->ScanEntityMapEntry(in); }) :
+          this->Nested(in, [&]
+              {
+                return this->ScanEntity(in, kNullEntity, f.entityId,
+                    f.entityComponents, false);
+              });
+      if (!ok)
+        return false;
+    }
+    return true;
+  }
+
+  /// \brief Read a length delimited field as a nested message.
+  /// \param[in] _in Input stream, positioned after the tag.
+  /// \param[in] _fn Function that reads the nested message.
+  /// \return False on malformed input.
+  private: template <typename F>
+  bool Nested(CodedInputStream &_in, F _fn)
+  {
+    uint32_t size;
+    if (!_in.ReadVarint32(&size))
+      return false;
+    auto limit = _in.PushLimit(static_cast<int>(size));
+    bool ok = _fn();
+    _in.PopLimit(limit);
+    return ok;
+  }
+
+  /// \brief Scan a map<uint64, SerializedEntityMap> entry.
+  /// \param[in] _in Input stream.
+  /// \return False on malformed input.
+  private: bool ScanEntityMapEntry(CodedInputStream &_in)
+  {
+    const auto &f = fields();
+    Entity entity{kNullEntity};
+    while (uint32_t tag = _in.ReadTag())
+    {
+      auto field = tag >> 3;
+      uint64_t value;
+      if (field == 1 && readVarint(_in, tag, value))
+      {
+        entity = value;
+      }
+      else if (field == 2 && (tag & 7u) == kLengthDelimited)
+      {
+        if (!this->Nested(_in, [&]
+            {
+              return this->ScanEntity(_in, entity, f.entityMapId,
+                  f.entityMapComponents, true);
+            }))
+        {
+          return false;
+        }
+      }
+      else if (!skipField(_in, tag))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// \brief Scan a SerializedEntity or SerializedEntityMap.
+  /// \param[in] _in Input stream.
+  /// \param[in] _entity Entity, if known from a map key.
+  /// \param[in] _idField Number of the id field.
+  /// \param[in] _componentsField Number of the components field.
+  /// \param[in] _isMap True if components are map entries.
+  /// \return False on malformed input.
+  private: bool ScanEntity(CodedInputStream &_in, Entity _entity,
+      int _idField, int _componentsField, bool _isMap)
+  {
+    Entity entity{_entity};
+    while (uint32_t tag = _in.ReadTag())
+    {
+      auto field = static_cast<int>(tag >> 3);
+      uint64_t value;
+      if (field == _idField && readVarint(_in, tag, value))
+      {
+        entity = value;
+      }
+      else if (field == _componentsField && (tag & 7u) == kLengthDelimited)
+      {
+        // The id comes first, so unwanted entities are skipped whole
+        if (!this->entities.empty() &&
+            this->entities.find(entity) == this->entities.end())
+        {
+          if (!skipField(_in, tag))
+            return false;
+          continue;
+        }
+
+        bool ok = _isMap ?
+            this->Nested(_in, [&]
+                {
+                  return this->ScanComponentMapEntry(_in, entity);
+                }) :
+            this->Nested(_in, [&]
+                {
+                  return this->ScanComponent(_in, entity);
+                });
+        if (!ok)
+          return false;
+      }
+      else if (!skipField(_in, tag))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// \brief Scan a map<int64, SerializedComponent> entry.
+  /// \param[in] _in Input stream.
+  /// \param[in] _entity Entity the component belongs to.
+  /// \return False on malformed input.
+  private: bool ScanComponentMapEntry(CodedInputStream &_in, Entity _entity)
+  {
+    while (uint32_t tag = _in.ReadTag())
+    {
+      if ((tag >> 3) == 2 && (tag & 7u) == kLengthDelimited)
+      {
+        if (!this->Nested(_in, [&]
+            {
+              return this->ScanComponent(_in, _entity);
+            }))
+        {
+          return false;
+        }
+      }
+      else if (!skipField(_in, tag))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// \brief Scan a SerializedComponent, only copying its data if wanted.
+  /// \param[in] _in Input stream.
+  /// \param[in] _entity Entity the component belongs to.
+  /// \return False on malformed input.
+  private: bool ScanComponent(CodedInputStream &_in, Entity _entity)
+  {
+    const auto &f = fields();
+    bool hasType{false};
+    ComponentTypeId type{kComponentTypeIdInvalid};
+    bool hasData{false};
+    bool remove{false};
+    this->data.clear();
+    while (uint32_t tag = _in.ReadTag())
+    {
+      auto field = static_cast<int>(tag >> 3);
+      uint64_t value;
+      if (field == f.componentType && readVarint(_in, tag, value))
+      {
+        type = static_cast<ComponentTypeId>(value);
+        hasType = true;
+      }
+      else if (field == f.componentData && (tag & 7u) == kLengthDelimited &&
+          (!hasType || this->types.count(type)))
+      {
+        uint32_t size;
+        if (!_in.ReadVarint32(&size) ||
+            !_in.ReadString(&this->data, static_cast<int>(size)))
+        {
+          return false;
+        }
+        hasData = true;
+      }
+      else if (field == f.componentRemove && readVarint(_in, tag, value))
+      {
+        remove = value != 0;
+      }
+      else if (!skipField(_in, tag))
+      {
+        return false;
+      }
+    }
+
+    if (hasData && !remove && this->types.count(type))
+      this->cb(_entity, type, this->data);
+    return true;
+  }
+
+  /// \brief Wanted component types.
+  private: const std::unordered_set<ComponentTypeId> &types;
+
+  /// \brief Wanted entities, empty for all.
+  private: const std::unordered_set<Entity> &entities;
+
+  /// \brief Callback.
+  private: Callback cb;
+
+  /// \brief Component data, reused between components.
+  private: std::string data;
+};
+}
+
+//////////////////////////////////////////////////
+bool LogAnalytics::Open(const std::string &_path)
+{
+  this->names.clear();
+
+  auto path = common::absPath(_path);
+  if (common::isDirectory(path))
+  {
+    auto chunkedPath = common::joinPaths(path, kChunkedLogFileName);
+    path = common::exists(chunkedPath) ? chunkedPath :
+        common::joinPaths(path, "state.tlog");
+  }
+
+  if (!common::exists(path))
+  {
+    ignerr << "Log file [" << path << "] does not exist." << std::endl;
+    return false;
+  }
+
+  this->path = path;
+  this->chunked = common::basename(path) == kChunkedLogFileName ||
+      (path.size() > 5 && path.compare(path.size() - 5, 5, ".clog") == 0);
+
+  if (this->chunked)
+  {
+    ChunkedLogReader reader;
+    if (!reader.Open(this->path))
+      return false;
+    this->startTime = reader.StartTime();
+    this->endTime = reader.EndTime();
+  }
+  else
+  {
+    transport::log::Log log;
+    if (!log.Open(this->path))
+    {
+      ignerr << "Failed to open log file [" << this->path << "]"
+             << std::endl;
+      return false;
+    }
+    this->startTime = log.StartTime();
+    this->endTime = log.EndTime();
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool LogAnalytics::Extract(const LogAnalyticsOptions &_options,
+    std::vector<LogAnalyticsSample> &_samples)
+{
+  IGN_PROFILE("LogAnalytics::Extract");
+  if (this->path.empty())
+  {
+    ignerr << "No log is open." << std::endl;
+    return false;
+  }
+
+  std::unordered_set<ComponentTypeId> types;
+  for (const auto &name : _options.components)
+  {
+    auto type = ComponentType(name);
+    if (type == kComponentTypeIdInvalid)
+    {
+      ignerr << "Unknown component [" << name << "]." << std::endl;
+      return false;
+    }
+    types.insert(type);
+  }
+  if (types.empty())
+  {
+    ignerr << "No components to extract." << std::endl;
+    return false;
+  }
+
+  std::regex pattern;
+  try
+  {
+    pattern = std::regex(_options.entityPattern);
+  }
+  catch (const std::regex_error &_e)
+  {
+    ignerr << "Invalid entity pattern [" << _options.entityPattern << "]: "
+           << _e.what() << std::endl;
+    return false;
+  }
+
+  unsigned int threads = _options.threads > 0 ? _options.threads :
+      std::max(1u, std::thread::hardware_concurrency());
+
+  // First pass, only for names and parents, to resolve entities
+  std::vector<LogAnalyticsSample> structure;
+  if (!this->Scan(threads,
+      {components::Name::typeId, components::ParentEntity::typeId}, {},
+      structure))
+  {
+    return false;
+  }
+
+  std::unordered_map<Entity, std::string> localNames;
+  std::unordered_map<Entity, Entity> parents;
+  for (const auto &sample : structure)
+  {
+    if (sample.type == components::Name::typeId)
+    {
+      localNames[sample.entity] = sample.data;
+    }
+    else
+    {
+      try
+      {
+        parents[sample.entity] = std::stoull(sample.data);
+      }
+      catch (...)
+      {
+        ignwarn << "Invalid parent [" << sample.data << "] of entity ["
+                << sample.entity << "]." << std::endl;
+      }
+    }
+  }
+
+  this->names.clear();
+  std::unordered_set<Entity> entities;
+  for (const auto &[entity, localName] : localNames)
+  {
+    std::string name = localName;
+    std::unordered_set<Entity> visited{entity};
+    for (auto it = parents.find(entity); it != parents.end();
+        it = parents.find(it->second))
+    {
+      // Guard against cycles in malformed logs
+      if (!visited.insert(it->second).second)
+        break;
+      auto parentName = localNames.find(it->second);
+      if (parentName == localNames.end())
+        break;
+      name = parentName->second + "::" + name;
+    }
+
+    if (std::regex_match(name, pattern))
+      entities.insert(entity);
+    this->names[entity] = std::move(name);
+  }
+
+  if (!_options.entityPattern.empty() && entities.empty())
+  {
+    ignwarn << "No entities match [" << _options.entityPattern << "]."
+            << std::endl;
+    return true;
+  }
+
+  // Second pass for the requested components of matching entities. An
+  // empty pattern also takes entities without names.
+  if (_options.entityPattern.empty())
+    entities.clear();
+  return this->Scan(threads, types, entities, _samples);
+}
+
+//////////////////////////////////////////////////
+bool LogAnalytics::Scan(unsigned int _threads,
+    const std::unordered_set<ComponentTypeId> &_types,
+    const std::unordered_set<Entity> &_entities,
+    std::vector<LogAnalyticsSample> &_samples) const
+{
+  IGN_PROFILE("LogAnalytics::Scan");
+
+  // More slices than threads, so a slow slice doesn't hold up the others
+  auto duration = this->endTime - this->startTime;
+  auto sliceCount = static_cast<int64_t>(_threads) * 4;
+  sliceCount = std::max<int64_t>(1,
+      std::min<int64_t>(sliceCount, duration.count() + 1));
+  auto sliceLength = (duration + std::chrono::nanoseconds(sliceCount)) /
+      sliceCount;
+
+  std::vector<std::vector<LogAnalyticsSample>> slices(sliceCount);
+  std::atomic<int64_t> nextSlice{0};
+  std::atomic<bool> ok{true};
+
+  auto worker = [&]
+  {
+    for (int64_t i = nextSlice++; i < sliceCount && ok; i = nextSlice++)
+    {
+      auto start = this->startTime + sliceLength * i;
+      auto end = (i == sliceCount - 1) ? this->endTime :
+          start + sliceLength - std::chrono::nanoseconds(1);
+      auto &samples = slices[i];
+
+      std::chrono::nanoseconds time{0};
+      StateScanner scanner(_types, _entities,
+          [&](Entity _entity, ComponentTypeId _type, std::string &_data)
+          {
+            samples.push_back({time, _entity, _type, std::move(_data)});
+          });
+
+      bool sliceOk = this->ForEachMessage(start, end,
+          [&](const std::chrono::nanoseconds &_time,
+              const std::string &_type, const std::string &_data)
+          {
+            time = _time;
+            if (!scanner.Scan(_type, _data))
+            {
+              ignwarn << "Skipping malformed message at [" << _time.count()
+                      << "] ns." << std::endl;
+            }
+          });
+      if (!sliceOk)
+        ok = false;
+    }
+  };
+
+  std::vector<std::thread> workers;
+  auto threadCount = std::min<int64_t>(_threads, sliceCount);
+  for (int64_t i = 1; i < threadCount; ++i)
+    workers.emplace_back(worker);
+  worker();
+  for (auto &thread : workers)
+    thread.join();
+
+  if (!ok)
+    return false;
+
+  std::size_t total{0};
+  for (const auto &slice : slices)
+    total += slice.size();
+  _samples.reserve(_samples.size() + total);
+  for (auto &slice : slices)
+  {
+    std::move(slice.begin(), slice.end(), std::back_inserter(_samples));
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool LogAnalytics::ForEachMessage(const std::chrono::nanoseconds &_start,
+    const std::chrono::nanoseconds &_end,
+    const std::function<void(const std::chrono::nanoseconds &,
+        const std::string &, const std::string &)> &_cb) const
+{
+  if (this->chunked)
+  {
+    ChunkedLogReader reader;
+    if (!reader.Open(this->path))
+      return false;
+    return reader.Query(_start, _end, [&](const ChunkedLogMessage &_msg)
+        {
+          _cb(_msg.time, _msg.type, _msg.data);
+          return true;
+        });
+  }
+
+  transport::log::Log log;
+  if (!log.Open(this->path))
+  {
+    ignerr << "Failed to open log file [" << this->path << "]" << std::endl;
+    return false;
+  }
+  for (const auto &msg :
+      log.QueryMessages(transport::log::AllTopics({_start, _end})))
+  {
+    _cb(msg.TimeReceived(), msg.Type(), msg.Data());
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+const std::unordered_map<Entity, std::string> &LogAnalytics::Names() const
+{
+  return this->names;
+}
+
+//////////////////////////////////////////////////
+void LogAnalytics::WriteCsv(std::ostream &_out,
+    const std::vector<LogAnalyticsSample> &_samples) const
+{
+  auto factory = components::Factory::Instance();
+  std::unordered_map<ComponentTypeId, std::string> typeNames;
+
+  auto writeField = [&_out](const std::string &_field)
+  {
+    if (_field.find_first_of(",\"\n") == std::string::npos)
+    {
+      _out << _field;
+      return;
+    }
+    _out << '"';
+    for (auto c : _field)
+    {
+      if (c == '"')
+        _out << '"';
+      _out << c;
+    }
+    _out << '"';
+  };
+
+  _out << "time,entity,name,component,value\n";
+  for (const auto &sample : _samples)
+  {
+    auto typeName = typeNames.find(sample.type);
+    if (typeName == typeNames.end())
+    {
+      auto name = factory->Name(sample.type);
+      if (name.empty())
+        name = std::to_string(sample.type);
+      typeName = typeNames.emplace(sample.type, name).first;
+    }
+
+    auto name = this->names.find(sample.entity);
+
+    _out << sample.time.count() << ','
+         << sample.entity << ',';
+    writeField(name != this->names.end() ? name->second : "");
+    _out << ',';
+    writeField(typeName->second);
+    _out << ',';
+
+    bool printable = std::all_of(sample.data.begin(), sample.data.end(),
+        [](unsigned char _c)
+        {
+          return std::isprint(_c) || _c == '\n' || _c == '\t';
+        });
+    if (printable)
+    {
+      writeField(sample.data);
+    }
+    else
+    {
+      _out << "0x" << std::hex << std::setfill('0');
+      for (unsigned char c : sample.data)
+        _out << std::setw(2) << static_cast<int>(c);
+      _out << std::dec << std::setfill(' ');
+    }
+    _out << '\n';
+  }
+}
+
+//////////////////////////////////////////////////
+ComponentTypeId LogAnalytics::ComponentType(const std::string &_name)
+{
+  auto factory = components::Factory::Instance();
+  for (auto type : factory->TypeIds())
+  {
+    auto name = factory->Name(type);
+    if (name == _name)
+      return type;
+
+    auto period = name.rfind('.');
+    if (period != std::string::npos && name.substr(period + 1) == _name)
+      return type;
+  }
+
+  // Components which aren't registered in this process can still be found
+  // by their full name
+  if (_name.find('.') != std::string::npos)
+    return common::hash64(_name);
+
+  return kComponentTypeIdInvalid;
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GAZEBO_SYSTEMS_LOGANALYTICS_HH_
+#define IGNITION_GAZEBO_SYSTEMS_LOGANALYTICS_HH_
+
+#include <chrono>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/log-system/Export.hh>
+#include <ignition/gazebo/Entity.hh>
+#include <ignition/gazebo/Types.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems
+{
+  /// \brief What to extract from a state log.
+  struct LogAnalyticsOptions
+  {
+    /// \brief Regular expression matched against the scoped names of
+    /// entities, such as `my_world::box::link`. Empty matches all entities.
+    std::string entityPattern;
+
+    /// \brief Names of the component types to extract, either full, such as
+    /// `ign_gazebo_components.Pose`, or short, such as `Pose`.
+    std::vector<std::string> components;
+
+    /// \brief Number of threads. Zero uses one per hardware thread.
+    unsigned int threads{0};
+  };
+
+  /// \brief A component value extracted from a state log.
+  struct LogAnalyticsSample
+  {
+    /// \brief Time the state was recorded at.
+    std::chrono::nanoseconds time{0};
+
+    /// \brief Entity the component belongs to.
+    Entity entity{kNullEntity};
+
+    /// \brief Component type.
+    ComponentTypeId type{kComponentTypeIdInvalid};
+
+    /// \brief Serialized component, as recorded.
+    std::string data;
+  };
+
+  /// \brief Extracts component values from a state log without running a
+  /// server.
+  ///
+  /// Messages are scanned at the wire level. Serialized components of
+  /// types that weren't requested are skipped without being copied or
+  /// deserialized, and no entity component manager is built. Entities are
+  /// identified by scoped names built from the recorded Name and
+  /// ParentEntity components. The log is split into time slices which are
+  /// scanned concurrently, each with its own reader.
+  class IGNITION_GAZEBO_LOG_SYSTEM_VISIBLE LogAnalytics
+  {
+    /// \brief Open a log recorded by LogRecord.
+    /// \param[in] _path Log directory, or path to a state.tlog or
+    /// state.clog file.
+    /// \return False if no readable log was found.
+    public: bool Open(const std::string &_path);
+
+    /// \brief Extract component values.
+    /// \param[in] _options What to extract.
+    /// \param[out] _samples Extracted values, in log order.
+    /// \return False if the options are invalid or the log can't be read.
+    public: bool Extract(const LogAnalyticsOptions &_options,
+                         std::vector<LogAnalyticsSample> &_samples);
+
+    /// \brief Scoped names of all the entities seen by the last extraction.
+    /// \return Map of entity to scoped name.
+    public: const std::unordered_map<Entity, std::string> &Names() const;
+
+    /// \brief Write samples as CSV, with a
+    /// `time,entity,name,component,value` header, one row per sample. Time
+    /// is in nanoseconds. Values are written as recorded if they're
+    /// printable, such as poses, and in hexadecimal otherwise.
+    /// \param[in] _out Output stream.
+    /// \param[in] _samples Samples to write.
+    public: void WriteCsv(std::ostream &_out,
+                          const std::vector<LogAnalyticsSample> &_samples)
+                          const;
+
+    /// \brief Get the component type of a component name.
+    /// \param[in] _name Full or short name.
+    /// \return Component type, or kComponentTypeIdInvalid if unknown.
+    public: static ComponentTypeId ComponentType(const std::string &_name);
+
+    /// \brief Call a function for each message within a time range, from a
+    /// reader owned by the calling thread.
+    /// \param[in] _start Start of the range.
+    /// \param[in] _end End of the range.
+    /// \param[in] _cb Function called with the time, type and data of each
+    /// message.
+    /// \return False if the log couldn't be read.
+    private: bool ForEachMessage(const std::chrono::nanoseconds &_start,
+        const std::chrono::nanoseconds &_end,
+        const std::function<void(const std::chrono::nanoseconds &,
+            const std::string &, const std::string &)> &_cb) const;
+
+    /// \brief Scan time slices of the log concurrently.
+    /// \param[in] _threads Number of threads.
+    /// \param[in] _types Component types to return.
+    /// \param[in] _entities Entities to return, empty for all.
+    /// \param[out] _samples Samples, in log order.
+    /// \return False if the log couldn't be read.
+    private: bool Scan(unsigned int _threads,
+        const std::unordered_set<ComponentTypeId> &_types,
+        const std::unordered_set<Entity> &_entities,
+        std::vector<LogAnalyticsSample> &_samples) const;
+
+    /// \brief Path to the state file.
+    private: std::string path;
+
+    /// \brief True if the state file is a chunked log.
+    private: bool chunked{false};
+
+    /// \brief Time of the first message.
+    private: std::chrono::nanoseconds startTime{0};
+
+    /// \brief Time of the last message.
+    private: std::chrono::nanoseconds endTime{0};
+
+    /// \brief Scoped names of entities.
+    private: std::unordered_map<Entity, std::string> names;
+  };
+}
+}
+}
+}
+#endif
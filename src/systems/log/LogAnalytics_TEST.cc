@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <ignition/msgs/serialized_map.pb.h>
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Filesystem.hh>
+
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/ParentEntity.hh"
+#include "ignition/gazebo/components/Pose.hh"
+#include "ignition/gazebo/test_config.hh"
+#include "ChunkedLog.hh"
+#include "LogAnalytics.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+using namespace std::chrono_literals;
+
+/// \brief Add a component to a state message.
+/// \param[in] _msg State message.
+/// \param[in] _entity Entity.
+/// \param[in] _type Component type.
+/// \param[in] _data Serialized component.
+void addComponent(msgs::SerializedStateMap &_msg, Entity _entity,
+    ComponentTypeId _type, const std::string &_data)
+{
+  auto &entityMsg = (*_msg.mutable_entities())[_entity];
+  entityMsg.set_id(_entity);
+  auto &compMsg = (*entityMsg.mutable_components())[
+      static_cast<int64_t>(_type)];
+  compMsg.set_type(_type);
+  compMsg.set_component(_data);
+}
+
+/////////////////////////////////////////////////
+TEST(LogAnalyticsTest, Extract)
+{
+  const auto path = common::joinPaths(PROJECT_BINARY_PATH,
+      "log_analytics_test.clog");
+
+  // A world with two models, each with a link, moving for 100 steps
+  {
+    ChunkedLogWriter writer(7);
+    ASSERT_TRUE(writer.Open(path));
+    for (int i = 0; i < 100; ++i)
+    {
+      msgs::SerializedStateMap msg;
+      if (i == 0)
+      {
+        addComponent(msg, 1, components::Name::typeId, "default");
+        addComponent(msg, 2, components::Name::typeId, "box");
+        addComponent(msg, 2, components::ParentEntity::typeId, "1");
+        addComponent(msg, 3, components::Name::typeId, "link");
+        addComponent(msg, 3, components::ParentEntity::typeId, "2");
+        addComponent(msg, 4, components::Name::typeId, "sphere");
+        addComponent(msg, 4, components::ParentEntity::typeId, "1");
+        addComponent(msg, 5, components::Name::typeId, "link");
+        addComponent(msg, 5, components::ParentEntity::typeId, "4");
+      }
+      addComponent(msg, 2, components::Pose::typeId,
+          std::to_string(i) + " 0 0 0 0 0");
+      addComponent(msg, 4, components::Pose::typeId,
+          "0 " + std::to_string(i) + " 0 0 0 0");
+
+      // Not printable
+      addComponent(msg, 2, 1234, std::string("\x01\x02", 2));
+
+      ASSERT_TRUE(writer.Write(std::chrono::milliseconds(i), "/state",
+          msg.GetTypeName(), msg.SerializeAsString()));
+    }
+  }
+
+  LogAnalytics analytics;
+  EXPECT_FALSE(analytics.Open("/this/log/does/not/exist"));
+  ASSERT_TRUE(analytics.Open(path));
+
+  LogAnalyticsOptions options;
+  options.entityPattern = "default::box";
+  options.components.push_back("Pose");
+  options.threads = 3;
+
+  std::vector<LogAnalyticsSample> samples;
+  ASSERT_TRUE(analytics.Extract(options, samples));
+  ASSERT_EQ(100u, samples.size());
+  for (int i = 0; i < 100; ++i)
+  {
+    EXPECT_EQ(std::chrono::milliseconds(i), samples[i].time);
+    EXPECT_EQ(2u, samples[i].entity);
+    EXPECT_EQ(components::Pose::typeId, samples[i].type);
+    EXPECT_EQ(std::to_string(i) + " 0 0 0 0 0", samples[i].data);
+  }
+
+  const auto &names = analytics.Names();
+  EXPECT_EQ("default", names.at(1));
+  EXPECT_EQ("default::box", names.at(2));
+  EXPECT_EQ("default::box::link", names.at(3));
+  EXPECT_EQ("default::sphere::link", names.at(5));
+
+  // All entities, more than one component
+  samples.clear();
+  options.entityPattern.clear();
+  options.components.push_back("ign_gazebo_components.Name");
+  options.threads = 0;
+  ASSERT_TRUE(analytics.Extract(options, samples));
+  EXPECT_EQ(205u, samples.size());
+
+  std::ostringstream csv;
+  samples = {
+      {5ms, 2, components::Pose::typeId, "1 2 3 0 0 0"},
+      {6ms, 4, 1234, std::string("\x01\x02", 2)},
+      {7ms, 99, components::Name::typeId, "a,\"b\""}};
+  analytics.WriteCsv(csv, samples);
+  EXPECT_EQ("time,entity,name,component,value\n"
+      "5000000,2,default::box,ign_gazebo_components.Pose,1 2 3 0 0 0\n"
+      "6000000,4,default::sphere,1234,0x0102\n"
+      "7000000,99,,ign_gazebo_components.Name,\"a,\"\"b\"\"\"\n",
+      csv.str());
+
+  // Invalid options
+  options.components = {"NotAComponent"};
+  EXPECT_FALSE(analytics.Extract(options, samples));
+  options.components = {"Pose"};
+  options.entityPattern = "(";
+  EXPECT_FALSE(analytics.Extract(options, samples));
+
+  common::removeFile(path);
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+
+#include "LogAnalytics.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief Print usage.
+/// \param[in] _name Executable name.
+void usage(const char *_name)
+{
+  std::cerr
+    << "Extract component values from a state log, without running a "
+    << "simulation.\n\n"
+    << "Usage: " << _name << " <log> -c <component> [options]\n\n"
+    << "  <log>               Log directory, state.tlog or state.clog.\n"
+    << "  -c <component>      Component to extract, such as Pose or\n"
+    << "                      ign_gazebo_components.Pose. Repeat for more.\n"
+    << "  -e <regex>          Only entities whose scoped names match,\n"
+    << "                      such as \"my_world::box::.*\".\n"
+    << "  -j <threads>        Threads to use, up to 1024. Defaults to all.\n"
+    << "  -o <file>           CSV output. Defaults to standard output.\n"
+    << "  -v <level>          Console verbosity, from 0 to 4.\n";
+}
+
+/// \brief Parse an unsigned number option.
+/// \param[in] _str Option value.
+/// \param[in] _max Largest accepted value.
+/// \param[out] _value Parsed value.
+/// \return False if _str isn't a number from 0 to _max.
+bool parseUnsigned(const std::string &_str, unsigned int _max,
+    unsigned int &_value)
+{
+  // std::stoul accepts leading spaces and wraps negative numbers around
+  if (_str.empty() || !std::isdigit(static_cast<unsigned char>(_str[0])))
+    return false;
+
+  unsigned long value;
+  std::size_t end;
+  try
+  {
+    value = std::stoul(_str, &end);
+  }
+  catch (const std::logic_error &)
+  {
+    return false;
+  }
+
+  if (end != _str.size() || value > _max)
+    return false;
+
+  _value = static_cast<unsigned int>(value);
+  return true;
+}
+
+//////////////////////////////////////////////////
+int main(int _argc, char **_argv)
+{
+  std::string logPath;
+  std::string output;
+  systems::LogAnalyticsOptions options;
+  common::Console::SetVerbosity(1);
+
+  for (int i = 1; i < _argc; ++i)
+  {
+    std::string arg = _argv[i];
+    bool hasValue = i + 1 < _argc;
+    if (arg == "-h" || arg == "--help")
+    {
+      usage(_argv[0]);
+      return 0;
+    }
+    else if (arg == "-c" && hasValue)
+    {
+      options.components.push_back(_argv[++i]);
+    }
+    else if (arg == "-e" && hasValue)
+    {
+      options.entityPattern = _argv[++i];
+    }
+    else if (arg == "-j" && hasValue)
+    {
+      if (!parseUnsigned(_argv[++i], 1024, options.threads))
+      {
+        std::cerr << "Invalid thread count [" << _argv[i] << "].\n\n";
+        usage(_argv[0]);
+        return 1;
+      }
+    }
+    else if (arg == "-o" && hasValue)
+    {
+      output = _argv[++i];
+    }
+    else if (arg == "-v" && hasValue)
+    {
+      unsigned int verbosity;
+      if (!parseUnsigned(_argv[++i], 4, verbosity))
+      {
+        std::cerr << "Invalid verbosity [" << _argv[i] << "].\n\n";
+        usage(_argv[0]);
+        return 1;
+      }
+      common::Console::SetVerbosity(static_cast<int>(verbosity));
+    }
+    else if (logPath.empty() && !arg.empty() && arg[0] != '-')
+    {
+      logPath = arg;
+    }
+    else
+    {
+      usage(_argv[0]);
+      return 1;
+    }
+  }
+
+  if (logPath.empty() || options.components.empty())
+  {
+    usage(_argv[0]);
+    return 1;
+  }
+
+  systems::LogAnalytics analytics;
+  std::vector<systems::LogAnalyticsSample> samples;
+  if (!analytics.Open(logPath) || !analytics.Extract(options, samples))
+    return 1;
+
+  if (output.empty())
+  {
+    analytics.WriteCsv(std::cout, samples);
+    return 0;
+  }
+
+  std::ofstream file(output);
+  if (!file)
+  {
+    ignerr << "Failed to open [" << output << "] for writing." << std::endl;
+    return 1;
+  }
+  analytics.WriteCsv(file, samples);
+  return 0;
+}
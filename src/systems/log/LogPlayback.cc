@@ -19,9 +19,13 @@
 
 #include <ignition/msgs/log_playback_stats.pb.h>
 
+#include <chrono>
+#include <functional>
+#include <memory>
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <ignition/common/Filesystem.hh>
 #include <ignition/common/Profiler.hh>
@@ -47,6 +51,9 @@
 #include "ignition/gazebo/components/Pose.hh"
 #include "ignition/gazebo/components/World.hh"
 
+#include "ChunkedLog.hh"
+#include "LogPrefetcher.hh"
+
 using namespace ignition;
 using namespace gazebo;
 using namespace systems;
@@ -85,12 +92,52 @@ class ignition::gazebo::systems::LogPlaybackPrivate
   public: void Parse(EntityComponentManager &_ecm,
       const msgs::SerializedStateMap &_msg);
 
+  /// \brief Call a function for each message recorded within a time
+  /// range, from either log format.
+  /// \param[in] _start Start of the time range.
+  /// \param[in] _end End of the time range.
+  /// \param[in] _cb Function called with the time, type and serialized
+  /// data of each message. Return false to stop.
+  public: void ForEachMessage(const std::chrono::nanoseconds &_start,
+      const std::chrono::nanoseconds &_end,
+      const std::function<bool(const std::chrono::nanoseconds &,
+          const std::string &, const std::string &)> &_cb);
+
+  /// \brief Time of the first recorded message.
+  /// \return Start time of the log.
+  public: std::chrono::nanoseconds LogStartTime() const;
+
+  /// \brief Time of the last recorded message.
+  /// \return End time of the log.
+  public: std::chrono::nanoseconds LogEndTime() const;
+
   /// \brief A batch of data from log file, of all pose messages
   public: transport::log::Batch batch;
 
   /// \brief Pointer to ign-transport Log
   public: std::unique_ptr<transport::log::Log> log;
 
+  /// \brief Chunked log, used instead of the ign-transport Log if the
+  /// recording has one.
+  public: std::unique_ptr<ChunkedLogReader> chunkedLog;
+
+  /// \brief Reads the log ahead of playback. Once it's created, the log is
+  /// only read from its thread.
+  public: std::unique_ptr<LogPrefetcher> prefetcher;
+
+  /// \brief Length of log time read ahead at once.
+  public: std::chrono::nanoseconds prefetchWindow{std::chrono::seconds(1)};
+
+  /// \brief Number of windows read ahead.
+  public: std::size_t prefetchBatches{8};
+
+  /// \brief Messages taken from the prefetcher, reused between updates.
+  public: std::vector<LogPrefetcher::Message> taken;
+
+  /// \brief Time of the last recorded message, kept here since the log is
+  /// only read from the prefetcher's thread.
+  public: std::chrono::nanoseconds endTime{0};
+
   /// \brief Indicator of whether any playback instance has ever been started
   public: static bool started;
 
@@ -119,6 +166,49 @@ class ignition::gazebo::systems::LogPlaybackPrivate
 
 bool LogPlaybackPrivate::started{false};
 
+//////////////////////////////////////////////////
+void LogPlaybackPrivate::ForEachMessage(const std::chrono::nanoseconds &_start,
+    const std::chrono::nanoseconds &_end,
+    const std::function<bool(const std::chrono::nanoseconds &,
+        const std::string &, const std::string &)> &_cb)
+{
+  if (this->chunkedLog)
+  {
+    if (!this->chunkedLog->Query(_start, _end,
+        [&](const ChunkedLogMessage &_msg)
+        {
+          return _cb(_msg.time, _msg.type, _msg.data);
+        }))
+    {
+      ignerr << "Failed to read chunked log between [" << _start.count()
+             << "] and [" << _end.count() << "] ns." << std::endl;
+    }
+    return;
+  }
+
+  this->batch = this->log->QueryMessages(
+      transport::log::AllTopics({_start, _end}));
+  for (const auto &msg : this->batch)
+  {
+    if (!_cb(msg.TimeReceived(), msg.Type(), msg.Data()))
+      return;
+  }
+}
+
+//////////////////////////////////////////////////
+std::chrono::nanoseconds LogPlaybackPrivate::LogStartTime() const
+{
+  return this->chunkedLog ? this->chunkedLog->StartTime() :
+      this->log->StartTime();
+}
+
+//////////////////////////////////////////////////
+std::chrono::nanoseconds LogPlaybackPrivate::LogEndTime() const
+{
+  return this->chunkedLog ? this->chunkedLog->EndTime() :
+      this->log->EndTime();
+}
+
 //////////////////////////////////////////////////
 LogPlayback::LogPlayback()
   : System(), dataPtr(std::make_unique<LogPlaybackPrivate>())
@@ -160,6 +250,21 @@ void LogPlayback::Configure(const Entity &,
 
   this->dataPtr->eventManager = &_eventMgr;
 
+  // Read ahead of playback, in windows of log time
+  auto prefetchWindow = _sdf->Get<double>("prefetch_window",
+      std::chrono::duration<double>(this->dataPtr->prefetchWindow).count())
+      .first;
+  if (prefetchWindow > 0.0)
+  {
+    this->dataPtr->prefetchWindow =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double>(prefetchWindow));
+  }
+  auto prefetchBatches = _sdf->Get<int>("prefetch_batches",
+      static_cast<int>(this->dataPtr->prefetchBatches)).first;
+  if (prefetchBatches > 0)
+    this->dataPtr->prefetchBatches = prefetchBatches;
+
   // Prepend working directory if path is relative
   this->dataPtr->logPath = common::absPath(this->dataPtr->logPath);
 
@@ -206,56 +311,97 @@ bool LogPlaybackPrivate::Start(EntityComponentManager &_ecm)
     return false;
   }
 
-  // Append file name
+  // Append file name. Chunked logs are preferred if present.
+  std::string chunkedPath = common::joinPaths(this->logPath,
+      kChunkedLogFileName);
   std::string dbPath = common::joinPaths(this->logPath, "state.tlog");
-  ignmsg << "Loading log file [" + dbPath + "]\n";
-  if (!common::exists(dbPath))
+  if (common::exists(chunkedPath))
   {
-    ignerr << "Log path invalid. File [" << dbPath << "] "
-      << "does not exist. Nothing to play.\n";
-    return false;
-  }
+    ignmsg << "Loading chunked log file [" + chunkedPath + "]\n";
+    this->chunkedLog = std::make_unique<ChunkedLogReader>();
+    if (!this->chunkedLog->Open(chunkedPath))
+    {
+      ignerr << "Failed to open log file [" << chunkedPath << "]"
+             << std::endl;
+      this->chunkedLog.reset();
+      return false;
+    }
 
-  // Call Log.hh directly to load a .tlog file
-  this->log = std::make_unique<transport::log::Log>();
-  if (!this->log->Open(dbPath))
-  {
-    ignerr << "Failed to open log file [" << dbPath << "]" << std::endl;
+    if (this->chunkedLog->ChunkCount() == 0)
+    {
+      ignerr << "No messages found in log file [" << chunkedPath << "]"
+             << std::endl;
+    }
   }
+  else
+  {
+    ignmsg << "Loading log file [" + dbPath + "]\n";
+    if (!common::exists(dbPath))
+    {
+      ignerr << "Log path invalid. File [" << dbPath << "] "
+        << "does not exist. Nothing to play.\n";
+      return false;
+    }
 
-  // Access all messages in .tlog file
-  this->batch = this->log->QueryMessages();
-  auto iter = this->batch.begin();
+    // Call Log.hh directly to load a .tlog file
+    this->log = std::make_unique<transport::log::Log>();
+    if (!this->log->Open(dbPath))
+    {
+      ignerr << "Failed to open log file [" << dbPath << "]" << std::endl;
+    }
 
-  if (iter == this->batch.end())
-  {
-    ignerr << "No messages found in log file [" << dbPath << "]" << std::endl;
+    // Access all messages in .tlog file
+    this->batch = this->log->QueryMessages();
+    if (this->batch.begin() == this->batch.end())
+    {
+      ignerr << "No messages found in log file [" << dbPath << "]"
+             << std::endl;
+    }
   }
 
   // Look for the first SerializedState message and use it to set the initial
   // state of the world. Messages received before this are ignored.
-  for (; iter != this->batch.end(); ++iter)
+  auto firstState = [&](const std::string &_type, const std::string &_data)
+      {
+        if (_type == "ignition.msgs.SerializedState")
+        {
+          msgs::SerializedState msg;
+          msg.ParseFromString(_data);
+          this->Parse(_ecm, msg);
+          return false;
+        }
+        else if (_type == "ignition.msgs.SerializedStateMap")
+        {
+          msgs::SerializedStateMap msg;
+          msg.ParseFromString(_data);
+          this->Parse(_ecm, msg);
+          return false;
+        }
+        return true;
+      };
+
+  if (this->chunkedLog)
   {
-    auto msgType = iter->Type();
-    if (msgType == "ignition.msgs.SerializedState")
-    {
-      msgs::SerializedState msg;
-      msg.ParseFromString(iter->Data());
-      this->Parse(_ecm, msg);
-      break;
-    }
-    else if (msgType == "ignition.msgs.SerializedStateMap")
+    this->ForEachMessage(this->LogStartTime(), this->LogEndTime(),
+        [&](const std::chrono::nanoseconds &, const std::string &_type,
+            const std::string &_data)
+        {
+          return firstState(_type, _data);
+        });
+  }
+  else
+  {
+    // Reuse the batch queried above instead of querying the whole log again
+    for (const auto &msg : this->batch)
     {
-      msgs::SerializedStateMap msg;
-      msg.ParseFromString(iter->Data());
-      this->Parse(_ecm, msg);
-      break;
+      if (!firstState(msg.Type(), msg.Data()))
+        break;
     }
   }
 
   msgs::LogPlaybackStatistics logStats;
-  auto startTime = convert<msgs::Time>(this->log->StartTime());
-  auto endTime = convert<msgs::Time>(this->log->EndTime());
+  auto startTime = convert<msgs::Time>(this->LogStartTime());
+  auto endTime = convert<msgs::Time>(this->LogEndTime());
   logStats.mutable_start_time()->set_sec(startTime.sec());
   logStats.mutable_start_time()->set_nsec(startTime.nsec());
   logStats.mutable_end_time()->set_sec(endTime.sec());
@@ -283,6 +429,17 @@ bool LogPlaybackPrivate::Start(EntityComponentManager &_ecm)
 
   this->ReplaceResourceURIs(_ecm);
 
+  // From now on, the log is read ahead of playback
+  this->endTime = this->LogEndTime();
+  this->prefetcher = std::make_unique<LogPrefetcher>(
+      [this](const std::chrono::nanoseconds &_start,
+          const std::chrono::nanoseconds &_end, const auto &_cb)
+      {
+        this->ForEachMessage(_start, _end, _cb);
+      },
+      this->LogStartTime(), this->LogEndTime(), this->prefetchWindow,
+      this->prefetchBatches);
+
   this->instStarted = true;
   LogPlaybackPrivate::started = true;
   return true;
@@ -485,18 +642,19 @@ void LogPlayback::Update(const UpdateInfo &_info, EntityComponentManager &_ecm)
     startTime = std::chrono::steady_clock::duration::zero();
   }
 
-  this->dataPtr->batch = this->dataPtr->log->QueryMessages(
-      transport::log::AllTopics({startTime, endTime}));
+  // Messages are read and parsed ahead by the prefetcher
+  if (seekRewind)
+    this->dataPtr->prefetcher->Seek(startTime);
 
-  auto iter = this->dataPtr->batch.begin();
-  while (iter != this->dataPtr->batch.end())
-  {
-    auto msgType = iter->Type();
+  auto &taken = this->dataPtr->taken;
+  taken.clear();
+  this->dataPtr->prefetcher->Take(startTime, endTime, taken);
 
-    if (msgType == "ignition.msgs.SerializedState")
+  for (const auto &prefetched : taken)
+  {
+    if (prefetched.state)
     {
-      msgs::SerializedState msg;
-      msg.ParseFromString(iter->Data());
+      const auto &msg = *prefetched.state;
 
       // For seeking back in time only:
       // While stepping, update the list of entities to be removed
@@ -519,10 +677,9 @@ void LogPlayback::Update(const UpdateInfo &_info, EntityComponentManager &_ecm)
 
       this->dataPtr->Parse(_ecm, msg);
     }
-    else if (msgType == "ignition.msgs.SerializedStateMap")
+    else if (prefetched.stateMap)
     {
-      msgs::SerializedStateMap msg;
-      msg.ParseFromString(iter->Data());
+      const auto &msg = *prefetched.stateMap;
 
       // For seeking back in time only:
       // While stepping, update the list of entities to be removed
@@ -546,17 +703,16 @@ void LogPlayback::Update(const UpdateInfo &_info, EntityComponentManager &_ecm)
 
       this->dataPtr->Parse(_ecm, msg);
     }
-    else if (msgType == "ignition.msgs.StringMsg")
+    else if (prefetched.type == "ignition.msgs.StringMsg")
     {
       // Do nothing, we assume this is the SDF string
     }
     else
     {
       ignwarn << "Trying to playback unsupported message type ["
-              << msgType << "]" << std::endl;
+              << prefetched.type << "]" << std::endl;
     }
     this->dataPtr->ReplaceResourceURIs(_ecm);
-    ++iter;
   }
 
     // particle emitters
@@ -592,11 +748,11 @@ void LogPlayback::Update(const UpdateInfo &_info, EntityComponentManager &_ecm)
   }
 
   // pause playback if end of log is reached
-  if (_info.simTime >= this->dataPtr->log->EndTime())
+  if (_info.simTime >= this->dataPtr->endTime)
   {
     ignmsg << "End of log file reached. Time: " <<
       std::chrono::duration_cast<std::chrono::seconds>(
-      this->dataPtr->log->EndTime()).count() << " seconds" << std::endl;
+      this->dataPtr->endTime).count() << " seconds" << std::endl;
 
     this->dataPtr->eventManager->Emit<events::Pause>(true);
   }
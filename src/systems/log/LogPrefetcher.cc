@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "LogPrefetcher.hh"
+
+#include <algorithm>
+#include <utility>
+
+#include <ignition/common/Profiler.hh>
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+
+//////////////////////////////////////////////////
+LogPrefetcher::LogPrefetcher(QueryFn _query,
+    const std::chrono::nanoseconds &_logStart,
+    const std::chrono::nanoseconds &_logEnd,
+    const std::chrono::nanoseconds &_window, std::size_t _capacity)
+  : query(std::move(_query)), logEnd(_logEnd),
+    window(std::max(_window, std::chrono::nanoseconds(1))),
+    capacity(std::max<std::size_t>(_capacity, 1u)), nextStart(_logStart),
+    done(_logStart > _logEnd)
+{
+  this->thread = std::thread(&LogPrefetcher::Run, this);
+}
+
+//////////////////////////////////////////////////
+LogPrefetcher::~LogPrefetcher()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->stop = true;
+  }
+  this->drained.notify_all();
+  if (this->thread.joinable())
+    this->thread.join();
+}
+
+//////////////////////////////////////////////////
+void LogPrefetcher::Seek(const std::chrono::nanoseconds &_time)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    ++this->generation;
+    this->ring.clear();
+    this->nextStart = _time;
+    this->done = _time > this->logEnd;
+  }
+  this->drained.notify_all();
+}
+
+//////////////////////////////////////////////////
+void LogPrefetcher::Take(const std::chrono::nanoseconds &_start,
+    const std::chrono::nanoseconds &_end, std::vector<Message> &_msgs)
+{
+  IGN_PROFILE("LogPrefetcher::Take");
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (true)
+  {
+    this->filled.wait(lock, [this]
+        {
+          return !this->ring.empty() || this->done;
+        });
+
+    // End of log
+    if (this->ring.empty())
+      return;
+
+    auto &batch = this->ring.front();
+    for (; batch.next < batch.msgs.size(); ++batch.next)
+    {
+      auto &msg = batch.msgs[batch.next];
+      if (msg.time > _end)
+        return;
+      if (msg.time >= _start)
+        _msgs.push_back(std::move(msg));
+    }
+
+    // Keep the batch until time goes past its window
+    if (batch.end > _end)
+      return;
+
+    this->ring.pop_front();
+    this->drained.notify_all();
+  }
+}
+
+//////////////////////////////////////////////////
+void LogPrefetcher::Run()
+{
+  IGN_PROFILE_THREAD_NAME("LogPrefetcher");
+
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (true)
+  {
+    this->drained.wait(lock, [this]
+        {
+          return this->stop ||
+              (!this->done && this->ring.size() < this->capacity);
+        });
+
+    if (this->stop)
+      return;
+
+    auto generation = this->generation;
+    Batch batch;
+    auto start = this->nextStart;
+    batch.end = start + this->window - std::chrono::nanoseconds(1);
+    lock.unlock();
+
+    {
+      IGN_PROFILE("LogPrefetcher::Read");
+      this->query(start, batch.end,
+          [&](const std::chrono::nanoseconds &_time, const std::string &_type,
+              const std::string &_data)
+          {
+            Message msg;
+            msg.time = _time;
+            msg.type = _type;
+            if (_type == "ignition.msgs.SerializedState")
+            {
+              msg.state = std::make_unique<msgs::SerializedState>();
+              msg.state->ParseFromString(_data);
+            }
+            else if (_type == "ignition.msgs.SerializedStateMap")
+            {
+              msg.stateMap = std::make_unique<msgs::SerializedStateMap>();
+              msg.stateMap->ParseFromString(_data);
+            }
+            batch.msgs.push_back(std::move(msg));
+            return true;
+          });
+    }
+
+    lock.lock();
+
+    // Seeked while reading
+    if (generation != this->generation)
+      continue;
+
+    this->nextStart = batch.end + std::chrono::nanoseconds(1);
+    this->done = this->nextStart > this->logEnd;
+    this->ring.push_back(std::move(batch));
+    this->filled.notify_all();
+  }
+}
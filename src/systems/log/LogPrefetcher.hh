@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GAZEBO_SYSTEMS_LOGPREFETCHER_HH_
+#define IGNITION_GAZEBO_SYSTEMS_LOGPREFETCHER_HH_
+
+#include <ignition/msgs/serialized.pb.h>
+#include <ignition/msgs/serialized_map.pb.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/log-system/Export.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems
+{
+  /// \brief Reads and parses upcoming log messages from a background
+  /// thread.
+  ///
+  /// The log is read in fixed windows of time into a bounded ring of
+  /// batches, ahead of playback. State messages are parsed on the
+  /// background thread, so the simulation thread only applies them.
+  class IGNITION_GAZEBO_LOG_SYSTEM_VISIBLE LogPrefetcher
+  {
+    /// \brief Function that calls _cb for each message recorded within
+    /// [_start, _end], with the time, type and serialized data of the
+    /// message. _cb returns false to stop.
+    public: using QueryFn = std::function<void(
+        const std::chrono::nanoseconds &_start,
+        const std::chrono::nanoseconds &_end,
+        const std::function<bool(const std::chrono::nanoseconds &,
+            const std::string &, const std::string &)> &_cb)>;
+
+    /// \brief A prefetched message.
+    public: struct Message
+    {
+      /// \brief Time stamp.
+      std::chrono::nanoseconds time{0};
+
+      /// \brief Message type.
+      std::string type;
+
+      /// \brief Parsed message, if it's a SerializedState.
+      std::unique_ptr<msgs::SerializedState> state;
+
+      /// \brief Parsed message, if it's a SerializedStateMap.
+      std::unique_ptr<msgs::SerializedStateMap> stateMap;
+    };
+
+    /// \brief Constructor. Starts reading from the start of the log.
+    /// \param[in] _query Function used to read the log. It's only called
+    /// from the background thread.
+    /// \param[in] _logStart Time of the first message in the log.
+    /// \param[in] _logEnd Time of the last message in the log.
+    /// \param[in] _window Length of time read at once.
+    /// \param[in] _capacity Maximum number of windows read ahead.
+    public: LogPrefetcher(QueryFn _query,
+                          const std::chrono::nanoseconds &_logStart,
+                          const std::chrono::nanoseconds &_logEnd,
+                          const std::chrono::nanoseconds &_window,
+                          std::size_t _capacity);
+
+    /// \brief Destructor. Stops the background thread.
+    public: ~LogPrefetcher();
+
+    /// \brief Drop everything read ahead and continue reading from the
+    /// given time.
+    /// \param[in] _time Time to read from.
+    public: void Seek(const std::chrono::nanoseconds &_time);
+
+    /// \brief Take the messages up to the given time which haven't been
+    /// taken yet, waiting for them to be read if needed. Messages before
+    /// _start are dropped.
+    /// \param[in] _start Time of the earliest message to take.
+    /// \param[in] _end Time of the latest message to take.
+    /// \param[out] _msgs Messages are appended here, in log order.
+    public: void Take(const std::chrono::nanoseconds &_start,
+                      const std::chrono::nanoseconds &_end,
+                      std::vector<Message> &_msgs);
+
+    /// \brief Main loop of the background thread.
+    private: void Run();
+
+    /// \brief Messages read from one window of time.
+    private: struct Batch
+    {
+      /// \brief End of the window, inclusive.
+      std::chrono::nanoseconds end{0};
+
+      /// \brief Messages in the window.
+      std::vector<Message> msgs;
+
+      /// \brief Index of the next message to be taken.
+      std::size_t next{0};
+    };
+
+    /// \brief Function used to read the log.
+    private: QueryFn query;
+
+    /// \brief Time of the last message in the log.
+    private: std::chrono::nanoseconds logEnd;
+
+    /// \brief Length of time read at once.
+    private: std::chrono::nanoseconds window;
+
+    /// \brief Maximum number of batches in the ring.
+    private: std::size_t capacity;
+
+    /// \brief Background thread.
+    private: std::thread thread;
+
+    /// \brief Protects all the members below.
+    private: std::mutex mutex;
+
+    /// \brief Signaled when a batch is added or the end of log is reached.
+    private: std::condition_variable filled;
+
+    /// \brief Signaled when a batch is taken, on seek, or on stop.
+    private: std::condition_variable drained;
+
+    /// \brief Batches read ahead, in time order.
+    private: std::deque<Batch> ring;
+
+    /// \brief Start of the next window to be read.
+    private: std::chrono::nanoseconds nextStart{0};
+
+    /// \brief Incremented on seek, so a window being read is discarded.
+    private: uint64_t generation{0};
+
+    /// \brief True once the whole log has been read.
+    private: bool done{false};
+
+    /// \brief True when the background thread should exit.
+    private: bool stop{false};
+  };
+}
+}
+}
+}
+#endif
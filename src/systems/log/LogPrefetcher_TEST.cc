@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "LogPrefetcher.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+using namespace std::chrono_literals;
+
+/////////////////////////////////////////////////
+TEST(LogPrefetcherTest, TakeAndSeek)
+{
+  // A log with a state every millisecond, from 0 to 99 ms
+  std::atomic<int> queries{0};
+  auto query = [&](const std::chrono::nanoseconds &_start,
+      const std::chrono::nanoseconds &_end, const auto &_cb)
+  {
+    ++queries;
+    for (auto time = 0ms; time < 100ms; ++time)
+    {
+      if (time < _start || time > _end)
+        continue;
+
+      msgs::SerializedStateMap msg;
+      (*msg.mutable_entities())[1].set_id(time.count());
+      if (!_cb(time, "ignition.msgs.SerializedStateMap",
+          msg.SerializeAsString()))
+      {
+        return;
+      }
+    }
+  };
+
+  LogPrefetcher prefetcher(query, 0ms, 99ms, 10ms, 2);
+
+  std::vector<LogPrefetcher::Message> msgs;
+  prefetcher.Take(0ms, 4ms, msgs);
+  ASSERT_EQ(5u, msgs.size());
+  for (int i = 0; i < 5; ++i)
+  {
+    EXPECT_EQ(std::chrono::milliseconds(i), msgs[i].time);
+    ASSERT_NE(nullptr, msgs[i].stateMap);
+    EXPECT_EQ(nullptr, msgs[i].state);
+    EXPECT_EQ(static_cast<uint64_t>(i),
+        msgs[i].stateMap->entities().at(1).id());
+  }
+
+  // Messages already taken aren't taken again, even if the range overlaps
+  msgs.clear();
+  prefetcher.Take(4ms, 25ms, msgs);
+  ASSERT_EQ(21u, msgs.size());
+  EXPECT_EQ(5ms, msgs.front().time);
+  EXPECT_EQ(25ms, msgs.back().time);
+
+  // Messages before the start are dropped
+  msgs.clear();
+  prefetcher.Take(30ms, 31ms, msgs);
+  ASSERT_EQ(2u, msgs.size());
+  EXPECT_EQ(30ms, msgs.front().time);
+
+  // Rewind
+  msgs.clear();
+  prefetcher.Seek(0ms);
+  prefetcher.Take(0ms, 2ms, msgs);
+  ASSERT_EQ(3u, msgs.size());
+  EXPECT_EQ(0ms, msgs.front().time);
+
+  // Past the end of the log
+  msgs.clear();
+  prefetcher.Take(3ms, 200ms, msgs);
+  ASSERT_EQ(97u, msgs.size());
+  EXPECT_EQ(99ms, msgs.back().time);
+
+  msgs.clear();
+  prefetcher.Take(200ms, 300ms, msgs);
+  EXPECT_TRUE(msgs.empty());
+
+  // The log was read in windows, not once per take
+  EXPECT_LT(queries, 20);
+}
+
+/////////////////////////////////////////////////
+TEST(LogPrefetcherTest, OtherTypes)
+{
+  auto query = [](const std::chrono::nanoseconds &,
+      const std::chrono::nanoseconds &, const auto &_cb)
+  {
+    msgs::SerializedState state;
+    _cb(0ms, "ignition.msgs.SerializedState", state.SerializeAsString());
+    _cb(1ms, "ignition.msgs.StringMsg", "<sdf/>");
+  };
+
+  LogPrefetcher prefetcher(query, 0ms, 1ms, 1s, 4);
+
+  std::vector<LogPrefetcher::Message> msgs;
+  prefetcher.Take(0ms, 1ms, msgs);
+  ASSERT_EQ(2u, msgs.size());
+  EXPECT_NE(nullptr, msgs[0].state);
+  EXPECT_EQ(nullptr, msgs[0].stateMap);
+  EXPECT_EQ("ignition.msgs.StringMsg", msgs[1].type);
+  EXPECT_EQ(nullptr, msgs[1].state);
+  EXPECT_EQ(nullptr, msgs[1].stateMap);
+}
@@ -20,11 +20,14 @@
 #include <sys/stat.h>
 #include <ignition/msgs/stringmsg.pb.h>
 
+#include <algorithm>
 #include <string>
 #include <fstream>
 #include <ctime>
 #include <set>
 #include <list>
+#include <memory>
+#include <utility>
 
 #include <ignition/common/Console.hh>
 #include <ignition/common/Filesystem.hh>
@@ -60,6 +63,9 @@
 
 #include "ignition/gazebo/Util.hh"
 
+#include "ChunkedLog.hh"
+#include "LogWriter.hh"
+
 using namespace ignition;
 using namespace ignition::gazebo;
 using namespace ignition::gazebo::systems;
@@ -143,6 +149,19 @@ class ignition::gazebo::systems::LogRecordPrivate
   /// \brief Publisher for state changes
   public: transport::Node::Publisher statePub;
 
+  /// \brief Topic which the SDF is published and recorded under. Empty if
+  /// no valid topic could be generated.
+  public: std::string sdfTopic;
+
+  /// \brief Topic which state changes are published and recorded under.
+  /// Empty if no valid topic could be generated.
+  public: std::string stateTopic;
+
+  /// \brief Writes the SDF and state straight into the log, instead of
+  /// going through the transport recorder. Used when no other topics are
+  /// recorded. Null when using the recorder.
+  public: std::unique_ptr<LogWriter> writer;
+
   /// \brief Message holding SDF string of world
   public: msgs::StringMsg sdfMsg;
 
@@ -185,8 +204,12 @@ LogRecord::~LogRecord()
 {
   if (this->dataPtr->instStarted)
   {
-    // Use ign-transport directly
-    this->dataPtr->recorder.Stop();
+    // Write everything that's queued before compressing, or stop the
+    // ign-transport recorder
+    if (this->dataPtr->writer)
+      this->dataPtr->writer->Close();
+    else
+      this->dataPtr->recorder.Stop();
 
     if (this->dataPtr->compress)
       this->dataPtr->CompressStateAndResources();
@@ -284,6 +307,7 @@ bool LogRecordPrivate::Start(const std::string &_logPath,
   // Use directory basename as topic name, to be able to retrieve at playback
   std::string sdfTopic = "/" + common::basename(this->logPath) + "/sdf";
   auto validSdfTopic = transport::TopicUtils::AsValidTopic(sdfTopic);
+  this->sdfTopic = validSdfTopic;
   if (!validSdfTopic.empty())
   {
     this->sdfPub = this->node.Advertise(validSdfTopic,
@@ -298,6 +322,7 @@ bool LogRecordPrivate::Start(const std::string &_logPath,
   // TODO(louise) Combine with SceneBroadcaster's state topic
   std::string stateTopic = "/world/" + this->worldName + "/changed_state";
   auto validStateTopic = transport::TopicUtils::AsValidTopic(stateTopic);
+  this->stateTopic = validStateTopic;
   if (!validStateTopic.empty())
   {
     this->statePub = this->node.Advertise<msgs::SerializedStateMap>(
@@ -316,8 +341,69 @@ bool LogRecordPrivate::Start(const std::string &_logPath,
     ignmsg << "Overwriting existing file [" << dbPath << "]\n";
     common::removeFile(dbPath);
   }
+
+  // Playback prefers a chunked log, so don't leave a stale one behind
+  std::string chunkedPath = common::joinPaths(this->logPath,
+      kChunkedLogFileName);
+  if (common::exists(chunkedPath))
+  {
+    ignmsg << "Overwriting existing file [" << chunkedPath << "]\n";
+    common::removeFile(chunkedPath);
+  }
+
+  // The chunked format keeps the state compressed on disk while recording.
+  // It's only supported when recording the SDF and state.
+  auto format = this->sdf->Get<std::string>("log_format", "sqlite").first;
+  bool chunked = format == "chunked";
+  if (chunked && this->sdf->HasElement("record_topic"))
+  {
+    ignwarn << "The chunked log format doesn't support <record_topic>. "
+            << "Recording to [" << dbPath << "] instead." << std::endl;
+    chunked = false;
+  }
+  else if (!chunked && format != "sqlite")
+  {
+    ignwarn << "Unknown log format [" << format << "], using [sqlite]."
+            << std::endl;
+  }
+
+  if (chunked)
+  {
+    auto chunkMessages = this->sdf->Get<int>("chunk_messages", 1000).first;
+    auto chunkBytes = this->sdf->Get<int>("chunk_bytes", 4194304).first;
+
+    this->writer = std::make_unique<LogWriter>();
+    if (this->writer->OpenChunked(chunkedPath,
+        static_cast<std::size_t>(std::max(chunkMessages, 1)),
+        static_cast<std::size_t>(std::max(chunkBytes, 1))))
+    {
+      ignmsg << "Recording chunked state to [" << chunkedPath << "]"
+             << std::endl;
+      this->instStarted = true;
+      return true;
+    }
+    this->writer.reset();
+    return false;
+  }
+
   ignmsg << "Recording to log file [" << dbPath << "]" << std::endl;
 
+  // If only the SDF and state are recorded, they're written straight into
+  // the log from a background thread, instead of being published, received
+  // by the recorder and serialized again.
+  if (!this->sdf->HasElement("record_topic"))
+  {
+    this->writer = std::make_unique<LogWriter>();
+    if (this->writer->Open(dbPath))
+    {
+      igndbg << "Recording SDF and state directly." << std::endl;
+      this->instStarted = true;
+      return true;
+    }
+    this->writer.reset();
+    return false;
+  }
+
   // Add default topics if no topics were specified.
   igndbg << "Recording default topic[" << sdfTopic << "].\n";
   igndbg << "Recording default topic[" << stateTopic << "].\n";
@@ -640,7 +726,7 @@ void LogRecord::PreUpdate(const UpdateInfo &_info,
 {
   IGN_PROFILE("LogRecord::PreUpdate");
   // Safe guard to prevent seg faults if recorder could not be started
-  if (!this->dataPtr->instStarted)
+  if (!this->dataPtr->instStarted || !this->dataPtr->clock)
     return;
   this->dataPtr->clock->SetTime(_info.simTime);
 }
@@ -684,6 +770,11 @@ void LogRecord::PostUpdate(const UpdateInfo &_info,
         this->dataPtr->sdfMsg.set_data(
             worldSdfComp->Data().Element()->ToString(""));
 
+        if (this->dataPtr->writer && !this->dataPtr->sdfTopic.empty())
+        {
+          this->dataPtr->writer->Write(_info.simTime, this->dataPtr->sdfTopic,
+              std::make_unique<msgs::StringMsg>(this->dataPtr->sdfMsg));
+        }
         this->dataPtr->sdfPub.Publish(this->dataPtr->sdfMsg);
         this->dataPtr->sdfPublished = true;
       }
@@ -696,10 +787,22 @@ void LogRecord::PostUpdate(const UpdateInfo &_info,
   // to store complete state periodically, and then store incremental from
   // that. It would reduce some of the compute on replaying
   // (especially in tools like plotting or seeking through logs).
-  msgs::SerializedStateMap stateMsg;
-  _ecm.ChangedState(stateMsg);
-  if (!stateMsg.entities().empty())
-    this->dataPtr->statePub.Publish(stateMsg);
+  auto stateMsg = std::make_unique<msgs::SerializedStateMap>();
+  _ecm.ChangedState(*stateMsg);
+  if (!stateMsg->entities().empty())
+  {
+    // The recorder receives the state through transport. With the direct
+    // writer, it's only published for live subscribers, and serialized on
+    // the writer's thread.
+    if (!this->dataPtr->writer || this->dataPtr->statePub.HasConnections())
+      this->dataPtr->statePub.Publish(*stateMsg);
+
+    if (this->dataPtr->writer && !this->dataPtr->stateTopic.empty())
+    {
+      this->dataPtr->writer->Write(_info.simTime, this->dataPtr->stateTopic,
+          std::move(stateMsg));
+    }
+  }
 
   // If there are new models loaded, save meshes and textures
   if (this->dataPtr->RecordResources() && _ecm.HasNewEntities())
@@ -0,0 +1,226 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include "LogWriter.hh"
+
+#include <algorithm>
+#include <utility>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Profiler.hh>
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+
+//////////////////////////////////////////////////
+LogWriter::~LogWriter()
+{
+  this->Close();
+}
+
+//////////////////////////////////////////////////
+bool LogWriter::Open(const std::string &_path)
+{
+  if (this->thread.joinable())
+  {
+    ignerr << "Log writer is already open." << std::endl;
+    return false;
+  }
+
+  auto log = std::make_unique<transport::log::Log>();
+  if (!log->Open(_path, std::ios_base::out))
+  {
+    ignerr << "Failed to open log file [" << _path << "] for writing."
+           << std::endl;
+    return false;
+  }
+
+  this->log = std::move(log);
+  this->stop = false;
+  this->thread = std::thread(&LogWriter::Run, this);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool LogWriter::OpenChunked(const std::string &_path,
+    std::size_t _chunkMessages, std::size_t _chunkBytes)
+{
+  if (this->thread.joinable())
+  {
+    ignerr << "Log writer is already open." << std::endl;
+    return false;
+  }
+
+  auto chunked = std::make_unique<ChunkedLogWriter>(_chunkMessages,
+      _chunkBytes);
+  if (!chunked->Open(_path))
+    return false;
+
+  this->chunkedLog = std::move(chunked);
+  this->stop = false;
+  this->thread = std::thread(&LogWriter::Run, this);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void LogWriter::Write(const std::chrono::nanoseconds &_time,
+    const std::string &_topic,
+    std::unique_ptr<google::protobuf::Message> _msg)
+{
+  if (nullptr == _msg)
+    return;
+
+  {
+    std::unique_lock<std::mutex> lock(this->mutex);
+
+    // Don't let a slow disk use up memory
+    if (this->queue.size() >= this->queueLimit && this->thread.joinable())
+    {
+      if (!this->queueFullWarned)
+      {
+        ignwarn << "Log writer queue is full, the simulation will wait for "
+                << "messages to be written." << std::endl;
+        this->queueFullWarned = true;
+      }
+      IGN_PROFILE("LogWriter::Write wait");
+      this->written.wait(lock, [this]
+          {
+            return this->queue.size() < this->queueLimit || this->stop;
+          });
+    }
+
+    this->queue.push_back({_time, _topic, std::move(_msg)});
+  }
+  this->queued.notify_one();
+}
+
+//////////////////////////////////////////////////
+void LogWriter::SetQueueLimit(std::size_t _limit)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  this->queueLimit = std::max<std::size_t>(_limit, 1u);
+}
+
+//////////////////////////////////////////////////
+void LogWriter::Flush()
+{
+  std::unique_lock<std::mutex> lock(this->mutex);
+  if (!this->thread.joinable())
+    return;
+
+  this->written.wait(lock, [this]
+      {
+        return this->queue.empty() && !this->writing;
+      });
+}
+
+//////////////////////////////////////////////////
+void LogWriter::Close()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->stop = true;
+  }
+  this->queued.notify_all();
+
+  if (!this->thread.joinable())
+    return;
+
+  this->thread.join();
+
+  // Write the last partial chunk
+  if (this->chunkedLog)
+    this->chunkedLog->Close();
+
+  // Commit the last transaction, so the file can be compressed or moved
+  this->log.reset();
+
+  igndbg << "Log writer wrote [" << this->writtenCount
+         << "] messages, up to [" << this->maxBatch << "] per batch."
+         << std::endl;
+}
+
+//////////////////////////////////////////////////
+uint64_t LogWriter::WrittenCount() const
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  return this->writtenCount;
+}
+
+//////////////////////////////////////////////////
+void LogWriter::Run()
+{
+  IGN_PROFILE_THREAD_NAME("LogWriter");
+
+  std::vector<Entry> batch;
+  std::string data;
+  std::unique_lock<std::mutex> lock(this->mutex);
+  while (true)
+  {
+    this->queued.wait(lock, [this]
+        {
+          return this->stop || !this->queue.empty();
+        });
+
+    if (this->queue.empty())
+    {
+      // Stopping and nothing left to write
+      return;
+    }
+
+    batch.swap(this->queue);
+    this->writing = true;
+    lock.unlock();
+
+    // Writers blocked on a full queue can go on
+    this->written.notify_all();
+
+    {
+      IGN_PROFILE("LogWriter::Write");
+      for (const auto &entry : batch)
+      {
+        data.clear();
+        if (!entry.msg->SerializeToString(&data))
+        {
+          ignerr << "Failed to serialize message of type ["
+                 << entry.msg->GetTypeName() << "] on topic [" << entry.topic
+                 << "]." << std::endl;
+          continue;
+        }
+
+        bool inserted = this->chunkedLog ?
+            this->chunkedLog->Write(entry.time, entry.topic,
+                entry.msg->GetTypeName(), data) :
+            this->log->InsertMessage(entry.time, entry.topic,
+                entry.msg->GetTypeName(), data.data(), data.size());
+        if (!inserted)
+        {
+          ignerr << "Failed to write message on topic [" << entry.topic
+                 << "] to the log." << std::endl;
+        }
+      }
+    }
+
+    lock.lock();
+    this->writtenCount += batch.size();
+    this->maxBatch = std::max(this->maxBatch, batch.size());
+    this->writing = false;
+    batch.clear();
+    this->written.notify_all();
+  }
+}
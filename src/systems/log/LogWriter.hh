@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_GAZEBO_SYSTEMS_LOGWRITER_HH_
+#define IGNITION_GAZEBO_SYSTEMS_LOGWRITER_HH_
+
+#include <google/protobuf/message.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/log-system/Export.hh>
+#include <ignition/transport/log/Log.hh>
+
+#include "ChunkedLog.hh"
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems
+{
+  /// \brief Writes messages straight into a transport log file, or a
+  /// chunked log, from a background thread, without going through transport.
+  ///
+  /// Messages are handed over without being serialized. The I/O thread
+  /// takes all the queued messages at once, then serializes and inserts
+  /// them, so the simulation thread only pays for queuing. If the disk
+  /// can't keep up and the queue reaches its limit, Write blocks until the
+  /// I/O thread takes the queue, rather than dropping state.
+  class IGNITION_GAZEBO_LOG_SYSTEM_VISIBLE LogWriter
+  {
+    /// \brief Destructor. Writes the remaining messages and closes the log.
+    public: ~LogWriter();
+
+    /// \brief Open a log file for writing and start the I/O thread.
+    /// \param[in] _path Path to the log file.
+    /// \return True if the file was opened.
+    public: bool Open(const std::string &_path);
+
+    /// \brief Create a chunked log for writing and start the I/O thread.
+    /// \param[in] _path Path to the log file.
+    /// \param[in] _chunkMessages Messages per chunk.
+    /// \param[in] _chunkBytes Uncompressed bytes per chunk.
+    /// \return True if the file was created.
+    /// \sa ChunkedLogWriter
+    public: bool OpenChunked(const std::string &_path,
+                             std::size_t _chunkMessages,
+                             std::size_t _chunkBytes);
+
+    /// \brief Queue a message to be written. Blocks while the queue is
+    /// full.
+    /// \param[in] _time Time stamp of the message.
+    /// \param[in] _topic Topic the message is recorded under.
+    /// \param[in] _msg Message. The writer takes ownership of it.
+    public: void Write(const std::chrono::nanoseconds &_time,
+                       const std::string &_topic,
+                       std::unique_ptr<google::protobuf::Message> _msg);
+
+    /// \brief Block until all the queued messages have been written.
+    public: void Flush();
+
+    /// \brief Set the number of queued messages at which Write blocks.
+    /// \param[in] _limit Message count, at least 1. Defaults to 10000.
+    public: void SetQueueLimit(std::size_t _limit);
+
+    /// \brief Stop the I/O thread after writing the queued messages, and
+    /// close the log file, so it's complete on disk.
+    public: void Close();
+
+    /// \brief Number of messages written so far.
+    /// \return Message count.
+    public: uint64_t WrittenCount() const;
+
+    /// \brief Main loop of the I/O thread.
+    private: void Run();
+
+    /// \brief A queued message.
+    private: struct Entry
+    {
+      /// \brief Time stamp.
+      std::chrono::nanoseconds time;
+
+      /// \brief Topic.
+      std::string topic;
+
+      /// \brief Message.
+      std::unique_ptr<google::protobuf::Message> msg;
+    };
+
+    /// \brief Log file, only accessed from the I/O thread once opened.
+    /// Null unless a log file is open.
+    private: std::unique_ptr<transport::log::Log> log;
+
+    /// \brief Chunked log, used instead of log if not null. Only accessed
+    /// from the I/O thread once opened.
+    private: std::unique_ptr<ChunkedLogWriter> chunkedLog;
+
+    /// \brief I/O thread.
+    private: std::thread thread;
+
+    /// \brief Protects all the members below.
+    private: mutable std::mutex mutex;
+
+    /// \brief Signaled when messages are queued or the writer stops.
+    private: std::condition_variable queued;
+
+    /// \brief Signaled when a batch has been written.
+    private: std::condition_variable written;
+
+    /// \brief Messages waiting to be written.
+    private: std::vector<Entry> queue;
+
+    /// \brief Number of queued messages at which Write blocks.
+    private: std::size_t queueLimit{10000};
+
+    /// \brief True once Write has blocked on a full queue, to only warn
+    /// once.
+    private: bool queueFullWarned{false};
+
+    /// \brief True while the I/O thread is writing a batch.
+    private: bool writing{false};
+
+    /// \brief Number of messages written.
+    private: uint64_t writtenCount{0};
+
+    /// \brief Largest number of messages written in one batch.
+    private: std::size_t maxBatch{0};
+
+    /// \brief True when the I/O thread should exit.
+    private: bool stop{false};
+  };
+}
+}
+}
+}
+#endif
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include <ignition/common/Filesystem.hh>
+#include <ignition/msgs/serialized_map.pb.h>
+#include <ignition/transport/log/Log.hh>
+
+#include "ignition/gazebo/test_config.hh"
+#include "ChunkedLog.hh"
+#include "LogWriter.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+using namespace std::chrono_literals;
+
+/// \brief Queue a state per millisecond, without waiting for them to be
+/// written.
+/// \param[in] _writer Open writer.
+/// \param[in] _count Number of states.
+void writeStates(LogWriter &_writer, int _count)
+{
+  for (int i = 0; i < _count; ++i)
+  {
+    auto msg = std::make_unique<msgs::SerializedStateMap>();
+    (*msg->mutable_entities())[1].set_id(i);
+    _writer.Write(std::chrono::milliseconds(i), "/world/default/changed_state",
+        std::move(msg));
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(LogWriterTest, CloseCommitsLastStep)
+{
+  const auto dir = common::joinPaths(PROJECT_BINARY_PATH, "log_writer_test");
+  common::removeAll(dir);
+  ASSERT_TRUE(common::createDirectories(dir));
+  const auto path = common::joinPaths(dir, "state.tlog");
+
+  LogWriter writer;
+  ASSERT_TRUE(writer.Open(path));
+  writeStates(writer, 100);
+  writer.Close();
+  EXPECT_EQ(100u, writer.WrittenCount());
+
+  // Once closed, the file is complete on disk, even if it's moved, as
+  // it's done when compressing a recording, before the writer is gone
+  const auto movedPath = common::joinPaths(PROJECT_BINARY_PATH,
+      "log_writer_test.tlog");
+  common::removeFile(movedPath);
+  ASSERT_TRUE(common::copyFile(path, movedPath));
+  common::removeAll(dir);
+
+  transport::log::Log log;
+  ASSERT_TRUE(log.Open(movedPath, std::ios_base::in));
+
+  int count{0};
+  msgs::SerializedStateMap last;
+  std::chrono::nanoseconds lastTime{-1};
+  for (const auto &msg : log.QueryMessages())
+  {
+    EXPECT_EQ("/world/default/changed_state", msg.Topic());
+    EXPECT_EQ(last.GetTypeName(), msg.Type());
+    EXPECT_TRUE(last.ParseFromString(msg.Data()));
+    lastTime = msg.TimeReceived();
+    ++count;
+  }
+  EXPECT_EQ(100, count);
+  EXPECT_EQ(99ms, lastTime);
+  ASSERT_EQ(1, last.entities_size());
+  EXPECT_EQ(99u, last.entities().at(1).id());
+}
+
+/////////////////////////////////////////////////
+TEST(LogWriterTest, CloseWritesLastChunk)
+{
+  const auto path = common::joinPaths(PROJECT_BINARY_PATH,
+      "log_writer_test.clog");
+  common::removeFile(path);
+
+  LogWriter writer;
+  ASSERT_TRUE(writer.OpenChunked(path, 30, 1u << 20));
+  writeStates(writer, 100);
+  writer.Close();
+
+  ChunkedLogReader reader;
+  ASSERT_TRUE(reader.Open(path));
+  EXPECT_EQ(4u, reader.ChunkCount());
+  EXPECT_EQ(99ms, reader.EndTime());
+
+  msgs::SerializedStateMap last;
+  EXPECT_TRUE(reader.Query(99ms, 99ms, [&](const ChunkedLogMessage &_msg)
+      {
+        EXPECT_TRUE(last.ParseFromString(_msg.data));
+        return true;
+      }));
+  ASSERT_EQ(1, last.entities_size());
+  EXPECT_EQ(99u, last.entities().at(1).id());
+}
+
+/////////////////////////////////////////////////
+TEST(LogWriterTest, QueueLimit)
+{
+  const auto path = common::joinPaths(PROJECT_BINARY_PATH,
+      "log_writer_test_limit.clog");
+  common::removeFile(path);
+
+  // Writes wait for the I/O thread instead of dropping messages
+  LogWriter writer;
+  writer.SetQueueLimit(5);
+  ASSERT_TRUE(writer.OpenChunked(path, 30, 1u << 20));
+  writeStates(writer, 100);
+  writer.Close();
+  EXPECT_EQ(100u, writer.WrittenCount());
+}
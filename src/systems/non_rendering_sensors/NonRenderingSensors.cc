@@ -0,0 +1,823 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "NonRenderingSensors.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <ignition/msgs/param.pb.h>
+
+#include <ignition/plugin/Register.hh>
+
+#include <sdf/Element.hh>
+#include <sdf/Sensor.hh>
+
+#include <ignition/common/Profiler.hh>
+
+#include <ignition/math/Helpers.hh>
+
+#include <ignition/transport/Node.hh>
+
+#include <ignition/sensors/AirPressureSensor.hh>
+#include <ignition/sensors/AltimeterSensor.hh>
+#include <ignition/sensors/ImuSensor.hh>
+#include <ignition/sensors/MagnetometerSensor.hh>
+#include <ignition/sensors/NavSatSensor.hh>
+#include <ignition/sensors/SensorFactory.hh>
+
+#include "ignition/gazebo/Conversions.hh"
+#include "ignition/gazebo/World.hh"
+#include "ignition/gazebo/components/AirPressureSensor.hh"
+#include "ignition/gazebo/components/Altimeter.hh"
+#include "ignition/gazebo/components/AngularVelocity.hh"
+#include "ignition/gazebo/components/Gravity.hh"
+#include "ignition/gazebo/components/Imu.hh"
+#include "ignition/gazebo/components/LinearAcceleration.hh"
+#include "ignition/gazebo/components/LinearVelocity.hh"
+#include "ignition/gazebo/components/MagneticField.hh"
+#include "ignition/gazebo/components/Magnetometer.hh"
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/NavSat.hh"
+#include "ignition/gazebo/components/ParentEntity.hh"
+#include "ignition/gazebo/components/Pose.hh"
+#include "ignition/gazebo/components/Sensor.hh"
+#include "ignition/gazebo/components/World.hh"
+#include "ignition/gazebo/EntityComponentManager.hh"
+#include "ignition/gazebo/Util.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+
+/// \brief Types of sensors handled by the system. Due sensors are updated
+/// in this order.
+enum class SensorKind
+{
+  IMU,
+  MAGNETOMETER,
+  ALTIMETER,
+  AIR_PRESSURE,
+  NAVSAT
+};
+
+/// \brief A sensor and the components it reads.
+struct SensorRecord
+{
+  /// \brief Sensor entity.
+  Entity entity{kNullEntity};
+
+  /// \brief Type of sensor.
+  SensorKind kind{SensorKind::IMU};
+
+  /// \brief Ign-sensors sensor. Its concrete type depends on kind.
+  std::unique_ptr<sensors::Sensor> sensor;
+
+  /// \brief World pose of the sensor, if it has one.
+  const components::WorldPose *worldPose{nullptr};
+
+  /// \brief World linear velocity of the sensor, if it has one.
+  const components::WorldLinearVelocity *worldLinearVel{nullptr};
+
+  /// \brief Angular velocity of IMUs.
+  const components::AngularVelocity *angularVel{nullptr};
+
+  /// \brief Linear acceleration of IMUs.
+  const components::LinearAcceleration *linearAccel{nullptr};
+
+  /// \brief Update period of staggered sensors, zero otherwise.
+  std::chrono::steady_clock::duration period{0};
+
+  /// \brief Next update time of staggered sensors.
+  std::chrono::steady_clock::duration nextUpdate{0};
+};
+
+/// \brief Deterministic fraction in [0, 1) for a sensor, used to offset its
+/// updates within its period.
+/// \param[in] _seed Seed
+/// \param[in] _name Scoped name of the sensor
+/// \return Fraction of the period.
+static double PhaseFraction(uint64_t _seed, const std::string &_name)
+{
+  // FNV-1a of the name, so the result doesn't depend on the platform or on
+  // the order in which sensors are created
+  uint64_t hash{14695981039346656037ull};
+  for (unsigned char c : _name)
+  {
+    hash ^= c;
+    hash *= 1099511628211ull;
+  }
+
+  // splitmix64 finalizer
+  uint64_t x = hash ^ _seed;
+  x += 0x9e3779b97f4a7c15ull;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  x = x ^ (x >> 31);
+
+  return static_cast<double>(x >> 11) * 0x1.0p-53;
+}
+
+/// \brief Private NonRenderingSensors data class.
+class ignition::gazebo::systems::NonRenderingSensorsPrivate
+{
+  /// \brief Create sensors for the new sensor entities.
+  /// \param[in] _ecm Immutable reference to ECM.
+  public: void CreateSensors(const EntityComponentManager &_ecm);
+
+  /// \brief Create a sensor of one of the supported types, if the entity is
+  /// one of them.
+  /// \param[in] _ecm Immutable reference to ECM.
+  /// \param[in] _entity Sensor entity.
+  /// \param[in] _parent Parent entity component.
+  public: void AddSensor(const EntityComponentManager &_ecm,
+                         const Entity _entity,
+                         const components::ParentEntity *_parent);
+
+  /// \brief Create an ign-sensors sensor, setting its name, topic and
+  /// parent like the individual sensor systems do.
+  /// \param[in] _ecm Immutable reference to ECM.
+  /// \param[in] _entity Sensor entity.
+  /// \param[in] _data SDF description of the sensor.
+  /// \param[in] _parent Parent entity component.
+  /// \param[in] _topicSuffix Suffix of the default topic, e.g. "/imu".
+  /// \return The sensor, or nullptr if it failed to be created.
+  public: template <typename SensorT>
+          std::unique_ptr<SensorT> CreateSensor(
+              const EntityComponentManager &_ecm, const Entity _entity,
+              sdf::Sensor _data, const components::ParentEntity *_parent,
+              const std::string &_topicSuffix);
+
+  /// \brief Refresh the cached component pointers of all sensors if
+  /// components were added or removed since the last update.
+  /// \param[in] _ecm Immutable reference to ECM.
+  public: void UpdateComponentPointers(const EntityComponentManager &_ecm);
+
+  /// \brief Update the sensors which are due at the given time.
+  /// \param[in] _ecm Immutable reference to ECM.
+  /// \param[in] _simTime Current simulation time.
+  public: void UpdateSensors(
+              const EntityComponentManager &_ecm,
+              const std::chrono::steady_clock::duration &_simTime);
+
+  /// \brief Pass the latest physics data to a sensor.
+  /// \param[in] _ecm Immutable reference to ECM.
+  /// \param[in] _record Sensor record.
+  public: void SetSensorData(const EntityComponentManager &_ecm,
+                             SensorRecord &_record);
+
+  /// \brief Add a sensor to the schedule at its next update time.
+  /// \param[in] _record Sensor record.
+  public: void Schedule(const SensorRecord &_record);
+
+  /// \brief Remove sensors whose entities have been removed from
+  /// simulation.
+  /// \param[in] _ecm Immutable reference to ECM.
+  public: void RemoveSensors(const EntityComponentManager &_ecm);
+
+  /// \brief Publish the sensor budget of the last step.
+  /// \param[in] _info Update info.
+  public: void PublishBudget(const UpdateInfo &_info);
+
+  /// \brief Sensors by entity.
+  public: std::unordered_map<Entity, SensorRecord> sensors;
+
+  /// \brief Sensor entities by the simulation time of their next update.
+  /// Entries of removed sensors are skipped when they become due.
+  public: std::map<std::chrono::steady_clock::duration, std::vector<Entity>>
+      schedule;
+
+  /// \brief Sensors due on the current step. Kept to reuse its memory.
+  public: std::vector<SensorRecord *> due;
+
+  /// \brief Ign-sensors sensor factory for creating sensors
+  public: sensors::SensorFactory sensorFactory;
+
+  /// \brief Keep list of sensors that were created during the previous
+  /// `PostUpdate`, so that components can be created during the next
+  /// `PreUpdate`.
+  public: std::vector<Entity> newSensors;
+
+  /// \brief World entity.
+  public: Entity worldEntity{kNullEntity};
+
+  /// \brief Current simulation time.
+  public: std::chrono::steady_clock::duration simTime{0};
+
+  /// \brief Whether sensor updates are offset within their period.
+  public: bool stagger{false};
+
+  /// \brief Seed for the phase offsets.
+  public: uint64_t staggerSeed{0};
+
+  /// \brief Number of sensors updated on the last step.
+  public: std::size_t stepUpdates{0};
+
+  /// \brief Wall time spent updating sensors on the last step.
+  public: std::chrono::steady_clock::duration stepTime{0};
+
+  /// \brief Largest number of sensors updated on a single step.
+  public: std::size_t maxStepUpdates{0};
+
+  /// \brief Longest wall time spent updating sensors on a single step.
+  public: std::chrono::steady_clock::duration maxStepTime{0};
+
+  /// \brief Transport node.
+  public: transport::Node node;
+
+  /// \brief Publisher of the sensor budget, if enabled.
+  public: std::optional<transport::Node::Publisher> budgetPub;
+
+  /// \brief Sensor budget message, reused across steps.
+  public: msgs::Param budgetMsg;
+
+  /// \brief ECM structure version for which the component pointers were
+  /// cached.
+  /// \sa EntityComponentManager::StructureVersion
+  public: uint64_t componentsVersion{0};
+
+  /// \brief Whether the component pointers of all sensors are cached.
+  public: bool componentsValid{false};
+
+  /// \brief True once the sensors that existed on the first update have
+  /// been created.
+  public: bool initialized{false};
+};
+
+//////////////////////////////////////////////////
+NonRenderingSensors::NonRenderingSensors()
+  : System(), dataPtr(std::make_unique<NonRenderingSensorsPrivate>())
+{
+}
+
+//////////////////////////////////////////////////
+NonRenderingSensors::~NonRenderingSensors()
+{
+  if (this->dataPtr->maxStepUpdates > 0)
+  {
+    igndbg << "Non-rendering sensors: at most ["
+           << this->dataPtr->maxStepUpdates << "] sensor updates and ["
+           << std::chrono::duration<double, std::milli>(
+                  this->dataPtr->maxStepTime).count()
+           << "] ms in a single step." << std::endl;
+  }
+}
+
+//////////////////////////////////////////////////
+void NonRenderingSensors::Configure(const Entity &/*_entity*/,
+    const std::shared_ptr<const sdf::Element> &_sdf,
+    EntityComponentManager &/*_ecm*/, EventManager &/*_eventMgr*/)
+{
+  if (_sdf->HasElement("stagger"))
+    this->dataPtr->stagger = _sdf->Get<bool>("stagger");
+
+  if (_sdf->HasElement("stagger_seed"))
+  {
+    this->dataPtr->staggerSeed = _sdf->Get<unsigned int>("stagger_seed");
+  }
+
+  if (_sdf->HasElement("budget_topic"))
+  {
+    auto topic = transport::TopicUtils::AsValidTopic(
+        _sdf->Get<std::string>("budget_topic"));
+    if (topic.empty())
+    {
+      ignerr << "Invalid budget topic [" << _sdf->Get<std::string>(
+                "budget_topic") << "]. The budget won't be published."
+             << std::endl;
+    }
+    else
+    {
+      this->dataPtr->budgetPub =
+          this->dataPtr->node.Advertise<msgs::Param>(topic);
+      igndbg << "Publishing sensor budget on [" << topic << "]"
+             << std::endl;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void NonRenderingSensors::PreUpdate(const UpdateInfo &/*_info*/,
+    EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("NonRenderingSensors::PreUpdate");
+
+  // Create components
+  for (auto entity : this->dataPtr->newSensors)
+  {
+    auto it = this->dataPtr->sensors.find(entity);
+    if (it == this->dataPtr->sensors.end())
+    {
+      ignerr << "Entity [" << entity
+             << "] isn't in sensor map, this shouldn't happen." << std::endl;
+      continue;
+    }
+    // Set topic
+    _ecm.CreateComponent(entity,
+        components::SensorTopic(it->second.sensor->Topic()));
+  }
+  this->dataPtr->newSensors.clear();
+}
+
+//////////////////////////////////////////////////
+void NonRenderingSensors::PostUpdate(const UpdateInfo &_info,
+    const EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("NonRenderingSensors::PostUpdate");
+
+  // \TODO(anyone) Support rewind
+  if (_info.dt < std::chrono::steady_clock::duration::zero())
+  {
+    ignwarn << "Detected jump back in time ["
+        << std::chrono::duration_cast<std::chrono::seconds>(_info.dt).count()
+        << "s]. System may not work properly." << std::endl;
+  }
+
+  this->dataPtr->simTime = _info.simTime;
+  this->dataPtr->CreateSensors(_ecm);
+
+  // Only update and publish if not paused.
+  if (!_info.paused)
+  {
+    this->dataPtr->UpdateComponentPointers(_ecm);
+    this->dataPtr->UpdateSensors(_ecm, _info.simTime);
+    this->dataPtr->PublishBudget(_info);
+  }
+
+  this->dataPtr->RemoveSensors(_ecm);
+}
+
+//////////////////////////////////////////////////
+void NonRenderingSensorsPrivate::CreateSensors(
+    const EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("NonRenderingSensorsPrivate::CreateSensors");
+  if (kNullEntity == this->worldEntity)
+    this->worldEntity = _ecm.EntityByComponents(components::World());
+  if (kNullEntity == this->worldEntity)
+  {
+    ignerr << "Missing world entity." << std::endl;
+    return;
+  }
+
+  // A single pass over all new sensors, whatever their type
+  auto addSensor = [&](const Entity &_entity, const components::Sensor *,
+      const components::ParentEntity *_parent)->bool
+  {
+    this->AddSensor(_ecm, _entity, _parent);
+    return true;
+  };
+
+  if (!this->initialized)
+  {
+    _ecm.Each<components::Sensor, components::ParentEntity>(addSensor);
+    this->initialized = true;
+  }
+  else
+  {
+    _ecm.EachNew<components::Sensor, components::ParentEntity>(addSensor);
+  }
+}
+
+//////////////////////////////////////////////////
+template <typename SensorT>
+std::unique_ptr<SensorT> NonRenderingSensorsPrivate::CreateSensor(
+    const EntityComponentManager &_ecm, const Entity _entity,
+    sdf::Sensor _data, const components::ParentEntity *_parent,
+    const std::string &_topicSuffix)
+{
+  std::string sensorScopedName =
+      removeParentScope(scopedName(_entity, _ecm, "::", false), "::");
+  _data.SetName(sensorScopedName);
+  // check topic
+  if (_data.Topic().empty())
+  {
+    std::string topic = scopedName(_entity, _ecm) + _topicSuffix;
+    _data.SetTopic(topic);
+  }
+  auto sensor = this->sensorFactory.CreateSensor<SensorT>(_data);
+  if (nullptr == sensor)
+  {
+    ignerr << "Failed to create sensor [" << sensorScopedName << "]"
+           << std::endl;
+    return nullptr;
+  }
+
+  // set sensor parent
+  std::string parentName = _ecm.Component<components::Name>(
+      _parent->Data())->Data();
+  sensor->SetParent(parentName);
+
+  return sensor;
+}
+
+//////////////////////////////////////////////////
+void NonRenderingSensorsPrivate::AddSensor(
+    const EntityComponentManager &_ecm,
+    const Entity _entity,
+    const components::ParentEntity *_parent)
+{
+  if (this->sensors.find(_entity) != this->sensors.end())
+    return;
+
+  SensorRecord record;
+  record.entity = _entity;
+
+  // The WorldPose components of new sensors haven't been filled yet, so
+  // initial poses are computed here.
+  if (auto imu = _ecm.Component<components::Imu>(_entity))
+  {
+    // Get the world acceleration (defined in world frame)
+    auto gravity = _ecm.Component<components::Gravity>(this->worldEntity);
+    if (nullptr == gravity)
+    {
+      ignerr << "World missing gravity." << std::endl;
+      return;
+    }
+
+    sdf::Sensor data = imu->Data();
+    auto sensor = this->CreateSensor<sensors::ImuSensor>(_ecm, _entity,
+        data, _parent, "/imu");
+    if (nullptr == sensor)
+      return;
+
+    // set gravity - assume it remains fixed
+    sensor->SetGravity(gravity->Data());
+
+    math::Pose3d p = worldPose(_entity, _ecm);
+    sensor->SetOrientationReference(p.Rot());
+
+    // If <orientation_reference_frame> includes a named frame like NED, that
+    // must be supplied to the IMU sensor, otherwise orientations are reported
+    // w.r.t to the initial orientation.
+    if (data.Element() && data.Element()->HasElement("imu"))
+    {
+      auto imuElementPtr = data.Element()->GetElement("imu");
+      if (imuElementPtr->HasElement("orientation_reference_frame"))
+      {
+        double heading = 0.0;
+
+        World world(this->worldEntity);
+        if (world.SphericalCoordinates(_ecm))
+        {
+          auto sphericalCoordinates = world.SphericalCoordinates(_ecm).value();
+          heading = sphericalCoordinates.HeadingOffset().Radian();
+        }
+
+        sensor->SetWorldFrameOrientation(math::Quaterniond(0, 0, heading),
+          sensors::WorldFrameEnumType::ENU);
+      }
+    }
+
+    // Set whether orientation is enabled
+    if (data.ImuSensor())
+    {
+      sensor->SetOrientationEnabled(
+          data.ImuSensor()->OrientationEnabled());
+    }
+
+    record.kind = SensorKind::IMU;
+    record.sensor = std::move(sensor);
+  }
+  else if (auto magnetometer =
+      _ecm.Component<components::Magnetometer>(_entity))
+  {
+    // Get the world magnetic field (defined in world frame)
+    auto worldField =
+        _ecm.Component<components::MagneticField>(this->worldEntity);
+    if (nullptr == worldField)
+    {
+      ignerr << "World missing magnetic field." << std::endl;
+      return;
+    }
+
+    auto sensor = this->CreateSensor<sensors::MagnetometerSensor>(_ecm,
+        _entity, magnetometer->Data(), _parent, "/magnetometer");
+    if (nullptr == sensor)
+      return;
+
+    // Assume the field is uniform in world and doesn't change throughout
+    // simulation
+    sensor->SetWorldMagneticField(worldField->Data());
+    sensor->SetWorldPose(worldPose(_entity, _ecm));
+
+    record.kind = SensorKind::MAGNETOMETER;
+    record.sensor = std::move(sensor);
+  }
+  else if (auto altimeter = _ecm.Component<components::Altimeter>(_entity))
+  {
+    auto sensor = this->CreateSensor<sensors::AltimeterSensor>(_ecm,
+        _entity, altimeter->Data(), _parent, "/altimeter");
+    if (nullptr == sensor)
+      return;
+
+    double verticalReference = worldPose(_entity, _ecm).Pos().Z();
+    sensor->SetVerticalReference(verticalReference);
+    sensor->SetPosition(verticalReference);
+
+    record.kind = SensorKind::ALTIMETER;
+    record.sensor = std::move(sensor);
+  }
+  else if (auto airPressure =
+      _ecm.Component<components::AirPressureSensor>(_entity))
+  {
+    auto sensor = this->CreateSensor<sensors::AirPressureSensor>(_ecm,
+        _entity, airPressure->Data(), _parent, "/air_pressure");
+    if (nullptr == sensor)
+      return;
+
+    sensor->SetPose(worldPose(_entity, _ecm));
+
+    record.kind = SensorKind::AIR_PRESSURE;
+    record.sensor = std::move(sensor);
+  }
+  else if (auto navSat = _ecm.Component<components::NavSat>(_entity))
+  {
+    auto sensor = this->CreateSensor<sensors::NavSatSensor>(_ecm,
+        _entity, navSat->Data(), _parent, "/navsat");
+    if (nullptr == sensor)
+      return;
+
+    record.kind = SensorKind::NAVSAT;
+    record.sensor = std::move(sensor);
+  }
+  else
+  {
+    // Not a sensor handled by this system
+    return;
+  }
+
+  // Offset the first update of the sensor by a fraction of its period. The
+  // sensor is then updated once per period, keeping its rate.
+  const double rate = record.sensor->UpdateRate();
+  if (this->stagger && rate > 0.0)
+  {
+    record.period = std::chrono::duration_cast<
+        std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / rate));
+    record.nextUpdate = this->simTime +
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            record.period * PhaseFraction(this->staggerSeed,
+                                          record.sensor->Name()));
+  }
+
+  this->Schedule(record);
+  this->sensors.emplace(_entity, std::move(record));
+  this->newSensors.push_back(_entity);
+
+  // Make sure the component pointers of the new sensor are filled
+  this->componentsValid = false;
+}
+
+//////////////////////////////////////////////////
+void NonRenderingSensorsPrivate::UpdateComponentPointers(
+    const EntityComponentManager &_ecm)
+{
+  if (this->componentsValid &&
+      this->componentsVersion == _ecm.StructureVersion())
+  {
+    return;
+  }
+
+  IGN_PROFILE("NonRenderingSensorsPrivate::UpdateComponentPointers");
+  for (auto &[entity, record] : this->sensors)
+  {
+    record.worldPose = _ecm.Component<components::WorldPose>(entity);
+    record.worldLinearVel =
+        _ecm.Component<components::WorldLinearVelocity>(entity);
+    if (record.kind == SensorKind::IMU)
+    {
+      record.angularVel = _ecm.Component<components::AngularVelocity>(entity);
+      record.linearAccel =
+          _ecm.Component<components::LinearAcceleration>(entity);
+    }
+  }
+  this->componentsVersion = _ecm.StructureVersion();
+  this->componentsValid = true;
+}
+
+//////////////////////////////////////////////////
+void NonRenderingSensorsPrivate::UpdateSensors(
+    const EntityComponentManager &_ecm,
+    const std::chrono::steady_clock::duration &_simTime)
+{
+  IGN_PROFILE("NonRenderingSensorsPrivate::UpdateSensors");
+
+  // Collect the sensors which are due
+  this->due.clear();
+  while (!this->schedule.empty() && this->schedule.begin()->first <= _simTime)
+  {
+    for (auto entity : this->schedule.begin()->second)
+    {
+      auto it = this->sensors.find(entity);
+      if (it != this->sensors.end())
+        this->due.push_back(&it->second);
+    }
+    this->schedule.erase(this->schedule.begin());
+  }
+
+  // Process sensors of the same type together
+  std::sort(this->due.begin(), this->due.end(),
+      [](const SensorRecord *_a, const SensorRecord *_b)
+      {
+        if (_a->kind != _b->kind)
+          return _a->kind < _b->kind;
+        return _a->entity < _b->entity;
+      });
+
+  auto start = std::chrono::steady_clock::now();
+  for (auto *record : this->due)
+  {
+    this->SetSensorData(_ecm, *record);
+
+    if (record->period > std::chrono::steady_clock::duration::zero())
+    {
+      // Staggered sensors follow their own schedule. If steps are longer
+      // than the period, skip the updates that were missed.
+      record->sensor->Update(_simTime, true);
+      auto periods = (_simTime - record->nextUpdate) / record->period + 1;
+      record->nextUpdate += periods * record->period;
+    }
+    else
+    {
+      // Update measurement time
+      record->sensor->Update(_simTime, false);
+    }
+
+    this->Schedule(*record);
+  }
+
+  this->stepUpdates = this->due.size();
+  this->stepTime = std::chrono::steady_clock::now() - start;
+  this->maxStepUpdates = std::max(this->maxStepUpdates, this->stepUpdates);
+  this->maxStepTime = std::max(this->maxStepTime, this->stepTime);
+}
+
+//////////////////////////////////////////////////
+void NonRenderingSensorsPrivate::PublishBudget(const UpdateInfo &_info)
+{
+  if (!this->budgetPub || !this->budgetPub->HasConnections())
+    return;
+
+  auto setInt = [&](const std::string &_key, std::size_t _value)
+  {
+    auto &param = (*this->budgetMsg.mutable_params())[_key];
+    param.set_type(msgs::Any::INT32);
+    param.set_int_value(static_cast<int>(_value));
+  };
+  auto setDouble = [&](const std::string &_key,
+      const std::chrono::steady_clock::duration &_value)
+  {
+    auto &param = (*this->budgetMsg.mutable_params())[_key];
+    param.set_type(msgs::Any::DOUBLE);
+    param.set_double_value(std::chrono::duration<double>(_value).count());
+  };
+
+  this->budgetMsg.mutable_header()->mutable_stamp()->CopyFrom(
+      convert<msgs::Time>(_info.simTime));
+  setInt("sensor_count", this->sensors.size());
+  setInt("sensor_updates", this->stepUpdates);
+  setInt("max_sensor_updates", this->maxStepUpdates);
+  setDouble("update_time", this->stepTime);
+  setDouble("max_update_time", this->maxStepTime);
+  this->budgetPub->Publish(this->budgetMsg);
+}
+
+//////////////////////////////////////////////////
+void NonRenderingSensorsPrivate::SetSensorData(
+    const EntityComponentManager &_ecm, SensorRecord &_record)
+{
+  switch (_record.kind)
+  {
+    case SensorKind::IMU:
+    {
+      if (nullptr == _record.worldPose || nullptr == _record.angularVel ||
+          nullptr == _record.linearAccel)
+      {
+        return;
+      }
+      auto *sensor = static_cast<sensors::ImuSensor *>(_record.sensor.get());
+      sensor->SetWorldPose(_record.worldPose->Data());
+
+      // Set the IMU angular velocity (defined in imu's local frame)
+      sensor->SetAngularVelocity(_record.angularVel->Data());
+
+      // Set the IMU linear acceleration in the imu local frame
+      sensor->SetLinearAcceleration(_record.linearAccel->Data());
+      break;
+    }
+    case SensorKind::MAGNETOMETER:
+    {
+      if (nullptr == _record.worldPose)
+        return;
+      auto *sensor =
+          static_cast<sensors::MagnetometerSensor *>(_record.sensor.get());
+      sensor->SetWorldPose(_record.worldPose->Data());
+      break;
+    }
+    case SensorKind::ALTIMETER:
+    {
+      if (nullptr == _record.worldPose || nullptr == _record.worldLinearVel)
+        return;
+      auto *sensor =
+          static_cast<sensors::AltimeterSensor *>(_record.sensor.get());
+      sensor->SetPosition(_record.worldPose->Data().Pos().Z());
+      sensor->SetVerticalVelocity(_record.worldLinearVel->Data().Z());
+      break;
+    }
+    case SensorKind::AIR_PRESSURE:
+    {
+      if (nullptr == _record.worldPose)
+        return;
+      auto *sensor =
+          static_cast<sensors::AirPressureSensor *>(_record.sensor.get());
+      sensor->SetPose(_record.worldPose->Data());
+      break;
+    }
+    case SensorKind::NAVSAT:
+    {
+      if (nullptr == _record.worldLinearVel)
+        return;
+
+      auto latLonEle = sphericalCoordinates(_record.entity, _ecm);
+      if (!latLonEle)
+      {
+        ignwarn << "Failed to update NavSat sensor enity [" << _record.entity
+                << "]. Spherical coordinates not set." << std::endl;
+        return;
+      }
+
+      auto *sensor =
+          static_cast<sensors::NavSatSensor *>(_record.sensor.get());
+      sensor->SetLatitude(IGN_DTOR(latLonEle.value().X()));
+      sensor->SetLongitude(IGN_DTOR(latLonEle.value().Y()));
+      sensor->SetAltitude(latLonEle.value().Z());
+
+      // Velocity in ENU frame
+      sensor->SetVelocity(_record.worldLinearVel->Data());
+      break;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void NonRenderingSensorsPrivate::Schedule(const SensorRecord &_record)
+{
+  if (_record.period > std::chrono::steady_clock::duration::zero())
+  {
+    this->schedule[_record.nextUpdate].push_back(_record.entity);
+    return;
+  }
+
+  // Sensors without an update rate have a next update time which is never
+  // in the future, so they're due on every step.
+  this->schedule[_record.sensor->NextDataUpdateTime()].push_back(
+      _record.entity);
+}
+
+//////////////////////////////////////////////////
+void NonRenderingSensorsPrivate::RemoveSensors(
+    const EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("NonRenderingSensorsPrivate::RemoveSensors");
+  _ecm.EachRemoved<components::Sensor>(
+    [&](const Entity &_entity,
+        const components::Sensor *)->bool
+      {
+        // Schedule entries of this sensor are skipped once they're due
+        this->sensors.erase(_entity);
+        return true;
+      });
+}
+
+IGNITION_ADD_PLUGIN(NonRenderingSensors, System,
+  NonRenderingSensors::ISystemConfigure,
+  NonRenderingSensors::ISystemPreUpdate,
+  NonRenderingSensors::ISystemPostUpdate
+)
+
+IGNITION_ADD_PLUGIN_ALIAS(NonRenderingSensors,
+                          "ignition::gazebo::systems::NonRenderingSensors")
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_SYSTEMS_NONRENDERINGSENSORS_HH_
+#define IGNITION_GAZEBO_SYSTEMS_NONRENDERINGSENSORS_HH_
+
+#include <memory>
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/System.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems
+{
+  // Forward declarations.
+  class NonRenderingSensorsPrivate;
+
+  /// \class NonRenderingSensors NonRenderingSensors.hh
+  /// ignition/gazebo/systems/NonRenderingSensors.hh
+  /// \brief This system manages the IMU, magnetometer, altimeter, air
+  /// pressure and NavSat sensors of a world. It replaces the Imu,
+  /// Magnetometer, Altimeter, AirPressure and NavSat systems, which must not
+  /// be loaded together with it.
+  ///
+  /// Instead of each of those systems iterating over its sensors on every
+  /// step, this system keeps a single table of sensors with cached component
+  /// pointers, and a schedule of sensors keyed by their next update time.
+  /// On each step only the sensors which are due are updated, grouped by
+  /// type. The sensors behave and publish exactly like the ones created by
+  /// the individual systems.
+  ///
+  /// Sensors with the same update rate normally become due on the same
+  /// steps. Staggering offsets the updates of each sensor by a fraction of
+  /// its period, derived from the seed and the sensor's scoped name, so the
+  /// same world and seed always produce the same schedule. Each sensor keeps
+  /// its rate, but the work is spread across steps.
+  ///
+  /// The following parameters are used by the system:
+  ///
+  /// <stagger>       Set to true to offset sensor updates within their
+  ///                 period. Defaults to false.
+  /// <stagger_seed>  Unsigned seed for the offsets. Defaults to 0.
+  /// <budget_topic>  If set, an ignition::msgs::Param with the number of
+  ///                 sensors updated and the wall time spent on the last
+  ///                 step, and the largest values seen so far, is
+  ///                 published on this topic on every step.
+  class NonRenderingSensors:
+    public System,
+    public ISystemConfigure,
+    public ISystemPreUpdate,
+    public ISystemPostUpdate
+  {
+    /// \brief Constructor
+    public: explicit NonRenderingSensors();
+
+    /// \brief Destructor
+    public: ~NonRenderingSensors() override;
+
+    /// Documentation inherited
+    public: void Configure(const Entity &_entity,
+                           const std::shared_ptr<const sdf::Element> &_sdf,
+                           EntityComponentManager &_ecm,
+                           EventManager &_eventMgr) final;
+
+    /// Documentation inherited
+    public: void PreUpdate(const UpdateInfo &_info,
+                           EntityComponentManager &_ecm) final;
+
+    /// Documentation inherited
+    public: void PostUpdate(const UpdateInfo &_info,
+                            const EntityComponentManager &_ecm) final;
+
+    /// \brief Private data pointer.
+    private: std::unique_ptr<NonRenderingSensorsPrivate> dataPtr;
+  };
+  }
+}
+}
+}
+#endif
@@ -29,6 +29,7 @@
 #include <sdf/Element.hh>
 
 #include "ignition/gazebo/components/ContactSensor.hh"
+#include "ignition/gazebo/components/ContactSensorBuffer.hh"
 #include "ignition/gazebo/components/ContactSensorData.hh"
 #include "ignition/gazebo/components/Collision.hh"
 #include "ignition/gazebo/components/DepthCamera.hh"
@@ -385,13 +386,19 @@ void OpticalTactilePlugin::PreUpdate(const UpdateInfo &_info,
   {
     // Get the first object being touched by the sensor
     // We assume there's only one object being touched
+    auto csb = _ecm.Component<components::ContactSensorBuffer>(
+      this->dataPtr->sensorCollisionEntity);
     auto csd = _ecm.Component<components::ContactSensorData>(
       this->dataPtr->sensorCollisionEntity);
-    for (const auto &contact : csd->Data().contact())
+    if (nullptr != csb && !csb->Data().Empty())
+    {
+      this->dataPtr->objectCollisionEntity =
+        csb->Data().pairs.front().collision2;
+    }
+    else if (nullptr != csd && csd->Data().contact_size() > 0)
     {
       this->dataPtr->objectCollisionEntity =
-        contact.collision2().id();
-      break;
+        csd->Data().contact(0).collision2().id();
     }
 
     // Get the tactile sensor pose, i.e. the model pose
@@ -425,13 +432,22 @@ void OpticalTactilePlugin::PostUpdate(
   // TODO(anyone) Get ContactSensor data and merge it with DepthCamera data
   if (this->dataPtr->visualizeContacts)
   {
+    auto *buffer =
+      _ecm.Component<components::ContactSensorBuffer>(
+        this->dataPtr->sensorCollisionEntity);
     auto *contacts =
       _ecm.Component<components::ContactSensorData>(
         this->dataPtr->sensorCollisionEntity);
 
-    if (nullptr != contacts)
+    if (nullptr != buffer)
+    {
+      this->dataPtr->visualizePtr->RequestContactsMarkerMsg(buffer->Data());
+    }
+    else if (nullptr != contacts)
     {
-      this->dataPtr->visualizePtr->RequestContactsMarkerMsg(contacts);
+      ContactBuffer converted;
+      converted.FromMsg(contacts->Data());
+      this->dataPtr->visualizePtr->RequestContactsMarkerMsg(converted);
     }
   }
 
@@ -499,7 +515,9 @@ void OpticalTactilePluginPrivate::Load(const EntityComponentManager &_ecm)
   for (const Entity &colEntity : linkCollisions)
   {
     if (_ecm.EntityHasComponentType(colEntity,
-        components::ContactSensorData::typeId))
+          components::ContactSensorData::typeId) ||
+        _ecm.EntityHasComponentType(colEntity,
+          components::ContactSensorBuffer::typeId))
     {
       this->sensorCollisionEntity = colEntity;
 
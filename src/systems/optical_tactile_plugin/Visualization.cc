@@ -105,34 +105,32 @@ void OpticalTactilePluginVisualization::InitializeContactsMarkerMsg(
 
 //////////////////////////////////////////////////
 void OpticalTactilePluginVisualization::AddContactToMarkerMsg(
-  ignition::msgs::Contact const &_contact,
+  ignition::math::Vector3d const &_position,
+  ignition::math::Vector3d const &_normal,
   ignition::msgs::Marker &_contactMarkerMsg)
 {
-  // todo(anyone) once available, use normal field in the Contact message
-  ignition::math::Vector3d contactNormal(0, 0, 0.03);
+  // Add a line marker starting from the contact position, ending at the
+  // endpoint of the normal.
+  ignition::math::Vector3d endPoint = _position + _normal * 0.03;
 
-  // For each contact, add a line marker starting from the contact position,
-  // ending at the endpoint of the normal.
-  for (auto const &position : _contact.position())
-  {
-    ignition::math::Vector3d startPoint = ignition::msgs::Convert(position);
-    ignition::math::Vector3d endPoint = startPoint + contactNormal;
-
-    ignition::msgs::Set(_contactMarkerMsg.add_point(), startPoint);
-    ignition::msgs::Set(_contactMarkerMsg.add_point(), endPoint);
-  }
+  ignition::msgs::Set(_contactMarkerMsg.add_point(), _position);
+  ignition::msgs::Set(_contactMarkerMsg.add_point(), endPoint);
 }
 
 //////////////////////////////////////////////////
 void OpticalTactilePluginVisualization::RequestContactsMarkerMsg(
-  const components::ContactSensorData *_contacts)
+  const ContactBuffer &_contacts)
 {
   ignition::msgs::Marker contactsMarkerMsg;
   this->InitializeContactsMarkerMsg(contactsMarkerMsg);
 
-  for (const auto &contact : _contacts->Data().contact())
+  // Use the normals from physics if available, otherwise point up
+  const bool hasNormals = _contacts.HasExtraData();
+  for (std::size_t i = 0; i < _contacts.positions.size(); ++i)
   {
-    this->AddContactToMarkerMsg(contact, contactsMarkerMsg);
+    this->AddContactToMarkerMsg(_contacts.positions[i],
+      hasNormals ? _contacts.normals[i] : ignition::math::Vector3d::UnitZ,
+      contactsMarkerMsg);
   }
 
   this->node.Request("/marker", contactsMarkerMsg);
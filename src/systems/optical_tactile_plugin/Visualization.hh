@@ -25,7 +25,7 @@
 #include <ignition/gazebo/System.hh>
 #include <ignition/msgs/marker.pb.h>
 
-#include "ignition/gazebo/components/ContactSensorData.hh"
+#include "ignition/gazebo/components/ContactSensorBuffer.hh"
 
 namespace ignition
 {
@@ -82,18 +82,19 @@ namespace optical_tactile_sensor
     private: void InitializeContactsMarkerMsg(
         ignition::msgs::Marker &_contactsMarkerMsg);
 
-    /// \brief Add a contact to the marker message representing the contacts
-    /// from the contact sensor based on physics
-    /// \param[in] _contact Contact to be added
+    /// \brief Add a contact point to the marker message representing the
+    /// contacts from the contact sensor based on physics
+    /// \param[in] _position Position of the contact point
+    /// \param[in] _normal Contact normal, used to orient the marker line
     /// \param[out] _contactsMarkerMsg Message for visualizing the contacts
     public: void AddContactToMarkerMsg(
-        ignition::msgs::Contact const &_contact,
+        ignition::math::Vector3d const &_position,
+        ignition::math::Vector3d const &_normal,
         ignition::msgs::Marker &_contactsMarkerMsg);
 
     /// \brief Request the "/marker" service for the contacts marker.
     /// \param[in] _contacts Contacts to visualize
-    public: void RequestContactsMarkerMsg(
-        components::ContactSensorData const *_contacts);
+    public: void RequestContactsMarkerMsg(ContactBuffer const &_contacts);
 
     /// \brief Initialize the marker messages representing the normal forces
     /// \param[out] _positionMarkerMsg Message for visualizing the contact
@@ -23,9 +23,10 @@
 #include <ignition/msgs/Utility.hh>
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <iostream>
-#include <deque>
-#include <map>
+#include <limits>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -34,7 +35,7 @@
 
 #include <ignition/common/HeightmapData.hh>
 #include <ignition/common/ImageHeightmap.hh>
-#include <ignition/common/MeshManager.hh>
+#include <ignition/common/Mesh.hh>
 #include <ignition/common/Profiler.hh>
 #include <ignition/common/SystemPaths.hh>
 #include <ignition/math/AxisAlignedBox.hh>
@@ -84,7 +85,7 @@
 #include <sdf/World.hh>
 
 #include "ignition/gazebo/EntityComponentManager.hh"
-#include "ignition/gazebo/Model.hh"
+#include "ignition/gazebo/MeshPrefetcher.hh"
 #include "ignition/gazebo/Util.hh"
 
 // Components
@@ -96,6 +97,7 @@
 #include "ignition/gazebo/components/CanonicalLink.hh"
 #include "ignition/gazebo/components/ChildLinkName.hh"
 #include "ignition/gazebo/components/Collision.hh"
+#include "ignition/gazebo/components/ContactSensorBuffer.hh"
 #include "ignition/gazebo/components/ContactSensorData.hh"
 #include "ignition/gazebo/components/Geometry.hh"
 #include "ignition/gazebo/components/Gravity.hh"
@@ -130,12 +132,12 @@
 #include "ignition/gazebo/components/Recreate.hh"
 #include "ignition/gazebo/components/SelfCollide.hh"
 #include "ignition/gazebo/components/SlipComplianceCmd.hh"
+#include "ignition/gazebo/components/Sleeping.hh"
 #include "ignition/gazebo/components/Static.hh"
 #include "ignition/gazebo/components/ThreadPitch.hh"
 #include "ignition/gazebo/components/World.hh"
 #include "ignition/gazebo/components/HaltMotion.hh"
 
-#include "CanonicalLinkModelTracker.hh"
 // Events
 #include "ignition/gazebo/physics/Events.hh"
 
@@ -230,55 +232,186 @@ class ignition::gazebo::systems::PhysicsPrivate
   public: ignition::physics::ForwardStep::Output Step(
               const std::chrono::steady_clock::duration &_dt);
 
-  /// \brief Get data of links that were updated in the latest physics step.
-  /// \param[in] _ecm Mutable reference to ECM.
+  /// \brief Marks the lack of a slot in the link table.
+  public: static constexpr std::size_t kNoSlot =
+      std::numeric_limits<std::size_t>::max();
+
+  /// \brief Row of the link table for a non-static model.
+  public: struct ModelSlot
+  {
+    /// \brief Model entity.
+    Entity entity{kNullEntity};
+
+    /// \brief Slot of the parent model, or kNoSlot for top level models.
+    std::size_t parent{kNoSlot};
+
+    /// \brief Slot of the top level model, which is this model's own slot
+    /// for top level models.
+    std::size_t top{kNoSlot};
+
+    /// \brief Canonical link entity, kNullEntity if the model has none.
+    Entity canonicalLink{kNullEntity};
+
+    /// \brief Slot of the canonical link, kNoSlot if it isn't in the table.
+    std::size_t canonicalLinkSlot{kNoSlot};
+
+    /// \brief Pose of the canonical link w.r.t. the model (X_ML).
+    math::Pose3d canonicalLinkPose;
+
+    /// \brief Whether the canonical link is a direct child of the model.
+    /// Only then canonicalLinkPose is constant and cached. If the link is in
+    /// a nested model, it moves with that model's joints, so its pose is
+    /// computed on each update.
+    bool canonicalLinkIsChild{false};
+
+    /// \brief The model's pose component.
+    components::Pose *pose{nullptr};
+
+    /// \brief Most recent world pose of the model, kept across steps because
+    /// models don't necessarily move on every step.
+    math::Pose3d worldPose;
+
+    /// \brief Whether worldPose has been computed yet.
+    bool hasWorldPose{false};
+
+    /// \brief Whether the model pose was updated on the current step.
+    bool updated{false};
+
+    /// \brief Slots of the model's own links.
+    std::vector<std::size_t> links;
+
+    /// \brief Top level models only: whether any link in the model tree
+    /// moved faster than the sleep thresholds on the current step.
+    bool moving{false};
+
+    /// \brief Top level models only: for how long the model has been
+    /// resting.
+    std::chrono::steady_clock::duration restTime{0};
+
+    /// \brief Top level models only: whether the model is sleeping.
+    bool sleeping{false};
+
+    /// \brief Top level models only: whether the sleeping state changed on
+    /// the current step.
+    bool sleepingChanged{false};
+
+    /// \brief Top level models only: world pose of the canonical link when
+    /// the model fell asleep.
+    math::Pose3d sleepPose;
+  };
+
+  /// \brief Row of the link table for a non-static link.
+  public: struct LinkSlot
+  {
+    /// \brief Link entity.
+    Entity entity{kNullEntity};
+
+    /// \brief Physics link.
+    LinkPtrType link;
+
+    /// \brief Slot of the parent model.
+    std::size_t model{kNoSlot};
+
+    /// \brief Slot of the top level model.
+    std::size_t top{kNoSlot};
+
+    /// \brief Whether this is the canonical link of its parent model.
+    bool canonical{false};
+
+    /// \brief Components updated from the link's frame data. All but the
+    /// pose are optional, and null if no system created them.
+    components::Pose *pose{nullptr};
+    components::WorldPose *worldPose{nullptr};
+    components::WorldLinearVelocity *worldLinVel{nullptr};
+    components::WorldAngularVelocity *worldAngVel{nullptr};
+    components::WorldLinearAcceleration *worldLinAccel{nullptr};
+    components::WorldAngularAcceleration *worldAngAccel{nullptr};
+    components::LinearVelocity *bodyLinVel{nullptr};
+    components::AngularVelocity *bodyAngVel{nullptr};
+    components::LinearAcceleration *bodyLinAccel{nullptr};
+    components::AngularAcceleration *bodyAngAccel{nullptr};
+
+    /// \brief Whether the link changed on the current step, in which case
+    /// frameData holds its latest frame data.
+    bool changed{false};
+
+    /// \brief Frame data from the current step.
+    physics::FrameData3d frameData;
+
+    /// \brief World pose of the link the last time it changed. This allows
+    /// for skipping pose updates if a link's pose didn't change after a
+    /// physics step.
+    math::Pose3d lastWorldPose;
+
+    /// \brief Whether lastWorldPose has been set yet.
+    bool hasLastWorldPose{false};
+  };
+
+  /// \brief Bring the link table up to date with the ECM. The table is only
+  /// rebuilt when the structure of the ECM changed since the last call, or
+  /// when physics links were added or removed.
+  /// \param[in] _ecm Immutable reference to ECM.
+  public: void UpdateLinkTable(const EntityComponentManager &_ecm);
+
+  /// \brief Mark links that were updated in the latest physics step as
+  /// changed in the link table, and store their frame data.
   /// \param[in] _updatedLinks Updated link poses from the latest physics step
   /// that were written to by the physics engine (some physics engines may
-  /// not write this data to ForwardStep::Output. If not, _ecm is used to get
-  /// this updated link pose data).
-  /// \return A map of gazebo link entities to their updated pose data.
-  /// std::map is used because canonical links must be in topological order
-  /// to ensure that nested models with multiple canonical links are updated
-  /// properly (models must be updated in topological order).
-  public: std::map<Entity, physics::FrameData3d> ChangedLinks(
-              EntityComponentManager &_ecm,
+  /// not write this data to ForwardStep::Output. If not, all links in the
+  /// table are checked for pose changes, except for the non-canonical links
+  /// of sleeping models).
+  public: void ChangedLinks(
               const ignition::physics::ForwardStep::Output &_updatedLinks);
 
-  /// \brief Helper function to update the pose of a model.
-  /// \param[in] _model The model to update.
-  /// \param[in] _canonicalLink The canonical link of _model.
+  /// \brief Helper function to update the pose of a model from the frame data
+  /// of its canonical link, and mark all of the model's links as changed,
+  /// since link poses are saved w.r.t. their parent model.
+  /// \param[in, out] _model Table slot of the model to update.
+  /// \param[in] _canonicalLink Table slot of the model's canonical link.
   /// \param[in] _ecm The entity component manager.
-  /// \param[in, out] _linkFrameData Links that experienced a pose change in the
-  /// most recent physics step. The key is the entity of the link, and the
-  /// value is the updated frame data corresponding to that entity. The
-  /// canonical links of _model's nested models are added to _linkFrameData to
-  /// ensure that all of _model's nested models are marked as models to be
-  /// updated (if a parent model's pose changes, all nested model poses must be
-  /// updated since nested model poses are saved w.r.t. the parent model).
-  public: void UpdateModelPose(const Entity _model,
-              const Entity _canonicalLink, EntityComponentManager &_ecm,
-              std::map<Entity, physics::FrameData3d> &_linkFrameData);
-
-  /// \brief Get an entity's frame data relative to world from physics.
-  /// \param[in] _entity The entity.
-  /// \param[in, out] _data The frame data to populate.
-  /// \return True if _data was populated with frame data for _entity, false
-  /// otherwise.
-  public: bool GetFrameDataRelativeToWorld(const Entity _entity,
-              physics::FrameData3d &_data);
-
-  /// \brief Update components from physics simulation
+  public: void UpdateModelPose(ModelSlot &_model,
+              const LinkSlot &_canonicalLink, EntityComponentManager &_ecm);
+
+  /// \brief Put top level models to sleep if all of their links have been
+  /// resting for longer than sleepTime, and wake them up when any link moves.
+  /// Links of sleeping models are unmarked as changed, so their components
+  /// aren't updated.
+  /// \param[in] _ecm Mutable reference to ECM.
+  /// \param[in] _dt Duration of the latest physics step, zero if paused.
+  public: void UpdateSleeping(EntityComponentManager &_ecm,
+              const std::chrono::steady_clock::duration &_dt);
+
+  /// \brief Fetch a link's frame data from physics and mark it as changed,
+  /// unless it's already marked.
+  /// \param[in, out] _link Table slot of the link.
+  public: void MarkLinkChanged(LinkSlot &_link);
+
+  /// \brief Update components from physics simulation. Only links marked as
+  /// changed in the link table by ChangedLinks are updated.
   /// \param[in] _ecm Mutable reference to ECM.
-  /// \param[in, out] _linkFrameData Links that experienced a pose change in the
-  /// most recent physics step. The key is the entity of the link, and the
-  /// value is the updated frame data corresponding to that entity.
-  public: void UpdateSim(EntityComponentManager &_ecm,
-              std::map<Entity, physics::FrameData3d> &_linkFrameData);
+  public: void UpdateSim(EntityComponentManager &_ecm);
 
   /// \brief Update collision components from physics simulation
   /// \param[in] _ecm Mutable reference to ECM.
   public: void UpdateCollisions(EntityComponentManager &_ecm);
 
+  /// \brief Fill a contact buffer with the contacts of the last step that
+  /// involve the given collision. UpdateCollisions must have populated
+  /// contactRecords beforehand.
+  /// \param[in] _collision Collision entity.
+  /// \param[in] _ecm Immutable reference to ECM, used to get names.
+  /// \param[out] _buffer Buffer to fill. It's cleared first.
+  public: void FillContactBuffer(const Entity _collision,
+              const EntityComponentManager &_ecm, ContactBuffer &_buffer);
+
+  /// \brief Get the name of a collision as it's populated in contacts.
+  /// Names are cached, since they're needed for every contact every step.
+  /// \param[in] _collision Collision entity.
+  /// \param[in] _ecm Immutable reference to ECM.
+  /// \return Collision name, scoped up to the top level model.
+  public: const std::string &ContactCollisionName(const Entity _collision,
+              const EntityComponentManager &_ecm);
+
   /// \brief FrameData relative to world at a given offset pose
   /// \param[in] _link ign-physics link
   /// \param[in] _pose Offset pose in which to compute the frame data
@@ -309,20 +442,43 @@ class ignition::gazebo::systems::PhysicsPrivate
   /// \brief Keep track of what entities are static (models and links).
   public: std::unordered_set<Entity> staticEntities;
 
-  /// \brief Keep track of poses for links attached to non-static models.
-  /// This allows for skipping pose updates if a link's pose didn't change
-  /// after a physics step.
-  public: std::unordered_map<Entity, ignition::math::Pose3d> linkWorldPoses;
+  /// \brief Non-static models, in topological order: a nested model always
+  /// comes after its parent. Updating model poses in this order guarantees
+  /// that the parent's world pose is up to date when a nested model pose is
+  /// computed, including when they share the same canonical link.
+  public: std::vector<ModelSlot> modelSlots;
+
+  /// \brief Non-static links, grouped by parent model.
+  public: std::vector<LinkSlot> linkSlots;
+
+  /// \brief Map from link entity to its slot in linkSlots.
+  public: std::unordered_map<Entity, std::size_t> linkSlotIndex;
+
+  /// \brief Map from model entity to its slot in modelSlots.
+  public: std::unordered_map<Entity, std::size_t> modelSlotIndex;
 
-  /// \brief Keep a mapping of canonical links to models that have this
-  /// canonical link. Useful for updating model poses efficiently after a
-  /// physics step
-  public: CanonicalLinkModelTracker canonicalLinkModelTracker;
+  /// \brief ECM structure version the link table was built for.
+  /// \sa EntityComponentManager::StructureVersion
+  public: uint64_t linkTableVersion{0};
 
-  /// \brief Keep track of non-static model world poses. Since non-static
-  /// models may not move on a given iteration, we want to keep track of the
-  /// most recent model world pose change that took place.
-  public: std::unordered_map<Entity, math::Pose3d> modelWorldPoses;
+  /// \brief Set to false to force the link table to be rebuilt, for example
+  /// when physics links are added or removed.
+  public: bool linkTableValid{false};
+
+  /// \brief Whether resting models should be put to sleep.
+  public: bool sleepEnabled{false};
+
+  /// \brief Models whose links all have a linear velocity below this
+  /// threshold, in m/s, are considered to be resting.
+  public: double sleepLinearVelocity{0.01};
+
+  /// \brief Models whose links all have an angular velocity below this
+  /// threshold, in rad/s, are considered to be resting.
+  public: double sleepAngularVelocity{0.01};
+
+  /// \brief How long a model must be resting before falling asleep.
+  public: std::chrono::steady_clock::duration sleepTime{
+      std::chrono::seconds(1)};
 
   /// \brief A map between model entity ids in the ECM to whether its battery
   /// has drained.
@@ -690,6 +846,44 @@ class ignition::gazebo::systems::PhysicsPrivate
   /// \brief Flag to store whether the names of colliding entities should
   /// be populated in the contact points.
   public: bool contactsEntityNames = true;
+
+  /// \brief A contact point from the last step, seen from one of its two
+  /// collisions.
+  public: struct ContactRecord
+  {
+    /// \brief Collision whose contacts this record belongs to.
+    Entity collision1;
+
+    /// \brief The other collision.
+    Entity collision2;
+
+    /// \brief Contact position in the world frame.
+    math::Vector3d position;
+
+    /// \brief Contact normal, pointing away from collision1.
+    math::Vector3d normal;
+
+    /// \brief Force applied on collision1.
+    math::Vector3d force;
+
+    /// \brief Penetration depth.
+    double depth{0.0};
+
+    /// \brief Whether normal, force and depth were provided by the engine.
+    bool hasExtraData{false};
+  };
+
+  /// \brief Contacts from the last step, two records per contact point
+  /// sorted by collision pair. It's a member so its memory is reused across
+  /// steps.
+  public: std::vector<ContactRecord> contactRecords;
+
+  /// \brief Buffer that is swapped with the component data when filling
+  /// ContactSensorBuffer components, so neither needs reallocating.
+  public: ContactBuffer contactScratch;
+
+  /// \brief Cache of collision names used to populate contacts.
+  public: std::unordered_map<Entity, std::string> contactCollisionNames;
 };
 
 //////////////////////////////////////////////////
@@ -744,6 +938,24 @@ void Physics::Configure(const Entity &_entity,
       "include_entity_names", true).first;
   }
 
+  // Check if resting models should be put to sleep.
+  auto sleepElement = _sdf->FindElement("sleep");
+  if (sleepElement)
+  {
+    this->dataPtr->sleepEnabled = true;
+    this->dataPtr->sleepLinearVelocity = sleepElement->Get<double>(
+        "linear_velocity_threshold",
+        this->dataPtr->sleepLinearVelocity).first;
+    this->dataPtr->sleepAngularVelocity = sleepElement->Get<double>(
+        "angular_velocity_threshold",
+        this->dataPtr->sleepAngularVelocity).first;
+    const auto sleepTime = sleepElement->Get<double>("time",
+        std::chrono::duration<double>(this->dataPtr->sleepTime).count()).first;
+    this->dataPtr->sleepTime =
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(sleepTime));
+  }
+
   // Find engine shared library
   // Look in:
   // * Paths from environment variable
@@ -854,8 +1066,11 @@ void Physics::Update(const UpdateInfo &_info, EntityComponentManager &_ecm)
     {
       stepOutput = this->dataPtr->Step(_info.dt);
     }
-    auto changedLinks = this->dataPtr->ChangedLinks(_ecm, stepOutput);
-    this->dataPtr->UpdateSim(_ecm, changedLinks);
+    this->dataPtr->UpdateLinkTable(_ecm);
+    this->dataPtr->ChangedLinks(stepOutput);
+    this->dataPtr->UpdateSleeping(_ecm, _info.paused ?
+        std::chrono::steady_clock::duration::zero() : _info.dt);
+    this->dataPtr->UpdateSim(_ecm);
 
     // Entities scheduled to be removed should be removed from physics after the
     // simulation step. Otherwise, since the to-be-removed entity still shows up
@@ -1159,6 +1374,7 @@ void PhysicsPrivate::CreateLinkEntities(const EntityComponentManager &_ecm)
 
         auto linkPtrPhys = modelPtrPhys->ConstructLink(link);
         this->entityLinkMap.AddEntity(_entity, linkPtrPhys);
+        this->linkTableValid = false;
         this->topLevelModelMap.insert(std::make_pair(_entity,
             topLevelModel(_entity, _ecm)));
 
@@ -1224,9 +1440,9 @@ void PhysicsPrivate::CreateCollisionEntities(const EntityComponentManager &_ecm)
             return true;
           }
 
-          auto &meshManager = *ignition::common::MeshManager::Instance();
+          // Usually decoded in the background since the entity was created
           auto fullPath = asFullPath(meshSdf->Uri(), meshSdf->FilePath());
-          auto *mesh = meshManager.Load(fullPath);
+          auto *mesh = MeshPrefetcher::Instance().Load(fullPath);
           if (nullptr == mesh)
           {
             ignwarn << "Failed to load mesh from [" << fullPath
@@ -1628,6 +1844,7 @@ void PhysicsPrivate::RemovePhysicsEntities(const EntityComponentManager &_ecm)
             {
               this->entityCollisionMap.Remove(childCollision);
               this->topLevelModelMap.erase(childCollision);
+              this->contactCollisionNames.erase(childCollision);
               if (this->customContactSurfaceEntities[world].erase(
                 childCollision))
               {
@@ -1642,8 +1859,6 @@ void PhysicsPrivate::RemovePhysicsEntities(const EntityComponentManager &_ecm)
             this->entityLinkMap.Remove(childLink);
             this->topLevelModelMap.erase(childLink);
             this->staticEntities.erase(childLink);
-            this->linkWorldPoses.erase(childLink);
-            this->canonicalLinkModelTracker.RemoveLink(childLink);
           }
 
           for (const auto &childJoint :
@@ -1659,7 +1874,7 @@ void PhysicsPrivate::RemovePhysicsEntities(const EntityComponentManager &_ecm)
           this->entityModelMap.Remove(_entity);
           this->topLevelModelMap.erase(_entity);
           this->staticEntities.erase(_entity);
-          this->modelWorldPoses.erase(_entity);
+          this->linkTableValid = false;
         }
         return true;
       });
@@ -2421,16 +2636,191 @@ ignition::math::Pose3d PhysicsPrivate::RelativePose(const Entity &_from,
 }
 
 //////////////////////////////////////////////////
-std::map<Entity, physics::FrameData3d> PhysicsPrivate::ChangedLinks(
-    EntityComponentManager &_ecm,
+void PhysicsPrivate::UpdateLinkTable(const EntityComponentManager &_ecm)
+{
+  if (this->linkTableValid &&
+      this->linkTableVersion == _ecm.StructureVersion())
+  {
+    return;
+  }
+
+  IGN_PROFILE("PhysicsPrivate::UpdateLinkTable");
+
+  // Keep the state cached from previous steps
+  auto oldModelSlots = std::move(this->modelSlots);
+  auto oldLinkSlots = std::move(this->linkSlots);
+  auto oldModelSlotIndex = std::move(this->modelSlotIndex);
+  auto oldLinkSlotIndex = std::move(this->linkSlotIndex);
+
+  this->modelSlots.clear();
+  this->linkSlots.clear();
+  this->modelSlotIndex.clear();
+  this->linkSlotIndex.clear();
+
+  // Sort models by nesting depth, so that parents come before nested models.
+  // Entity IDs break ties to keep the order deterministic.
+  std::vector<std::pair<std::size_t, Entity>> models;
+  _ecm.Each<components::Model, components::Pose>(
+      [&](const Entity &_entity, const components::Model *,
+          const components::Pose *) -> bool
+      {
+        if (this->staticEntities.find(_entity) != this->staticEntities.end())
+          return true;
+
+        std::size_t depth{0};
+        for (auto parent = _ecm.ParentEntity(_entity);
+             parent != kNullEntity &&
+             _ecm.Component<components::Model>(parent);
+             parent = _ecm.ParentEntity(parent))
+        {
+          ++depth;
+        }
+        models.emplace_back(depth, _entity);
+        return true;
+      });
+  std::sort(models.begin(), models.end());
+
+  this->modelSlots.reserve(models.size());
+  for (const auto &[depth, entity] : models)
+  {
+    ModelSlot slot;
+    slot.entity = entity;
+    slot.pose = _ecm.Component<components::Pose>(entity);
+
+    auto parentIt = this->modelSlotIndex.find(_ecm.ParentEntity(entity));
+    if (parentIt != this->modelSlotIndex.end())
+    {
+      slot.parent = parentIt->second;
+      slot.top = this->modelSlots[slot.parent].top;
+    }
+    else
+    {
+      slot.top = this->modelSlots.size();
+    }
+
+    auto canonicalLinkComp =
+        _ecm.Component<components::ModelCanonicalLink>(entity);
+    if (canonicalLinkComp)
+    {
+      slot.canonicalLink = canonicalLinkComp->Data();
+      slot.canonicalLinkIsChild =
+          _ecm.ParentEntity(slot.canonicalLink) == entity;
+      slot.canonicalLinkPose =
+          this->RelativePose(entity, slot.canonicalLink, _ecm);
+    }
+
+    auto oldIt = oldModelSlotIndex.find(entity);
+    if (oldIt != oldModelSlotIndex.end())
+    {
+      const auto &oldSlot = oldModelSlots[oldIt->second];
+      slot.worldPose = oldSlot.worldPose;
+      slot.hasWorldPose = oldSlot.hasWorldPose;
+      slot.restTime = oldSlot.restTime;
+      slot.sleeping = oldSlot.sleeping;
+      slot.sleepPose = oldSlot.sleepPose;
+    }
+
+    this->modelSlotIndex[entity] = this->modelSlots.size();
+    this->modelSlots.push_back(std::move(slot));
+  }
+
+  // Group links by model, following the model order
+  std::vector<std::pair<std::size_t, Entity>> links;
+  _ecm.Each<components::Link, components::Pose>(
+      [&](const Entity &_entity, const components::Link *,
+          const components::Pose *) -> bool
+      {
+        if (this->staticEntities.find(_entity) != this->staticEntities.end() ||
+            _ecm.EntityHasComponentType(_entity, components::Recreate::typeId))
+        {
+          return true;
+        }
+
+        if (!this->entityLinkMap.HasEntity(_entity))
+        {
+          if (this->linkAddedToModel.find(_entity) ==
+              this->linkAddedToModel.end())
+          {
+            ignerr << "Internal error: link [" << _entity
+              << "] not in entity map" << std::endl;
+          }
+          return true;
+        }
+
+        std::size_t model{kNoSlot};
+        auto modelIt = this->modelSlotIndex.find(_ecm.ParentEntity(_entity));
+        if (modelIt != this->modelSlotIndex.end())
+          model = modelIt->second;
+
+        links.emplace_back(model, _entity);
+        return true;
+      });
+  std::sort(links.begin(), links.end());
+
+  this->linkSlots.reserve(links.size());
+  for (const auto &[model, entity] : links)
+  {
+    LinkSlot slot;
+    slot.entity = entity;
+    slot.link = this->entityLinkMap.Get(entity);
+    slot.model = model;
+    slot.canonical =
+        nullptr != _ecm.Component<components::CanonicalLink>(entity);
+    slot.pose = _ecm.Component<components::Pose>(entity);
+    slot.worldPose = _ecm.Component<components::WorldPose>(entity);
+    slot.worldLinVel =
+        _ecm.Component<components::WorldLinearVelocity>(entity);
+    slot.worldAngVel =
+        _ecm.Component<components::WorldAngularVelocity>(entity);
+    slot.worldLinAccel =
+        _ecm.Component<components::WorldLinearAcceleration>(entity);
+    slot.worldAngAccel =
+        _ecm.Component<components::WorldAngularAcceleration>(entity);
+    slot.bodyLinVel = _ecm.Component<components::LinearVelocity>(entity);
+    slot.bodyAngVel = _ecm.Component<components::AngularVelocity>(entity);
+    slot.bodyLinAccel =
+        _ecm.Component<components::LinearAcceleration>(entity);
+    slot.bodyAngAccel =
+        _ecm.Component<components::AngularAcceleration>(entity);
+
+    auto oldIt = oldLinkSlotIndex.find(entity);
+    if (oldIt != oldLinkSlotIndex.end())
+    {
+      const auto &oldSlot = oldLinkSlots[oldIt->second];
+      slot.lastWorldPose = oldSlot.lastWorldPose;
+      slot.hasLastWorldPose = oldSlot.hasLastWorldPose;
+    }
+
+    const auto index = this->linkSlots.size();
+    this->linkSlotIndex[entity] = index;
+    if (model != kNoSlot)
+    {
+      slot.top = this->modelSlots[model].top;
+      this->modelSlots[model].links.push_back(index);
+    }
+    this->linkSlots.push_back(std::move(slot));
+  }
+
+  for (auto &model : this->modelSlots)
+  {
+    auto linkIt = this->linkSlotIndex.find(model.canonicalLink);
+    if (linkIt != this->linkSlotIndex.end())
+      model.canonicalLinkSlot = linkIt->second;
+  }
+
+  this->linkTableVersion = _ecm.StructureVersion();
+  this->linkTableValid = true;
+}
+
+//////////////////////////////////////////////////
+void PhysicsPrivate::ChangedLinks(
     const ignition::physics::ForwardStep::Output &_updatedLinks)
 {
   IGN_PROFILE("Links Frame Data");
 
-  std::map<Entity, physics::FrameData3d> linkFrameData;
-
   // Check to see if the physics engine gave a list of changed poses. If not, we
-  // will iterate through all of the links via the ECM to see which ones changed
+  // will iterate through all of the links in the table to see which ones
+  // changed
   if (_updatedLinks.Has<ignition::physics::ChangedWorldPoses>())
   {
     for (const auto &link :
@@ -2452,79 +2842,192 @@ std::map<Entity, physics::FrameData3d> PhysicsPrivate::ChangedLinks(
         continue;
       }
 
-      auto frameData = linkPhys->FrameDataRelativeToWorld();
-      linkFrameData[entity] = frameData;
+      auto slotIt = this->linkSlotIndex.find(entity);
+      if (slotIt == this->linkSlotIndex.end())
+        continue;
+
+      auto &slot = this->linkSlots[slotIt->second];
+      slot.frameData = linkPhys->FrameDataRelativeToWorld();
+      slot.changed = true;
     }
   }
   else
   {
-    _ecm.Each<components::Link>(
-      [&](const Entity &_entity, components::Link *) -> bool
+    for (std::size_t i = 0; i < this->linkSlots.size(); ++i)
+    {
+      auto &slot = this->linkSlots[i];
+
+      // Only the canonical link of a sleeping model is queried, which is
+      // enough for UpdateSleeping to notice the model was pushed. The other
+      // links are refreshed when the model wakes up.
+      if (slot.top != kNoSlot)
       {
-        if (this->staticEntities.find(_entity) != this->staticEntities.end() ||
-            _ecm.EntityHasComponentType(_entity, components::Recreate::typeId))
-        {
-          return true;
-        }
+        const auto &top = this->modelSlots[slot.top];
+        if (top.sleeping && top.canonicalLinkSlot != i)
+          continue;
+      }
 
-        // This `once` variable is here to aid in debugging, make sure to
-        // remove it.
-        auto linkPhys = this->entityLinkMap.Get(_entity);
-        if (nullptr == linkPhys)
-        {
-          if (this->linkAddedToModel.find(_entity) ==
-              this->linkAddedToModel.end())
-          {
-            ignerr << "Internal error: link [" << _entity
-              << "] not in entity map" << std::endl;
-          }
-          return true;
-        }
+      slot.frameData = slot.link->FrameDataRelativeToWorld();
 
-        auto frameData = linkPhys->FrameDataRelativeToWorld();
+      // update the link pose if this is the first update,
+      // or if the link pose has changed since the last update
+      // (if the link pose hasn't changed, there's no need for a pose update)
+      const auto worldPoseMath3d = ignition::math::eigen3::convert(
+          slot.frameData.pose);
+      if (!slot.hasLastWorldPose ||
+          !this->pose3Eql(slot.lastWorldPose, worldPoseMath3d))
+      {
+        // cache the updated link pose to check if the link pose has changed
+        // during the next iteration
+        slot.lastWorldPose = worldPoseMath3d;
+        slot.hasLastWorldPose = true;
+        slot.changed = true;
+      }
+    }
+  }
+}
 
-        // update the link pose if this is the first update,
-        // or if the link pose has changed since the last update
-        // (if the link pose hasn't changed, there's no need for a pose update)
-        const auto worldPoseMath3d = ignition::math::eigen3::convert(
-            frameData.pose);
-        if ((this->linkWorldPoses.find(_entity) == this->linkWorldPoses.end())
-            || !this->pose3Eql(this->linkWorldPoses[_entity], worldPoseMath3d))
-        {
-          // cache the updated link pose to check if the link pose has changed
-          // during the next iteration
-          this->linkWorldPoses[_entity] = worldPoseMath3d;
+//////////////////////////////////////////////////
+void PhysicsPrivate::UpdateSleeping(EntityComponentManager &_ecm,
+    const std::chrono::steady_clock::duration &_dt)
+{
+  if (!this->sleepEnabled ||
+      _dt <= std::chrono::steady_clock::duration::zero())
+  {
+    return;
+  }
+
+  IGN_PROFILE("PhysicsPrivate::UpdateSleeping");
+
+  // A sleeping model that drifted further than it could have moved while
+  // below the thresholds during sleepTime is woken up. This catches
+  // teleports and slow creeping motion.
+  const double seconds = std::chrono::duration<double>(this->sleepTime).count();
+  const double maxDistance = this->sleepLinearVelocity * seconds;
+  const double maxAngle = this->sleepAngularVelocity * seconds;
+
+  for (auto &model : this->modelSlots)
+  {
+    model.moving = false;
+    model.sleepingChanged = false;
+  }
+
+  // Links that didn't change on this step are resting
+  for (std::size_t i = 0; i < this->linkSlots.size(); ++i)
+  {
+    const auto &link = this->linkSlots[i];
+    if (!link.changed || link.top == kNoSlot)
+      continue;
+
+    auto &top = this->modelSlots[link.top];
+    if (top.moving)
+      continue;
+
+    if (link.frameData.linearVelocity.norm() > this->sleepLinearVelocity ||
+        link.frameData.angularVelocity.norm() > this->sleepAngularVelocity)
+    {
+      top.moving = true;
+    }
+    else if (top.sleeping && top.canonicalLinkSlot == i)
+    {
+      const auto pose = math::eigen3::convert(link.frameData.pose);
+      auto rot = top.sleepPose.Rot().Inverse() * pose.Rot();
+      rot.Normalize();
+      const double angle = 2.0 * std::acos(std::min(1.0, std::abs(rot.W())));
+      top.moving = pose.Pos().Distance(top.sleepPose.Pos()) > maxDistance ||
+          angle > maxAngle;
+    }
+  }
+
+  bool sleepingChanged{false};
+  for (std::size_t i = 0; i < this->modelSlots.size(); ++i)
+  {
+    auto &model = this->modelSlots[i];
+    if (model.top != i)
+      continue;
 
-          linkFrameData[_entity] = frameData;
+    if (model.moving)
+    {
+      model.restTime = std::chrono::steady_clock::duration::zero();
+      model.sleepingChanged = model.sleeping;
+      model.sleeping = false;
+    }
+    else if (!model.sleeping)
+    {
+      model.restTime += _dt;
+      if (model.restTime >= this->sleepTime)
+      {
+        model.sleeping = true;
+        model.sleepingChanged = true;
+        if (model.canonicalLinkSlot != kNoSlot)
+        {
+          model.sleepPose = math::eigen3::convert(
+              this->linkSlots[model.canonicalLinkSlot].link->
+              FrameDataRelativeToWorld().pose);
         }
+      }
+    }
+    sleepingChanged = sleepingChanged || model.sleepingChanged;
+  }
 
-        return true;
-      });
+  // Let other systems know which entities fell asleep or woke up
+  auto setSleeping = [&](const Entity _entity, const bool _sleeping)
+  {
+    auto sleepingComp = _ecm.Component<components::Sleeping>(_entity);
+    if (!sleepingComp)
+    {
+      _ecm.CreateComponent(_entity, components::Sleeping(_sleeping));
+      return;
+    }
+    sleepingComp->Data() = _sleeping;
+    _ecm.SetChanged(_entity, components::Sleeping::typeId,
+        ComponentState::OneTimeChange);
+  };
+
+  if (sleepingChanged)
+  {
+    for (const auto &model : this->modelSlots)
+    {
+      const auto &top = this->modelSlots[model.top];
+      if (top.sleepingChanged)
+        setSleeping(model.entity, top.sleeping);
+    }
   }
 
-  return linkFrameData;
+  for (auto &link : this->linkSlots)
+  {
+    if (link.top == kNoSlot)
+      continue;
+
+    const auto &top = this->modelSlots[link.top];
+    if (top.sleepingChanged)
+      setSleeping(link.entity, top.sleeping);
+
+    // Resting links of sleeping models don't need to be updated, but the
+    // final pose is written on the step the model falls asleep
+    if (top.sleeping && !top.sleepingChanged)
+      link.changed = false;
+    // Links skipped by ChangedLinks while the model slept catch up on the
+    // step it wakes up
+    else if (!top.sleeping && top.sleepingChanged)
+      this->MarkLinkChanged(link);
+  }
 }
 
 //////////////////////////////////////////////////
-void PhysicsPrivate::UpdateModelPose(const Entity _model,
-    const Entity _canonicalLink, EntityComponentManager &_ecm,
-    std::map<Entity, physics::FrameData3d> &_linkFrameData)
+void PhysicsPrivate::MarkLinkChanged(LinkSlot &_link)
 {
-  std::optional<math::Pose3d> parentWorldPose;
+  if (_link.changed)
+    return;
 
-  // If this model is nested, the pose of the parent model has already
-  // been updated since we iterate through the modified links in
-  // topological order. We expect to find the updated pose in
-  // this->modelWorldPoses. If not found, this must not be nested, so this
-  // model's pose component would reflect it's absolute pose.
-  auto parentModelPoseIt =
-    this->modelWorldPoses.find(
-        _ecm.Component<components::ParentEntity>(_model)->Data());
-  if (parentModelPoseIt != this->modelWorldPoses.end())
-  {
-    parentWorldPose = parentModelPoseIt->second;
-  }
+  _link.frameData = _link.link->FrameDataRelativeToWorld();
+  _link.changed = true;
+}
 
+//////////////////////////////////////////////////
+void PhysicsPrivate::UpdateModelPose(ModelSlot &_model,
+    const LinkSlot &_canonicalLink, EntityComponentManager &_ecm)
+{
   // Given the following frame names:
   // W: World/inertial frame
   // P: Parent frame (this could be a parent model or the World frame)
@@ -2546,103 +3049,47 @@ void PhysicsPrivate::UpdateModelPose(const Entity _model,
   //
   // And X_WM is calculated from X_WL, which is obtained from physics as:
   //   X_WM = X_WL * (X_ML)^-1
-  auto linkPoseFromModel = this->RelativePose(_model, _canonicalLink, _ecm);
-  const auto &linkWorldPose = _linkFrameData[_canonicalLink].pose;
-  const auto &modelWorldPose =
-      math::eigen3::convert(linkWorldPose) * linkPoseFromModel.Inverse();
+  if (!_model.canonicalLinkIsChild)
+  {
+    _model.canonicalLinkPose =
+        this->RelativePose(_model.entity, _model.canonicalLink, _ecm);
+  }
 
-  this->modelWorldPoses[_model] = modelWorldPose;
+  const auto &linkWorldPose = _canonicalLink.frameData.pose;
+  _model.worldPose = math::eigen3::convert(linkWorldPose) *
+      _model.canonicalLinkPose.Inverse();
+  _model.hasWorldPose = true;
+  _model.updated = true;
 
-  // update model's pose
-  auto modelPose = _ecm.Component<components::Pose>(_model);
-  if (parentWorldPose)
+  // If this model is nested, the pose of the parent model has already
+  // been updated since models are iterated in topological order. If the
+  // parent's world pose isn't available, this must not be nested, so this
+  // model's pose component would reflect it's absolute pose.
+  if (_model.parent != kNoSlot && this->modelSlots[_model.parent].hasWorldPose)
   {
-    *modelPose =
-        components::Pose(parentWorldPose->Inverse() * modelWorldPose);
+    const auto &parentWorldPose = this->modelSlots[_model.parent].worldPose;
+    *_model.pose = components::Pose(parentWorldPose.Inverse() *
+        _model.worldPose);
   }
   else
   {
     // This is a non-nested model and parentWorldPose would be identity
     // because it would be the pose of the parent (world) w.r.t the world.
-    *modelPose = components::Pose(modelWorldPose);
+    *_model.pose = components::Pose(_model.worldPose);
   }
 
-  _ecm.SetChanged(_model, components::Pose::typeId,
+  _ecm.SetChanged(_model.entity, components::Pose::typeId,
                   ComponentState::PeriodicChange);
 
   // once the model pose has been updated, all descendant link poses of this
   // model must be updated (whether the link actually changed pose or not)
   // since link poses are saved w.r.t. their parent model
-  auto model = gazebo::Model(_model);
-  for (const auto &childLink : model.Links(_ecm))
-  {
-    // skip links that are already marked as a link to be updated
-    if (_linkFrameData.find(childLink) != _linkFrameData.end())
-      continue;
-
-    physics::FrameData3d childLinkFrameData;
-    if (!this->GetFrameDataRelativeToWorld(childLink, childLinkFrameData))
-      continue;
-
-    _linkFrameData[childLink] = childLinkFrameData;
-  }
-
-  // since nested model poses are saved w.r.t. the nested model's parent
-  // pose, we must also update any nested models that have a different
-  // canonical link
-  for (const auto &nestedModel : model.Models(_ecm))
-  {
-    auto nestedModelCanonicalLinkComp =
-      _ecm.Component<components::ModelCanonicalLink>(nestedModel);
-    if (!nestedModelCanonicalLinkComp)
-    {
-      auto staticComp = _ecm.Component<components::Static>(nestedModel);
-      if (!staticComp || !staticComp->Data())
-        ignerr << "Model [" << nestedModel << "] has no canonical link\n";
-      continue;
-    }
-
-    auto nestedCanonicalLink = nestedModelCanonicalLinkComp->Data();
-
-    // skip links that are already marked as a link to be updated
-    if (nestedCanonicalLink == _canonicalLink ||
-        _linkFrameData.find(nestedCanonicalLink) != _linkFrameData.end())
-      continue;
-
-    // mark this canonical link as one that needs to be updated so that all of
-    // the models that have this canonical link are updated
-    physics::FrameData3d canonicalLinkFrameData;
-    if (!this->GetFrameDataRelativeToWorld(nestedCanonicalLink,
-          canonicalLinkFrameData))
-      continue;
-
-    _linkFrameData[nestedCanonicalLink] = canonicalLinkFrameData;
-  }
-}
-
-//////////////////////////////////////////////////
-bool PhysicsPrivate::GetFrameDataRelativeToWorld(const Entity _entity,
-    physics::FrameData3d &_data)
-{
-  auto entityPhys = this->entityLinkMap.Get(_entity);
-  if (nullptr == entityPhys)
-  {
-    // Suppress error message if the link has just been added to the model.
-    if (this->linkAddedToModel.find(_entity) == this->linkAddedToModel.end())
-    {
-      ignerr << "Internal error: entity [" << _entity
-        << "] not in entity map" << std::endl;
-    }
-    return false;
-  }
-
-  _data = entityPhys->FrameDataRelativeToWorld();
-  return true;
+  for (const auto link : _model.links)
+    this->MarkLinkChanged(this->linkSlots[link]);
 }
 
 //////////////////////////////////////////////////
-void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm,
-    std::map<Entity, physics::FrameData3d> &_linkFrameData)
+void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm)
 {
   IGN_PROFILE("PhysicsPrivate::UpdateSim");
 
@@ -2683,76 +3130,84 @@ void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm,
       });
 
   IGN_PROFILE_BEGIN("Models");
+  // Models are in topological order, so a parent model is always updated
+  // before its nested models.
+  for (auto &model : this->modelSlots)
+  {
+    model.updated = false;
 
-  // make sure we have an up-to-date mapping of canonical links to their models
-  this->canonicalLinkModelTracker.AddNewModels(_ecm);
+    const bool parentUpdated = model.parent != kNoSlot &&
+        this->modelSlots[model.parent].updated;
 
-  for (const auto &[linkEntity, frameData] : _linkFrameData)
-  {
-    // get a topological ordering of the models that have linkEntity as the
-    // model's canonical link. If linkEntity isn't a canonical link for any
-    // models, canonicalLinkModels will be empty
-    auto canonicalLinkModels =
-      this->canonicalLinkModelTracker.CanonicalLinkModels(linkEntity);
-
-    // Update poses for all of the models that have this changed canonical link
-    // (linkEntity). Since we have the models in topological order and
-    // _linkFrameData stores links in topological order thanks to the ordering
-    // of std::map (entity IDs are created in ascending order), this should
-    // properly handle pose updates for nested models that share the same
-    // canonical link.
-    //
-    // Nested models that don't share the same canonical link will also need to
-    // be updated since these nested models have their pose saved w.r.t. their
-    // parent model, which just experienced a pose update. The UpdateModelPose
-    // method also handles this case.
-    for (auto &modelEnt : canonicalLinkModels)
-      this->UpdateModelPose(modelEnt, linkEntity, _ecm, _linkFrameData);
+    if (model.canonicalLinkSlot == kNoSlot)
+    {
+      // Nested model poses are saved w.r.t. their parent model, so they must
+      // be updated when the parent moves.
+      if (parentUpdated)
+      {
+        if (model.canonicalLink == kNullEntity)
+        {
+          ignerr << "Model [" << model.entity << "] has no canonical link\n";
+        }
+        else if (this->linkAddedToModel.find(model.canonicalLink) ==
+            this->linkAddedToModel.end())
+        {
+          ignerr << "Internal error: entity [" << model.canonicalLink
+            << "] not in entity map" << std::endl;
+        }
+      }
+      continue;
+    }
+
+    auto &canonicalLink = this->linkSlots[model.canonicalLinkSlot];
+    if (!canonicalLink.changed && !parentUpdated)
+      continue;
+
+    this->MarkLinkChanged(canonicalLink);
+    this->UpdateModelPose(model, canonicalLink, _ecm);
   }
   IGN_PROFILE_END();
 
   // Link poses, velocities...
   IGN_PROFILE_BEGIN("Links");
-  for (const auto &[entity, frameData] : _linkFrameData)
+  for (auto &link : this->linkSlots)
   {
-    IGN_PROFILE_BEGIN("Local pose");
-    auto canonicalLink =
-        _ecm.Component<components::CanonicalLink>(entity);
+    if (!link.changed)
+      continue;
+    link.changed = false;
 
+    const auto &entity = link.entity;
+    const auto &frameData = link.frameData;
     const auto &worldPose = frameData.pose;
-    const auto parentEntity = _ecm.ParentEntity(entity);
 
-    if (!canonicalLink)
+    if (!link.canonical)
     {
       // Compute the relative pose of this link from the parent model
-      auto parentModelPoseIt = this->modelWorldPoses.find(parentEntity);
-      if (parentModelPoseIt == this->modelWorldPoses.end())
+      if (link.model == kNoSlot || !this->modelSlots[link.model].hasWorldPose)
       {
-        ignerr << "Internal error: parent model [" << parentEntity
+        ignerr << "Internal error: parent model [" << _ecm.ParentEntity(entity)
               << "] does not have a world pose available for child entity["
               << entity << "]" << std::endl;
         continue;
       }
-      const math::Pose3d &parentWorldPose = parentModelPoseIt->second;
+      const math::Pose3d &parentWorldPose =
+          this->modelSlots[link.model].worldPose;
 
       // Unlike canonical links, pose of regular links can move relative.
       // to the parent. Same for links inside nested models.
-      auto pose = _ecm.Component<components::Pose>(entity);
-      *pose = components::Pose(parentWorldPose.Inverse() *
-                                math::eigen3::convert(worldPose));
+      *link.pose = components::Pose(parentWorldPose.Inverse() *
+                                    math::eigen3::convert(worldPose));
       _ecm.SetChanged(entity, components::Pose::typeId,
           ComponentState::PeriodicChange);
     }
-    IGN_PROFILE_END();
 
     // Populate world poses, velocities and accelerations of the link. For
     // now these components are updated only if another system has created
     // the corresponding component on the entity.
-    auto worldPoseComp = _ecm.Component<components::WorldPose>(entity);
-    if (worldPoseComp)
+    if (link.worldPose)
     {
       auto state =
-          worldPoseComp->SetData(math::eigen3::convert(frameData.pose),
+          link.worldPose->SetData(math::eigen3::convert(frameData.pose),
           this->pose3Eql) ?
           ComponentState::PeriodicChange :
           ComponentState::NoChange;
@@ -2760,11 +3215,9 @@ void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm,
     }
 
     // Velocity in world coordinates
-    auto worldLinVelComp =
-        _ecm.Component<components::WorldLinearVelocity>(entity);
-    if (worldLinVelComp)
+    if (link.worldLinVel)
     {
-      auto state = worldLinVelComp->SetData(
+      auto state = link.worldLinVel->SetData(
             math::eigen3::convert(frameData.linearVelocity),
             this->vec3Eql) ?
             ComponentState::PeriodicChange :
@@ -2774,11 +3227,9 @@ void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm,
     }
 
     // Angular velocity in world frame coordinates
-    auto worldAngVelComp =
-        _ecm.Component<components::WorldAngularVelocity>(entity);
-    if (worldAngVelComp)
+    if (link.worldAngVel)
     {
-      auto state = worldAngVelComp->SetData(
+      auto state = link.worldAngVel->SetData(
           math::eigen3::convert(frameData.angularVelocity),
           this->vec3Eql) ?
           ComponentState::PeriodicChange :
@@ -2788,11 +3239,9 @@ void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm,
     }
 
     // Acceleration in world frame coordinates
-    auto worldLinAccelComp =
-        _ecm.Component<components::WorldLinearAcceleration>(entity);
-    if (worldLinAccelComp)
+    if (link.worldLinAccel)
     {
-      auto state = worldLinAccelComp->SetData(
+      auto state = link.worldLinAccel->SetData(
           math::eigen3::convert(frameData.linearAcceleration),
           this->vec3Eql) ?
           ComponentState::PeriodicChange :
@@ -2802,12 +3251,9 @@ void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm,
     }
 
     // Angular acceleration in world frame coordinates
-    auto worldAngAccelComp =
-        _ecm.Component<components::WorldAngularAcceleration>(entity);
-
-    if (worldAngAccelComp)
+    if (link.worldAngAccel)
     {
-      auto state = worldAngAccelComp->SetData(
+      auto state = link.worldAngAccel->SetData(
           math::eigen3::convert(frameData.angularAcceleration),
           this->vec3Eql) ?
           ComponentState::PeriodicChange :
@@ -2819,13 +3265,11 @@ void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm,
     const Eigen::Matrix3d R_bs = worldPose.linear().transpose(); // NOLINT
 
     // Velocity in body-fixed frame coordinates
-    auto bodyLinVelComp =
-        _ecm.Component<components::LinearVelocity>(entity);
-    if (bodyLinVelComp)
+    if (link.bodyLinVel)
     {
       Eigen::Vector3d bodyLinVel = R_bs * frameData.linearVelocity;
       auto state =
-          bodyLinVelComp->SetData(math::eigen3::convert(bodyLinVel),
+          link.bodyLinVel->SetData(math::eigen3::convert(bodyLinVel),
           this->vec3Eql) ?
           ComponentState::PeriodicChange :
           ComponentState::NoChange;
@@ -2833,13 +3277,11 @@ void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm,
     }
 
     // Angular velocity in body-fixed frame coordinates
-    auto bodyAngVelComp =
-        _ecm.Component<components::AngularVelocity>(entity);
-    if (bodyAngVelComp)
+    if (link.bodyAngVel)
     {
       Eigen::Vector3d bodyAngVel = R_bs * frameData.angularVelocity;
       auto state =
-          bodyAngVelComp->SetData(math::eigen3::convert(bodyAngVel),
+          link.bodyAngVel->SetData(math::eigen3::convert(bodyAngVel),
           this->vec3Eql) ?
           ComponentState::PeriodicChange :
           ComponentState::NoChange;
@@ -2848,13 +3290,11 @@ void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm,
     }
 
     // Acceleration in body-fixed frame coordinates
-    auto bodyLinAccelComp =
-        _ecm.Component<components::LinearAcceleration>(entity);
-    if (bodyLinAccelComp)
+    if (link.bodyLinAccel)
     {
       Eigen::Vector3d bodyLinAccel = R_bs * frameData.linearAcceleration;
       auto state =
-          bodyLinAccelComp->SetData(math::eigen3::convert(bodyLinAccel),
+          link.bodyLinAccel->SetData(math::eigen3::convert(bodyLinAccel),
           this->vec3Eql)?
           ComponentState::PeriodicChange :
           ComponentState::NoChange;
@@ -2863,13 +3303,11 @@ void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm,
     }
 
     // Angular acceleration in world frame coordinates
-    auto bodyAngAccelComp =
-        _ecm.Component<components::AngularAcceleration>(entity);
-    if (bodyAngAccelComp)
+    if (link.bodyAngAccel)
     {
       Eigen::Vector3d bodyAngAccel = R_bs * frameData.angularAcceleration;
       auto state =
-          bodyAngAccelComp->SetData(math::eigen3::convert(bodyAngAccel),
+          link.bodyAngAccel->SetData(math::eigen3::convert(bodyAngAccel),
           this->vec3Eql) ?
           ComponentState::PeriodicChange :
           ComponentState::NoChange;
@@ -3175,9 +3613,13 @@ void PhysicsPrivate::UpdateSim(EntityComponentManager &_ecm,
 void PhysicsPrivate::UpdateCollisions(EntityComponentManager &_ecm)
 {
   IGN_PROFILE("PhysicsPrivate::UpdateCollisions");
-  // Quit early if the ContactData component hasn't been created. This means
+  // Quit early if no contact component has been created. This means
   // there are no systems that need contact information
-  if (!_ecm.HasComponentType(components::ContactSensorData::typeId))
+  const bool hasBuffers =
+      _ecm.HasComponentType(components::ContactSensorBuffer::typeId);
+  const bool hasMsgs =
+      _ecm.HasComponentType(components::ContactSensorData::typeId);
+  if (!hasBuffers && !hasMsgs)
     return;
 
   // TODO(addisu) If systems are assumed to only have one world, we should
@@ -3212,24 +3654,19 @@ void PhysicsPrivate::UpdateCollisions(EntityComponentManager &_ecm)
     return;
   }
 
+  using ExtraContactData =
+      physics::GetContactsFromLastStepFeature::ExtraContactDataT<
+      physics::FeaturePolicy3d>;
+
   // Each contact object we get from ign-physics contains the EntityPtrs of the
   // two colliding entities and other data about the contact such as the
-  // position. This map groups contacts so that it is easy to query all the
-  // contacts of one entity.
-  using EntityContactMap = std::unordered_map<Entity,
-      std::deque<const WorldShapeType::ContactPoint *>>;
-
-  // This data structure is essentially a mapping between a pair of entities and
-  // a list of pointers to their contact object. We use a map inside a map to
-  // create msgs::Contact objects conveniently later on.
-  std::unordered_map<Entity, EntityContactMap> entityContactMap;
-
-  // Note that we are temporarily storing pointers to elements in this
-  // ("allContacts") container. Thus, we must make sure it doesn't get destroyed
-  // until the end of this function.
-  auto allContacts =
-      std::move(worldCollisionFeature->GetContactsFromLastStep());
+  // position. Each contact is recorded once for each of its collisions, and
+  // the records are sorted by collision pair, so that all the contacts of one
+  // entity are contiguous and can be found with a binary search.
+  auto allContacts = worldCollisionFeature->GetContactsFromLastStep();
 
+  this->contactRecords.clear();
+  this->contactRecords.reserve(allContacts.size() * 2);
   for (const auto &contactComposite : allContacts)
   {
     const auto &contact = contactComposite.Get<WorldShapeType::ContactPoint>();
@@ -3238,65 +3675,157 @@ void PhysicsPrivate::UpdateCollisions(EntityComponentManager &_ecm)
     auto coll2Entity =
       this->entityCollisionMap.GetByPhysicsId(contact.collision2->EntityID());
 
-    if (coll1Entity != kNullEntity && coll2Entity != kNullEntity)
+    if (coll1Entity == kNullEntity || coll2Entity == kNullEntity)
+      continue;
+
+    ContactRecord record;
+    record.collision1 = coll1Entity;
+    record.collision2 = coll2Entity;
+    record.position = math::eigen3::convert(contact.point);
+
+    const auto *extraData = contactComposite.Query<ExtraContactData>();
+    if (nullptr != extraData)
     {
-      entityContactMap[coll1Entity][coll2Entity].push_back(&contact);
-      entityContactMap[coll2Entity][coll1Entity].push_back(&contact);
+      record.normal = math::eigen3::convert(extraData->normal);
+      record.force = math::eigen3::convert(extraData->force);
+      record.depth = extraData->depth;
+      record.hasExtraData = true;
     }
+    this->contactRecords.push_back(record);
+
+    // Same contact, seen from the other collision
+    std::swap(record.collision1, record.collision2);
+    record.normal = -record.normal;
+    record.force = -record.force;
+    this->contactRecords.push_back(record);
   }
 
-  // Go through each collision entity that has a ContactData component and
-  // set the component value to the list of contacts that correspond to
-  // the collision entity
-  _ecm.Each<components::Collision, components::ContactSensorData>(
-      [&](const Entity &_collEntity1, components::Collision *,
-          components::ContactSensorData *_contacts) -> bool
+  // Stable so that points keep the engine's order within each pair
+  std::stable_sort(this->contactRecords.begin(), this->contactRecords.end(),
+      [](const ContactRecord &_a, const ContactRecord &_b)
       {
-        msgs::Contacts contactsComp;
-        if (entityContactMap.find(_collEntity1) == entityContactMap.end())
+        return _a.collision1 < _b.collision1 ||
+            (_a.collision1 == _b.collision1 && _a.collision2 < _b.collision2);
+      });
+
+  // Go through each collision entity that has a ContactSensorBuffer component
+  // and fill it with the contacts that correspond to the collision entity.
+  if (hasBuffers)
+  {
+    _ecm.Each<components::Collision, components::ContactSensorBuffer>(
+        [&](const Entity &_collEntity, components::Collision *,
+            components::ContactSensorBuffer *_contacts) -> bool
+        {
+          this->FillContactBuffer(_collEntity, _ecm, this->contactScratch);
+
+          // Always take the new data, since normals and forces aren't part of
+          // the comparison, but only flag changes in the contact points.
+          auto state = this->contactScratch.Equal(_contacts->Data()) ?
+            ComponentState::NoChange :
+            ComponentState::PeriodicChange;
+          std::swap(_contacts->Data(), this->contactScratch);
+          _ecm.SetChanged(
+            _collEntity, components::ContactSensorBuffer::typeId, state);
+          return true;
+        });
+  }
+
+  // ContactSensorData is kept for backwards compatibility, its messages are
+  // only built if something created the component.
+  if (hasMsgs)
+  {
+    _ecm.Each<components::Collision, components::ContactSensorData>(
+        [&](const Entity &_collEntity, components::Collision *,
+            components::ContactSensorData *_contacts) -> bool
         {
-          // Clear the last contact data
+          auto bufferComp =
+              _ecm.Component<components::ContactSensorBuffer>(_collEntity);
+          if (nullptr == bufferComp)
+          {
+            this->FillContactBuffer(_collEntity, _ecm, this->contactScratch);
+          }
+          const auto &buffer =
+              bufferComp ? bufferComp->Data() : this->contactScratch;
+
+          msgs::Contacts contactsComp;
+          buffer.AddToMsg(contactsComp);
+
           auto state = _contacts->SetData(contactsComp,
             this->contactsEql) ?
             ComponentState::PeriodicChange :
             ComponentState::NoChange;
           _ecm.SetChanged(
-            _collEntity1, components::ContactSensorData::typeId, state);
+            _collEntity, components::ContactSensorData::typeId, state);
+
           return true;
-        }
+        });
+  }
+}
 
-        const auto &contactMap = entityContactMap[_collEntity1];
+//////////////////////////////////////////////////
+void PhysicsPrivate::FillContactBuffer(const Entity _collision,
+    const EntityComponentManager &_ecm, ContactBuffer &_buffer)
+{
+  _buffer.Clear();
 
-        for (const auto &[collEntity2, contactData] : contactMap)
-        {
-          msgs::Contact *contactMsg = contactsComp.add_contact();
-          contactMsg->mutable_collision1()->set_id(_collEntity1);
-          contactMsg->mutable_collision2()->set_id(collEntity2);
-          if (this->contactsEntityNames)
-          {
-            contactMsg->mutable_collision1()->set_name(
-              removeParentScope(scopedName(_collEntity1, _ecm, "::", 0), "::"));
-            contactMsg->mutable_collision2()->set_name(
-              removeParentScope(scopedName(collEntity2, _ecm, "::", 0), "::"));
-          }
-          for (const auto &contact : contactData)
-          {
-            auto *position = contactMsg->add_position();
-            position->set_x(contact->point.x());
-            position->set_y(contact->point.y());
-            position->set_z(contact->point.z());
-          }
-        }
+  auto it = std::lower_bound(this->contactRecords.begin(),
+      this->contactRecords.end(), _collision,
+      [](const ContactRecord &_record, const Entity _entity)
+      {
+        return _record.collision1 < _entity;
+      });
 
-        auto state = _contacts->SetData(contactsComp,
-          this->contactsEql) ?
-          ComponentState::PeriodicChange :
-          ComponentState::NoChange;
-        _ecm.SetChanged(
-          _collEntity1, components::ContactSensorData::typeId, state);
+  bool extra{true};
+  for (; it != this->contactRecords.end() && it->collision1 == _collision;
+       ++it)
+  {
+    if (_buffer.pairs.empty() ||
+        _buffer.pairs.back().collision2 != it->collision2)
+    {
+      ContactBuffer::Pair pair;
+      pair.collision1 = it->collision1;
+      pair.collision2 = it->collision2;
+      if (this->contactsEntityNames)
+      {
+        pair.collision1Name = this->ContactCollisionName(it->collision1, _ecm);
+        pair.collision2Name = this->ContactCollisionName(it->collision2, _ecm);
+      }
+      pair.offset = _buffer.positions.size();
+      _buffer.pairs.push_back(std::move(pair));
+    }
 
-        return true;
-      });
+    _buffer.pairs.back().count++;
+    _buffer.positions.push_back(it->position);
+
+    extra = extra && it->hasExtraData;
+    if (extra)
+    {
+      _buffer.normals.push_back(it->normal);
+      _buffer.depths.push_back(it->depth);
+      _buffer.forces.push_back(it->force);
+    }
+  }
+
+  // Extra data is all or nothing
+  if (!extra)
+  {
+    _buffer.normals.clear();
+    _buffer.depths.clear();
+    _buffer.forces.clear();
+  }
+}
+
+//////////////////////////////////////////////////
+const std::string &PhysicsPrivate::ContactCollisionName(
+    const Entity _collision, const EntityComponentManager &_ecm)
+{
+  auto it = this->contactCollisionNames.find(_collision);
+  if (it == this->contactCollisionNames.end())
+  {
+    it = this->contactCollisionNames.emplace(_collision,
+        removeParentScope(scopedName(_collision, _ecm, "::", 0), "::")).first;
+  }
+  return it->second;
 }
 
 //////////////////////////////////////////////////
@@ -76,6 +76,25 @@ namespace systems
   ///    </contacts>
   ///  </plugin>
   ///  ```
+  ///
+  /// Includes optional parameter : <sleep>. When present, non-static top
+  /// level models whose links all move slower than the given thresholds
+  /// for `<time>` seconds fall asleep: their poses and velocities stop being
+  /// updated in the ECM until one of their links moves again. The physics
+  /// engine keeps simulating them. Sleeping models and links are tagged with
+  /// components::Sleeping so other systems can skip them. Usage, with the
+  /// default values:
+  /// ```
+  ///  <plugin
+  ///    filename="ignition-gazebo-physics-system"
+  ///    name="ignition::gazebo::systems::Physics">
+  ///    <sleep>
+  ///      <linear_velocity_threshold>0.01</linear_velocity_threshold>
+  ///      <angular_velocity_threshold>0.01</angular_velocity_threshold>
+  ///      <time>1.0</time>
+  ///    </sleep>
+  ///  </plugin>
+  ///  ```
 
   class Physics:
     public System,
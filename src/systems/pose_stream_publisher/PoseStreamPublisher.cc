@@ -0,0 +1,444 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "PoseStreamPublisher.hh"
+
+#include <ignition/msgs/pose_v.pb.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Profiler.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/plugin/Register.hh>
+#include <ignition/transport/Node.hh>
+
+#include "ignition/gazebo/components/Collision.hh"
+#include "ignition/gazebo/components/Link.hh"
+#include "ignition/gazebo/components/Model.hh"
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/ParentEntity.hh"
+#include "ignition/gazebo/components/Pose.hh"
+#include "ignition/gazebo/components/Sensor.hh"
+#include "ignition/gazebo/components/Visual.hh"
+#include "ignition/gazebo/components/World.hh"
+#include "ignition/gazebo/Conversions.hh"
+#include "ignition/gazebo/Util.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+
+/// \brief Private data class for PoseStreamPublisher
+class ignition::gazebo::systems::PoseStreamPublisherPrivate
+{
+  /// \brief A frame whose pose may be published.
+  public: struct Frame
+  {
+    /// \brief Entity whose pose is published.
+    Entity entity{kNullEntity};
+
+    /// \brief Pose of the entity relative to its parent.
+    const components::Pose *pose{nullptr};
+
+    /// \brief Scoped name of the parent entity.
+    std::string frameId;
+
+    /// \brief Scoped name of the entity.
+    std::string childFrameId;
+  };
+
+  /// \brief A subset of the frames published on one topic.
+  public: struct Stream
+  {
+    /// \brief Topic name.
+    std::string topic;
+
+    /// \brief Publisher.
+    transport::Node::Publisher pub;
+
+    /// \brief Frames whose child frame matches any of these are published.
+    /// If empty, all frames are published.
+    std::vector<std::regex> filters;
+
+    /// \brief Update period calculated from the update_frequency parameter.
+    std::chrono::steady_clock::duration updatePeriod{0};
+
+    /// \brief Last time poses were published.
+    std::chrono::steady_clock::duration lastPubTime{0};
+
+    /// \brief Resolution positions are rounded to, if positive.
+    double positionResolution{0.0};
+
+    /// \brief Resolution quaternion components are rounded to, if positive.
+    double orientationResolution{0.0};
+
+    /// \brief Indices in PoseStreamPublisherPrivate::frames of the frames in
+    /// this stream, in the same order as the poses in msg.
+    std::vector<std::size_t> frames;
+
+    /// \brief Message that is reused for every publication. Only the poses
+    /// and time stamps are updated unless the frames change.
+    msgs::Pose_V msg;
+  };
+
+  /// \brief Parse a stream from SDF.
+  /// \param[in] _sdf Element containing the stream parameters.
+  /// \param[in] _defaultTopic Topic used if there's no <topic>.
+  public: void AddStream(const sdf::ElementPtr &_sdf,
+                         const std::string &_defaultTopic);
+
+  /// \brief Whether an entity's pose should be published.
+  /// \param[in] _entity Entity to check.
+  /// \param[in] _ecm Immutable reference to the ECM.
+  /// \return True if its type is selected by the publish_*_pose parameters.
+  public: bool IsPublished(const Entity _entity,
+                           const EntityComponentManager &_ecm) const;
+
+  /// \brief Rebuild the frames and stream messages if the structure of the
+  /// ECM changed since they were last built.
+  /// \param[in] _ecm Immutable reference to the ECM.
+  public: void UpdateFrames(const EntityComponentManager &_ecm);
+
+  /// \brief Update the poses and time stamp of a stream's message.
+  /// \param[in, out] _stream Stream to update.
+  /// \param[in] _stampMsg Time stamp.
+  public: void FillPoses(Stream &_stream, const msgs::Time &_stampMsg);
+
+  /// \brief Ignition communication node.
+  public: transport::Node node;
+
+  /// \brief Name of the world.
+  public: std::string worldName;
+
+  /// \brief True to publish model pose
+  public: bool publishModelPose{true};
+
+  /// \brief True to publish link pose
+  public: bool publishLinkPose{true};
+
+  /// \brief True to publish visual pose
+  public: bool publishVisualPose{false};
+
+  /// \brief True to publish collision pose
+  public: bool publishCollisionPose{false};
+
+  /// \brief True to publish sensor pose
+  public: bool publishSensorPose{false};
+
+  /// \brief All frames that can be published, ordered by entity.
+  public: std::vector<Frame> frames;
+
+  /// \brief All streams.
+  public: std::vector<Stream> streams;
+
+  /// \brief ECM structure version the frames were built for.
+  /// \sa EntityComponentManager::StructureVersion
+  public: uint64_t framesVersion{0};
+
+  /// \brief Whether the frames have been built.
+  public: bool framesValid{false};
+};
+
+//////////////////////////////////////////////////
+/// \brief Round a value to a multiple of a resolution.
+/// \param[in] _value Value to round.
+/// \param[in] _resolution Resolution, ignored if not positive.
+/// \return The rounded value.
+static double quantize(double _value, double _resolution)
+{
+  if (_resolution <= 0.0)
+    return _value;
+  return std::round(_value / _resolution) * _resolution;
+}
+
+//////////////////////////////////////////////////
+PoseStreamPublisher::PoseStreamPublisher()
+  : dataPtr(std::make_unique<PoseStreamPublisherPrivate>())
+{
+}
+
+//////////////////////////////////////////////////
+void PoseStreamPublisher::Configure(const Entity &_entity,
+    const std::shared_ptr<const sdf::Element> &_sdf,
+    EntityComponentManager &_ecm,
+    EventManager &/*_eventMgr*/)
+{
+  auto worldName = _ecm.Component<components::Name>(_entity);
+  if (!_ecm.Component<components::World>(_entity) || !worldName)
+  {
+    ignerr << "PoseStreamPublisher plugin should be attached to a world "
+      << "entity. Failed to initialize." << std::endl;
+    return;
+  }
+  this->dataPtr->worldName = worldName->Data();
+
+  // parse optional params
+  this->dataPtr->publishModelPose = _sdf->Get<bool>("publish_model_pose",
+      this->dataPtr->publishModelPose).first;
+  this->dataPtr->publishLinkPose = _sdf->Get<bool>("publish_link_pose",
+      this->dataPtr->publishLinkPose).first;
+  this->dataPtr->publishVisualPose = _sdf->Get<bool>("publish_visual_pose",
+      this->dataPtr->publishVisualPose).first;
+  this->dataPtr->publishCollisionPose =
+    _sdf->Get<bool>("publish_collision_pose",
+        this->dataPtr->publishCollisionPose).first;
+  this->dataPtr->publishSensorPose = _sdf->Get<bool>("publish_sensor_pose",
+      this->dataPtr->publishSensorPose).first;
+
+  const std::string baseTopic = "/world/" + this->dataPtr->worldName +
+      "/pose_stream";
+
+  // Clone the element so we can iterate over it
+  auto sdfClone = _sdf->Clone();
+  if (sdfClone->HasElement("stream"))
+  {
+    for (auto streamElem = sdfClone->GetElement("stream"); streamElem;
+         streamElem = streamElem->GetNextElement("stream"))
+    {
+      this->dataPtr->AddStream(streamElem, baseTopic + "/" +
+          std::to_string(this->dataPtr->streams.size()));
+    }
+  }
+  else
+  {
+    this->dataPtr->AddStream(sdfClone, baseTopic);
+  }
+}
+
+//////////////////////////////////////////////////
+void PoseStreamPublisherPrivate::AddStream(const sdf::ElementPtr &_sdf,
+    const std::string &_defaultTopic)
+{
+  Stream stream;
+
+  stream.topic = transport::TopicUtils::AsValidTopic(
+      _sdf->Get<std::string>("topic", _defaultTopic).first);
+  if (stream.topic.empty())
+  {
+    ignerr << "Invalid pose stream topic [" << _sdf->Get<std::string>("topic")
+           << "]. The stream won't be published." << std::endl;
+    return;
+  }
+
+  double updateFrequency = _sdf->Get<double>("update_frequency", -1).first;
+  if (updateFrequency > 0)
+  {
+    std::chrono::duration<double> period{1 / updateFrequency};
+    stream.updatePeriod =
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(period);
+  }
+
+  if (_sdf->HasElement("frame"))
+  {
+    for (auto frameElem = _sdf->GetElement("frame"); frameElem;
+         frameElem = frameElem->GetNextElement("frame"))
+    {
+      const auto pattern = frameElem->Get<std::string>();
+      try
+      {
+        stream.filters.emplace_back(pattern);
+      }
+      catch (const std::regex_error &_e)
+      {
+        ignerr << "Invalid frame pattern [" << pattern << "] in pose stream ["
+               << stream.topic << "]: " << _e.what() << std::endl;
+      }
+    }
+  }
+
+  stream.positionResolution =
+    _sdf->Get<double>("position_resolution", 0.0).first;
+  stream.orientationResolution =
+    _sdf->Get<double>("orientation_resolution", 0.0).first;
+
+  stream.pub = this->node.Advertise<msgs::Pose_V>(stream.topic);
+
+  igndbg << "Publishing pose stream on [" << stream.topic << "]" << std::endl;
+  this->streams.push_back(std::move(stream));
+}
+
+//////////////////////////////////////////////////
+void PoseStreamPublisher::PostUpdate(const UpdateInfo &_info,
+    const EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("PoseStreamPublisher::PostUpdate");
+
+  // Nothing left to do if paused.
+  if (_info.paused)
+    return;
+
+  bool framesUpdated{false};
+  msgs::Time stampMsg;
+  for (auto &stream : this->dataPtr->streams)
+  {
+    // If the diff is positive and it's less than the update period, we skip
+    // publication. If the diff is negative, then time has gone backward, we go
+    // ahead publish and allow the time to be reset
+    auto diff = _info.simTime - stream.lastPubTime;
+    if ((diff > std::chrono::steady_clock::duration::zero()) &&
+        (diff < stream.updatePeriod))
+    {
+      continue;
+    }
+
+    // Don't spend time filling messages nobody will receive
+    if (!stream.pub.HasConnections())
+      continue;
+
+    if (!framesUpdated)
+    {
+      this->dataPtr->UpdateFrames(_ecm);
+      stampMsg = convert<msgs::Time>(_info.simTime);
+      framesUpdated = true;
+    }
+
+    this->dataPtr->FillPoses(stream, stampMsg);
+    stream.pub.Publish(stream.msg);
+    stream.lastPubTime = _info.simTime;
+  }
+}
+
+//////////////////////////////////////////////////
+bool PoseStreamPublisherPrivate::IsPublished(const Entity _entity,
+    const EntityComponentManager &_ecm) const
+{
+  return (this->publishModelPose &&
+          _ecm.Component<components::Model>(_entity)) ||
+      (this->publishLinkPose && _ecm.Component<components::Link>(_entity)) ||
+      (this->publishVisualPose &&
+          _ecm.Component<components::Visual>(_entity)) ||
+      (this->publishCollisionPose &&
+          _ecm.Component<components::Collision>(_entity)) ||
+      (this->publishSensorPose &&
+          _ecm.Component<components::Sensor>(_entity));
+}
+
+//////////////////////////////////////////////////
+void PoseStreamPublisherPrivate::UpdateFrames(
+    const EntityComponentManager &_ecm)
+{
+  if (this->framesValid && this->framesVersion == _ecm.StructureVersion())
+    return;
+
+  IGN_PROFILE("PoseStreamPublisher::UpdateFrames");
+
+  this->frames.clear();
+  _ecm.Each<components::Pose, components::ParentEntity>(
+      [&](const Entity &_entity, const components::Pose *_pose,
+          const components::ParentEntity *_parent) -> bool
+      {
+        if (!this->IsPublished(_entity, _ecm))
+          return true;
+
+        Frame frame;
+        frame.entity = _entity;
+        frame.pose = _pose;
+        frame.frameId = removeParentScope(
+            scopedName(_parent->Data(), _ecm, "::", false), "::");
+        frame.childFrameId = removeParentScope(
+            scopedName(_entity, _ecm, "::", false), "::");
+        this->frames.push_back(std::move(frame));
+        return true;
+      });
+
+  std::sort(this->frames.begin(), this->frames.end(),
+      [](const Frame &_a, const Frame &_b)
+      {
+        return _a.entity < _b.entity;
+      });
+
+  // Rebuild the messages, which only need their poses updated from now on
+  for (auto &stream : this->streams)
+  {
+    stream.frames.clear();
+    stream.msg.Clear();
+    for (std::size_t i = 0; i < this->frames.size(); ++i)
+    {
+      const auto &frame = this->frames[i];
+      if (!stream.filters.empty() &&
+          std::none_of(stream.filters.begin(), stream.filters.end(),
+              [&](const std::regex &_filter)
+              {
+                return std::regex_match(frame.childFrameId, _filter);
+              }))
+      {
+        continue;
+      }
+
+      stream.frames.push_back(i);
+
+      // frame_id: parent entity name
+      // child_frame_id = entity name
+      // pose is the transform from frame_id to child_frame_id
+      auto poseMsg = stream.msg.add_pose();
+      poseMsg->set_name(frame.childFrameId);
+      auto header = poseMsg->mutable_header();
+      auto frameData = header->add_data();
+      frameData->set_key("frame_id");
+      frameData->add_value(frame.frameId);
+      auto childFrameData = header->add_data();
+      childFrameData->set_key("child_frame_id");
+      childFrameData->add_value(frame.childFrameId);
+    }
+  }
+
+  this->framesVersion = _ecm.StructureVersion();
+  this->framesValid = true;
+}
+
+//////////////////////////////////////////////////
+void PoseStreamPublisherPrivate::FillPoses(Stream &_stream,
+    const msgs::Time &_stampMsg)
+{
+  IGN_PROFILE("PoseStreamPublisher::FillPoses");
+
+  _stream.msg.mutable_header()->mutable_stamp()->CopyFrom(_stampMsg);
+  for (std::size_t i = 0; i < _stream.frames.size(); ++i)
+  {
+    const auto &pose = this->frames[_stream.frames[i]].pose->Data();
+    auto poseMsg = _stream.msg.mutable_pose(static_cast<int>(i));
+    poseMsg->mutable_header()->mutable_stamp()->CopyFrom(_stampMsg);
+
+    auto position = poseMsg->mutable_position();
+    position->set_x(quantize(pose.Pos().X(), _stream.positionResolution));
+    position->set_y(quantize(pose.Pos().Y(), _stream.positionResolution));
+    position->set_z(quantize(pose.Pos().Z(), _stream.positionResolution));
+
+    auto orientation = poseMsg->mutable_orientation();
+    orientation->set_x(
+        quantize(pose.Rot().X(), _stream.orientationResolution));
+    orientation->set_y(
+        quantize(pose.Rot().Y(), _stream.orientationResolution));
+    orientation->set_z(
+        quantize(pose.Rot().Z(), _stream.orientationResolution));
+    orientation->set_w(
+        quantize(pose.Rot().W(), _stream.orientationResolution));
+  }
+}
+
+IGNITION_ADD_PLUGIN(PoseStreamPublisher,
+                    System,
+                    PoseStreamPublisher::ISystemConfigure,
+                    PoseStreamPublisher::ISystemPostUpdate)
+
+IGNITION_ADD_PLUGIN_ALIAS(PoseStreamPublisher,
+                          "ignition::gazebo::systems::PoseStreamPublisher")
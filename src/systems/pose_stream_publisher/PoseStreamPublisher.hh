@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_SYSTEMS_POSESTREAMPUBLISHER_HH_
+#define IGNITION_GAZEBO_SYSTEMS_POSESTREAMPUBLISHER_HH_
+
+#include <memory>
+#include <ignition/gazebo/config.hh>
+#include <ignition/gazebo/System.hh>
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems
+{
+  // Forward declaration
+  class PoseStreamPublisherPrivate;
+
+  /// \brief World-level pose publisher. Attach to a world to publish the
+  /// transforms of the entities of all models in a single
+  /// ignition::msgs::Pose_V message per stream, instead of running a
+  /// PosePublisher per model.
+  ///
+  /// Each pose in the message is the transform from the entity's parent
+  /// (frame_id) to the entity (child_frame_id), with the same naming as
+  /// PosePublisher. Frames are ordered by entity ID. The messages are built
+  /// once and only their poses and time stamps are updated on each
+  /// publication, and they're rebuilt when entities are added or removed.
+  ///
+  /// The following parameters are used by the system:
+  ///
+  /// publish_model_pose        : Set to true to publish model poses, including
+  ///                             nested models. Defaults to true.
+  /// publish_link_pose         : Set to true to publish link poses. Defaults
+  ///                             to true.
+  /// publish_visual_pose       : Set to true to publish visual poses.
+  /// publish_collision_pose    : Set to true to publish collision poses.
+  /// publish_sensor_pose       : Set to true to publish sensor poses.
+  /// stream                    : A stream of poses for one consumer. It may
+  ///                             be repeated to publish different subsets of
+  ///                             the frames at different rates. If there are
+  ///                             no streams, a single stream is published on
+  ///                             "/world/<world_name>/pose_stream" with the
+  ///                             parameters below read from the plugin
+  ///                             element itself. Each stream accepts:
+  ///
+  ///   topic                   : Topic to publish on. Defaults to
+  ///                             "/world/<world_name>/pose_stream/<index>".
+  ///   update_frequency        : Frequency of publications in Hz, in
+  ///                             simulation time. A negative frequency
+  ///                             publishes at every simulation step, which is
+  ///                             the default.
+  ///   frame                   : Regular expression matched against the
+  ///                             child frame name, e.g. "robot_[0-9]+::.*".
+  ///                             It may be repeated, and frames matching any
+  ///                             of them are published. If there are none,
+  ///                             all frames are published.
+  ///   position_resolution     : If positive, positions are rounded to
+  ///                             multiples of this value in meters, which
+  ///                             makes the stream compress better.
+  ///   orientation_resolution  : If positive, quaternion components are
+  ///                             rounded to multiples of this value.
+  class PoseStreamPublisher
+      : public System,
+        public ISystemConfigure,
+        public ISystemPostUpdate
+  {
+    /// \brief Constructor
+    public: PoseStreamPublisher();
+
+    /// \brief Destructor
+    public: ~PoseStreamPublisher() override = default;
+
+    // Documentation inherited
+    public: void Configure(const Entity &_entity,
+                           const std::shared_ptr<const sdf::Element> &_sdf,
+                           EntityComponentManager &_ecm,
+                           EventManager &_eventMgr) override;
+
+    // Documentation inherited
+    public: void PostUpdate(
+                const UpdateInfo &_info,
+                const EntityComponentManager &_ecm) override;
+
+    /// \brief Private data pointer
+    private: std::unique_ptr<PoseStreamPublisherPrivate> dataPtr;
+  };
+  }
+}
+}
+}
+
+#endif
@@ -16,15 +16,22 @@
 */
 
 #include "SceneBroadcaster.hh"
+#include "StateStreams.hh"
 
 #include <ignition/msgs/scene.pb.h>
 
 #include <algorithm>
 #include <chrono>
 #include <condition_variable>
+#include <deque>
+#include <iterator>
 #include <map>
+#include <memory>
 #include <string>
+#include <thread>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include <ignition/common/Profiler.hh>
 #include <ignition/math/graph/Graph.hh>
@@ -52,12 +59,14 @@
 #include "ignition/gazebo/components/Pose.hh"
 #include "ignition/gazebo/components/RgbdCamera.hh"
 #include "ignition/gazebo/components/Sensor.hh"
+#include "ignition/gazebo/components/Sleeping.hh"
 #include "ignition/gazebo/components/Static.hh"
 #include "ignition/gazebo/components/ThermalCamera.hh"
 #include "ignition/gazebo/components/Visual.hh"
 #include "ignition/gazebo/components/World.hh"
 #include "ignition/gazebo/Conversions.hh"
 #include "ignition/gazebo/EntityComponentManager.hh"
+#include "ignition/gazebo/Util.hh"
 
 #include <sdf/Camera.hh>
 #include <sdf/Imu.hh>
@@ -101,6 +110,40 @@ class ignition::gazebo::systems::SceneBroadcasterPrivate
   /// \param[out] _res Response containing the last available full state.
   public: void StateAsyncService(const ignition::msgs::StringMsg &_req);
 
+  /// \brief Destructor. Stops the snapshot thread.
+  public: ~SceneBroadcasterPrivate();
+
+  /// \brief Queue a state message to be merged into the state snapshot.
+  /// Starts the snapshot thread the first time it's called.
+  /// \param[in] _msg State message
+  /// \param[in] _full True if _msg has the full state and replaces the
+  /// snapshot.
+  public: void QueueSnapshotUpdate(
+              std::shared_ptr<const msgs::SerializedStepMap> _msg,
+              bool _full);
+
+  /// \brief Get the latest full state from the snapshot and the updates
+  /// which haven't been merged into it yet.
+  /// \param[out] _msg Full state
+  /// \return False if there's no snapshot yet.
+  public: bool SnapshotState(msgs::SerializedStepMap &_msg);
+
+  /// \brief Merge the queued updates into the snapshot, until stopped.
+  public: void SnapshotThread();
+
+  /// \brief Drop the snapshot and stop updating it. The next request is
+  /// served from the simulation thread and seeds a new snapshot.
+  public: void ResetSnapshot();
+
+  /// \brief Merge a state message into a full state.
+  /// \param[in, out] _state Full state
+  /// \param[in] _update State message, as created by
+  /// EntityComponentManager::State or ChangedState
+  /// \param[in] _full True if _update replaces _state
+  public: static void MergeState(msgs::SerializedStepMap &_state,
+                                 const msgs::SerializedStepMap &_update,
+                                 bool _full);
+
   /// \brief Updates the scene graph when entities are added
   /// \param[in] _manager The entity component manager
   public: void SceneGraphAddEntities(const EntityComponentManager &_manager);
@@ -160,6 +203,27 @@ class ignition::gazebo::systems::SceneBroadcasterPrivate
   public: static void RemoveFromGraph(const Entity _entity,
                                       SceneGraphType &_graph);
 
+  /// \brief Add the models and lights of a scene diff to the cached scene,
+  /// or invalidate the cache if the diff can't be merged. Must be called
+  /// with graphMutex locked.
+  /// \param[in] _diff Scene message with the new entities
+  /// \param[in] _complete True if the diff contains all new entities, i.e.
+  /// they were all added under new top level models or lights.
+  public: void MergeIntoSceneCache(const msgs::Scene &_diff,
+                                   bool _complete);
+
+  /// \brief Remove top level models and lights from the cached scene, or
+  /// invalidate the cache if some of the entities aren't at the top level.
+  /// Must be called with graphMutex locked.
+  /// \param[in] _entities Removed entities
+  public: void RemoveFromSceneCache(const std::vector<Entity> &_entities);
+
+  /// \brief Get the cached scene for modification. It's copied first if
+  /// a service callback still holds it. Must be called with graphMutex
+  /// locked, and only while the cache is valid.
+  /// \return Cached scene
+  public: msgs::Scene &MutableSceneCache();
+
   /// \brief Create and send out pose updates.
   /// \param[in] _info The update information
   /// \param[in] _manager The entity component manager
@@ -169,6 +233,9 @@ class ignition::gazebo::systems::SceneBroadcasterPrivate
   /// \brief Transport node.
   public: std::unique_ptr<transport::Node> node{nullptr};
 
+  /// \brief Filtered state streams negotiated by subscribers.
+  public: std::unique_ptr<StateStreams> stateStreams{nullptr};
+
   /// \brief Pose publisher.
   public: transport::Node::Publisher posePub;
 
@@ -203,9 +270,16 @@ class ignition::gazebo::systems::SceneBroadcasterPrivate
   /// scene graphs
   public: std::string worldName;
 
-  /// \brief Protects scene graph.
+  /// \brief Protects scene graph and scene cache.
   public: std::mutex graphMutex;
 
+  /// \brief Scene message for the scene info service, built from the
+  /// scene graph the first time it's requested and then kept up to date
+  /// with the diffs published when entities are added or removed. Null
+  /// when it has to be rebuilt. Service callbacks keep a reference and copy
+  /// it without holding graphMutex.
+  public: std::shared_ptr<msgs::Scene> sceneCache;
+
   /// \brief Protects stepMsg.
   public: std::mutex stateMutex;
 
@@ -236,6 +310,64 @@ class ignition::gazebo::systems::SceneBroadcasterPrivate
 
   /// \brief A list of async state requests
   public: std::unordered_set<std::string> stateRequests;
+
+  /// \brief An update to the state snapshot.
+  public: struct SnapshotUpdate
+  {
+    /// \brief State message.
+    std::shared_ptr<const msgs::SerializedStepMap> msg;
+
+    /// \brief True if msg has the full state.
+    bool full{false};
+  };
+
+  /// \brief True once the state snapshot is maintained. This happens after
+  /// the first full state request, which is the only one served from the
+  /// simulation thread, until nobody has requested the state for
+  /// snapshotTimeout. Only accessed from the simulation thread.
+  public: bool snapshotActive{false};
+
+  /// \brief Time without requests after which the snapshot is dropped.
+  public: std::chrono::steady_clock::duration snapshotTimeout{5s};
+
+  /// \brief Time of the last full state request. Protected by
+  /// snapshotQueueMutex.
+  public: std::chrono::steady_clock::time_point lastSnapshotRequest;
+
+  /// \brief Types of the components with periodic changes since the last
+  /// snapshot update. Periodic changes are only serialized on some steps,
+  /// so the latest values of these types are sent with the next update.
+  /// Only accessed from the simulation thread.
+  public: std::unordered_set<ComponentTypeId> snapshotPeriodicTypes;
+
+  /// \brief Incremented when the snapshot is reset, so the snapshot thread
+  /// doesn't merge an update which was dropped. Protected by both
+  /// snapshotMutex and snapshotQueueMutex.
+  public: uint64_t snapshotGeneration{0};
+
+  /// \brief Full state, kept up to date in the background by merging the
+  /// state messages created on the simulation thread. Later requests are
+  /// served from it.
+  public: msgs::SerializedStepMap snapshot;
+
+  /// \brief Protects snapshot. Must be locked before snapshotQueueMutex
+  /// when both are needed.
+  public: std::mutex snapshotMutex;
+
+  /// \brief Updates not merged into the snapshot yet, oldest first.
+  public: std::deque<SnapshotUpdate> snapshotQueue;
+
+  /// \brief Protects snapshotQueue, snapshotStop and lastSnapshotRequest.
+  public: std::mutex snapshotQueueMutex;
+
+  /// \brief Signaled when updates are queued or the thread should stop.
+  public: std::condition_variable snapshotCv;
+
+  /// \brief True when the snapshot thread should stop.
+  public: bool snapshotStop{false};
+
+  /// \brief Thread merging updates into the snapshot.
+  public: std::thread snapshotThread;
 };
 
 //////////////////////////////////////////////////
@@ -334,15 +466,41 @@ void SceneBroadcaster::PostUpdate(const UpdateInfo &_info,
   auto shouldPublish = this->dataPtr->statePub.HasConnections() &&
        (changeEvent || itsPubTime);
 
-  if (this->dataPtr->stateServiceRequest || shouldPublish)
+  // The snapshot is only kept up to date while the state is being requested
+  if (this->dataPtr->snapshotActive)
+  {
+    std::unique_lock<std::mutex> lock(this->dataPtr->snapshotQueueMutex);
+    auto expired = std::chrono::steady_clock::now() -
+        this->dataPtr->lastSnapshotRequest > this->dataPtr->snapshotTimeout;
+    lock.unlock();
+    if (expired)
+      this->dataPtr->ResetSnapshot();
+  }
+
+  // Once there's a snapshot, the same messages are created for it even if
+  // nobody is subscribed
+  auto updateSnapshot = this->dataPtr->snapshotActive &&
+       (changeEvent || itsPubTime);
+
+  // Keep track of the periodic changes on the steps which aren't serialized
+  if (this->dataPtr->snapshotActive && !_info.paused)
+  {
+    auto periodicTypes = _manager.ComponentTypesWithPeriodicChanges();
+    this->dataPtr->snapshotPeriodicTypes.insert(periodicTypes.begin(),
+        periodicTypes.end());
+  }
+
+  if (this->dataPtr->stateServiceRequest || shouldPublish || updateSnapshot)
   {
     std::unique_lock<std::mutex> lock(this->dataPtr->stateMutex);
     this->dataPtr->stepMsg.Clear();
 
     set(this->dataPtr->stepMsg.mutable_stats(), _info);
 
+    const bool fullState = this->dataPtr->stateServiceRequest;
+
     // Publish full state if it has been explicitly requested
-    if (this->dataPtr->stateServiceRequest)
+    if (fullState)
     {
       _manager.State(*this->dataPtr->stepMsg.mutable_state(), {}, {}, true);
     }
@@ -384,9 +542,49 @@ void SceneBroadcaster::PostUpdate(const UpdateInfo &_info,
     {
       IGN_PROFILE("SceneBroadcast::PostUpdate Publish State");
       this->dataPtr->statePub.Publish(this->dataPtr->stepMsg);
+    }
+
+    if (shouldPublish || updateSnapshot)
       this->dataPtr->lastStatePubTime = now;
+
+    // The first full state seeds the snapshot, and all later messages are
+    // merged into it. Full states are copied because the state service may
+    // still be reading them, other messages are handed over.
+    if (fullState)
+    {
+      this->dataPtr->snapshotActive = true;
+      this->dataPtr->snapshotPeriodicTypes.clear();
+      this->dataPtr->QueueSnapshotUpdate(
+          std::make_shared<msgs::SerializedStepMap>(this->dataPtr->stepMsg),
+          true);
+    }
+    else if (updateSnapshot)
+    {
+      // The latest values of everything which changed periodically since
+      // the last update, including on the steps which weren't serialized
+      if (!this->dataPtr->snapshotPeriodicTypes.empty())
+      {
+        IGN_PROFILE("SceneBroadcast::PostUpdate SnapshotPeriodic");
+        auto msg = std::make_shared<msgs::SerializedStepMap>();
+        msg->mutable_stats()->CopyFrom(this->dataPtr->stepMsg.stats());
+        _manager.State(*msg->mutable_state(), {},
+            this->dataPtr->snapshotPeriodicTypes, true);
+        this->dataPtr->snapshotPeriodicTypes.clear();
+        this->dataPtr->QueueSnapshotUpdate(std::move(msg), false);
+      }
+
+      if (this->dataPtr->stepMsg.has_state())
+      {
+        auto msg = std::make_shared<msgs::SerializedStepMap>();
+        msg->Swap(&this->dataPtr->stepMsg);
+        this->dataPtr->QueueSnapshotUpdate(std::move(msg), false);
+      }
     }
   }
+
+  // Filtered streams have their own rates
+  if (this->dataPtr->stateStreams)
+    this->dataPtr->stateStreams->Update(_info, _manager);
 }
 
 //////////////////////////////////////////////////
@@ -399,6 +597,10 @@ void SceneBroadcasterPrivate::PoseUpdate(const UpdateInfo &_info,
   bool dyPoseConnections = this->dyPosePub.HasConnections();
   bool poseConnections = this->posePub.HasConnections();
 
+  // Nothing sleeps unless physics has sleeping enabled
+  const bool checkSleeping = dyPoseConnections &&
+      _manager.HasComponentType(components::Sleeping::typeId);
+
   // Models
   _manager.Each<components::Model, components::Name, components::Pose,
                 components::Static>(
@@ -416,7 +618,9 @@ void SceneBroadcasterPrivate::PoseUpdate(const UpdateInfo &_info,
           pose->set_id(_entity);
         }
 
-        if (dyPoseConnections && !_staticComp->Data())
+        // Sleeping models don't move
+        if (dyPoseConnections && !_staticComp->Data() &&
+            (!checkSleeping || !isSleeping(_entity, _manager)))
         {
           // Add to dynamic pose msg
           auto dyPose = dyPoseMsg.add_pose();
@@ -447,7 +651,8 @@ void SceneBroadcasterPrivate::PoseUpdate(const UpdateInfo &_info,
         // Check whether parent model is static
         auto staticComp = _manager.Component<components::Static>(
           _parentComp->Data());
-        if (dyPoseConnections && !staticComp->Data())
+        if (dyPoseConnections && !staticComp->Data() &&
+            (!checkSleeping || !isSleeping(_entity, _manager)))
         {
           // Add to dynamic pose msg
           auto dyPose = dyPoseMsg.add_pose();
@@ -584,6 +789,12 @@ void SceneBroadcasterPrivate::SetupTransport(const std::string &_worldName)
   ignmsg << "Publishing state changes on [" << stateTopic << "]"
       << std::endl;
 
+  // Filtered state streams
+  auto stateRate = 1.0 / std::chrono::duration<double>(
+      this->statePublishPeriod[false]).count();
+  this->stateStreams = std::make_unique<StateStreams>(*this->node, ns,
+      stateRate);
+
   // Pose info publisher
   std::string poseTopic{"pose/info"};
 
@@ -610,17 +821,27 @@ void SceneBroadcasterPrivate::SetupTransport(const std::string &_worldName)
 //////////////////////////////////////////////////
 bool SceneBroadcasterPrivate::SceneInfoService(ignition::msgs::Scene &_res)
 {
-  std::lock_guard<std::mutex> lock(this->graphMutex);
+  std::shared_ptr<const msgs::Scene> scene;
+  {
+    std::lock_guard<std::mutex> lock(this->graphMutex);
 
-  _res.Clear();
+    if (!this->sceneCache)
+    {
+      IGN_PROFILE("SceneBroadcasterPrivate::SceneInfoService Rebuild");
+      this->sceneCache = std::make_shared<msgs::Scene>();
 
-  // Populate scene message
+      // Populate scene message
 
-  // Add models
-  AddModels(&_res, this->worldEntity, this->sceneGraph);
+      // Add models
+      AddModels(this->sceneCache.get(), this->worldEntity, this->sceneGraph);
 
-  // Add lights
-  AddLights(&_res, this->worldEntity, this->sceneGraph);
+      // Add lights
+      AddLights(this->sceneCache.get(), this->worldEntity, this->sceneGraph);
+    }
+    scene = this->sceneCache;
+  }
+
+  _res.CopyFrom(*scene);
 
   return true;
 }
@@ -629,6 +850,14 @@ bool SceneBroadcasterPrivate::SceneInfoService(ignition::msgs::Scene &_res)
 void SceneBroadcasterPrivate::StateAsyncService(
     const ignition::msgs::StringMsg &_req)
 {
+  // Reply from the snapshot without involving the simulation thread
+  msgs::SerializedStepMap res;
+  if (this->SnapshotState(res))
+  {
+    this->node->Request(_req.data(), res);
+    return;
+  }
+
   std::unique_lock<std::mutex> lock(this->stateMutex);
   this->stateServiceRequest = true;
   this->stateRequests.insert(_req.data());
@@ -640,6 +869,10 @@ bool SceneBroadcasterPrivate::StateService(
 {
   _res.Clear();
 
+  // Reply from the snapshot without involving the simulation thread
+  if (this->SnapshotState(_res))
+    return true;
+
   // Lock and wait for an iteration to be run and fill the state
   std::unique_lock<std::mutex> lock(this->stateMutex);
 
@@ -657,6 +890,135 @@ bool SceneBroadcasterPrivate::StateService(
   return success;
 }
 
+//////////////////////////////////////////////////
+SceneBroadcasterPrivate::~SceneBroadcasterPrivate()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->snapshotQueueMutex);
+    this->snapshotStop = true;
+  }
+  this->snapshotCv.notify_all();
+  if (this->snapshotThread.joinable())
+    this->snapshotThread.join();
+}
+
+//////////////////////////////////////////////////
+void SceneBroadcasterPrivate::QueueSnapshotUpdate(
+    std::shared_ptr<const msgs::SerializedStepMap> _msg, bool _full)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->snapshotQueueMutex);
+    this->snapshotQueue.push_back({std::move(_msg), _full});
+  }
+  this->snapshotCv.notify_one();
+
+  if (!this->snapshotThread.joinable())
+  {
+    this->snapshotThread =
+        std::thread(&SceneBroadcasterPrivate::SnapshotThread, this);
+  }
+}
+
+//////////////////////////////////////////////////
+bool SceneBroadcasterPrivate::SnapshotState(msgs::SerializedStepMap &_msg)
+{
+  std::vector<SnapshotUpdate> tail;
+  {
+    std::lock_guard<std::mutex> lock(this->snapshotMutex);
+    {
+      std::lock_guard<std::mutex> queueLock(this->snapshotQueueMutex);
+      this->lastSnapshotRequest = std::chrono::steady_clock::now();
+      if (this->snapshot.has_state() == false && this->snapshotQueue.empty())
+        return false;
+      tail.assign(this->snapshotQueue.begin(), this->snapshotQueue.end());
+    }
+    _msg.CopyFrom(this->snapshot);
+  }
+
+  // Apply the updates which the snapshot thread hasn't merged yet
+  for (const auto &update : tail)
+    MergeState(_msg, *update.msg, update.full);
+
+  return true;
+}
+
+//////////////////////////////////////////////////
+void SceneBroadcasterPrivate::SnapshotThread()
+{
+  IGN_PROFILE_THREAD_NAME("SceneBroadcaster snapshot");
+  while (true)
+  {
+    SnapshotUpdate update;
+    uint64_t generation;
+    {
+      std::unique_lock<std::mutex> lock(this->snapshotQueueMutex);
+      this->snapshotCv.wait(lock, [this]
+          {
+            return this->snapshotStop || !this->snapshotQueue.empty();
+          });
+      if (this->snapshotStop)
+        return;
+      update = this->snapshotQueue.front();
+      generation = this->snapshotGeneration;
+    }
+
+    // Merge and dequeue atomically, so readers never apply an update twice
+    std::lock_guard<std::mutex> lock(this->snapshotMutex);
+    if (generation != this->snapshotGeneration)
+      continue;
+    MergeState(this->snapshot, *update.msg, update.full);
+    std::lock_guard<std::mutex> queueLock(this->snapshotQueueMutex);
+    this->snapshotQueue.pop_front();
+  }
+}
+
+//////////////////////////////////////////////////
+void SceneBroadcasterPrivate::ResetSnapshot()
+{
+  this->snapshotActive = false;
+  this->snapshotPeriodicTypes.clear();
+
+  std::lock_guard<std::mutex> lock(this->snapshotMutex);
+  std::lock_guard<std::mutex> queueLock(this->snapshotQueueMutex);
+  this->snapshot.Clear();
+  this->snapshotQueue.clear();
+  ++this->snapshotGeneration;
+}
+
+//////////////////////////////////////////////////
+void SceneBroadcasterPrivate::MergeState(msgs::SerializedStepMap &_state,
+    const msgs::SerializedStepMap &_update, bool _full)
+{
+  if (_full)
+  {
+    _state.CopyFrom(_update);
+    return;
+  }
+
+  _state.mutable_stats()->CopyFrom(_update.stats());
+
+  auto &entities = *_state.mutable_state()->mutable_entities();
+  for (const auto &[id, entityMsg] : _update.state().entities())
+  {
+    if (entityMsg.remove())
+    {
+      entities.erase(id);
+      continue;
+    }
+
+    auto &stateEntity = entities[id];
+    stateEntity.set_id(entityMsg.id());
+    auto &components = *stateEntity.mutable_components();
+    for (const auto &[type, compMsg] : entityMsg.components())
+    {
+      if (compMsg.remove())
+        components.erase(type);
+      else
+        components[type] = compMsg;
+    }
+  }
+}
+
 //////////////////////////////////////////////////
 bool SceneBroadcasterPrivate::SceneGraphService(ignition::msgs::StringMsg &_res)
 {
@@ -686,6 +1048,10 @@ void SceneBroadcasterPrivate::SceneGraphAddEntities(
   auto worldVertex = this->sceneGraph.VertexFromId(this->worldEntity);
   newGraph.AddVertex(worldVertex.Name(), worldVertex.Data(), worldVertex.Id());
 
+  // Edges from parent to new entity. They're added once all the new vertices
+  // are in the graph, because children may be visited before their parents.
+  std::vector<std::pair<Entity, Entity>> newEdges;
+
   // Worlds: check this in case we're loading a world without models
   _manager.EachNew<components::World>(
       [&](const Entity &, const components::World *) -> bool
@@ -709,7 +1075,7 @@ void SceneBroadcasterPrivate::SceneGraphAddEntities(
 
         // Add to graph
         newGraph.AddVertex(_nameComp->Data(), modelMsg, _entity);
-        newGraph.AddEdge({_parentComp->Data(), _entity}, true);
+        newEdges.emplace_back(_parentComp->Data(), _entity);
 
         newEntity = true;
         return true;
@@ -730,7 +1096,7 @@ void SceneBroadcasterPrivate::SceneGraphAddEntities(
 
         // Add to graph
         newGraph.AddVertex(_nameComp->Data(), linkMsg, _entity);
-        newGraph.AddEdge({_parentComp->Data(), _entity}, true);
+        newEdges.emplace_back(_parentComp->Data(), _entity);
 
         newEntity = true;
         return true;
@@ -772,7 +1138,7 @@ void SceneBroadcasterPrivate::SceneGraphAddEntities(
 
         // Add to graph
         newGraph.AddVertex(_nameComp->Data(), visualMsg, _entity);
-        newGraph.AddEdge({_parentComp->Data(), _entity}, true);
+        newEdges.emplace_back(_parentComp->Data(), _entity);
 
         newEntity = true;
         return true;
@@ -795,7 +1161,7 @@ void SceneBroadcasterPrivate::SceneGraphAddEntities(
 
         // Add to graph
         newGraph.AddVertex(_nameComp->Data(), lightMsg, _entity);
-        newGraph.AddEdge({_parentComp->Data(), _entity}, true);
+        newEdges.emplace_back(_parentComp->Data(), _entity);
         newEntity = true;
         return true;
       });
@@ -979,11 +1345,34 @@ void SceneBroadcasterPrivate::SceneGraphAddEntities(
 
         // Add to graph
         newGraph.AddVertex(_nameComp->Data(), sensorMsg, _entity);
-        newGraph.AddEdge({_parentComp->Data(), _entity}, true);
+        newEdges.emplace_back(_parentComp->Data(), _entity);
         newEntity = true;
         return true;
       });
 
+  if (!newEntity)
+    return;
+
+  // The diff only has the new entities which are reachable from the world
+  // through other new entities. Entities added under existing ones, which
+  // are only in the cached graph, aren't in it, and require the cached scene
+  // to be rebuilt.
+  bool completeDiff{true};
+  for (const auto &[parent, child] : newEdges)
+  {
+    if (newGraph.VertexFromId(parent).Valid())
+      newGraph.AddEdge({parent, child}, true);
+    else
+      completeDiff = false;
+  }
+
+  msgs::Scene sceneMsg;
+
+  AddModels(&sceneMsg, this->worldEntity, newGraph);
+
+  // Add lights
+  AddLights(&sceneMsg, this->worldEntity, newGraph);
+
   // Update the whole scene graph from the new graph
   {
     std::lock_guard<std::mutex> lock(this->graphMutex);
@@ -993,32 +1382,82 @@ void SceneBroadcasterPrivate::SceneGraphAddEntities(
       if (!this->sceneGraph.VertexFromId(id).Valid())
         this->sceneGraph.AddVertex(vert.get().Name(), vert.get().Data(), id);
     }
-    for (const auto &[id, edge] : newGraph.Edges())
+    for (const auto &[parent, child] : newEdges)
     {
-      // Add the edge only if it's not already in the graph
-      if (!this->sceneGraph.EdgeFromVertices(edge.get().Vertices().first,
-            edge.get().Vertices().second).Valid())
-      {
-        this->sceneGraph.AddEdge(edge.get().Vertices(), edge.get().Data());
-      }
+      // Add the edge only if it's not already in the graph. Edges to
+      // existing parents are only in newEdges.
+      if (!this->sceneGraph.EdgeFromVertices(parent, child).Valid())
+        this->sceneGraph.AddEdge({parent, child}, true);
     }
+
+    this->MergeIntoSceneCache(sceneMsg, completeDiff);
   }
 
-  if (newEntity)
-  {
-    // Only offer scene services once the message has been populated at least
-    // once
-    if (!this->node)
-      this->SetupTransport(this->worldName);
+  // Only offer scene services once the message has been populated at least
+  // once
+  if (!this->node)
+    this->SetupTransport(this->worldName);
 
-    msgs::Scene sceneMsg;
+  this->scenePub.Publish(sceneMsg);
+}
 
-    AddModels(&sceneMsg, this->worldEntity, newGraph);
+//////////////////////////////////////////////////
+void SceneBroadcasterPrivate::MergeIntoSceneCache(const msgs::Scene &_diff,
+    bool _complete)
+{
+  if (!this->sceneCache)
+    return;
 
-    // Add lights
-    AddLights(&sceneMsg, this->worldEntity, newGraph);
-    this->scenePub.Publish(sceneMsg);
+  if (!_complete)
+  {
+    this->sceneCache.reset();
+    return;
   }
+
+  auto &scene = this->MutableSceneCache();
+  for (const auto &model : _diff.model())
+    scene.add_model()->CopyFrom(model);
+  for (const auto &light : _diff.light())
+    scene.add_light()->CopyFrom(light);
+}
+
+//////////////////////////////////////////////////
+void SceneBroadcasterPrivate::RemoveFromSceneCache(
+    const std::vector<Entity> &_entities)
+{
+  if (!this->sceneCache || _entities.empty())
+    return;
+
+  std::unordered_set<Entity> removed(_entities.begin(), _entities.end());
+  std::size_t found{0};
+
+  auto eraseRemoved = [&](auto *_field)
+  {
+    auto it = std::remove_if(_field->begin(), _field->end(),
+        [&](const auto &_msg)
+        {
+          return removed.find(_msg.id()) != removed.end();
+        });
+    found += std::distance(it, _field->end());
+    _field->erase(it, _field->end());
+  };
+  auto &scene = this->MutableSceneCache();
+  eraseRemoved(scene.mutable_model());
+  eraseRemoved(scene.mutable_light());
+
+  // Nested models and lights are inside other messages
+  if (found != removed.size())
+    this->sceneCache.reset();
+}
+
+//////////////////////////////////////////////////
+msgs::Scene &SceneBroadcasterPrivate::MutableSceneCache()
+{
+  // References are only taken with graphMutex locked, so a count of 1 can't
+  // go up while the cache is modified
+  if (this->sceneCache.use_count() > 1)
+    this->sceneCache = std::make_shared<msgs::Scene>(*this->sceneCache);
+  return *this->sceneCache;
 }
 
 //////////////////////////////////////////////////
@@ -1053,6 +1492,8 @@ void SceneBroadcasterPrivate::SceneGraphRemoveEntities(
         return true;
       });
 
+  this->RemoveFromSceneCache(removedEntities);
+
   if (!removedEntities.empty())
   {
     // Send the list of deleted entities
@@ -0,0 +1,384 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "StateStreams.hh"
+
+#include <utility>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Profiler.hh>
+#include <ignition/common/StringUtils.hh>
+#include <ignition/math/Helpers.hh>
+
+#include "ignition/gazebo/components/Factory.hh"
+#include "ignition/gazebo/Conversions.hh"
+#include "ignition/gazebo/Util.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+
+/// \brief How long a stream is kept without subscribers.
+static const std::chrono::seconds kStreamExpiry{10};
+
+//////////////////////////////////////////////////
+StateStreams::StateStreams(transport::Node &_node, const std::string &_ns,
+    double _defaultRate)
+  : node(_node), ns(_ns), defaultRate(_defaultRate)
+{
+  std::string subscribeService{"state/subscribe"};
+
+  this->node.Advertise(subscribeService, &StateStreams::SubscribeService,
+      this);
+
+  ignmsg << "Serving filtered state subscriptions on [" << this->ns << "/"
+         << subscribeService << "]" << std::endl;
+}
+
+//////////////////////////////////////////////////
+bool StateStreams::SubscribeService(const msgs::Param &_req,
+    msgs::StringMsg &_res)
+{
+  StateStreamOptions options;
+  if (!this->ParseOptions(_req, options))
+    return false;
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+
+  // Subscribers with the same options share a stream
+  auto now = std::chrono::steady_clock::now();
+  for (auto &stream : this->streams)
+  {
+    const auto &other = stream->options;
+    if (math::equal(other.rate, options.rate) &&
+        other.entityPattern == options.entityPattern &&
+        other.entityComponent == options.entityComponent &&
+        other.components == options.components)
+    {
+      stream->lastUsedTime = now;
+      _res.set_data(stream->topic);
+      return true;
+    }
+  }
+
+  auto topic = this->ns + "/state/stream/" +
+      std::to_string(this->nextStreamId);
+
+  auto stream = std::make_unique<Stream>();
+  stream->pub = this->node.Advertise<msgs::SerializedStepMap>(topic);
+  if (!stream->pub.Valid())
+  {
+    ignerr << "Failed to advertise filtered state on [" << topic << "]"
+           << std::endl;
+    return false;
+  }
+  stream->period = std::chrono::duration<double>(1.0 / options.rate);
+  stream->options = std::move(options);
+  stream->topic = topic;
+  stream->lastUsedTime = now;
+  this->streams.push_back(std::move(stream));
+  ++this->nextStreamId;
+
+  igndbg << "Publishing filtered state on [" << topic << "]" << std::endl;
+
+  _res.set_data(topic);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool StateStreams::ParseOptions(const msgs::Param &_req,
+    StateStreamOptions &_options) const
+{
+  _options.rate = this->defaultRate;
+  for (const auto &[key, value] : _req.params())
+  {
+    if (key == "rate")
+    {
+      if (value.type() == msgs::Any::DOUBLE)
+        _options.rate = value.double_value();
+      else if (value.type() == msgs::Any::INT32)
+        _options.rate = value.int_value();
+      else
+      {
+        ignerr << "Parameter [rate] must be a number." << std::endl;
+        return false;
+      }
+
+      if (_options.rate <= 0.0)
+      {
+        ignerr << "Parameter [rate] must be positive, got ["
+               << _options.rate << "]." << std::endl;
+        return false;
+      }
+    }
+    else if (key == "entity_pattern")
+    {
+      _options.entityPattern = value.string_value();
+    }
+    else if (key == "entity_component")
+    {
+      _options.entityComponent = ComponentType(value.string_value());
+      if (_options.entityComponent == kComponentTypeIdInvalid)
+      {
+        ignerr << "Unknown component [" << value.string_value()
+               << "] in parameter [entity_component]." << std::endl;
+        return false;
+      }
+    }
+    else if (key == "components")
+    {
+      for (const auto &name : common::split(value.string_value(), ","))
+      {
+        auto trimmed = common::trimmed(name);
+        if (trimmed.empty())
+          continue;
+
+        auto type = ComponentType(trimmed);
+        if (type == kComponentTypeIdInvalid)
+        {
+          ignerr << "Unknown component [" << trimmed
+                 << "] in parameter [components]." << std::endl;
+          return false;
+        }
+        _options.components.insert(type);
+      }
+    }
+    else
+    {
+      ignwarn << "Ignoring unknown state subscription parameter [" << key
+              << "]." << std::endl;
+    }
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+void StateStreams::Update(const UpdateInfo &_info,
+    const EntityComponentManager &_ecm)
+{
+  std::lock_guard<std::mutex> lock(this->mutex);
+  if (this->streams.empty())
+    return;
+
+  auto now = std::chrono::steady_clock::now();
+  std::vector<Stream *> due;
+  for (auto it = this->streams.begin(); it != this->streams.end();)
+  {
+    auto &stream = *it;
+    if (!stream->pub.HasConnections())
+    {
+      // Give new subscribers time to connect before removing the stream
+      if (now - stream->lastUsedTime > kStreamExpiry)
+      {
+        igndbg << "Removing unused filtered state stream [" << stream->topic
+               << "]" << std::endl;
+        it = this->streams.erase(it);
+      }
+      else
+      {
+        ++it;
+      }
+      continue;
+    }
+
+    stream->lastUsedTime = now;
+    if (now - stream->lastPubTime >= stream->period)
+      due.push_back(stream.get());
+    ++it;
+  }
+
+  if (due.empty())
+    return;
+
+  IGN_PROFILE("StateStreams::Update");
+
+  // Serialize the union of what the due streams need, once
+  bool allEntities{false};
+  bool allComponents{false};
+  std::unordered_set<Entity> entities;
+  std::unordered_set<ComponentTypeId> types;
+  for (auto *stream : due)
+  {
+    UpdateEntities(*stream, _ecm);
+
+    // Streams without entity filters never compute their entities
+    if (!stream->entitiesValid)
+      allEntities = true;
+    else
+      entities.insert(stream->entities.begin(), stream->entities.end());
+
+    if (stream->options.components.empty())
+      allComponents = true;
+    else
+      types.insert(stream->options.components.begin(),
+          stream->options.components.end());
+  }
+
+  this->sharedState.Clear();
+  if (allEntities || !entities.empty())
+  {
+    IGN_PROFILE("StateStreams::Update Serialize");
+    _ecm.State(this->sharedState,
+        allEntities ? std::unordered_set<Entity>() : entities,
+        allComponents ? std::unordered_set<ComponentTypeId>() : types, true);
+  }
+
+  // Each stream copies its share of the serialized state
+  for (auto *stream : due)
+  {
+    auto &msg = stream->msg;
+    msg.Clear();
+    set(msg.mutable_stats(), _info);
+
+    const auto &components = stream->options.components;
+    auto &msgEntities = *msg.mutable_state()->mutable_entities();
+    for (const auto &[id, entityMsg] : this->sharedState.entities())
+    {
+      if (stream->entitiesValid && stream->entities.find(id) ==
+          stream->entities.end())
+      {
+        continue;
+      }
+
+      if (components.empty())
+      {
+        msgEntities[id] = entityMsg;
+        continue;
+      }
+
+      // Entities without any of the requested components are left out
+      msgs::SerializedEntityMap *msgEntity{nullptr};
+      for (const auto &[type, compMsg] : entityMsg.components())
+      {
+        if (components.find(static_cast<ComponentTypeId>(type)) ==
+            components.end())
+        {
+          continue;
+        }
+
+        if (nullptr == msgEntity)
+        {
+          msgEntity = &msgEntities[id];
+          msgEntity->set_id(entityMsg.id());
+        }
+        (*msgEntity->mutable_components())[type] = compMsg;
+      }
+    }
+
+    stream->pub.Publish(msg);
+    stream->lastPubTime = now;
+  }
+}
+
+//////////////////////////////////////////////////
+void StateStreams::UpdateEntities(Stream &_stream,
+    const EntityComponentManager &_ecm)
+{
+  const auto &options = _stream.options;
+
+  // Streams without entity filters take all the serialized entities
+  if (options.entityPattern.empty() &&
+      options.entityComponent == kComponentTypeIdInvalid)
+  {
+    return;
+  }
+
+  if (_stream.entitiesValid &&
+      _stream.entitiesVersion == _ecm.StructureVersion())
+  {
+    return;
+  }
+
+  _stream.entities.clear();
+  for (const auto &vertex : _ecm.Entities().Vertices())
+  {
+    Entity entity = vertex.first;
+    if (options.entityComponent != kComponentTypeIdInvalid &&
+        !_ecm.EntityHasComponentType(entity, options.entityComponent))
+    {
+      continue;
+    }
+
+    if (!options.entityPattern.empty() &&
+        !MatchPattern(options.entityPattern,
+            scopedName(entity, _ecm, "::", false)))
+    {
+      continue;
+    }
+
+    _stream.entities.insert(entity);
+  }
+
+  _stream.entitiesVersion = _ecm.StructureVersion();
+  _stream.entitiesValid = true;
+}
+
+//////////////////////////////////////////////////
+bool StateStreams::MatchPattern(const std::string &_pattern,
+    const std::string &_name)
+{
+  // Greedy wildcard matching, backtracking to the last `*`
+  std::size_t p{0};
+  std::size_t n{0};
+  std::size_t star{std::string::npos};
+  std::size_t starMatch{0};
+  while (n < _name.size())
+  {
+    if (p < _pattern.size() &&
+        (_pattern[p] == '?' || _pattern[p] == _name[n]))
+    {
+      ++p;
+      ++n;
+    }
+    else if (p < _pattern.size() && _pattern[p] == '*')
+    {
+      star = p++;
+      starMatch = n;
+    }
+    else if (star != std::string::npos)
+    {
+      p = star + 1;
+      n = ++starMatch;
+    }
+    else
+    {
+      return false;
+    }
+  }
+
+  while (p < _pattern.size() && _pattern[p] == '*')
+    ++p;
+
+  return p == _pattern.size();
+}
+
+//////////////////////////////////////////////////
+ComponentTypeId StateStreams::ComponentType(const std::string &_name)
+{
+  auto factory = components::Factory::Instance();
+  for (auto type : factory->TypeIds())
+  {
+    auto name = factory->Name(type);
+    if (name == _name)
+      return type;
+
+    auto period = name.rfind('.');
+    if (period != std::string::npos && name.substr(period + 1) == _name)
+      return type;
+  }
+  return kComponentTypeIdInvalid;
+}
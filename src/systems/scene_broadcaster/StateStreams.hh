@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_SYSTEMS_SCENEBROADCASTER_STATESTREAMS_HH_
+#define IGNITION_GAZEBO_SYSTEMS_SCENEBROADCASTER_STATESTREAMS_HH_
+
+#include <ignition/msgs/param.pb.h>
+#include <ignition/msgs/serialized_map.pb.h>
+#include <ignition/msgs/stringmsg.pb.h>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <ignition/transport/Node.hh>
+
+#include "ignition/gazebo/config.hh"
+#include "ignition/gazebo/EntityComponentManager.hh"
+#include "ignition/gazebo/Types.hh"
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems
+{
+  /// \brief Options requested by a state subscriber.
+  struct StateStreamOptions
+  {
+    /// \brief Publish rate in Hz.
+    double rate{0.0};
+
+    /// \brief Pattern matched against the entities' scoped names, i.e.
+    /// `world::model::link`. Supports the `*` and `?` wildcards. Empty
+    /// matches all entities.
+    std::string entityPattern;
+
+    /// \brief Only entities which have this component are streamed.
+    ComponentTypeId entityComponent{kComponentTypeIdInvalid};
+
+    /// \brief Components to stream. Empty streams all components.
+    std::set<ComponentTypeId> components;
+  };
+
+  /// \brief Filtered state streams, with a rate, entities and components
+  /// negotiated by each subscriber through a service.
+  ///
+  /// Subscribers call the `<ns>/state/subscribe` service with an
+  /// ignition::msgs::Param holding any of these parameters:
+  ///
+  /// * `rate`: Publish rate in Hz. Defaults to the state topic's rate.
+  /// * `entity_pattern`: Scoped name pattern, such as `world::box*`.
+  /// * `entity_component`: Name of a component which the entities must have.
+  /// * `components`: Comma-separated names of the components to stream.
+  ///
+  /// Component names are the ones registered with the component factory,
+  /// like `ign_gazebo_components.Pose`, or just the part after the last
+  /// period, like `Pose`. The response holds the topic to subscribe to.
+  /// Subscribers asking for the same options share a topic. A stream which
+  /// has had no subscribers for a while is removed, and asking for its
+  /// options again negotiates a new topic.
+  ///
+  /// Each message holds the full state of the stream's entities and
+  /// components. All the streams due on a step are filled from a single
+  /// serialization of the ECM.
+  class StateStreams
+  {
+    /// \brief Constructor. Advertises the subscribe service.
+    /// \param[in] _node Node used to advertise the service and the streams.
+    /// \param[in] _ns World namespace, such as `/world/default`.
+    /// \param[in] _defaultRate Rate used when the subscriber doesn't request
+    /// one.
+    public: StateStreams(transport::Node &_node, const std::string &_ns,
+                         double _defaultRate);
+
+    /// \brief Publish the streams which are due.
+    /// \param[in] _info Update info.
+    /// \param[in] _ecm Entity component manager.
+    public: void Update(const UpdateInfo &_info,
+                        const EntityComponentManager &_ecm);
+
+    /// \brief Callback for the subscribe service.
+    /// \param[in] _req Requested options.
+    /// \param[out] _res Topic of the stream.
+    /// \return False if the options are invalid.
+    public: bool SubscribeService(const msgs::Param &_req,
+                                  msgs::StringMsg &_res);
+
+    /// \brief Parse the options of a subscribe request.
+    /// \param[in] _req Request.
+    /// \param[out] _options Parsed options.
+    /// \return False if the request has invalid options.
+    public: bool ParseOptions(const msgs::Param &_req,
+                              StateStreamOptions &_options) const;
+
+    /// \brief Check if a name matches a pattern with `*` and `?` wildcards.
+    /// \param[in] _pattern Pattern.
+    /// \param[in] _name Name.
+    /// \return True if the whole name matches.
+    public: static bool MatchPattern(const std::string &_pattern,
+                                     const std::string &_name);
+
+    /// \brief Find a component type by name.
+    /// \param[in] _name Full or short name of the component.
+    /// \return Type ID, or kComponentTypeIdInvalid if not found.
+    public: static ComponentTypeId ComponentType(const std::string &_name);
+
+    /// \brief A negotiated stream.
+    private: struct Stream
+    {
+      /// \brief Options.
+      StateStreamOptions options;
+
+      /// \brief Topic.
+      std::string topic;
+
+      /// \brief Publisher.
+      transport::Node::Publisher pub;
+
+      /// \brief Publish period.
+      std::chrono::duration<double> period;
+
+      /// \brief Last time the stream was published.
+      std::chrono::steady_clock::time_point lastPubTime;
+
+      /// \brief Last time the stream was negotiated or had subscribers.
+      std::chrono::steady_clock::time_point lastUsedTime;
+
+      /// \brief Entities matching the options.
+      std::unordered_set<Entity> entities;
+
+      /// \brief ECM structure version of the entities.
+      uint64_t entitiesVersion{0};
+
+      /// \brief True if entities has been computed.
+      bool entitiesValid{false};
+
+      /// \brief Reused message.
+      msgs::SerializedStepMap msg;
+    };
+
+    /// \brief Recompute the entities of a stream.
+    /// \param[in] _stream Stream.
+    /// \param[in] _ecm Entity component manager.
+    private: static void UpdateEntities(Stream &_stream,
+                                        const EntityComponentManager &_ecm);
+
+    /// \brief Node used to advertise the streams.
+    private: transport::Node &node;
+
+    /// \brief World namespace.
+    private: std::string ns;
+
+    /// \brief Rate used when the subscriber doesn't request one.
+    private: double defaultRate;
+
+    /// \brief Protects streams.
+    private: std::mutex mutex;
+
+    /// \brief All negotiated streams which are still in use.
+    private: std::vector<std::unique_ptr<Stream>> streams;
+
+    /// \brief Number used in the topic of the next stream. Topics of
+    /// removed streams aren't reused.
+    private: uint64_t nextStreamId{0};
+
+    /// \brief Serialized state shared by the streams due on a step.
+    private: msgs::SerializedStateMap sharedState;
+  };
+}
+}
+}
+}
+#endif
@@ -29,6 +29,7 @@
 #include <sdf/Element.hh>
 
 #include "ignition/gazebo/components/ContactSensor.hh"
+#include "ignition/gazebo/components/ContactSensorBuffer.hh"
 #include "ignition/gazebo/components/ContactSensorData.hh"
 #include "ignition/gazebo/components/Collision.hh"
 #include "ignition/gazebo/components/Link.hh"
@@ -138,8 +139,8 @@ void TouchPluginPrivate::Load(const EntityComponentManager &_ecm,
   this->AddTargetEntities(_ecm, potentialEntities);
 
   // Create a list of collision entities that have been marked as contact
-  // sensors in this model. These are collisions that have a ContactSensorData
-  // component
+  // sensors in this model. These are collisions that have a
+  // ContactSensorData or a ContactSensorBuffer component
   auto allLinks =
       _ecm.ChildrenByComponents(this->model.Entity(), components::Link());
 
@@ -150,7 +151,9 @@ void TouchPluginPrivate::Load(const EntityComponentManager &_ecm,
     for (const Entity colEntity : linkCollisions)
     {
       if (_ecm.EntityHasComponentType(colEntity,
-                                      components::ContactSensorData::typeId))
+              components::ContactSensorData::typeId) ||
+          _ecm.EntityHasComponentType(colEntity,
+              components::ContactSensorBuffer::typeId))
       {
         this->collisionEntities.push_back(colEntity);
       }
@@ -258,21 +261,37 @@ void TouchPluginPrivate::Update(const UpdateInfo &_info,
   // between the target entity and this model
   for (const Entity colEntity : this->collisionEntities)
   {
+    // Check if the contacts include one of the target entities.
+    auto isTarget = [this](const Entity _col1, const Entity _col2)
+    {
+      return std::binary_search(this->targetEntities.begin(),
+              this->targetEntities.end(), _col1) ||
+          std::binary_search(this->targetEntities.begin(),
+              this->targetEntities.end(), _col2);
+    };
+
+    auto *buffer = _ecm.Component<components::ContactSensorBuffer>(colEntity);
+    if (buffer)
+    {
+      for (const auto &pair : buffer->Data().pairs)
+      {
+        if (isTarget(pair.collision1, pair.collision2))
+        {
+          touching = true;
+          break;
+        }
+      }
+    }
+
     auto *contacts = _ecm.Component<components::ContactSensorData>(colEntity);
     if (contacts)
     {
-      // Check if the contacts include one of the target entities.
       for (const auto &contact : contacts->Data().contact())
       {
-        bool col1Target = std::binary_search(this->targetEntities.begin(),
-            this->targetEntities.end(),
-            contact.collision1().id());
-        bool col2Target = std::binary_search(this->targetEntities.begin(),
-            this->targetEntities.end(),
-            contact.collision2().id());
-        if (col1Target || col2Target)
+        if (isTarget(contact.collision1().id(), contact.collision2().id()))
         {
           touching = true;
+          break;
         }
       }
     }
@@ -0,0 +1,493 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "InputMatcher.hh"
+
+#include <google/protobuf/message.h>
+#include <google/protobuf/text_format.h>
+
+#include <cmath>
+#include <limits>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Util.hh>
+#include <ignition/msgs/Factory.hh>
+
+// bug https://github.com/protocolbuffers/protobuf/issues/5051
+#ifdef _WIN32
+#undef GetMessage
+#endif
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+
+/// \brief Compare two floats the same way as DefaultFieldComparator does in
+/// APPROXIMATE mode with a fraction of DBL_MIN.
+/// \param[in] _a First value
+/// \param[in] _b Second value
+/// \param[in] _tol Margin
+/// \return True if the values are equal within the margin.
+template <typename T>
+static bool AlmostEqual(T _a, T _b, T _tol)
+{
+  if (_a == _b)
+    return true;
+  if (!std::isfinite(_a) || !std::isfinite(_b))
+    return false;
+  return std::abs(_a - _b) <= _tol;
+}
+
+//////////////////////////////////////////////////
+InputMatcher::InputMatcher(const std::string &_msgType)
+    : matchMsg(msgs::Factory::New(_msgType))
+{
+  this->comparator.set_float_comparison(
+      google::protobuf::util::DefaultFieldComparator::APPROXIMATE);
+
+  this->diff.set_field_comparator(&this->comparator);
+}
+
+//////////////////////////////////////////////////
+bool InputMatcher::Match(const transport::ProtoMsg &_input) const
+{
+  if (!this->CheckTypeMatch(*this->matchMsg, _input))
+  {
+    return false;
+  }
+  return this->DoMatch(_input);
+}
+
+//////////////////////////////////////////////////
+void InputMatcher::SetTolerance(double _tol)
+{
+  this->tol = _tol;
+  this->comparator.SetDefaultFractionAndMargin(
+      std::numeric_limits<double>::min(), _tol);
+}
+
+//////////////////////////////////////////////////
+bool InputMatcher::CheckTypeMatch(const transport::ProtoMsg &_matcher,
+                                  const transport::ProtoMsg &_input)
+{
+  const auto *matcherDesc = _matcher.GetDescriptor();
+  const auto *inputDesc = _input.GetDescriptor();
+  if (matcherDesc != inputDesc)
+  {
+    ignerr << "Received message has a different type than configured in "
+           << "<input>. Expected [" << matcherDesc->full_name() << "] got ["
+           << inputDesc->full_name() << "]\n";
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool InputMatcher::IsScalar(const google::protobuf::FieldDescriptor *_field)
+{
+  return !_field->is_repeated() &&
+         _field->cpp_type() !=
+             google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE &&
+         nullptr == _field->containing_oneof() &&
+         _field->file()->syntax() ==
+             google::protobuf::FileDescriptor::SYNTAX_PROTO3;
+}
+
+//////////////////////////////////////////////////
+ScalarComparison InputMatcher::MakeScalarComparison(
+    const transport::ProtoMsg &_matcher,
+    const google::protobuf::FieldDescriptor *_field)
+{
+  using google::protobuf::FieldDescriptor;
+
+  ScalarComparison comparison;
+  comparison.field = _field;
+
+  const auto *refl = _matcher.GetReflection();
+  switch (_field->cpp_type())
+  {
+    case FieldDescriptor::CPPTYPE_INT32:
+      comparison.intValue = refl->GetInt32(_matcher, _field);
+      break;
+    case FieldDescriptor::CPPTYPE_INT64:
+      comparison.intValue = refl->GetInt64(_matcher, _field);
+      break;
+    case FieldDescriptor::CPPTYPE_ENUM:
+      comparison.intValue = refl->GetEnumValue(_matcher, _field);
+      break;
+    case FieldDescriptor::CPPTYPE_UINT32:
+      comparison.uintValue = refl->GetUInt32(_matcher, _field);
+      break;
+    case FieldDescriptor::CPPTYPE_UINT64:
+      comparison.uintValue = refl->GetUInt64(_matcher, _field);
+      break;
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      comparison.doubleValue = refl->GetFloat(_matcher, _field);
+      break;
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      comparison.doubleValue = refl->GetDouble(_matcher, _field);
+      break;
+    case FieldDescriptor::CPPTYPE_BOOL:
+      comparison.boolValue = refl->GetBool(_matcher, _field);
+      break;
+    case FieldDescriptor::CPPTYPE_STRING:
+      comparison.stringValue = refl->GetString(_matcher, _field);
+      break;
+    default:
+      break;
+  }
+  return comparison;
+}
+
+//////////////////////////////////////////////////
+bool InputMatcher::CompareScalar(const ScalarComparison &_comparison,
+                                 const transport::ProtoMsg &_input) const
+{
+  using google::protobuf::FieldDescriptor;
+
+  const auto *field = _comparison.field;
+  const auto *refl = _input.GetReflection();
+  switch (field->cpp_type())
+  {
+    case FieldDescriptor::CPPTYPE_INT32:
+      return refl->GetInt32(_input, field) == _comparison.intValue;
+    case FieldDescriptor::CPPTYPE_INT64:
+      return refl->GetInt64(_input, field) == _comparison.intValue;
+    case FieldDescriptor::CPPTYPE_ENUM:
+      return refl->GetEnumValue(_input, field) == _comparison.intValue;
+    case FieldDescriptor::CPPTYPE_UINT32:
+      return refl->GetUInt32(_input, field) == _comparison.uintValue;
+    case FieldDescriptor::CPPTYPE_UINT64:
+      return refl->GetUInt64(_input, field) == _comparison.uintValue;
+    case FieldDescriptor::CPPTYPE_FLOAT:
+      return AlmostEqual(refl->GetFloat(_input, field),
+          static_cast<float>(_comparison.doubleValue),
+          static_cast<float>(this->tol));
+    case FieldDescriptor::CPPTYPE_DOUBLE:
+      return AlmostEqual(refl->GetDouble(_input, field),
+          _comparison.doubleValue, this->tol);
+    case FieldDescriptor::CPPTYPE_BOOL:
+      return refl->GetBool(_input, field) == _comparison.boolValue;
+    case FieldDescriptor::CPPTYPE_STRING:
+    {
+      std::string scratch;
+      return refl->GetStringReference(_input, field, &scratch) ==
+             _comparison.stringValue;
+    }
+    default:
+      return false;
+  }
+}
+
+//////////////////////////////////////////////////
+AnyMatcher::AnyMatcher(const std::string &_msgType) : InputMatcher(_msgType)
+{
+  this->valid = (nullptr == this->matchMsg || !this->matchMsg->IsInitialized());
+}
+
+//////////////////////////////////////////////////
+bool AnyMatcher::DoMatch(const transport::ProtoMsg &) const
+{
+  return true;
+}
+
+//////////////////////////////////////////////////
+FullMatcher::FullMatcher(const std::string &_msgType, bool _logicType,
+                         const std::string &_matchString)
+    : InputMatcher(_msgType), logicType(_logicType)
+{
+  if (nullptr == this->matchMsg || !this->matchMsg->IsInitialized())
+    return;
+
+  this->valid = google::protobuf::TextFormat::ParseFromString(
+      _matchString, this->matchMsg.get());
+  if (!this->valid)
+    return;
+
+  const auto *desc = this->matchMsg->GetDescriptor();
+  for (int i = 0; i < desc->field_count(); ++i)
+  {
+    const auto *field = desc->field(i);
+    if (IsScalar(field))
+      this->scalars.push_back(MakeScalarComparison(*this->matchMsg, field));
+    else
+      this->otherFields.push_back(field);
+  }
+}
+
+//////////////////////////////////////////////////
+bool FullMatcher::DoMatch(const transport::ProtoMsg &_input) const
+{
+  const auto *inputRefl = _input.GetReflection();
+
+  // Unknown fields are only handled by the full comparison
+  if (!inputRefl->GetUnknownFields(_input).empty())
+    return this->logicType == this->diff.Compare(*this->matchMsg, _input);
+
+  for (const auto &scalar : this->scalars)
+  {
+    if (!this->CompareScalar(scalar, _input))
+      return !this->logicType;
+  }
+
+  const auto *matcherRefl = this->matchMsg->GetReflection();
+  for (const auto *field : this->otherFields)
+  {
+    // Fields which are empty in both messages are equal
+    bool set{false};
+    if (field->is_repeated())
+    {
+      set = matcherRefl->FieldSize(*this->matchMsg, field) > 0 ||
+            inputRefl->FieldSize(_input, field) > 0;
+    }
+    else
+    {
+      set = matcherRefl->HasField(*this->matchMsg, field) ||
+            inputRefl->HasField(_input, field);
+    }
+
+    if (set && !this->diff.CompareWithFields(*this->matchMsg, _input,
+                                             {field}, {field}))
+    {
+      return !this->logicType;
+    }
+  }
+
+  return this->logicType;
+}
+
+//////////////////////////////////////////////////
+FieldMatcher::FieldMatcher(const std::string &_msgType, bool _logicType,
+                           const std::string &_fieldName,
+                           const std::string &_fieldString)
+    : InputMatcher(_msgType),
+      logicType(_logicType),
+      fieldName(_fieldName)
+{
+  if (nullptr == this->matchMsg || !this->matchMsg->IsInitialized())
+    return;
+
+  transport::ProtoMsg *matcherSubMsg{nullptr};
+  if (!FindFieldSubMessage(this->matchMsg.get(), _fieldName,
+                          this->fieldDescMatcher, &matcherSubMsg))
+  {
+    return;
+  }
+
+  if (this->fieldDescMatcher.empty())
+  {
+    return;
+  }
+  else if (this->fieldDescMatcher.back()->is_repeated())
+  {
+    this->diff.set_scope(google::protobuf::util::MessageDifferencer::PARTIAL);
+    this->diff.set_repeated_field_comparison(
+        google::protobuf::util::MessageDifferencer::AS_SET);
+  }
+
+  if (nullptr == matcherSubMsg)
+    return;
+
+  bool result = google::protobuf::TextFormat::ParseFieldValueFromString(
+      _fieldString, this->fieldDescMatcher.back(), matcherSubMsg);
+  if (!result)
+  {
+    ignerr << "Failed to parse matcher string [" << _fieldString
+           << "] for field [" << this->fieldName << "] of input message type ["
+           << _msgType << "]\n";
+    return;
+  }
+
+  if (IsScalar(this->fieldDescMatcher.back()))
+  {
+    this->isScalar = true;
+    this->scalar =
+        MakeScalarComparison(*matcherSubMsg, this->fieldDescMatcher.back());
+  }
+
+  this->valid = true;
+}
+
+//////////////////////////////////////////////////
+bool FieldMatcher::FindFieldSubMessage(
+    transport::ProtoMsg *_msg, const std::string &_fieldName,
+    std::vector<const google::protobuf::FieldDescriptor *> &_fieldDesc,
+    transport::ProtoMsg **_subMsg)
+{
+  const google::protobuf::Descriptor *fieldMsgType = _msg->GetDescriptor();
+
+  // If fieldMsgType is nullptr, then this is not a composite message and we
+  // shouldn't be using a FieldMatcher
+  if (nullptr == fieldMsgType)
+  {
+    ignerr << "FieldMatcher with field name [" << _fieldName
+           << "] cannot be used because the input message type ["
+           << fieldMsgType->full_name() << "] does not have any fields\n";
+    return false;
+  }
+
+  *_subMsg = _msg;
+
+  auto fieldNames = common::split(_fieldName, ".");
+  if (fieldNames.empty())
+  {
+    ignerr << "Empty field attribute for input message type ["
+           << fieldMsgType->full_name() << "]\n";
+    return false;
+  }
+
+  for (std::size_t i = 0; i < fieldNames.size(); ++i)
+  {
+    auto fieldDesc = fieldMsgType->FindFieldByName(fieldNames[i]);
+
+    if (nullptr == fieldDesc)
+    {
+      ignerr << "Field name [" << fieldNames[i]
+             << "] could not be found in message type ["
+             << fieldMsgType->full_name() << "].\n";
+      return false;
+    }
+
+    _fieldDesc.push_back(fieldDesc);
+
+    if (i < fieldNames.size() - 1)
+    {
+      if (google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE !=
+          fieldDesc->cpp_type())
+      {
+        ignerr << "Subfield [" << fieldNames[i+1]
+          << "] could not be found in Submessage type ["
+          << fieldDesc->full_name() << "].\n";
+        return false;
+      }
+
+      auto *reflection = (*_subMsg)->GetReflection();
+      if (fieldDesc->is_repeated())
+      {
+        ignerr
+            << "Field matcher for field name [" << _fieldName
+            << "] could not be created because the field [" << fieldDesc->name()
+            << "] is a repeated message type. Matching subfields of repeated "
+            << "messages is not supported.\n";
+        return false;
+      }
+      else
+      {
+        *_subMsg = reflection->MutableMessage(*_subMsg, fieldDesc);
+      }
+
+      // Update fieldMsgType for next iteration
+      fieldMsgType = fieldDesc->message_type();
+    }
+  }
+
+  return true;
+}
+
+
+//////////////////////////////////////////////////
+bool FieldMatcher::DoMatch(
+    const transport::ProtoMsg &_input) const
+{
+  const transport::ProtoMsg *subMsgMatcher = this->matchMsg.get();
+  const transport::ProtoMsg *subMsgInput = &_input;
+  for (std::size_t i = 0; i < this->fieldDescMatcher.size() - 1; ++i)
+  {
+    auto *fieldDesc = this->fieldDescMatcher[i];
+    if (fieldDesc->is_repeated())
+    {
+      // This should not happen since the matching subfields of repeated fields
+      // is not allowed and this matcher shouldn't have been created.
+      ignerr << "Matching subfields of repeated messages is not supported\n";
+    }
+    else
+    {
+      if (!this->isScalar)
+      {
+        subMsgMatcher =
+            &subMsgMatcher->GetReflection()->GetMessage(*subMsgMatcher,
+                                                        fieldDesc);
+      }
+      subMsgInput =
+          &subMsgInput->GetReflection()->GetMessage(*subMsgInput, fieldDesc);
+    }
+  }
+
+  if (this->isScalar)
+    return this->logicType == this->CompareScalar(this->scalar, *subMsgInput);
+
+  return this->logicType ==
+         this->diff.CompareWithFields(*subMsgMatcher, *subMsgInput,
+                                      {this->fieldDescMatcher.back()},
+                                      {this->fieldDescMatcher.back()});
+}
+
+//////////////////////////////////////////////////
+bool InputMatcher::IsValid() const
+{
+  return this->valid;
+}
+
+//////////////////////////////////////////////////
+std::unique_ptr<InputMatcher> InputMatcher::Create(
+    const std::string &_msgType, const sdf::ElementPtr &_matchElem)
+{
+  if (nullptr == _matchElem)
+  {
+    return std::make_unique<AnyMatcher>(_msgType);
+  }
+
+  std::unique_ptr<InputMatcher> matcher{nullptr};
+
+  const auto logicTypeStr =
+      _matchElem->Get<std::string>("logic_type", "positive").first;
+  if (logicTypeStr != "positive" && logicTypeStr != "negative")
+  {
+    ignerr << "Unrecognized logic_type attribute [" << logicTypeStr
+           << "] in matcher for input message type [" << _msgType << "]\n";
+    return nullptr;
+  }
+
+  const bool logicType = logicTypeStr == "positive";
+
+  auto inputMatchString = common::trimmed(_matchElem->Get<std::string>());
+  if (!inputMatchString.empty())
+  {
+    if (_matchElem->HasAttribute("field"))
+    {
+      const auto fieldName = _matchElem->Get<std::string>("field");
+      matcher = std::make_unique<FieldMatcher>(_msgType, logicType, fieldName,
+                                               inputMatchString);
+    }
+    else
+    {
+      matcher =
+          std::make_unique<FullMatcher>(_msgType, logicType, inputMatchString);
+    }
+    if (matcher == nullptr || !matcher->IsValid())
+    {
+      ignerr << "Matcher for input type [" << _msgType
+             << "] could not be created from:\n"
+             << inputMatchString << std::endl;
+      return nullptr;
+    }
+
+    const auto tol = _matchElem->Get<double>("tol", 1e-8).first;
+    matcher->SetTolerance(tol);
+  }
+  return matcher;
+}
@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_SYSTEMS_TRIGGEREDPUBLISHER_INPUTMATCHER_HH_
+#define IGNITION_GAZEBO_SYSTEMS_TRIGGEREDPUBLISHER_INPUTMATCHER_HH_
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/util/field_comparator.h>
+#include <google/protobuf/util/message_differencer.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sdf/Element.hh>
+#include <ignition/transport/Node.hh>
+#include "ignition/gazebo/config.hh"
+
+namespace ignition
+{
+namespace gazebo
+{
+// Inline bracket to help doxygen filtering.
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems
+{
+  /// \brief Expected value of a singular scalar field, extracted from the
+  /// matcher message when the matcher is created so that input messages can
+  /// be compared without going through MessageDifferencer.
+  struct ScalarComparison
+  {
+    /// \brief Field being compared.
+    const google::protobuf::FieldDescriptor *field{nullptr};
+
+    /// \brief Expected value of signed integer and enum fields.
+    int64_t intValue{0};
+
+    /// \brief Expected value of unsigned integer fields.
+    uint64_t uintValue{0};
+
+    /// \brief Expected value of float and double fields.
+    double doubleValue{0.0};
+
+    /// \brief Expected value of bool fields.
+    bool boolValue{false};
+
+    /// \brief Expected value of string and bytes fields.
+    std::string stringValue;
+  };
+
+  /// \brief Base class for input matchers.
+  class InputMatcher
+  {
+    /// \brief Constructor
+    /// \param[in] _msgType Input message type
+    public: InputMatcher(const std::string &_msgType);
+
+    /// \brief Destructor
+    public: virtual ~InputMatcher() = default;
+
+    /// \brief Match input message against the match criteria.
+    /// \param[in] _input Input message
+    /// \return True if the input matches the match criteria.
+    public: bool Match(const transport::ProtoMsg &_input) const;
+
+    /// \brief Match input message against the match criteria. Subclasses
+    /// should override this
+    /// \param[in] _input Input message
+    /// \return True if the input matches the match criteria.
+    public: virtual bool DoMatch(const transport::ProtoMsg &_input) const = 0;
+
+    /// \brief Checks if the matcher is in a valid state.
+    /// \return True if the matcher is in a valid state.
+    public: virtual bool IsValid() const;
+
+    /// \brief Set the float comparison tolerance
+    /// \param[in] _tol Tolerance for float comparisons
+    public: void SetTolerance(double _tol);
+
+    /// \brief Helper function that checks if two messages have the same type
+    /// \input[in] _matcher Matcher message
+    /// \input[in] _input Input message
+    /// \return True if the two message types match
+    public: static bool CheckTypeMatch(const transport::ProtoMsg &_matcher,
+                                       const transport::ProtoMsg &_input);
+
+    /// \brief Factory function for creating matchers.
+    /// \param[in] _msgType Input message type (eg. ignition.msgs.Boolean)
+    /// \param[in] _matchElem the SDFormat Element that contains the
+    /// configuration for the matcher
+    /// \return A concrete InputMatcher initialized according to the contents
+    /// of _matchElem. A nullptr is returned if the created InputMatcher is
+    /// invalid.
+    public: static std::unique_ptr<InputMatcher> Create(
+                const std::string &_msgType,
+                const sdf::ElementPtr &_matchElem);
+
+    /// \brief Check if a field can be compared with CompareScalar. These are
+    /// the singular, non-message fields of proto3 messages which aren't part
+    /// of a oneof, whose value is always defined.
+    /// \param[in] _field Field descriptor
+    /// \return True if the field can be compared with CompareScalar.
+    protected: static bool IsScalar(
+                   const google::protobuf::FieldDescriptor *_field);
+
+    /// \brief Extract the expected value of a scalar field.
+    /// \param[in] _matcher Message holding the expected value
+    /// \param[in] _field Field descriptor, for which IsScalar is true
+    /// \return The comparison.
+    protected: static ScalarComparison MakeScalarComparison(
+                   const transport::ProtoMsg &_matcher,
+                   const google::protobuf::FieldDescriptor *_field);
+
+    /// \brief Compare a scalar field of the input against its expected value.
+    /// Floats are equal if they differ by at most the tolerance, like in
+    /// the field comparator.
+    /// \param[in] _comparison Comparison created by MakeScalarComparison
+    /// \param[in] _input Message containing the field
+    /// \return True if the values are equal.
+    protected: bool CompareScalar(const ScalarComparison &_comparison,
+                                  const transport::ProtoMsg &_input) const;
+
+    /// \brief Protobuf message for matching against input
+    protected: std::unique_ptr<transport::ProtoMsg> matchMsg;
+
+    /// \brief State of the matcher
+    protected: bool valid{false};
+
+    /// \brief Tolerance for float comparisons
+    protected: double tol{1e-8};
+
+    /// \brief Field comparator used by MessageDifferencer. This is where
+    /// tolerance for float comparisons is set
+    protected: google::protobuf::util::DefaultFieldComparator comparator;
+
+    /// \brief MessageDifferencer used for comparing input to matcher. This is
+    /// mutable because MessageDifferencer::CompareWithFields is not a const
+    /// function
+    protected: mutable google::protobuf::util::MessageDifferencer diff;
+  };
+
+  //////////////////////////////////////////////////
+  /// \brief Matches any input message of the specified type
+  class AnyMatcher : public InputMatcher
+  {
+    /// \brief Constructor
+    /// \param[in] _msgType Input message type
+    public: explicit AnyMatcher(const std::string &_msgType);
+
+    // Documentation inherited
+    public: bool DoMatch(const transport::ProtoMsg &_input) const override;
+  };
+
+  //////////////////////////////////////////////////
+  /// \brief Matches the whole input message against the match criteria.
+  /// Floats are compared using MathUtil::AlmostEquals()
+  ///
+  /// The top level fields of the message are sorted when the matcher is
+  /// created. Scalar fields are compared directly against their expected
+  /// values, and only the remaining fields which are set in either message go
+  /// through MessageDifferencer.
+  class FullMatcher : public InputMatcher
+  {
+    /// \brief Constructor
+    /// \param[in] _msgType Input message type
+    /// \param[in] _logicType Determines what the returned value of Match()
+    /// would be on a successful comparison. If this is false, a successful
+    /// match would return false.
+    /// \param[in] _matchString String used to construct the protobuf message
+    /// against which input messages are matched. This is the human-readable
+    /// representation of a protobuf message as used by `ign topic` for
+    /// publishing messages
+    public: FullMatcher(const std::string &_msgType, bool _logicType,
+                        const std::string &_matchString);
+
+    // Documentation inherited
+    public: bool DoMatch(const transport::ProtoMsg &_input) const override;
+
+    /// \brief Logic type of this matcher
+    protected: const bool logicType;
+
+    /// \brief Comparisons of the scalar fields
+    protected: std::vector<ScalarComparison> scalars;
+
+    /// \brief Fields which are compared with MessageDifferencer
+    protected: std::vector<const google::protobuf::FieldDescriptor *>
+                   otherFields;
+  };
+
+  //////////////////////////////////////////////////
+  /// \brief Matches a specific field in the input message against the match
+  /// criteria. Floats are compared using MathUtil::AlmostEquals()
+  ///
+  /// The field path is resolved into descriptors when the matcher is
+  /// created. If the field is a scalar, its expected value is cached and the
+  /// input is compared without MessageDifferencer.
+  class FieldMatcher : public InputMatcher
+  {
+    /// \brief Constructor
+    /// \param[in] _msgType Input message type
+    /// \param[in] _logicType Determines what the returned value of Match()
+    /// would be on a successful comparison. If this is false, a successful
+    /// match would return false.
+    /// \param[in] _fieldName Name of the field to compare
+    /// \param[in] _fieldString String used to construct the protobuf message
+    /// against which the specified field in the input messages are matched.
+    /// This is the human-readable representation of a protobuf message as
+    /// used by `ign topic` for publishing messages
+    public: FieldMatcher(const std::string &_msgType, bool _logicType,
+                         const std::string &_fieldName,
+                         const std::string &_fieldString);
+
+    // Documentation inherited
+    public: bool DoMatch(const transport::ProtoMsg &_input) const override;
+
+    /// \brief Helper function to find a subfield inside the message based on
+    /// the given field name.
+    /// \param[in] _msg The message containing the subfield
+    /// \param[in] _fieldName Field name inside the message. Each period ('.')
+    /// character is used to indicate a subfield.
+    /// \param[out] _fieldDesc Field descriptors found while traversing the
+    /// message to find the field
+    /// \param[out] _subMsg Submessage of the field that corresponds to the
+    /// field name
+    protected: static bool FindFieldSubMessage(
+                   transport::ProtoMsg *_msg, const std::string &_fieldName,
+                   std::vector<const google::protobuf::FieldDescriptor *>
+                       &_fieldDesc,
+                   transport::ProtoMsg **_subMsg);
+
+    /// \brief Logic type of this matcher
+    protected: const bool logicType;
+
+    /// \brief Name of the field compared by this matcher
+    protected: const std::string fieldName;
+
+    /// \brief Field descriptor of the field compared by this matcher
+    protected: std::vector<const google::protobuf::FieldDescriptor *>
+                   fieldDescMatcher;
+
+    /// \brief True if the compared field is a scalar
+    protected: bool isScalar{false};
+
+    /// \brief Comparison of the field, if it's a scalar
+    protected: ScalarComparison scalar;
+  };
+}
+}
+}
+}
+
+#endif
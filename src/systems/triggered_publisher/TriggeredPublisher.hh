@@ -17,11 +17,15 @@
 #ifndef IGNITION_GAZEBO_SYSTEMS_TRIGGEREDPUBLISHER_HH_
 #define IGNITION_GAZEBO_SYSTEMS_TRIGGEREDPUBLISHER_HH_
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include <ignition/transport/Node.hh>
+#include "ignition/gazebo/PublishExecutor.hh"
 #include "ignition/gazebo/System.hh"
 
 namespace ignition
@@ -179,7 +183,8 @@ namespace systems
                 const ignition::gazebo::UpdateInfo &_info,
                 ignition::gazebo::EntityComponentManager &_ecm) override;
 
-    /// \brief Thread that handles publishing output messages
+    /// \brief Publish the pending output messages. This runs on the
+    /// shared PublishExecutor.
     public: void DoWork();
 
     /// \brief Helper function that calls Match on every InputMatcher available
@@ -210,39 +215,61 @@ namespace systems
       transport::Node::Publisher pub;
     };
 
-    /// \brief List of InputMatchers
-    private: std::vector<std::unique_ptr<InputMatcher>> matchers;
+    /// \brief Data used by the input callback and by the publish tasks.
+    /// These may still be running while the system is destroyed, so they
+    /// only hold weak pointers to it.
+    private: struct State : public std::enable_shared_from_this<State>
+    {
+      /// \brief Calls Match on every InputMatcher.
+      /// \param[in] _inputMsg Input message
+      /// \return True if all of the matchers return true
+      bool MatchInput(const transport::ProtoMsg &_inputMsg);
 
-    /// \brief List of outputs
-    private: std::vector<OutputInfo> outputInfo;
+      /// \brief Add publications and schedule them on the executor.
+      /// \param[in] _count Number of times to publish the outputs.
+      void SchedulePublish(std::size_t _count);
 
-    /// \brief Ignition communication node.
-    private: transport::Node node;
+      /// \brief Publish the pending output messages.
+      void DoWork();
+
+      /// \brief List of InputMatchers
+      std::vector<std::unique_ptr<InputMatcher>> matchers;
+
+      /// \brief List of outputs
+      std::vector<OutputInfo> outputInfo;
 
-    /// \brief Counter that tells the publisher how many times to publish
-    private: std::size_t publishCount{0};
+      /// \brief Counter that tells the publisher how many times to publish
+      std::size_t publishCount{0};
 
-    /// \brief Mutex to synchronize access to publishCount
-    private: std::mutex publishCountMutex;
+      /// \brief Mutex to synchronize access to publishCount
+      std::mutex publishCountMutex;
 
-    /// \brief Condition variable to signal that new matches have occured
-    private: std::condition_variable newMatchSignal;
+      /// \brief Executor the publications run on. Only the system holds a
+      /// strong reference to it, so it's never destroyed by its own tasks.
+      std::weak_ptr<PublishExecutor> executor;
 
-    /// \brief Thread handle for worker thread
-    private: std::thread workerThread;
+      /// \brief Key used to coalesce this system's PublishExecutor tasks, so
+      /// at most one of them is queued at a time.
+      uint64_t publishKey{0};
 
-    /// \brief Flag for when the system is done and the worker thread should
-    /// stop
-    private: std::atomic<bool> done{false};
+      /// \brief Publish delay time. This is in simulation time.
+      std::chrono::steady_clock::duration delay{0};
 
-    /// \brief Publish delay time. This is in simulation time.
-    private: std::chrono::steady_clock::duration delay{0};
+      /// \brief Queue of publication times.
+      std::vector<std::chrono::steady_clock::duration> publishQueue;
+
+      /// \brief Mutex to synchronize access to publishQueue
+      std::mutex publishQueueMutex;
+    };
+
+    /// \brief Ignition communication node.
+    private: transport::Node node;
 
-    /// \brief Queue of publication times.
-    private: std::vector<std::chrono::steady_clock::duration> publishQueue;
+    /// \brief Executor the publications run on.
+    private: std::shared_ptr<PublishExecutor> executor;
 
-    /// \brief Mutex to synchronize access to publishQueue
-    private: std::mutex publishQueueMutex;
+    /// \brief Data shared with the callbacks.
+    private: std::shared_ptr<State> state{std::make_shared<State>()};
   };
   }
 }
@@ -21,6 +21,7 @@
 #include <ignition/msgs/boolean.pb.h>
 #include <ignition/msgs/entity_factory.pb.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -35,7 +36,9 @@
 
 #include "ignition/gazebo/EntityComponentManager.hh"
 #include "ignition/gazebo/SdfEntityCreator.hh"
+#include "ignition/gazebo/Util.hh"
 
+#include "ignition/gazebo/components/ExternalWorldWrenchCmd.hh"
 #include "ignition/gazebo/components/Inertial.hh"
 #include "ignition/gazebo/components/Light.hh"
 #include "ignition/gazebo/components/LinearVelocity.hh"
@@ -49,6 +52,8 @@
 
 #include "ignition/gazebo/Link.hh"
 
+#include "WindField.hh"
+
 using namespace ignition;
 using namespace gazebo;
 using namespace systems;
@@ -73,6 +78,11 @@ class ignition::gazebo::systems::WindEffectsPrivate
   public: void UpdateWindVelocity(const UpdateInfo &_info,
                                   EntityComponentManager &_ecm);
 
+  /// \brief Rebuild the list of links affected by wind if the structure of
+  /// the ECM changed since it was last built.
+  /// \param[in] _ecm Immutable reference to the EntityComponentManager.
+  public: void UpdateWindLinks(const EntityComponentManager &_ecm);
+
   /// \brief Calculate and apply forces on links affected by wind.
   /// \param[in] _info Simulation update info.
   /// \param[in] _ecm Mutable reference to the EntityComponentManager.
@@ -161,6 +171,49 @@ class ignition::gazebo::systems::WindEffectsPrivate
   /// \brief Current wind velocity seed and global enable/disable state.
   /// This is set by a transport message.
   public: msgs::Wind currentWindInfo;
+
+  /// \brief Spatially varying wind, added to the uniform wind velocity.
+  /// Null if no field was configured.
+  public: std::unique_ptr<wind_effects::WindField> windField;
+
+  /// \brief Links affected by wind, stored as parallel arrays so that forces
+  /// for all of them are computed in a single pass without component lookups.
+  public: struct WindLinks
+  {
+    /// \brief Link entities.
+    std::vector<Entity> entities;
+
+    /// \brief Inertial components.
+    std::vector<const components::Inertial *> inertials;
+
+    /// \brief World pose components.
+    std::vector<const components::WorldPose *> poses;
+
+    /// \brief World linear velocity components.
+    std::vector<const components::WorldLinearVelocity *> velocities;
+
+    /// \brief Wrench components, null until created.
+    std::vector<components::ExternalWorldWrenchCmd *> wrenches;
+
+    /// \brief Scratch: center of mass offsets in the world frame.
+    std::vector<math::Vector3d> comOffsets;
+
+    /// \brief Scratch: center of mass positions in the world frame.
+    std::vector<math::Vector3d> positions;
+
+    /// \brief Scratch: wind velocity at each center of mass.
+    std::vector<math::Vector3d> windVelocities;
+  };
+
+  /// \brief Links affected by wind.
+  public: WindLinks windLinks;
+
+  /// \brief ECM structure version windLinks was built for.
+  /// \sa EntityComponentManager::StructureVersion
+  public: uint64_t windLinksVersion{0};
+
+  /// \brief Whether windLinks has been built.
+  public: bool windLinksValid{false};
 };
 
 /////////////////////////////////////////////////
@@ -285,6 +338,23 @@ void WindEffectsPrivate::Load(EntityComponentManager &_ecm,
     this->forceApproximationScalingFactor = sdfForceApprox->Get<double>();
   }
 
+  if (_sdf->HasElement("field"))
+  {
+    auto sdfField = _sdf->GetElementImpl("field");
+
+    auto uri = sdfField->Get<std::string>("uri", "").first;
+    if (uri.empty())
+    {
+      ignerr << "Please set <field><uri> to the wind field file" << std::endl;
+      return;
+    }
+
+    this->windField = std::make_unique<wind_effects::WindField>();
+    this->windField->SetLoop(sdfField->Get<bool>("loop", true).first);
+    if (!this->windField->Load(asFullPath(uri, _sdf->FilePath())))
+      return;
+  }
+
   // If the forceApproximationScalingFactor is very small don't update.
   // It doesn't make sense to be negative, that would be negative wind drag.
   if (std::fabs(this->forceApproximationScalingFactor) < 1e-6)
@@ -400,24 +470,29 @@ void WindEffectsPrivate::UpdateWindVelocity(const UpdateInfo &_info,
 }
 
 //////////////////////////////////////////////////
-void WindEffectsPrivate::ApplyWindForce(const UpdateInfo &,
-                                        EntityComponentManager &_ecm)
+void WindEffectsPrivate::UpdateWindLinks(const EntityComponentManager &_ecm)
 {
-  IGN_PROFILE("WindEffectsPrivate::ApplyWindForce");
-  auto windVel =
-      _ecm.Component<components::WorldLinearVelocity>(this->windEntity);
-  if (!windVel)
+  if (this->windLinksValid &&
+      this->windLinksVersion == _ecm.StructureVersion())
+  {
     return;
+  }
 
-  Link link;
+  auto &links = this->windLinks;
+  links.entities.clear();
+  links.inertials.clear();
+  links.poses.clear();
+  links.velocities.clear();
+  links.wrenches.clear();
 
   _ecm.Each<components::Link, components::Inertial, components::WindMode,
-            components::WorldLinearVelocity>(
+            components::WorldLinearVelocity, components::WorldPose>(
       [&](const Entity &_entity,
-          components::Link *,
-          components::Inertial *_inertial,
-          components::WindMode *_windMode,
-          components::WorldLinearVelocity *_linkVel) -> bool
+          const components::Link *,
+          const components::Inertial *_inertial,
+          const components::WindMode *_windMode,
+          const components::WorldLinearVelocity *_linkVel,
+          const components::WorldPose *_worldPose) -> bool
       {
         // Skip links for which the wind is disabled
         if (!_windMode->Data())
@@ -425,17 +500,81 @@ void WindEffectsPrivate::ApplyWindForce(const UpdateInfo &,
           return true;
         }
 
-        link.ResetEntity(_entity);
+        links.entities.push_back(_entity);
+        links.inertials.push_back(_inertial);
+        links.poses.push_back(_worldPose);
+        links.velocities.push_back(_linkVel);
+        links.wrenches.push_back(
+            _ecm.Component<components::ExternalWorldWrenchCmd>(_entity));
+        return true;
+      });
 
-        math::Vector3d windForce = _inertial->Data().MassMatrix().Mass() *
-                                   this->forceApproximationScalingFactor *
-                                   (windVel->Data() - _linkVel->Data());
+  this->windLinksVersion = _ecm.StructureVersion();
+  this->windLinksValid = true;
+}
 
-        // Apply force at center of mass
-        link.AddWorldForce(_ecm, windForce);
+//////////////////////////////////////////////////
+void WindEffectsPrivate::ApplyWindForce(const UpdateInfo &_info,
+                                        EntityComponentManager &_ecm)
+{
+  IGN_PROFILE("WindEffectsPrivate::ApplyWindForce");
+  auto windVel =
+      _ecm.Component<components::WorldLinearVelocity>(this->windEntity);
+  if (!windVel)
+    return;
 
-        return true;
-      });
+  this->UpdateWindLinks(_ecm);
+  auto &links = this->windLinks;
+  const auto count = links.entities.size();
+
+  // Gather centers of mass. Forces are applied at the center of mass, but
+  // ExternalWorldWrenchCmd applies them at the link origin, so the offset is
+  // needed to compute the resulting torque.
+  links.comOffsets.resize(count);
+  links.positions.resize(count);
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const auto &pose = links.poses[i]->Data();
+    links.comOffsets[i] =
+        pose.Rot().RotateVector(links.inertials[i]->Data().Pose().Pos());
+    links.positions[i] = pose.Pos() + links.comOffsets[i];
+  }
+
+  // Sample the wind at all centers of mass at once
+  links.windVelocities.assign(count, windVel->Data());
+  if (this->windField)
+  {
+    this->windField->AddSamples(links.positions,
+        std::chrono::duration<double>(_info.simTime).count(),
+        links.windVelocities);
+  }
+
+  // Compute and apply forces
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const math::Vector3d windForce =
+        links.inertials[i]->Data().MassMatrix().Mass() *
+        this->forceApproximationScalingFactor *
+        (links.windVelocities[i] - links.velocities[i]->Data());
+    const math::Vector3d torque = links.comOffsets[i].Cross(windForce);
+
+    auto *wrenchComp = links.wrenches[i];
+    if (!wrenchComp)
+    {
+      // The new component changes the ECM structure, so the links will be
+      // rebuilt with a pointer to it on the next update
+      components::ExternalWorldWrenchCmd wrench;
+      msgs::Set(wrench.Data().mutable_force(), windForce);
+      msgs::Set(wrench.Data().mutable_torque(), torque);
+      _ecm.CreateComponent(links.entities[i], wrench);
+      continue;
+    }
+
+    msgs::Set(wrenchComp->Data().mutable_force(),
+              msgs::Convert(wrenchComp->Data().force()) + windForce);
+    msgs::Set(wrenchComp->Data().mutable_torque(),
+              msgs::Convert(wrenchComp->Data().torque()) + torque);
+  }
 }
 
 
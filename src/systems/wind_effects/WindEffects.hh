@@ -33,9 +33,9 @@ namespace systems
   class WindEffectsPrivate;
 
   /// \brief A system that simulates a simple wind model.
-  /// The wind is described as a uniform worldwide model. So it is independent
-  /// from model position for simple computations. Its components are computed
-  /// separately:
+  /// The wind is described as a uniform worldwide model, optionally combined
+  /// with a gridded wind field that depends on position. The uniform
+  /// components are computed separately:
   /// - Horizontal amplitude:
   ///      Low pass filtering on user input (complementary gain)
   ///      + small local fluctuations
@@ -86,6 +86,16 @@ namespace systems
   /// - `<vertical><noise>`
   /// Parameters for the noise that is added to the vertical wind velocity
   /// magnitude.
+  ///
+  /// - `<field><uri>`
+  /// Optional gridded wind field file, which adds a spatially varying, and
+  /// optionally time varying, velocity to the uniform wind described above.
+  /// The field is memory-mapped and trilinearly interpolated at the center
+  /// of mass of each link. See wind_effects::WindField for the file format.
+  ///
+  /// - `<field><loop>`
+  /// Whether a time varying field loops back to its first sample after its
+  /// last one. Otherwise the last sample is held. Defaults to true.
   class WindEffects:
     public System,
     public ISystemConfigure,
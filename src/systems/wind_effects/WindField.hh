@@ -0,0 +1,424 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_GAZEBO_SYSTEMS_WIND_EFFECTS_WINDFIELD_HH_
+#define IGNITION_GAZEBO_SYSTEMS_WIND_EFFECTS_WINDFIELD_HH_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+#include <ignition/common/Console.hh>
+#include <ignition/math/Vector3.hh>
+
+#include "ignition/gazebo/config.hh"
+
+namespace ignition::gazebo
+{
+inline namespace IGNITION_GAZEBO_VERSION_NAMESPACE {
+namespace systems::wind_effects
+{
+  /// \brief Gridded wind velocity field, sampled with trilinear interpolation
+  /// in space and linear interpolation in time.
+  ///
+  /// The field is loaded from a binary file, which is memory-mapped where
+  /// supported so that fields spanning several kilometres don't need to be
+  /// read into memory up front. All values are little-endian:
+  ///
+  /// | Offset | Type        | Content                                     |
+  /// |--------|-------------|---------------------------------------------|
+  /// | 0      | char[8]     | Magic string "IGNWIND1"                     |
+  /// | 8      | uint32[4]   | Number of samples along X, Y, Z and time    |
+  /// | 24     | double[3]   | World position of the first sample, in m    |
+  /// | 48     | double[3]   | Distance between samples along X, Y, Z, in m|
+  /// | 72     | double      | Time between samples, in s                  |
+  /// | 80     | float[t][z][y][x][3] | Wind velocity in the world frame, m/s |
+  ///
+  /// A 3D field has a single time sample. Positions outside of the grid are
+  /// clamped to its boundary.
+  class WindField
+  {
+    /// \brief Size of the file header, in bytes.
+    public: static constexpr std::size_t kHeaderSize{80};
+
+    /// \brief Constructor.
+    public: WindField() = default;
+
+    /// \brief Destructor. Unmaps the file.
+    public: ~WindField()
+    {
+      this->Unload();
+    }
+
+    /// \brief Not copyable, since it owns a memory mapping.
+    public: WindField(const WindField &) = delete;
+
+    /// \brief Not copyable, since it owns a memory mapping.
+    public: WindField &operator=(const WindField &) = delete;
+
+    /// \brief Load a field from a file, replacing any previous field.
+    /// \param[in] _path Absolute path to the file.
+    /// \return True if the file was loaded.
+    public: bool Load(const std::string &_path)
+    {
+      this->Unload();
+
+#ifndef _WIN32
+      int fd = open(_path.c_str(), O_RDONLY);
+      if (fd < 0)
+      {
+        ignerr << "Failed to open wind field [" << _path << "]" << std::endl;
+        return false;
+      }
+
+      struct stat st;
+      if (fstat(fd, &st) != 0 ||
+          static_cast<std::size_t>(st.st_size) < kHeaderSize)
+      {
+        ignerr << "Wind field [" << _path << "] is too small" << std::endl;
+        close(fd);
+        return false;
+      }
+
+      void *map = mmap(nullptr, static_cast<std::size_t>(st.st_size),
+          PROT_READ, MAP_PRIVATE, fd, 0);
+      close(fd);
+      if (map == MAP_FAILED)
+      {
+        ignerr << "Failed to map wind field [" << _path << "]" << std::endl;
+        return false;
+      }
+      this->mapping = map;
+      this->mappingSize = static_cast<std::size_t>(st.st_size);
+      const char *bytes = static_cast<const char *>(map);
+      const std::size_t size = this->mappingSize;
+#else
+      std::ifstream file(_path, std::ios::binary);
+      if (!file)
+      {
+        ignerr << "Failed to open wind field [" << _path << "]" << std::endl;
+        return false;
+      }
+      std::vector<char> contents((std::istreambuf_iterator<char>(file)),
+          std::istreambuf_iterator<char>());
+      this->buffer.resize(contents.size() / sizeof(float) + 1);
+      std::memcpy(this->buffer.data(), contents.data(), contents.size());
+      const char *bytes = reinterpret_cast<const char *>(this->buffer.data());
+      const std::size_t size = contents.size();
+#endif
+
+      if (!this->ParseHeader(bytes, size, _path))
+      {
+        this->Unload();
+        return false;
+      }
+
+      this->data = reinterpret_cast<const float *>(bytes + kHeaderSize);
+      return true;
+    }
+
+    /// \brief Release the field.
+    public: void Unload()
+    {
+#ifndef _WIN32
+      if (this->mapping)
+        munmap(this->mapping, this->mappingSize);
+      this->mapping = nullptr;
+      this->mappingSize = 0;
+#else
+      this->buffer.clear();
+#endif
+      this->data = nullptr;
+    }
+
+    /// \brief Whether a field is loaded.
+    /// \return True if loaded.
+    public: bool Valid() const
+    {
+      return nullptr != this->data;
+    }
+
+    /// \brief Set whether time wraps around to the first sample after the
+    /// last one, instead of holding the last sample.
+    /// \param[in] _loop True to loop.
+    public: void SetLoop(bool _loop)
+    {
+      this->loop = _loop;
+    }
+
+    /// \brief Sample the field at a single position.
+    /// \param[in] _position World position.
+    /// \param[in] _time Time since the start of the field, in seconds.
+    /// \return Wind velocity, zero if no field is loaded.
+    public: math::Vector3d Sample(const math::Vector3d &_position,
+                                  double _time) const
+    {
+      std::vector<math::Vector3d> velocities(1);
+      this->AddSamples({_position}, _time, velocities);
+      return velocities[0];
+    }
+
+    /// \brief Sample the field at many positions at once, adding the result
+    /// to the given velocities. The time interpolation is computed once for
+    /// the whole batch.
+    /// \param[in] _positions World positions.
+    /// \param[in] _time Time since the start of the field, in seconds.
+    /// \param[in, out] _velocities Velocities to add the samples to. Must
+    /// have the same size as _positions.
+    public: void AddSamples(const std::vector<math::Vector3d> &_positions,
+                            double _time,
+                            std::vector<math::Vector3d> &_velocities) const
+    {
+      if (!this->Valid())
+        return;
+
+      // Time slices and interpolation weight
+      std::size_t t0{0};
+      std::size_t t1{0};
+      double ft{0.0};
+      if (this->nt > 1 && std::isfinite(_time))
+      {
+        double t = _time / this->timeStep;
+        if (this->loop)
+        {
+          t = std::fmod(t, static_cast<double>(this->nt));
+          if (t < 0.0)
+            t += static_cast<double>(this->nt);
+          t0 = std::min(static_cast<std::size_t>(t), this->nt - 1);
+          t1 = (t0 + 1) % this->nt;
+        }
+        else
+        {
+          t = std::clamp(t, 0.0, static_cast<double>(this->nt - 1));
+          t0 = std::min(static_cast<std::size_t>(t), this->nt - 2);
+          t1 = t0 + 1;
+        }
+        ft = t - static_cast<double>(t0);
+      }
+
+      const std::size_t sliceSize = this->nx * this->ny * this->nz * 3;
+      const float *slice0 = this->data + t0 * sliceSize;
+      const float *slice1 = this->data + t1 * sliceSize;
+
+      const std::size_t count =
+          std::min(_positions.size(), _velocities.size());
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        std::size_t x0, x1, y0, y1, z0, z1;
+        double fx, fy, fz;
+        Cell(_positions[i].X(), this->origin.X(), this->spacing.X(),
+             this->nx, x0, x1, fx);
+        Cell(_positions[i].Y(), this->origin.Y(), this->spacing.Y(),
+             this->ny, y0, y1, fy);
+        Cell(_positions[i].Z(), this->origin.Z(), this->spacing.Z(),
+             this->nz, z0, z1, fz);
+
+        double v[3]{0.0, 0.0, 0.0};
+        this->Trilinear(slice0, x0, x1, y0, y1, z0, z1, fx, fy, fz,
+            1.0 - ft, v);
+        if (ft > 0.0)
+        {
+          this->Trilinear(slice1, x0, x1, y0, y1, z0, z1, fx, fy, fz, ft, v);
+        }
+        _velocities[i] += math::Vector3d(v[0], v[1], v[2]);
+      }
+    }
+
+    /// \brief Read and validate the header.
+    /// \param[in] _bytes File contents.
+    /// \param[in] _size Size of the file contents.
+    /// \param[in] _path Path used for error messages.
+    /// \return True if the header is valid and matches the file size.
+    private: bool ParseHeader(const char *_bytes, std::size_t _size,
+                              const std::string &_path)
+    {
+      if (std::memcmp(_bytes, "IGNWIND1", 8) != 0)
+      {
+        ignerr << "Wind field [" << _path << "] has an invalid header"
+               << std::endl;
+        return false;
+      }
+
+      uint32_t dims[4];
+      double values[7];
+      std::memcpy(dims, _bytes + 8, sizeof(dims));
+      std::memcpy(values, _bytes + 24, sizeof(values));
+
+      this->nx = dims[0];
+      this->ny = dims[1];
+      this->nz = dims[2];
+      this->nt = dims[3];
+      this->origin.Set(values[0], values[1], values[2]);
+      this->spacing.Set(values[3], values[4], values[5]);
+      this->timeStep = values[6];
+
+      if (this->nx == 0 || this->ny == 0 || this->nz == 0 || this->nt == 0 ||
+          !this->origin.IsFinite() || !this->spacing.IsFinite() ||
+          this->spacing.X() <= 0.0 || this->spacing.Y() <= 0.0 ||
+          this->spacing.Z() <= 0.0 || (this->nt > 1 &&
+          (this->timeStep <= 0.0 || !std::isfinite(this->timeStep))))
+      {
+        ignerr << "Wind field [" << _path << "] has invalid dimensions"
+               << std::endl;
+        return false;
+      }
+
+      // The dimensions come from the file, so the data size may overflow
+      std::size_t expected = 3 * sizeof(float);
+      for (std::size_t n : {this->nx, this->ny, this->nz, this->nt})
+      {
+        if (expected > (SIZE_MAX - kHeaderSize) / n)
+        {
+          ignerr << "Wind field [" << _path << "] is too large" << std::endl;
+          return false;
+        }
+        expected *= n;
+      }
+      expected += kHeaderSize;
+      if (_size < expected)
+      {
+        ignerr << "Wind field [" << _path << "] is truncated: expected ["
+               << expected << "] bytes, got [" << _size << "]" << std::endl;
+        return false;
+      }
+      return true;
+    }
+
+    /// \brief Find the grid cell containing a coordinate along one axis.
+    /// \param[in] _value Coordinate.
+    /// \param[in] _origin Coordinate of the first sample.
+    /// \param[in] _spacing Distance between samples.
+    /// \param[in] _n Number of samples.
+    /// \param[out] _i0 Index of the lower sample.
+    /// \param[out] _i1 Index of the upper sample.
+    /// \param[out] _f Interpolation weight of the upper sample.
+    private: static void Cell(double _value, double _origin, double _spacing,
+                              std::size_t _n, std::size_t &_i0,
+                              std::size_t &_i1, double &_f)
+    {
+      if (_n == 1)
+      {
+        _i0 = _i1 = 0;
+        _f = 0.0;
+        return;
+      }
+      double g = (_value - _origin) / _spacing;
+
+      // Casting NaN to an index is undefined, use the first cell instead
+      if (std::isnan(g))
+        g = 0.0;
+      g = std::clamp(g, 0.0, static_cast<double>(_n - 1));
+      _i0 = std::min(static_cast<std::size_t>(g), _n - 2);
+      _i1 = _i0 + 1;
+      _f = g - static_cast<double>(_i0);
+    }
+
+    /// \brief Add a weighted trilinear interpolation of one time slice.
+    /// \param[in] _slice First value of the time slice.
+    /// \param[in] _x0 _x1 _y0 _y1 _z0 _z1 Cell corner indices.
+    /// \param[in] _fx _fy _fz Interpolation weights along each axis.
+    /// \param[in] _weight Weight of this time slice.
+    /// \param[in, out] _v Velocity to add to.
+    private: void Trilinear(const float *_slice,
+                            std::size_t _x0, std::size_t _x1,
+                            std::size_t _y0, std::size_t _y1,
+                            std::size_t _z0, std::size_t _z1,
+                            double _fx, double _fy, double _fz,
+                            double _weight, double _v[3]) const
+    {
+      auto at = [&](std::size_t _x, std::size_t _y, std::size_t _z)
+      {
+        return _slice + ((_z * this->ny + _y) * this->nx + _x) * 3;
+      };
+      const float *c000 = at(_x0, _y0, _z0);
+      const float *c100 = at(_x1, _y0, _z0);
+      const float *c010 = at(_x0, _y1, _z0);
+      const float *c110 = at(_x1, _y1, _z0);
+      const float *c001 = at(_x0, _y0, _z1);
+      const float *c101 = at(_x1, _y0, _z1);
+      const float *c011 = at(_x0, _y1, _z1);
+      const float *c111 = at(_x1, _y1, _z1);
+
+      for (int k = 0; k < 3; ++k)
+      {
+        const double c00 = c000[k] + (c100[k] - c000[k]) * _fx;
+        const double c10 = c010[k] + (c110[k] - c010[k]) * _fx;
+        const double c01 = c001[k] + (c101[k] - c001[k]) * _fx;
+        const double c11 = c011[k] + (c111[k] - c011[k]) * _fx;
+        const double c0 = c00 + (c10 - c00) * _fy;
+        const double c1 = c01 + (c11 - c01) * _fy;
+        _v[k] += _weight * (c0 + (c1 - c0) * _fz);
+      }
+    }
+
+    /// \brief Number of samples along X.
+    private: std::size_t nx{0};
+
+    /// \brief Number of samples along Y.
+    private: std::size_t ny{0};
+
+    /// \brief Number of samples along Z.
+    private: std::size_t nz{0};
+
+    /// \brief Number of time samples.
+    private: std::size_t nt{0};
+
+    /// \brief World position of the first sample.
+    private: math::Vector3d origin;
+
+    /// \brief Distance between samples.
+    private: math::Vector3d spacing;
+
+    /// \brief Time between samples.
+    private: double timeStep{0.0};
+
+    /// \brief Whether time loops.
+    private: bool loop{true};
+
+    /// \brief First velocity value.
+    private: const float *data{nullptr};
+
+#ifndef _WIN32
+    /// \brief Memory-mapped file.
+    private: void *mapping{nullptr};
+
+    /// \brief Size of the memory-mapped file.
+    private: std::size_t mappingSize{0};
+#else
+    /// \brief File contents, where memory mapping isn't supported. Stored as
+    /// floats to guarantee alignment.
+    private: std::vector<float> buffer;
+#endif
+  };
+}
+}
+}
+
+#endif
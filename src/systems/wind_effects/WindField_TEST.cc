@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <ignition/common/Filesystem.hh>
+
+#include "ignition/gazebo/test_config.hh"
+#include "WindField.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems::wind_effects;
+
+/// \brief Write a wind field file.
+/// \param[in] _path File path.
+/// \param[in] _dims Number of samples along X, Y, Z and time.
+/// \param[in] _timeStep Time between samples.
+/// \param[in] _values Velocity values.
+void writeField(const std::string &_path, const uint32_t _dims[4],
+    double _timeStep, const std::vector<float> &_values)
+{
+  std::ofstream file(_path, std::ios::binary);
+  file.write("IGNWIND1", 8);
+  file.write(reinterpret_cast<const char *>(_dims), 4 * sizeof(uint32_t));
+  const double header[7]{0.0, 0.0, 0.0, 1.0, 1.0, 1.0, _timeStep};
+  file.write(reinterpret_cast<const char *>(header), sizeof(header));
+  file.write(reinterpret_cast<const char *>(_values.data()),
+      _values.size() * sizeof(float));
+}
+
+/////////////////////////////////////////////////
+TEST(WindFieldTest, Invalid)
+{
+  WindField field;
+  EXPECT_FALSE(field.Valid());
+  EXPECT_EQ(math::Vector3d::Zero, field.Sample(math::Vector3d::Zero, 0.0));
+
+  EXPECT_FALSE(field.Load("/this/file/does/not/exist"));
+  EXPECT_FALSE(field.Valid());
+
+  // Truncated data
+  const auto path = common::joinPaths(PROJECT_BINARY_PATH,
+      "wind_field_truncated.bin");
+  const uint32_t dims[4]{2, 2, 2, 1};
+  writeField(path, dims, 0.0, std::vector<float>(3, 1.0f));
+  EXPECT_FALSE(field.Load(path));
+  EXPECT_FALSE(field.Valid());
+
+  // Dimensions whose data size overflows
+  const uint32_t hugeDims[4]{65536, 65536, 65536, 65536};
+  writeField(path, hugeDims, 1.0, std::vector<float>(3, 1.0f));
+  EXPECT_FALSE(field.Load(path));
+  EXPECT_FALSE(field.Valid());
+}
+
+/////////////////////////////////////////////////
+TEST(WindFieldTest, Trilinear)
+{
+  // 2x2x2 grid where the X velocity equals x + 2y + 4z
+  std::vector<float> values;
+  for (int z = 0; z < 2; ++z)
+  {
+    for (int y = 0; y < 2; ++y)
+    {
+      for (int x = 0; x < 2; ++x)
+      {
+        values.push_back(static_cast<float>(x + 2 * y + 4 * z));
+        values.push_back(1.0f);
+        values.push_back(0.0f);
+      }
+    }
+  }
+
+  const auto path = common::joinPaths(PROJECT_BINARY_PATH,
+      "wind_field_3d.bin");
+  const uint32_t dims[4]{2, 2, 2, 1};
+  writeField(path, dims, 0.0, values);
+
+  WindField field;
+  ASSERT_TRUE(field.Load(path));
+  EXPECT_TRUE(field.Valid());
+
+  EXPECT_EQ(math::Vector3d(0, 1, 0), field.Sample({0, 0, 0}, 0.0));
+  EXPECT_EQ(math::Vector3d(7, 1, 0), field.Sample({1, 1, 1}, 0.0));
+  EXPECT_EQ(math::Vector3d(3.5, 1, 0), field.Sample({0.5, 0.5, 0.5}, 0.0));
+  EXPECT_EQ(math::Vector3d(1.75, 1, 0),
+      field.Sample({0.25, 0.25, 0.25}, 0.0));
+
+  // Clamped outside the grid
+  EXPECT_EQ(math::Vector3d(7, 1, 0), field.Sample({10, 10, 10}, 0.0));
+  EXPECT_EQ(math::Vector3d(0, 1, 0), field.Sample({-10, -10, -10}, 0.0));
+
+  // Non-finite positions use the first or last cell
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  const double inf = std::numeric_limits<double>::infinity();
+  EXPECT_EQ(math::Vector3d(0, 1, 0), field.Sample({nan, nan, nan}, 0.0));
+  EXPECT_EQ(math::Vector3d(7, 1, 0), field.Sample({inf, inf, inf}, nan));
+
+  // Batches add to the given velocities
+  std::vector<math::Vector3d> positions{{0, 0, 0}, {1, 0, 0}, {0, 1, 1}};
+  std::vector<math::Vector3d> velocities(3, math::Vector3d(1, 0, 0));
+  field.AddSamples(positions, 0.0, velocities);
+  EXPECT_EQ(math::Vector3d(1, 1, 0), velocities[0]);
+  EXPECT_EQ(math::Vector3d(2, 1, 0), velocities[1]);
+  EXPECT_EQ(math::Vector3d(7, 1, 0), velocities[2]);
+}
+
+/////////////////////////////////////////////////
+TEST(WindFieldTest, Time)
+{
+  // Single point, two time samples: 0 then 10 m/s along Z
+  const std::vector<float> values{0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 10.0f};
+
+  const auto path = common::joinPaths(PROJECT_BINARY_PATH,
+      "wind_field_4d.bin");
+  const uint32_t dims[4]{1, 1, 1, 2};
+  writeField(path, dims, 2.0, values);
+
+  WindField field;
+  ASSERT_TRUE(field.Load(path));
+
+  EXPECT_EQ(math::Vector3d(0, 0, 0), field.Sample({5, 5, 5}, 0.0));
+  EXPECT_EQ(math::Vector3d(0, 0, 5), field.Sample({5, 5, 5}, 1.0));
+  EXPECT_EQ(math::Vector3d(0, 0, 10), field.Sample({5, 5, 5}, 2.0));
+
+  // Looping interpolates back towards the first sample
+  EXPECT_EQ(math::Vector3d(0, 0, 5), field.Sample({5, 5, 5}, 3.0));
+  EXPECT_EQ(math::Vector3d(0, 0, 0), field.Sample({5, 5, 5}, 4.0));
+
+  // Without looping, the last sample is held
+  field.SetLoop(false);
+  EXPECT_EQ(math::Vector3d(0, 0, 10), field.Sample({5, 5, 5}, 3.0));
+  EXPECT_EQ(math::Vector3d(0, 0, 10), field.Sample({5, 5, 5}, 100.0));
+}
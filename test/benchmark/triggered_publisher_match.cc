@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <google/protobuf/util/message_differencer.h>
+
+#include <limits>
+#include <memory>
+#include <string>
+
+#include <ignition/msgs/pose.pb.h>
+#include <ignition/msgs/Utility.hh>
+#include <sdf/Element.hh>
+
+#include "InputMatcher.hh"
+
+using namespace ignition;
+using namespace gazebo;
+using namespace systems;
+
+/// \brief Create a matcher the same way the system does from its <match>
+/// element.
+/// \param[in] _field Value of the field attribute, or empty for a full match
+/// \param[in] _value Match string
+/// \return The matcher.
+static std::unique_ptr<InputMatcher> CreateMatcher(const std::string &_field,
+    const std::string &_value)
+{
+  auto elem = std::make_shared<sdf::Element>();
+  elem->SetName("match");
+  elem->AddValue("string", "", false);
+  elem->AddAttribute("logic_type", "string", "positive", false);
+  elem->AddAttribute("tol", "double", "1e-8", false);
+  if (!_field.empty())
+  {
+    elem->AddAttribute("field", "string", "", false);
+    elem->GetAttribute("field")->Set(_field);
+  }
+  elem->Set<std::string>(_value);
+  return InputMatcher::Create("ignition.msgs.Pose", elem);
+}
+
+/// \brief Input message which matches the matchers below.
+/// \return The message.
+static msgs::Pose InputMsg()
+{
+  msgs::Pose msg;
+  msg.set_name("box");
+  msg.set_id(3);
+  msgs::Set(&msg, math::Pose3d(1, 2, 3, 0, 0, 0));
+  return msg;
+}
+
+// NOLINTNEXTLINE
+void BM_FieldMatcherScalar(benchmark::State &_st)
+{
+  auto matcher = CreateMatcher("position.z", "3.0");
+  auto msg = InputMsg();
+  for (auto _ : _st)
+  {
+    benchmark::DoNotOptimize(matcher->Match(msg));
+  }
+}
+BENCHMARK(BM_FieldMatcherScalar);
+
+// NOLINTNEXTLINE
+void BM_FieldMatcherMessage(benchmark::State &_st)
+{
+  auto matcher = CreateMatcher("position", "x: 1.0, y: 2.0, z: 3.0");
+  auto msg = InputMsg();
+  for (auto _ : _st)
+  {
+    benchmark::DoNotOptimize(matcher->Match(msg));
+  }
+}
+BENCHMARK(BM_FieldMatcherMessage);
+
+// NOLINTNEXTLINE
+void BM_FullMatcher(benchmark::State &_st)
+{
+  auto matcher = CreateMatcher("",
+      "name: \"box\" id: 3 position {x: 1.0, y: 2.0, z: 3.0} "
+      "orientation {w: 1.0}");
+  auto msg = InputMsg();
+  for (auto _ : _st)
+  {
+    benchmark::DoNotOptimize(matcher->Match(msg));
+  }
+}
+BENCHMARK(BM_FullMatcher);
+
+// Comparison with a plain MessageDifferencer, which is what the matchers used
+// before they were compiled.
+// NOLINTNEXTLINE
+void BM_MessageDifferencer(benchmark::State &_st)
+{
+  google::protobuf::util::DefaultFieldComparator comparator;
+  comparator.set_float_comparison(
+      google::protobuf::util::DefaultFieldComparator::APPROXIMATE);
+  comparator.SetDefaultFractionAndMargin(
+      std::numeric_limits<double>::min(), 1e-8);
+  google::protobuf::util::MessageDifferencer diff;
+  diff.set_field_comparator(&comparator);
+
+  auto expected = InputMsg();
+  auto msg = InputMsg();
+  for (auto _ : _st)
+  {
+    benchmark::DoNotOptimize(diff.Compare(expected, msg));
+  }
+}
+BENCHMARK(BM_MessageDifferencer);
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+BENCHMARK_MAIN();
+#pragma GCC diagnostic pop
@@ -19,6 +19,7 @@
 
 #include <ignition/common/Console.hh>
 #include <ignition/common/Util.hh>
+#include <ignition/msgs/Utility.hh>
 #include <ignition/utilities/ExtraTestMacros.hh>
 
 #include "ignition/gazebo/Util.hh"
@@ -26,6 +27,7 @@
 #include "ignition/gazebo/SystemLoader.hh"
 #include "ignition/gazebo/TestFixture.hh"
 #include "ignition/gazebo/components/CenterOfVolume.hh"
+#include "ignition/gazebo/components/ExternalWorldWrenchCmd.hh"
 #include "ignition/gazebo/components/Link.hh"
 #include "ignition/gazebo/components/Name.hh"
 #include "ignition/gazebo/components/ParentEntity.hh"
@@ -529,3 +531,75 @@ TEST_F(BuoyancyTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(OffsetAndRotation))
   fixture.Server()->Run(true, targetIterations, false);
   EXPECT_EQ(targetIterations, iterations);
 }
+
+/////////////////////////////////////////////////
+TEST_F(BuoyancyTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(WorldPoseAndWrench))
+{
+  // Start server
+  ServerConfig serverConfig;
+  const auto sdfFile = std::string(PROJECT_BINARY_PATH) +
+    "/test/worlds/buoyancy.sdf";
+  serverConfig.SetSdfFile(sdfFile);
+
+  Server server(serverConfig);
+  EXPECT_FALSE(server.Running());
+  EXPECT_FALSE(*server.Running(0));
+
+  std::size_t iterations{100};
+  std::size_t preUpdates{0};
+  std::size_t postUpdates{0};
+
+  test::Relay testSystem;
+
+  // This runs after the buoyancy system and before physics, so the wrench
+  // only holds the buoyancy force
+  testSystem.OnPreUpdate([&](const gazebo::UpdateInfo &,
+                             gazebo::EntityComponentManager &_ecm)
+  {
+    auto links = entitiesFromScopedName("submarine::body", _ecm);
+    ASSERT_EQ(1u, links.size());
+    auto link = *links.begin();
+
+    auto wrench = _ecm.Component<components::ExternalWorldWrenchCmd>(link);
+    ASSERT_NE(nullptr, wrench);
+
+    // rho * V * g
+    auto force = msgs::Convert(wrench->Data().force());
+    EXPECT_NEAR(0.0, force.X(), 1e-6);
+    EXPECT_NEAR(0.0, force.Y(), 1e-6);
+    EXPECT_NEAR(1000 * 0.25132741228718347 * 9.8, force.Z(), 1e-1);
+
+    preUpdates++;
+  });
+
+  // Buoyancy creates world poses on buoyant links, which are kept up to date
+  // by physics
+  testSystem.OnPostUpdate([&](const gazebo::UpdateInfo &,
+                              const gazebo::EntityComponentManager &_ecm)
+  {
+    std::size_t buoyantLinks{0};
+    _ecm.Each<components::Link, components::Volume>(
+        [&](const Entity &_entity, const components::Link *,
+            const components::Volume *) -> bool
+        {
+          auto pose = _ecm.Component<components::WorldPose>(_entity);
+          EXPECT_NE(nullptr, pose);
+          if (nullptr != pose)
+          {
+            EXPECT_EQ(worldPose(_entity, _ecm), pose->Data())
+                << scopedName(_entity, _ecm);
+          }
+          buoyantLinks++;
+          return true;
+        });
+    EXPECT_LT(0u, buoyantLinks);
+
+    postUpdates++;
+  });
+
+  server.AddSystem(testSystem.systemPtr);
+  server.Run(true, iterations, false);
+
+  EXPECT_EQ(iterations, preUpdates);
+  EXPECT_EQ(iterations, postUpdates);
+}
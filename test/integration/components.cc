@@ -43,6 +43,7 @@
 #include "ignition/gazebo/components/CanonicalLink.hh"
 #include "ignition/gazebo/components/ChildLinkName.hh"
 #include "ignition/gazebo/components/Collision.hh"
+#include "ignition/gazebo/components/ContactSensorBuffer.hh"
 #include "ignition/gazebo/components/DetachableJoint.hh"
 #include "ignition/gazebo/components/Geometry.hh"
 #include "ignition/gazebo/components/Gravity.hh"
@@ -382,6 +383,72 @@ TEST_F(ComponentsTest, Collision)
   comp3.Deserialize(istr);
 }
 
+/////////////////////////////////////////////////
+TEST_F(ComponentsTest, ContactSensorBuffer)
+{
+  ContactBuffer buffer1;
+  ContactBuffer::Pair pair;
+  pair.collision1 = 1;
+  pair.collision2 = 2;
+  pair.collision1Name = "box::link::collision";
+  pair.collision2Name = "ground_plane::link::collision";
+  pair.offset = 0;
+  pair.count = 2;
+  buffer1.pairs.push_back(pair);
+  buffer1.positions = {{1, 2, 3}, {4, 5, 6}};
+  buffer1.normals = {{0, 0, 1}, {0, 0, 1}};
+  buffer1.depths = {0.01, 0.02};
+  buffer1.forces = {{0, 0, 10}, {0, 0, 20}};
+  EXPECT_FALSE(buffer1.Empty());
+  EXPECT_TRUE(buffer1.HasExtraData());
+
+  ContactBuffer buffer2 = buffer1;
+  buffer2.positions[1] = {4, 5, 7};
+
+  // Create components
+  auto comp1 = components::ContactSensorBuffer(buffer1);
+  auto comp2 = components::ContactSensorBuffer(buffer2);
+
+  // Equality operators
+  EXPECT_NE(comp1, comp2);
+  EXPECT_FALSE(comp1 == comp2);
+  EXPECT_TRUE(comp1 != comp2);
+
+  // Conversion to message
+  msgs::Contacts msg;
+  buffer1.AddToMsg(msg);
+  ASSERT_EQ(1, msg.contact_size());
+  EXPECT_EQ(1u, msg.contact(0).collision1().id());
+  EXPECT_EQ(2u, msg.contact(0).collision2().id());
+  EXPECT_EQ("box::link::collision", msg.contact(0).collision1().name());
+  ASSERT_EQ(2, msg.contact(0).position_size());
+  EXPECT_EQ(math::Vector3d(4, 5, 6),
+      msgs::Convert(msg.contact(0).position(1)));
+  ASSERT_EQ(2, msg.contact(0).normal_size());
+  ASSERT_EQ(2, msg.contact(0).depth_size());
+  EXPECT_DOUBLE_EQ(0.02, msg.contact(0).depth(1));
+  ASSERT_EQ(2, msg.contact(0).wrench_size());
+  EXPECT_EQ(math::Vector3d(0, 0, -20), msgs::Convert(
+      msg.contact(0).wrench(1).body_2_wrench().force()));
+
+  // Stream operators
+  std::ostringstream ostr;
+  comp1.Serialize(ostr);
+
+  std::istringstream istr(ostr.str());
+  components::ContactSensorBuffer comp3;
+  comp3.Deserialize(istr);
+  EXPECT_EQ(comp1, comp3);
+  EXPECT_TRUE(comp3.Data().HasExtraData());
+  EXPECT_EQ(buffer1.forces, comp3.Data().forces);
+  EXPECT_EQ(pair.collision2Name, comp3.Data().pairs[0].collision2Name);
+
+  // Clear
+  buffer1.Clear();
+  EXPECT_TRUE(buffer1.Empty());
+  EXPECT_FALSE(buffer1.HasExtraData());
+}
+
 /////////////////////////////////////////////////
 TEST_F(ComponentsTest, DetachableJoint)
 {
@@ -19,6 +19,9 @@
 
 #include <ignition/msgs/contacts.pb.h>
 
+#include <fstream>
+#include <sstream>
+#include <string>
 #include <thread>
 
 #include <ignition/common/Console.hh>
@@ -26,12 +29,16 @@
 #include <ignition/transport/Node.hh>
 #include <ignition/utilities/ExtraTestMacros.hh>
 
+#include "ignition/gazebo/components/Collision.hh"
+#include "ignition/gazebo/components/ContactSensorBuffer.hh"
+#include "ignition/gazebo/components/ContactSensorData.hh"
 #include "ignition/gazebo/Server.hh"
 #include "ignition/gazebo/SystemLoader.hh"
 #include "ignition/gazebo/test_config.hh"
 
 #include "plugins/MockSystem.hh"
 #include "../helpers/EnvTestFixture.hh"
+#include "../helpers/Relay.hh"
 
 using namespace ignition;
 using namespace gazebo;
@@ -320,3 +327,78 @@ TEST_F(ContactSystemTest,
     EXPECT_EQ(0u, contactMsgs.size());
   }
 }
+
+/////////////////////////////////////////////////
+// Systems reading ContactSensorData keep getting contacts by default, and
+// the contact buffer is only used when requested.
+TEST_F(ContactSystemTest,
+       IGN_UTILS_TEST_DISABLED_ON_WIN32(ContactComponents))
+{
+  const auto sdfFile = std::string(PROJECT_SOURCE_PATH) +
+    "/test/worlds/contact.sdf";
+  std::ifstream file(sdfFile);
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  const std::string sdfString = buffer.str();
+
+  for (bool useBuffer : {false, true})
+  {
+    ServerConfig serverConfig;
+    if (useBuffer)
+    {
+      std::string modified = sdfString;
+      const std::string plugin =
+          "name=\"ignition::gazebo::systems::Contact\">";
+      auto pos = modified.find(plugin);
+      ASSERT_NE(std::string::npos, pos);
+      modified.insert(pos + plugin.size(),
+          "<use_contact_buffer>true</use_contact_buffer>");
+      serverConfig.SetSdfString(modified);
+    }
+    else
+    {
+      serverConfig.SetSdfFile(sdfFile);
+    }
+
+    Server server(serverConfig);
+
+    std::size_t dataCount{0};
+    std::size_t bufferCount{0};
+    std::size_t inContact{0};
+    test::Relay testSystem;
+    testSystem.OnPostUpdate(
+        [&](const UpdateInfo &, const EntityComponentManager &_ecm)
+        {
+          dataCount = 0;
+          bufferCount = 0;
+          inContact = 0;
+          _ecm.Each<components::Collision, components::ContactSensorData>(
+              [&](const Entity &, const components::Collision *,
+                  const components::ContactSensorData *_contacts) -> bool
+              {
+                ++dataCount;
+                if (_contacts->Data().contact_size() > 0)
+                  ++inContact;
+                return true;
+              });
+          _ecm.Each<components::Collision, components::ContactSensorBuffer>(
+              [&](const Entity &, const components::Collision *,
+                  const components::ContactSensorBuffer *_contacts) -> bool
+              {
+                ++bufferCount;
+                if (!_contacts->Data().Empty())
+                  ++inContact;
+                return true;
+              });
+        });
+    server.AddSystem(testSystem.systemPtr);
+
+    // Let the sphere fall on the boxes
+    server.Run(true, 1000, false);
+
+    // The sensor uses both sphere collisions
+    EXPECT_EQ(useBuffer ? 0u : 2u, dataCount);
+    EXPECT_EQ(useBuffer ? 2u : 0u, bufferCount);
+    EXPECT_EQ(2u, inContact);
+  }
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <ignition/common/Console.hh>
+#include <ignition/common/Util.hh>
+#include <ignition/msgs/Utility.hh>
+#include <ignition/utilities/ExtraTestMacros.hh>
+
+#include "ignition/gazebo/Server.hh"
+#include "ignition/gazebo/Util.hh"
+#include "ignition/gazebo/components/AngularVelocity.hh"
+#include "ignition/gazebo/components/ExternalWorldWrenchCmd.hh"
+#include "ignition/gazebo/components/LinearVelocity.hh"
+#include "ignition/gazebo/components/Pose.hh"
+
+#include "ignition/gazebo/test_config.hh"
+#include "../helpers/EnvTestFixture.hh"
+#include "../helpers/Relay.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+class HydrodynamicsTest : public InternalFixture<::testing::Test>
+{
+};
+
+/////////////////////////////////////////////////
+TEST_F(HydrodynamicsTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(QuadraticDamping))
+{
+  // The world has no physics, so velocities are set by the test system, which
+  // runs after the hydrodynamics system. The wrench computed for the
+  // velocities set on one step is checked on the next one.
+  ServerConfig serverConfig;
+  serverConfig.SetSdfFile(common::joinPaths(std::string(PROJECT_SOURCE_PATH),
+      "test", "worlds", "hydrodynamics.sdf"));
+
+  Server server(serverConfig);
+  EXPECT_FALSE(server.Running());
+  EXPECT_FALSE(*server.Running(0));
+
+  // Fractional velocities, whose absolute values must not be truncated
+  const math::Vector3d linearVel(0.5, -1.5, 0.25);
+  const math::Vector3d angularVel(0.5, 0.0, -0.75);
+
+  std::size_t checks{0};
+  test::Relay testSystem;
+  testSystem.OnPreUpdate([&](const gazebo::UpdateInfo &_info,
+                             gazebo::EntityComponentManager &_ecm)
+  {
+    auto links = entitiesFromScopedName("vehicle::body", _ecm);
+    ASSERT_EQ(1u, links.size());
+    auto link = *links.begin();
+
+    // Created by the hydrodynamics system
+    ASSERT_NE(nullptr, _ecm.Component<components::WorldPose>(link));
+    ASSERT_NE(nullptr, _ecm.Component<components::WorldLinearVelocity>(link));
+    ASSERT_NE(nullptr,
+        _ecm.Component<components::WorldAngularVelocity>(link));
+
+    auto wrench = _ecm.Component<components::ExternalWorldWrenchCmd>(link);
+    ASSERT_NE(nullptr, wrench);
+
+    if (_info.iterations > 1)
+    {
+      // Quadratic damping only: -d * |v| * v, with d being 10 for linear and
+      // 2 for angular velocities
+      auto force = msgs::Convert(wrench->Data().force());
+      EXPECT_NEAR(-2.5, force.X(), 1e-6);
+      EXPECT_NEAR(22.5, force.Y(), 1e-6);
+      EXPECT_NEAR(-0.625, force.Z(), 1e-6);
+
+      auto torque = msgs::Convert(wrench->Data().torque());
+      EXPECT_NEAR(-0.5, torque.X(), 1e-6);
+      EXPECT_NEAR(0.0, torque.Y(), 1e-6);
+      EXPECT_NEAR(1.125, torque.Z(), 1e-6);
+      checks++;
+    }
+
+    // There's no physics system to clear the wrench
+    wrench->Data().Clear();
+
+    _ecm.SetComponentData<components::WorldLinearVelocity>(link, linearVel);
+    _ecm.SetComponentData<components::WorldAngularVelocity>(link,
+        angularVel);
+  });
+
+  server.AddSystem(testSystem.systemPtr);
+
+  const std::size_t iterations{10};
+  server.Run(true, iterations, false);
+  EXPECT_EQ(iterations - 1, checks);
+}
@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <ignition/msgs/altimeter.pb.h>
+#include <ignition/msgs/fluid_pressure.pb.h>
+#include <ignition/msgs/imu.pb.h>
+#include <ignition/msgs/magnetometer.pb.h>
+#include <ignition/msgs/navsat.pb.h>
+#include <ignition/msgs/param.pb.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <ignition/common/Console.hh>
+#include <ignition/msgs/Utility.hh>
+#include <ignition/transport/Node.hh>
+#include <ignition/utilities/ExtraTestMacros.hh>
+
+#include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/Sensor.hh"
+#include "ignition/gazebo/Server.hh"
+#include "ignition/gazebo/test_config.hh"
+
+#include "../helpers/Relay.hh"
+#include "../helpers/EnvTestFixture.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief Test NonRenderingSensors system
+class NonRenderingSensorsTest : public InternalFixture<::testing::Test>
+{
+};
+
+/////////////////////////////////////////////////
+// Check that each sensor publishes at its own rate and gets a topic
+// component, like with the individual sensor systems.
+TEST_F(NonRenderingSensorsTest,
+    IGN_UTILS_TEST_DISABLED_ON_WIN32(PublishAtRate))
+{
+  ServerConfig serverConfig;
+  const auto sdfFile = std::string(PROJECT_SOURCE_PATH) +
+    "/test/worlds/non_rendering_sensors_system.sdf";
+  serverConfig.SetSdfFile(sdfFile);
+
+  Server server(serverConfig);
+  EXPECT_FALSE(server.Running());
+  EXPECT_FALSE(*server.Running(0));
+
+  const std::string prefix = "world/non_rendering_sensors_system/"
+      "model/sensors_model/link/link/sensor/";
+
+  // Sensor name, and its topic and update rate
+  const std::map<std::string, std::pair<std::string, unsigned int>> expected{
+      {"imu_sensor", {prefix + "imu_sensor/imu", 100u}},
+      {"magnetometer_sensor",
+          {prefix + "magnetometer_sensor/magnetometer", 10u}},
+      {"altimeter_sensor", {prefix + "altimeter_sensor/altimeter", 30u}},
+      {"air_pressure_sensor",
+          {prefix + "air_pressure_sensor/air_pressure", 30u}},
+      {"navsat_sensor", {prefix + "navsat_sensor/navsat", 50u}}};
+
+  // Record the topics of the sensors
+  std::map<std::string, std::string> topics;
+  test::Relay testSystem;
+  testSystem.OnPostUpdate([&](const UpdateInfo &,
+                              const EntityComponentManager &_ecm)
+      {
+        _ecm.Each<components::Sensor, components::Name,
+                  components::SensorTopic>(
+            [&](const Entity &,
+                const components::Sensor *,
+                const components::Name *_name,
+                const components::SensorTopic *_topic) -> bool
+            {
+              topics[_name->Data()] = _topic->Data();
+              return true;
+            });
+      });
+  server.AddSystem(testSystem.systemPtr);
+
+  std::atomic<unsigned int> imuCount{0};
+  std::atomic<unsigned int> magnetometerCount{0};
+  std::atomic<unsigned int> altimeterCount{0};
+  std::atomic<unsigned int> airPressureCount{0};
+  std::atomic<unsigned int> navSatCount{0};
+
+  transport::Node node;
+  std::function<void(const msgs::IMU &)> imuCb =
+      [&](const msgs::IMU &){++imuCount;};
+  std::function<void(const msgs::Magnetometer &)> magnetometerCb =
+      [&](const msgs::Magnetometer &){++magnetometerCount;};
+  std::function<void(const msgs::Altimeter &)> altimeterCb =
+      [&](const msgs::Altimeter &){++altimeterCount;};
+  std::function<void(const msgs::FluidPressure &)> airPressureCb =
+      [&](const msgs::FluidPressure &){++airPressureCount;};
+  std::function<void(const msgs::NavSat &)> navSatCb =
+      [&](const msgs::NavSat &){++navSatCount;};
+  EXPECT_TRUE(node.Subscribe(expected.at("imu_sensor").first, imuCb));
+  EXPECT_TRUE(node.Subscribe(expected.at("magnetometer_sensor").first,
+      magnetometerCb));
+  EXPECT_TRUE(node.Subscribe(expected.at("altimeter_sensor").first,
+      altimeterCb));
+  EXPECT_TRUE(node.Subscribe(expected.at("air_pressure_sensor").first,
+      airPressureCb));
+  EXPECT_TRUE(node.Subscribe(expected.at("navsat_sensor").first, navSatCb));
+
+  const size_t iters = 1000u;
+  const double stepSize = 0.001;
+  server.Run(true, iters, false);
+
+  auto expectedCount = [&](const std::string &_name)
+  {
+    return static_cast<unsigned int>(
+        iters * stepSize * expected.at(_name).second + 1);
+  };
+
+  // Wait for messages to be received
+  for (int sleep = 0; sleep < 30; ++sleep)
+  {
+    if (imuCount == expectedCount("imu_sensor") &&
+        magnetometerCount == expectedCount("magnetometer_sensor") &&
+        altimeterCount == expectedCount("altimeter_sensor") &&
+        airPressureCount == expectedCount("air_pressure_sensor") &&
+        navSatCount == expectedCount("navsat_sensor"))
+    {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+
+  EXPECT_EQ(expectedCount("imu_sensor"), imuCount);
+  EXPECT_EQ(expectedCount("magnetometer_sensor"), magnetometerCount);
+  EXPECT_EQ(expectedCount("altimeter_sensor"), altimeterCount);
+  EXPECT_EQ(expectedCount("air_pressure_sensor"), airPressureCount);
+  EXPECT_EQ(expectedCount("navsat_sensor"), navSatCount);
+
+  ASSERT_EQ(expected.size(), topics.size());
+  for (const auto &[name, topicRate] : expected)
+  {
+    EXPECT_EQ(topicRate.first, topics[name]) << name;
+  }
+}
+
+/////////////////////////////////////////////////
+// Check that staggered sensors keep their rate while being updated on
+// different steps.
+TEST_F(NonRenderingSensorsTest,
+    IGN_UTILS_TEST_DISABLED_ON_WIN32(Stagger))
+{
+  ServerConfig serverConfig;
+  const auto sdfFile = std::string(PROJECT_SOURCE_PATH) +
+    "/test/worlds/non_rendering_sensors_stagger.sdf";
+  serverConfig.SetSdfFile(sdfFile);
+
+  Server server(serverConfig);
+
+  const unsigned int sensorCount = 4u;
+  const std::chrono::milliseconds period{10};
+
+  // Stamps of the messages received from each sensor
+  std::mutex mutex;
+  std::map<std::string, std::vector<std::chrono::steady_clock::duration>>
+      stamps;
+  std::atomic<int> maxUpdates{0};
+
+  transport::Node node;
+  for (unsigned int i = 0; i < sensorCount; ++i)
+  {
+    const auto name = "imu_" + std::to_string(i);
+    std::function<void(const msgs::IMU &)> imuCb =
+        [&, name](const msgs::IMU &_msg)
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          stamps[name].push_back(msgs::Convert(_msg.header().stamp()));
+        };
+    EXPECT_TRUE(node.Subscribe("world/non_rendering_sensors_stagger/model/"
+        "sensors_model/link/link/sensor/" + name + "/imu", imuCb));
+  }
+
+  std::function<void(const msgs::Param &)> budgetCb =
+      [&](const msgs::Param &_msg)
+      {
+        maxUpdates = _msg.params().at("max_sensor_updates").int_value();
+      };
+  EXPECT_TRUE(node.Subscribe("/sensor_budget", budgetCb));
+
+  const unsigned int iters = 1000u;
+  server.Run(true, iters, false);
+
+  // Each sensor updates 100 times in a second
+  auto received = [&]
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::size_t count{0};
+    for (const auto &[name, sensorStamps] : stamps)
+      count += sensorStamps.size();
+    return count;
+  };
+  for (int sleep = 0; sleep < 30 && received() < sensorCount * 100u; ++sleep)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+
+  // Messages may be lost, so rather than counting them, check that each
+  // sensor keeps its own offset within the period, updating once per period
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_EQ(sensorCount, stamps.size());
+  std::set<std::chrono::steady_clock::duration::rep> offsets;
+  for (const auto &[name, sensorStamps] : stamps)
+  {
+    ASSERT_LT(1u, sensorStamps.size()) << name;
+    EXPECT_GE(101u, sensorStamps.size()) << name;
+
+    const auto offset = sensorStamps.front().count() %
+        std::chrono::steady_clock::duration(period).count();
+    offsets.insert(offset);
+    for (std::size_t i = 1; i < sensorStamps.size(); ++i)
+    {
+      EXPECT_EQ(offset, sensorStamps[i].count() %
+          std::chrono::steady_clock::duration(period).count()) << name;
+      EXPECT_LT(sensorStamps[i - 1], sensorStamps[i]) << name;
+    }
+  }
+
+  // Not all sensors are updated on the same step
+  EXPECT_LT(1u, offsets.size());
+  EXPECT_LT(0, maxUpdates);
+  EXPECT_GT(static_cast<int>(sensorCount), maxUpdates);
+}
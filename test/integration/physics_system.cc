@@ -68,6 +68,7 @@
 #include "ignition/gazebo/components/Physics.hh"
 #include "ignition/gazebo/components/Pose.hh"
 #include "ignition/gazebo/components/PoseCmd.hh"
+#include "ignition/gazebo/components/Sleeping.hh"
 #include "ignition/gazebo/components/Static.hh"
 #include "ignition/gazebo/components/Visual.hh"
 #include "ignition/gazebo/components/World.hh"
@@ -2264,3 +2265,90 @@ TEST_F(PhysicsSystemFixtureWithDart6_10,
   server->AddSystem(testSystem.systemPtr);
   server->Run(true, nIters, false);
 }
+
+/////////////////////////////////////////////////
+// A resting model falls asleep with its final pose written, its pose isn't
+// updated while it sleeps, and a pose command wakes it up.
+TEST_F(PhysicsSystemFixture, IGN_UTILS_TEST_DISABLED_ON_WIN32(Sleeping))
+{
+  ServerConfig serverConfig;
+  serverConfig.SetSdfFile(std::string(PROJECT_SOURCE_PATH) +
+    "/test/worlds/sleeping.sdf");
+
+  Server server(serverConfig);
+  server.SetUpdatePeriod(1us);
+
+  std::vector<math::Pose3d> poses;
+  std::vector<bool> sleeping;
+  bool wake{false};
+
+  test::Relay testSystem;
+  testSystem.OnPreUpdate(
+    [&](const UpdateInfo &, EntityComponentManager &_ecm)
+    {
+      if (!wake)
+        return;
+
+      auto box = _ecm.EntityByComponents(components::Model(),
+          components::Name("box"));
+      _ecm.CreateComponent(box,
+          components::WorldPoseCmd(math::Pose3d(0, 0, 2, 0, 0, 0)));
+      wake = false;
+    });
+  testSystem.OnPostUpdate(
+    [&](const UpdateInfo &, const EntityComponentManager &_ecm)
+    {
+      auto box = _ecm.EntityByComponents(components::Model(),
+          components::Name("box"));
+      poses.push_back(_ecm.Component<components::Pose>(box)->Data());
+      auto sleepingComp = _ecm.Component<components::Sleeping>(box);
+      sleeping.push_back(nullptr != sleepingComp && sleepingComp->Data());
+    });
+  server.AddSystem(testSystem.systemPtr);
+
+  // Let the box land and settle
+  server.Run(true, 2000, false);
+  ASSERT_EQ(2000u, poses.size());
+
+  auto asleep = std::find(sleeping.begin(), sleeping.end(), true);
+  ASSERT_NE(sleeping.end(), asleep);
+  const auto asleepStep =
+      static_cast<std::size_t>(std::distance(sleeping.begin(), asleep));
+  ASSERT_GT(asleepStep, 0u);
+
+  // The pose written on the step the box fell asleep is its resting pose,
+  // and it doesn't change afterwards
+  EXPECT_NEAR(0.5, poses[asleepStep].Pos().Z(), 1e-2);
+  EXPECT_NEAR(0.0, poses[asleepStep].Pos().Distance(
+      poses[asleepStep - 1].Pos()), 1e-4);
+  for (std::size_t i = asleepStep; i < poses.size(); ++i)
+  {
+    EXPECT_TRUE(sleeping[i]) << i;
+    EXPECT_EQ(poses[asleepStep], poses[i]) << i;
+  }
+
+  // Teleport the box up, it wakes up and falls freely
+  poses.clear();
+  sleeping.clear();
+  wake = true;
+  server.Run(true, 300, false);
+  ASSERT_EQ(300u, poses.size());
+
+  const double dt = 0.001;
+  const double gravity = 9.8;
+  for (std::size_t i = 0; i < poses.size(); ++i)
+  {
+    EXPECT_FALSE(sleeping[i]) << i;
+    const double t = static_cast<double>(i + 1) * dt;
+    EXPECT_NEAR(2.0 - 0.5 * gravity * t * t, poses[i].Pos().Z(), 1e-2) << i;
+    if (i > 0)
+    {
+      EXPECT_LT(poses[i].Pos().Z(), poses[i - 1].Pos().Z()) << i;
+    }
+  }
+
+  // It falls asleep again once it rests on the ground
+  server.Run(true, 3000, false);
+  EXPECT_TRUE(sleeping.back());
+  EXPECT_NEAR(0.5, poses.back().Pos().Z(), 1e-2);
+}
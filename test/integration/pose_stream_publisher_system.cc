@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2022 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <ignition/msgs/pose_v.pb.h>
+
+#include <ignition/common/Console.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/transport/Node.hh>
+#include <ignition/utilities/ExtraTestMacros.hh>
+
+#include "ignition/gazebo/Server.hh"
+#include "ignition/gazebo/test_config.hh"
+
+#include "../helpers/EnvTestFixture.hh"
+
+using namespace ignition;
+using namespace gazebo;
+
+/// \brief Test PoseStreamPublisher system
+class PoseStreamPublisherTest : public InternalFixture<::testing::Test>
+{
+};
+
+/// \brief Collects messages received on a topic.
+class PoseVCollector
+{
+  /// \brief Callback for the subscription.
+  /// \param[in] _msg Received message.
+  public: void OnMsg(const msgs::Pose_V &_msg)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->msgs.push_back(_msg);
+  }
+
+  /// \brief Number of received messages.
+  /// \return Message count.
+  public: std::size_t Count()
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->msgs.size();
+  }
+
+  /// \brief Mutex protecting msgs.
+  public: std::mutex mutex;
+
+  /// \brief Received messages.
+  public: std::vector<msgs::Pose_V> msgs;
+};
+
+/// \brief Get the value of a header key of a pose.
+/// \param[in] _pose Pose message.
+/// \param[in] _key Key.
+/// \return The first value for that key, or an empty string.
+std::string headerValue(const msgs::Pose &_pose, const std::string &_key)
+{
+  for (const auto &data : _pose.header().data())
+  {
+    if (data.key() == _key && data.value_size() > 0)
+      return data.value(0);
+  }
+  return "";
+}
+
+/////////////////////////////////////////////////
+TEST_F(PoseStreamPublisherTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(Streams))
+{
+  ServerConfig serverConfig;
+  serverConfig.SetSdfFile(std::string(PROJECT_SOURCE_PATH) +
+      "/test/worlds/pose_stream_publisher.sdf");
+
+  Server server(serverConfig);
+
+  PoseVCollector all;
+  PoseVCollector robot1;
+  transport::Node node;
+  EXPECT_TRUE(node.Subscribe("/pose_stream/all", &PoseVCollector::OnMsg,
+      &all));
+  EXPECT_TRUE(node.Subscribe("/pose_stream/robot_1", &PoseVCollector::OnMsg,
+      &robot1));
+
+  // 1 kHz simulation for 1 second
+  const std::size_t iters{1000u};
+  server.Run(true, iters, false);
+
+  for (int sleep = 0; sleep < 30 &&
+      (all.Count() < iters || robot1.Count() < 100u); ++sleep)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+
+  // One message per step on the unthrottled stream, 100 Hz on the other
+  EXPECT_EQ(iters, all.Count());
+  EXPECT_NEAR(100u, robot1.Count(), 1u);
+
+  std::lock_guard<std::mutex> lockAll(all.mutex);
+  std::lock_guard<std::mutex> lockRobot1(robot1.mutex);
+  ASSERT_FALSE(all.msgs.empty());
+  ASSERT_FALSE(robot1.msgs.empty());
+
+  // 2 models and 3 links
+  const auto &allMsg = all.msgs.back();
+  ASSERT_EQ(5, allMsg.pose_size());
+  std::vector<std::string> names;
+  for (const auto &pose : allMsg.pose())
+  {
+    names.push_back(pose.name());
+    EXPECT_EQ(allMsg.header().stamp().sec(), pose.header().stamp().sec());
+    EXPECT_EQ(allMsg.header().stamp().nsec(), pose.header().stamp().nsec());
+    EXPECT_EQ(pose.name(), headerValue(pose, "child_frame_id"));
+  }
+  EXPECT_EQ(std::vector<std::string>({"robot_1", "robot_1::base",
+      "robot_1::arm", "robot_2", "robot_2::base"}), names);
+  EXPECT_EQ("pose_stream_publisher", headerValue(allMsg.pose(0), "frame_id"));
+  EXPECT_EQ("robot_1", headerValue(allMsg.pose(1), "frame_id"));
+  EXPECT_EQ(math::Pose3d(-3, 0, 0, 0, 0, 0),
+      msgs::Convert(allMsg.pose(3)));
+  EXPECT_EQ(math::Pose3d(0, 0.1, 0, 0, 0, 0),
+      msgs::Convert(allMsg.pose(1)));
+
+  // Only robot_1 frames, with quantized positions
+  const auto &robot1Msg = robot1.msgs.front();
+  ASSERT_EQ(3, robot1Msg.pose_size());
+  EXPECT_EQ("robot_1", robot1Msg.pose(0).name());
+  EXPECT_DOUBLE_EQ(1.0, robot1Msg.pose(0).position().x());
+  EXPECT_DOUBLE_EQ(0.0, robot1Msg.pose(1).position().y());
+}
@@ -17,13 +17,22 @@
 
 #include <gtest/gtest.h>
 #include <google/protobuf/util/message_differencer.h>
+#include <ignition/msgs/param.pb.h>
+#include <ignition/msgs/stringmsg.pb.h>
 
+#include <algorithm>
+#include <mutex>
+#include <sstream>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include <ignition/common/Console.hh>
 #include <ignition/common/Util.hh>
+#include "ignition/gazebo/components/Link.hh"
 #include "ignition/gazebo/components/Model.hh"
 #include "ignition/gazebo/components/Name.hh"
+#include "ignition/gazebo/components/ParentEntity.hh"
 #include "ignition/gazebo/components/Pose.hh"
 #include <ignition/transport/Node.hh>
 #include <ignition/utilities/ExtraTestMacros.hh>
@@ -405,6 +414,176 @@ TEST_P(SceneBroadcasterTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(SpawnedModel))
   EXPECT_EQ(initEntityCount + 3, *server.EntityCount());
 }
 
+/////////////////////////////////////////////////
+/// Test that the cached scene is kept up to date when models are spawned
+/// and removed after it has been requested.
+TEST_P(SceneBroadcasterTest,
+    IGN_UTILS_TEST_DISABLED_ON_WIN32(SceneInfoCacheUpdated))
+{
+  // Start server
+  ignition::gazebo::ServerConfig serverConfig;
+  serverConfig.SetSdfFile(std::string(PROJECT_SOURCE_PATH) +
+                          "/test/worlds/shapes.sdf");
+
+  gazebo::Server server(serverConfig);
+  server.Run(true, 1, false);
+
+  transport::Node node;
+
+  auto requestScene = [&node]()
+  {
+    ignition::msgs::Empty req;
+    ignition::msgs::Scene rep;
+    bool result{false};
+    unsigned int timeout = 2000;
+    EXPECT_TRUE(node.Request("/world/default/scene/info", req, timeout,
+          rep, result));
+    EXPECT_TRUE(result);
+    return rep;
+  };
+
+  auto findModel = [](const msgs::Scene &_scene, const std::string &_name)
+  {
+    for (const auto &model : _scene.model())
+    {
+      if (model.name() == _name)
+        return true;
+    }
+    return false;
+  };
+
+  // Build the cache
+  auto initialScene = requestScene();
+  EXPECT_TRUE(findModel(initialScene, "cylinder"));
+  EXPECT_FALSE(findModel(initialScene, "spawned_model"));
+
+  // Requesting again gives the same scene
+  auto cachedScene = requestScene();
+  EXPECT_EQ(initialScene.DebugString(), cachedScene.DebugString());
+
+  // Spawn a model
+  {
+    auto modelStr = R"(
+<?xml version="1.0" ?>
+<sdf version='1.6'>
+  <model name='spawned_model'>
+    <link name='link'>
+      <visual name='visual'>
+        <geometry><sphere><radius>1.0</radius></sphere></geometry>
+      </visual>
+    </link>
+  </model>
+</sdf>)";
+
+    msgs::EntityFactory req;
+    msgs::Boolean res;
+    bool result;
+    unsigned int timeout = 5000;
+    req.set_sdf(modelStr);
+    EXPECT_TRUE(node.Request("/world/default/create",
+          req, timeout, res, result));
+    EXPECT_TRUE(result);
+    EXPECT_TRUE(res.data());
+  }
+  server.Run(true, 1, false);
+
+  auto spawnedScene = requestScene();
+  EXPECT_EQ(initialScene.model_size() + 1, spawnedScene.model_size());
+  EXPECT_TRUE(findModel(spawnedScene, "spawned_model"));
+  for (const auto &model : spawnedScene.model())
+  {
+    if (model.name() != "spawned_model")
+      continue;
+    ASSERT_EQ(1, model.link_size());
+    EXPECT_EQ(1, model.link(0).visual_size());
+  }
+
+  // Remove a model
+  auto cylinderModelId = server.EntityByName("cylinder");
+  ASSERT_TRUE(cylinderModelId.has_value());
+  server.RequestRemoveEntity(cylinderModelId.value());
+  server.Run(true, 2, false);
+
+  auto removedScene = requestScene();
+  EXPECT_EQ(initialScene.model_size(), removedScene.model_size());
+  EXPECT_FALSE(findModel(removedScene, "cylinder"));
+  EXPECT_TRUE(findModel(removedScene, "spawned_model"));
+}
+
+/////////////////////////////////////////////////
+/// Test that the cached scene is rebuilt when a link is added to an existing
+/// model.
+TEST_P(SceneBroadcasterTest,
+    IGN_UTILS_TEST_DISABLED_ON_WIN32(SceneInfoCacheSpawnedLink))
+{
+  // Start server
+  ignition::gazebo::ServerConfig serverConfig;
+  serverConfig.SetSdfFile(std::string(PROJECT_SOURCE_PATH) +
+                          "/test/worlds/shapes.sdf");
+
+  gazebo::Server server(serverConfig);
+
+  bool spawn{false};
+  test::Relay testSystem;
+  testSystem.OnPreUpdate(
+      [&](const gazebo::UpdateInfo &, gazebo::EntityComponentManager &_ecm)
+      {
+        if (!spawn)
+          return;
+        spawn = false;
+
+        auto box = _ecm.EntityByComponents(gazebo::components::Model(),
+            gazebo::components::Name("box"));
+        auto link = _ecm.CreateEntity();
+        _ecm.CreateComponent(link, gazebo::components::Link());
+        _ecm.CreateComponent(link, gazebo::components::Name("spawned_link"));
+        _ecm.CreateComponent(link, gazebo::components::ParentEntity(box));
+        _ecm.CreateComponent(link,
+            gazebo::components::Pose(math::Pose3d(0, 0, 1, 0, 0, 0)));
+      });
+  server.AddSystem(testSystem.systemPtr);
+  server.Run(true, 1, false);
+
+  transport::Node node;
+
+  auto requestBoxLinks = [&node]()
+  {
+    ignition::msgs::Empty req;
+    ignition::msgs::Scene rep;
+    bool result{false};
+    unsigned int timeout = 2000;
+    EXPECT_TRUE(node.Request("/world/default/scene/info", req, timeout,
+          rep, result));
+    EXPECT_TRUE(result);
+
+    std::vector<std::string> links;
+    for (const auto &model : rep.model())
+    {
+      if (model.name() != "box")
+        continue;
+      for (const auto &link : model.link())
+        links.push_back(link.name());
+    }
+    return links;
+  };
+
+  // Build the cache
+  auto links = requestBoxLinks();
+  ASSERT_EQ(1u, links.size());
+  EXPECT_EQ("box_link", links[0]);
+
+  // Add a link to the box
+  spawn = true;
+  server.Run(true, 1, false);
+  EXPECT_FALSE(spawn);
+
+  links = requestBoxLinks();
+  ASSERT_EQ(2u, links.size());
+  EXPECT_NE(links.end(), std::find(links.begin(), links.end(), "box_link"));
+  EXPECT_NE(links.end(),
+      std::find(links.begin(), links.end(), "spawned_link"));
+}
+
 /////////////////////////////////////////////////
 TEST_P(SceneBroadcasterTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(State))
 {
@@ -514,6 +693,211 @@ TEST_P(SceneBroadcasterTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(State))
     IGN_SLEEP_MS(100);
   }
   EXPECT_TRUE(received);
+
+  // Later requests are served from the snapshot, which keeps up with the
+  // periodic state updates, without waiting for the server to step
+  auto iterationsBefore = *server.IterationCount();
+  server.Run(true, 100, false);
+  auto iterations = *server.IterationCount();
+
+  msgs::SerializedStepMap res;
+  bool result{false};
+  unsigned int timeout{5000u};
+  EXPECT_TRUE(node.Request("/world/default/state", timeout, res, result));
+  EXPECT_TRUE(result);
+
+  received = false;
+  checkMsg(res, 24);
+  EXPECT_TRUE(received);
+  EXPECT_LT(iterationsBefore, res.stats().iterations());
+  EXPECT_GE(iterations, res.stats().iterations());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneBroadcasterTest,
+    IGN_UTILS_TEST_DISABLED_ON_WIN32(StateSnapshotPeriodicChange))
+{
+  // Start server
+  ignition::gazebo::ServerConfig serverConfig;
+  serverConfig.SetSdfFile(std::string(PROJECT_SOURCE_PATH) +
+      "/test/worlds/shapes.sdf");
+
+  gazebo::Server server(serverConfig);
+
+  // Move the light on a single step, which most likely isn't one of the
+  // steps whose state is serialized
+  const uint64_t moveIteration{50u};
+  const math::Pose3d movedPose(5, 6, 7, 0, 0, 0);
+  gazebo::Entity light{gazebo::kNullEntity};
+  test::Relay testSystem;
+  testSystem.OnPreUpdate(
+      [&](const gazebo::UpdateInfo &_info,
+          gazebo::EntityComponentManager &_ecm)
+      {
+        if (light == gazebo::kNullEntity)
+          light = _ecm.EntityByComponents(gazebo::components::Name("sun"));
+        if (_info.iterations != moveIteration)
+          return;
+        _ecm.SetComponentData<gazebo::components::Pose>(light, movedPose);
+        _ecm.SetChanged(light, gazebo::components::Pose::typeId,
+            gazebo::ComponentState::PeriodicChange);
+      });
+  server.AddSystem(testSystem.systemPtr);
+
+  // Seed the snapshot while paused
+  server.Run(false, 0, true);
+
+  transport::Node node;
+  msgs::SerializedStepMap res;
+  bool result{false};
+  unsigned int timeout{5000u};
+  EXPECT_TRUE(node.Request("/world/default/state", timeout, res, result));
+  EXPECT_TRUE(result);
+  EXPECT_GT(moveIteration, res.stats().iterations());
+
+  // Keep requesting the state until the snapshot is past the move
+  server.SetPaused(false);
+  for (int sleep = 0; sleep < 50 &&
+      res.stats().iterations() <= moveIteration; ++sleep)
+  {
+    IGN_SLEEP_MS(100);
+    EXPECT_TRUE(node.Request("/world/default/state", timeout, res, result));
+    EXPECT_TRUE(result);
+  }
+  EXPECT_LT(moveIteration, res.stats().iterations());
+
+  auto entityIt = res.state().entities().find(light);
+  ASSERT_NE(res.state().entities().end(), entityIt);
+  auto compIt = entityIt->second.components().find(
+      gazebo::components::Pose::typeId);
+  ASSERT_NE(entityIt->second.components().end(), compIt);
+
+  gazebo::components::Pose pose;
+  std::istringstream istr(compIt->second.component());
+  pose.Deserialize(istr);
+  EXPECT_EQ(movedPose, pose.Data());
+}
+
+/////////////////////////////////////////////////
+TEST_P(SceneBroadcasterTest, IGN_UTILS_TEST_DISABLED_ON_WIN32(StateStream))
+{
+  // Start server
+  ignition::gazebo::ServerConfig serverConfig;
+  serverConfig.SetSdfFile(std::string(PROJECT_SOURCE_PATH) +
+      "/test/worlds/shapes.sdf");
+
+  gazebo::Server server(serverConfig);
+  EXPECT_EQ(24u, *server.EntityCount());
+
+  // Run server once so the services are advertised
+  server.Run(true, 1, false);
+
+  transport::Node node;
+  auto subscribe = [&](const msgs::Param &_req)
+  {
+    msgs::StringMsg res;
+    bool result{false};
+    unsigned int timeout{5000u};
+    EXPECT_TRUE(node.Request("/world/default/state/subscribe", _req,
+        timeout, res, result));
+    return result ? res.data() : std::string();
+  };
+
+  auto setParam = [](msgs::Param &_req, const std::string &_key,
+      const std::string &_value)
+  {
+    auto &param = (*_req.mutable_params())[_key];
+    param.set_type(msgs::Any::STRING);
+    param.set_string_value(_value);
+  };
+
+  // Poses of the box model and its descendants
+  msgs::Param boxReq;
+  setParam(boxReq, "entity_pattern", "default::box*");
+  setParam(boxReq, "components", "Pose");
+  auto &rate = (*boxReq.mutable_params())["rate"];
+  rate.set_type(msgs::Any::DOUBLE);
+  rate.set_double_value(5.0);
+  auto boxTopic = subscribe(boxReq);
+  EXPECT_FALSE(boxTopic.empty());
+
+  // The same options share a topic
+  EXPECT_EQ(boxTopic, subscribe(boxReq));
+
+  // All components of all links
+  msgs::Param linkReq;
+  setParam(linkReq, "entity_component", "ign_gazebo_components.Link");
+  auto linkTopic = subscribe(linkReq);
+  EXPECT_FALSE(linkTopic.empty());
+  EXPECT_NE(boxTopic, linkTopic);
+
+  // Invalid options are rejected
+  msgs::Param badReq;
+  setParam(badReq, "components", "NotAComponent");
+  EXPECT_TRUE(subscribe(badReq).empty());
+
+  std::mutex mutex;
+  std::vector<msgs::SerializedStepMap> boxMsgs;
+  std::vector<msgs::SerializedStepMap> linkMsgs;
+  std::function<void(const msgs::SerializedStepMap &)> boxCb =
+      [&](const msgs::SerializedStepMap &_msg)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    boxMsgs.push_back(_msg);
+  };
+  std::function<void(const msgs::SerializedStepMap &)> linkCb =
+      [&](const msgs::SerializedStepMap &_msg)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    linkMsgs.push_back(_msg);
+  };
+  EXPECT_TRUE(node.Subscribe(boxTopic, boxCb));
+  EXPECT_TRUE(node.Subscribe(linkTopic, linkCb));
+
+  // Run for 1 second of real time
+  server.Run(true, 1000, false);
+
+  unsigned int sleep{0u};
+  unsigned int maxSleep{30u};
+  while (sleep++ < maxSleep)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!boxMsgs.empty() && !linkMsgs.empty())
+        break;
+    }
+    IGN_SLEEP_MS(100);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  // Box stream is throttled to 5 Hz
+  ASSERT_FALSE(boxMsgs.empty());
+  EXPECT_GE(7u, boxMsgs.size());
+  for (const auto &msg : boxMsgs)
+  {
+    EXPECT_TRUE(msg.has_stats());
+    // Model, link, collision and visual
+    EXPECT_EQ(4, msg.state().entities_size());
+    for (const auto &[id, entityMsg] : msg.state().entities())
+    {
+      ASSERT_EQ(1, entityMsg.components_size());
+      EXPECT_EQ(static_cast<int64_t>(gazebo::components::Pose::typeId),
+          entityMsg.components().begin()->first);
+    }
+  }
+
+  // Link stream uses the default rate
+  ASSERT_FALSE(linkMsgs.empty());
+  EXPECT_LT(boxMsgs.size(), linkMsgs.size());
+  for (const auto &msg : linkMsgs)
+  {
+    EXPECT_EQ(5, msg.state().entities_size());
+    for (const auto &[id, entityMsg] : msg.state().entities())
+    {
+      EXPECT_LT(1, entityMsg.components_size());
+    }
+  }
 }
 
 /////////////////////////////////////////////////